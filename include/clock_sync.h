@@ -0,0 +1,127 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class OKXRestAPI;
+
+/**
+ * @brief Estimates the offset between the local clock and OKX server time
+ *
+ * Each sample is one GET /api/v5/public/time round trip: the local clock
+ * is read as the request goes out (t0) and as the response arrives (t1),
+ * and the server time is assumed to have been taken half way, so
+ *
+ *     offset = server - (t0 + t1) / 2,   error <= rtt / 2
+ *
+ * As in NTP's clock filter, the estimate is the offset of the sample with
+ * the smallest round trip among the last kWindow, since that sample has
+ * the tightest error bound; slow round trips (queuing, retransmits) are
+ * kept in the window but never win. OKX reports whole milliseconds, so
+ * the server time is taken at the middle of its millisecond.
+ *
+ * On every new estimate the offset is pushed to OKXSigner, which moves the
+ * REST / WebSocket login timestamps and the WebSocket market-data latency
+ * (Tick::latency_us) onto the exchange clock.
+ */
+class ClockSync {
+public:
+    struct Estimate {
+        int64_t offset_us = 0;     // Server time - local time
+        int64_t rtt_us = 0;        // Round trip of the sample the offset came from
+        int64_t jitter_us = 0;     // RMS spread of the window's offsets around offset_us
+        uint64_t samples = 0;      // Samples accepted
+        uint64_t rejected = 0;     // Failed requests and implausible round trips
+        bool valid = false;
+    };
+
+    // Server time in epoch ms; <= 0 on failure
+    using ServerTimeSource = std::function<int64_t()>;
+
+    // Same, also reporting the local send / receive times (epoch µs) it measured
+    using TimedServerTimeSource = std::function<int64_t(int64_t& send_us, int64_t& receive_us)>;
+
+    static constexpr size_t kWindow = 8;
+
+    explicit ClockSync(OKXRestAPI& api);
+    explicit ClockSync(ServerTimeSource source);
+    explicit ClockSync(TimedServerTimeSource source);
+    ~ClockSync();
+
+    ClockSync(const ClockSync&) = delete;
+    ClockSync& operator=(const ClockSync&) = delete;
+
+    /**
+     * @brief Take one sample and, if the estimate changed, apply it
+     */
+    bool SyncOnce();
+
+    /**
+     * @brief Take up to `rounds` samples back to back
+     * @return Number of samples accepted
+     */
+    int Sync(int rounds = static_cast<int>(kWindow));
+
+    /**
+     * @brief Feed a measured round trip (local times in epoch µs)
+     * @return false if rejected (negative or over SetMaxRtt)
+     */
+    bool AddSample(int64_t send_us, int64_t server_ms, int64_t receive_us);
+
+    Estimate GetEstimate() const;
+
+    /**
+     * @brief Push the current offset to OKXSigner (done by SyncOnce / Sync)
+     */
+    void Apply() const;
+
+    /**
+     * @brief Round trips longer than this are discarded (default 2 s)
+     */
+    void SetMaxRtt(std::chrono::microseconds max_rtt);
+
+    /**
+     * @brief Resample in the background: a burst of samples at start,
+     *        then one per interval
+     */
+    bool Start(std::chrono::milliseconds interval = std::chrono::seconds(60));
+    void Stop();
+    bool IsRunning() const { return running_.load(); }
+
+    /**
+     * @brief Unadjusted local clock, epoch µs
+     */
+    static int64_t LocalNowUs();
+
+private:
+    struct Sample {
+        int64_t offset_us;
+        int64_t rtt_us;
+    };
+
+    void Run(std::chrono::milliseconds interval);
+    void UpdateEstimate();
+
+private:
+    TimedServerTimeSource source_;
+
+    mutable std::mutex mutex_;
+    Sample window_[kWindow];
+    size_t window_count_;
+    size_t window_next_;
+    int64_t max_rtt_us_;
+    Estimate estimate_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+};
+
+#endif // CLOCK_SYNC_H
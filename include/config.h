@@ -1,11 +1,58 @@
 #pragma once
 
+#include "data_types.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <map>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 using json = nlohmann::json;
 
+/**
+ * @brief 已解析的配置：Load 时一次性转换成类型化字段，之后不可变
+ *
+ * 策略线程按 tick 读取参数时不再查 JSON；重新加载时整体替换成新快照，
+ * 读者手里的旧快照在释放前一直有效。
+ */
+struct ConfigSnapshot {
+    struct OKXAccount {
+        std::string api_key;
+        std::string secret_key;
+        std::string passphrase;
+        std::string rest_url;
+        std::string ws_public;
+        std::string ws_private;
+    };
+
+    struct MT5Account {
+        std::string server;
+        int login = 0;
+        std::string password;
+    };
+
+    std::string environment;
+    OKXAccount okx;                                  // 当前环境
+    MT5Account mt5;                                  // 当前环境
+    std::map<std::string, std::string> okx_symbols;  // base -> inst_id
+    std::map<std::string, std::string> mt5_symbols;  // base -> MT5 symbol
+    StrategyParams strategy;
+    uint64_t version = 0;                            // 每次成功加载 +1
+
+    bool IsSimulation() const { return environment == "simulation"; }
+
+    /**
+     * @brief 从 JSON 构建快照并校验
+     * @param environment 为空时使用 JSON 中的 "environment"
+     * @return false 时 error 说明原因（缺少/类型错误/取值非法）
+     */
+    static bool Build(const json& config, const std::string& environment,
+                      ConfigSnapshot& snapshot, std::string& error);
+};
+
 /**
  * @brief 简单的配置管理器
  */
@@ -15,17 +62,47 @@ public:
         static Config instance;
         return instance;
     }
-    
-    // 加载配置文件
+
+    // 加载配置文件（校验失败时保留原配置）
     bool Load(const std::string& filepath);
-    
+
+    // 当前快照；持有期间不受重新加载影响
+    std::shared_ptr<const ConfigSnapshot> GetSnapshot() const;
+    uint64_t GetVersion() const { return version_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 热路径读取：版本未变时只有一次原子读，不加锁
+     *
+     * 每个读线程各持有一个 Reader。
+     */
+    class Reader {
+    public:
+        explicit Reader(const Config& config = Config::Instance()) : config_(config), version_(0) {}
+
+        const ConfigSnapshot& Get() {
+            uint64_t version = config_.GetVersion();
+            if (version != version_ || !snapshot_) {
+                snapshot_ = config_.GetSnapshot();
+                version_ = version;
+            }
+            return *snapshot_;
+        }
+
+        const StrategyParams& Strategy() { return Get().strategy; }
+
+    private:
+        const Config& config_;
+        uint64_t version_;
+        std::shared_ptr<const ConfigSnapshot> snapshot_;
+    };
+
     // 获取当前环境
-    bool IsSimulation() const { return environment_ == "simulation"; }
-    std::string GetEnvironment() const { return environment_; }
-    
-    // 切换环境
-    void SetEnvironment(const std::string& env) { environment_ = env; }
-    
+    bool IsSimulation() const { return GetSnapshot()->IsSimulation(); }
+    std::string GetEnvironment() const { return GetSnapshot()->environment; }
+
+    // 切换环境（重新生成快照）；之后的 Load 沿用该环境，传空串恢复使用 JSON 中的值
+    void SetEnvironment(const std::string& env);
+
     // OKX配置
     std::string GetOKXAPIKey() const;
     std::string GetOKXSecretKey() const;
@@ -34,14 +111,17 @@ public:
     std::string GetOKXWSPublic() const;
     std::string GetOKXWSPrivate() const;
     std::string GetOKXSymbol(const std::string& base) const;
-    
+    std::vector<std::string> GetSymbolBases() const;   // okx.symbols 的所有键
+
     // MT5配置
     std::string GetMT5Server() const;
     int GetMT5Login() const;
     std::string GetMT5Password() const;
     std::string GetMT5Symbol(const std::string& base) const;
-    
+    bool HasMT5Symbol(const std::string& base) const;
+
     // 策略配置
+    StrategyParams GetStrategyParams() const;
     double GetFirstOrder() const;
     double GetNextOrder() const;
     int GetMaxOrders() const;
@@ -50,9 +130,16 @@ public:
     double GetMT5FeeRate() const;
     double GetOKXOrderSize() const;
     double GetMT5OrderSize() const;
-    
+
 private:
-    Config() = default;
-    json config_;
-    std::string environment_;
+    Config();
+
+    // 校验并发布新快照
+    bool Publish(const json& config, const std::string& environment);
+
+    std::mutex load_mutex_;                          // 保护 config_，串行化加载
+    json config_;                                    // 仅加载/切换环境时使用
+    std::string environment_;                        // SetEnvironment 的覆盖值，受 load_mutex_ 保护
+    std::shared_ptr<const ConfigSnapshot> snapshot_; // 通过 std::atomic_load/store 访问
+    std::atomic<uint64_t> version_;
 };
@@ -0,0 +1,80 @@
+#ifndef CONFIG_WATCHER_H
+#define CONFIG_WATCHER_H
+
+#include "config.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Reloads the config file whenever it changes on disk
+ *
+ * A background thread watches the file's directory with inotify (so
+ * editors that save through a temp file + rename are seen too) and calls
+ * Config::Load on every completed write. Load validates the new JSON and
+ * publishes a new ConfigSnapshot atomically, so strategy threads reading
+ * through Config::Reader pick up new StrategyParams / endpoints on their
+ * next read without pausing; a file that fails validation is rejected
+ * and the previous snapshot stays in force. Other platforms poll the
+ * file's modification time.
+ */
+class ConfigWatcher {
+public:
+    struct Statistics {
+        uint64_t accepted = 0;     // Reloads that published a new snapshot
+        uint64_t rejected = 0;     // Reloads that failed to parse or validate
+    };
+
+    using ReloadCallback = std::function<void(const ConfigSnapshot& snapshot)>;
+
+    explicit ConfigWatcher(Config& config = Config::Instance());
+    ~ConfigWatcher();
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief Called on the watcher thread after each accepted reload
+     *        (e.g. to reconnect when endpoints changed); set before Start()
+     */
+    void SetReloadCallback(ReloadCallback callback);
+
+    /**
+     * @brief Start watching a config file (already loaded or not)
+     */
+    bool Start(const std::string& path);
+    void Stop();
+    bool IsRunning() const { return running_.load(); }
+
+    /**
+     * @brief Reload now, counted like a file change
+     */
+    bool Reload();
+
+    Statistics GetStatistics() const;
+
+    // Writes closer together than this are folded into one reload
+    static constexpr int kSettleMs = 20;
+
+private:
+    void Run();
+
+private:
+    Config& config_;
+    std::string path_;
+    std::string directory_;
+    std::string file_name_;
+    ReloadCallback reload_callback_;
+
+    std::atomic<bool> running_;
+    std::thread thread_;
+    int notify_fd_;
+    int wake_fd_[2];
+
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> rejected_;
+};
+
+#endif // CONFIG_WATCHER_H
@@ -15,6 +15,23 @@ using Timestamp = uint64_t;  // Millisecond timestamp
 using Price = double;
 using Volume = double;
 
+// Fixed-point values on an instrument's grid (see fixed_point.h); only
+// filled when the instrument's tick/lot size is known, 0 otherwise
+using PriceTicks = int64_t;  // Price in multiples of tickSz
+using SizeLots = int64_t;    // Size in multiples of lotSz
+
+/**
+ * @brief Order / taker side
+ */
+enum class Side {
+    kBuy,
+    kSell
+};
+
+inline Side SideFromString(const std::string& side) {
+    return side == "buy" ? Side::kBuy : Side::kSell;
+}
+
 // ============================================================================
 // Market Data
 // ============================================================================
@@ -35,6 +52,7 @@ struct Tick {
     Volume ask_size;            // Ask size
     
     Timestamp timestamp;        // Timestamp
+    int64_t latency_us;         // Exchange ts -> local receipt on the synced clock (0: not measured)
     
     Price mark_price;           // Mark price
     double funding_rate;        // Funding rate
@@ -49,10 +67,15 @@ struct Tick {
     double volume_24h;          // 24h volume
     double volume_currency_24h; // 24h volume in currency
     
+    // Fixed point (instrument scale known)
+    PriceTicks bid_ticks;       // Bid price in ticks
+    PriceTicks ask_ticks;       // Ask price in ticks
+    
     Tick() : bid(0), ask(0), last(0), bid_size(0), ask_size(0),
-             timestamp(0), mark_price(0), funding_rate(0),
+             timestamp(0), latency_us(0), mark_price(0), funding_rate(0),
              last_price(0), bid_price(0), ask_price(0),
-             high_24h(0), low_24h(0), volume_24h(0), volume_currency_24h(0) {}
+             high_24h(0), low_24h(0), volume_24h(0), volume_currency_24h(0),
+             bid_ticks(0), ask_ticks(0) {}
 };
 
 /**
@@ -62,8 +85,13 @@ struct DepthLevel {
     Price price;      // Price
     Volume size;      // Size
     
-    DepthLevel() : price(0), size(0) {}
-    DepthLevel(Price p, Volume s) : price(p), size(s) {}
+    PriceTicks price_ticks;  // Price in ticks (Depth::fixed_point)
+    SizeLots size_lots;      // Size in lots (Depth::fixed_point)
+    
+    DepthLevel() : price(0), size(0), price_ticks(0), size_lots(0) {}
+    DepthLevel(Price p, Volume s) : price(p), size(s), price_ticks(0), size_lots(0) {}
+    DepthLevel(Price p, Volume s, PriceTicks pt, SizeLots sl)
+        : price(p), size(s), price_ticks(pt), size_lots(sl) {}
 };
 
 /**
@@ -78,17 +106,24 @@ struct Depth {
     std::vector<DepthLevel> asks;  // Asks (price low to high)
     
     Timestamp timestamp;        // Timestamp
+    int64_t latency_us;         // Exchange ts -> local receipt on the synced clock (0: not measured)
     
     // OKX complete fields
     std::string inst_id;        // Instrument ID (OKX format)
     
-    Depth() : timestamp(0) {}
+    bool fixed_point;           // Levels carry price_ticks/size_lots
+    
+    Depth() : timestamp(0), latency_us(0), fixed_point(false) {}
     
     /**
      * @brief Calculate average price for a given size
+     *
+     * Walks asks for a buy, bids for a sell; 0 if the book is too thin.
+     * For many sizes per book use DepthPricer (depth_pricer.h).
      */
-    Price CalculateAvgPrice(const std::string& side, Volume target_size) const {
-        const auto& levels = (side == "buy") ? asks : bids;
+    Price CalculateAvgPrice(Side side, Volume target_size) const {
+        const auto& levels = (side == Side::kBuy) ? asks : bids;
+        if (target_size <= 0) return 0;
         
         double total_cost = 0;
         double filled_size = 0;
@@ -96,7 +131,8 @@ struct Depth {
         for (const auto& level : levels) {
             if (filled_size >= target_size) break;
             
-            double fill = std::min(target_size - filled_size, level.size);
+            double remaining = target_size - filled_size;
+            double fill = remaining < level.size ? remaining : level.size;
             total_cost += fill * level.price;
             filled_size += fill;
         }
@@ -104,6 +140,10 @@ struct Depth {
         if (filled_size < target_size) return 0;  // Not enough depth
         return total_cost / filled_size;
     }
+    
+    Price CalculateAvgPrice(const std::string& side, Volume target_size) const {
+        return CalculateAvgPrice(SideFromString(side), target_size);
+    }
 };
 
 // ============================================================================
@@ -149,11 +189,18 @@ struct Order {
     double sl_trigger_price;      // Stop loss trigger price
     double sl_order_price;        // Stop loss order price
     
+    // Fixed point: when set (and the instrument scale is known) these are
+    // sent instead of price/size, formatted exactly
+    PriceTicks price_ticks;       // Order price in ticks
+    SizeLots size_lots;           // Order size in lots
+    uint32_t instrument_id;       // InstrumentRegistry id; UINT32_MAX: look up inst_id
+    
     Order() : price(0), size(0), filled_size(0), avg_price(0),
               fee(0), pnl(0), create_time(0), update_time(0), group_id(0),
               avg_fill_price(0), leverage(1),
               tp_trigger_price(0), tp_order_price(0),
-              sl_trigger_price(0), sl_order_price(0) {}
+              sl_trigger_price(0), sl_order_price(0),
+              price_ticks(0), size_lots(0), instrument_id(UINT32_MAX) {}
 };
 
 /**
@@ -0,0 +1,87 @@
+#ifndef DEPTH_PRICER_H
+#define DEPTH_PRICER_H
+
+#include "data_types.h"
+#include <cstddef>
+#include <vector>
+
+class OrderBook;
+
+/**
+ * @brief Batch VWAP over one book: average fill price for many sizes
+ *
+ * Build() turns each side into prefix sums once per book update
+ * (cumulative size and cost after each level, best level first); after
+ * that the average price for a size is one search plus two multiply-adds:
+ *
+ *     avg(q) = (cost[k] + (q - filled[k]) * price[k]) / q
+ *
+ * where k is the first level whose cumulative size reaches q. AvgPrices()
+ * prices a whole ladder of sizes in one forward pass over the table
+ * (sorted targets continue the search where the previous one stopped);
+ * the level search compares several cumulative sizes per instruction
+ * (SSE2, or AVX when compiled with it).
+ *
+ * Results match Depth::CalculateAvgPrice: asks for a buy, bids for a
+ * sell, 0 when the book is too thin or the size is not positive. Buffers
+ * are reused across Build() calls, so steady-state use doesn't allocate.
+ */
+class DepthPricer {
+public:
+    DepthPricer() = default;
+
+    void Build(const Depth& depth);
+    void Build(const OrderBook& book, size_t max_levels = 400);
+
+    /**
+     * @brief Average fill price for one size
+     */
+    Price AvgPrice(Side side, Volume target_size) const;
+
+    /**
+     * @brief Average fill prices for `count` sizes into `out`
+     *
+     * Ascending targets (the usual ladder) are priced in a single pass;
+     * unsorted input is still correct, just restarts the search.
+     */
+    void AvgPrices(Side side, const Volume* targets, size_t count, Price* out) const;
+
+    void AvgPrices(Side side, const std::vector<Volume>& targets,
+                   std::vector<Price>& out) const;
+
+    /**
+     * @brief Price the ladder step, 2*step, ... count*step (e.g. okx_order_size
+     *        up to max_orders)
+     */
+    void AvgPricesForLadder(Side side, Volume step, size_t count, Price* out) const;
+
+    /**
+     * @brief Total size available on the side that a `side` order takes
+     */
+    Volume AvailableSize(Side side) const;
+
+private:
+    // Levels of one side, best first; cumulative arrays have one
+    // entry per level: totals *after* that level
+    struct Table {
+        std::vector<double> price;
+        std::vector<double> filled;     // Cumulative size after the level
+        std::vector<double> cost;       // Cumulative price*size after the level
+        size_t count = 0;
+
+        void Clear() { count = 0; }
+        void Add(double px, double sz);
+    };
+
+    const Table& TableFor(Side side) const { return side == Side::kBuy ? asks_ : bids_; }
+
+    // First level in [start, count) whose cumulative size reaches target
+    static size_t FindLevel(const Table& table, size_t start, double target);
+
+    static Price PriceAt(const Table& table, size_t level, double target);
+
+    Table bids_;
+    Table asks_;
+};
+
+#endif // DEPTH_PRICER_H
@@ -0,0 +1,331 @@
+#ifndef EVENT_RING_H
+#define EVENT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Bounded lock-free rings for handing fixed-size records between threads
+ *
+ * SpscRing: one producer, one consumer (e.g. a WebSocket I/O thread and a
+ * strategy thread). MpscRing: several producers, one consumer (e.g. the
+ * public and private WebSocket connections feeding one strategy thread).
+ *
+ * Records are trivially copyable and copied in and out of preallocated
+ * slots; nothing allocates after construction. A full ring never blocks
+ * the producer: TryPush drops the record and counts an overrun, so a slow
+ * consumer cannot stall network reads. Consumers either poll (TryPop /
+ * Drain) or wait in Pop with a busy-spin or yielding loop.
+ *
+ * Capacity is rounded up to a power of two.
+ */
+class EventRing {
+public:
+    static constexpr size_t kCacheLine = 64;
+
+    enum class WaitMode {
+        kBusySpin,   // Lowest latency, burns the (pinned) core
+        kYield       // Spin briefly, then std::this_thread::yield()
+    };
+
+    struct Statistics {
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        uint64_t overruns = 0;     // Records dropped because the ring was full
+    };
+
+    static size_t RoundUpCapacity(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    static void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    /**
+     * @brief One idle step of a wait loop
+     */
+    static void Idle(WaitMode mode, uint32_t& spins) {
+        if (mode == WaitMode::kYield && ++spins > 64) {
+            std::this_thread::yield();
+        } else {
+            CpuRelax();
+        }
+    }
+
+    /**
+     * @brief Pin the calling thread to one CPU core (false if unsupported)
+     */
+    static bool PinCurrentThread(int core);
+};
+
+/**
+ * @brief Single-producer single-consumer ring
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing records must be trivially copyable");
+
+public:
+    explicit SpscRing(size_t capacity)
+        : capacity_(EventRing::RoundUpCapacity(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(new T[capacity_]) {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // ==================== Producer ====================
+
+    /**
+     * @brief Append a record; false (and one overrun) if the ring is full
+     */
+    bool TryPush(const T& item) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - producer_head_cache_ >= capacity_) {
+            producer_head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - producer_head_cache_ >= capacity_) {
+                overruns_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        slots_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ==================== Consumer ====================
+
+    bool TryPop(T& item) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == consumer_tail_cache_) {
+            consumer_tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == consumer_tail_cache_) {
+                return false;
+            }
+        }
+        item = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Wait for a record while `running` is true
+     * @return false if `running` went false before a record arrived
+     */
+    bool Pop(T& item, const std::atomic<bool>& running,
+             EventRing::WaitMode mode = EventRing::WaitMode::kBusySpin) {
+        uint32_t spins = 0;
+        while (!TryPop(item)) {
+            if (!running.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            EventRing::Idle(mode, spins);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Hand up to `max` available records to `handler(const T&)`,
+     *        releasing the slots once after the whole batch
+     */
+    template <typename Handler>
+    size_t Drain(Handler&& handler, size_t max = SIZE_MAX) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        consumer_tail_cache_ = tail;
+
+        size_t count = static_cast<size_t>(tail - head);
+        if (count > max) {
+            count = max;
+        }
+        for (size_t i = 0; i < count; i++) {
+            handler(static_cast<const T&>(slots_[(head + i) & mask_]));
+        }
+        if (count) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // ==================== Queries ====================
+
+    size_t Capacity() const { return capacity_; }
+
+    size_t Size() const {
+        return static_cast<size_t>(tail_.load(std::memory_order_acquire) -
+                                   head_.load(std::memory_order_acquire));
+    }
+
+    bool Empty() const { return Size() == 0; }
+
+    EventRing::Statistics GetStatistics() const {
+        EventRing::Statistics stats;
+        stats.pushed = tail_.load(std::memory_order_relaxed);
+        stats.popped = head_.load(std::memory_order_relaxed);
+        stats.overruns = overruns_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // Producer and consumer indices on separate cache lines, each side
+    // with a cached copy of the other's index to avoid re-reading it
+    alignas(EventRing::kCacheLine) std::atomic<uint64_t> tail_{0};
+    uint64_t producer_head_cache_ = 0;
+    std::atomic<uint64_t> overruns_{0};
+
+    alignas(EventRing::kCacheLine) std::atomic<uint64_t> head_{0};
+    uint64_t consumer_tail_cache_ = 0;
+};
+
+/**
+ * @brief Multi-producer single-consumer ring
+ *
+ * Bounded queue with a sequence number per slot (Vyukov): producers claim
+ * a slot with one CAS on the tail and publish it through the slot's
+ * sequence, the consumer needs no atomic read-modify-write at all.
+ */
+template <typename T>
+class MpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "MpscRing records must be trivially copyable");
+
+public:
+    explicit MpscRing(size_t capacity)
+        : capacity_(EventRing::RoundUpCapacity(capacity))
+        , mask_(capacity_ - 1)
+        , cells_(new Cell[capacity_]) {
+        for (size_t i = 0; i < capacity_; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // ==================== Producers ====================
+
+    bool TryPush(const T& item) {
+        uint64_t position = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[position & mask_];
+            uint64_t sequence = cell->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(position);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                overruns_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ==================== Consumer ====================
+
+    bool TryPop(T& item) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[head & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        item = cell.value;
+        cell.sequence.store(head + capacity_, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool Pop(T& item, const std::atomic<bool>& running,
+             EventRing::WaitMode mode = EventRing::WaitMode::kBusySpin) {
+        uint32_t spins = 0;
+        while (!TryPop(item)) {
+            if (!running.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            EventRing::Idle(mode, spins);
+        }
+        return true;
+    }
+
+    template <typename Handler>
+    size_t Drain(Handler&& handler, size_t max = SIZE_MAX) {
+        size_t count = 0;
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        while (count < max) {
+            Cell& cell = cells_[head & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+                break;
+            }
+            handler(static_cast<const T&>(cell.value));
+            cell.sequence.store(head + capacity_, std::memory_order_release);
+            head++;
+            count++;
+        }
+        head_.store(head, std::memory_order_relaxed);
+        return count;
+    }
+
+    // ==================== Queries ====================
+
+    size_t Capacity() const { return capacity_; }
+
+    size_t Size() const {
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+
+    bool Empty() const { return Size() == 0; }
+
+    EventRing::Statistics GetStatistics() const {
+        EventRing::Statistics stats;
+        stats.pushed = tail_.load(std::memory_order_relaxed);
+        stats.popped = head_.load(std::memory_order_relaxed);
+        stats.overruns = overruns_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(EventRing::kCacheLine) std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> overruns_{0};
+
+    alignas(EventRing::kCacheLine) std::atomic<uint64_t> head_{0};
+};
+
+#endif // EVENT_RING_H
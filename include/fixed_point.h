@@ -0,0 +1,83 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Decimal grid of an instrument (tick size or lot size)
+ *
+ * A value on the grid is stored as an integer count of steps, e.g. with
+ * tickSz "0.1" the price 2350.5 is 23505 ticks. Integers compare and hash
+ * exactly, and formatting back to text is exact: "1" rather than
+ * "1.000000", "2350.5" rather than "2350.500000".
+ *
+ * Internally the step is kept as an integer number of 10^-decimals units
+ * so steps like "0.5" or "0.25" are represented exactly as well.
+ */
+class FixedScale {
+public:
+    static constexpr int kMaxDecimals = 15;
+    static constexpr size_t kMaxFormatLength = 32;
+
+    FixedScale() : decimals_(0), step_(0) {}
+
+    /**
+     * @brief Build from the exchange's step text ("0.01", "1", "0.5")
+     * @return false if the text is not a positive plain decimal
+     */
+    static bool FromStep(std::string_view step, FixedScale& scale);
+
+    /**
+     * @brief Build from a step already parsed to double (InstrumentInfo);
+     *        the shortest round-trip decimal form is used
+     */
+    static bool FromStep(double step, FixedScale& scale);
+
+    bool Valid() const { return step_ > 0; }
+    int Decimals() const { return decimals_; }
+
+    /**
+     * @brief Step size in units of 10^-Decimals()
+     */
+    int64_t Step() const { return step_; }
+
+    /**
+     * @brief Exact text -> steps; false if malformed or off the grid
+     */
+    bool Parse(std::string_view text, int64_t& steps) const;
+
+    /**
+     * @brief Nearest grid point to a double
+     */
+    int64_t Round(double value) const;
+
+    double ToDouble(int64_t steps) const;
+
+    /**
+     * @brief Write the exact decimal text (no trailing zeros) to `out`,
+     *        which must hold kMaxFormatLength chars; not NUL-terminated
+     * @return Number of chars written
+     */
+    size_t Format(int64_t steps, char* out) const;
+
+    std::string ToString(int64_t steps) const;
+
+private:
+    int decimals_;
+    int64_t step_;
+};
+
+/**
+ * @brief Price and size grids of one instrument (tickSz / lotSz)
+ */
+struct InstrumentScale {
+    FixedScale price;
+    FixedScale size;
+
+    bool Valid() const { return price.Valid() && size.Valid(); }
+};
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,271 @@
+#ifndef HISTORY_PAGER_H
+#define HISTORY_PAGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Lazy walk over an OKX cursor-paginated history endpoint
+ *
+ * OKX history endpoints return newest-first pages of at most `limit`
+ * records; `after=<cursor>` asks for the records older than a cursor
+ * (ordId for orders, billId for fills and bills). The pager requests the
+ * first page on the first Next(), and while the caller works through a
+ * page the next one is already being fetched on a background thread.
+ * At most two pages are held at any time, however long the range.
+ *
+ * Page requests go through OKXRestAPI, so they wait on the endpoint's
+ * rate limiter like any other call; a failed page (rejected by the
+ * limiter, HTTP error, non-zero code) is retried with a doubling delay
+ * before the walk stops with Failed() set. A page shorter than the page
+ * size ends the walk without another request.
+ *
+ * Destroying the pager cancels a prefetch: one still queued or waiting
+ * on the limiter gives up without sending, and the destructor waits for
+ * one whose request is already on the wire.
+ *
+ * Usable as a range: for (const Order& order : api.IterateOrderHistory(query)).
+ */
+template <typename T>
+class HistoryPager {
+public:
+    /**
+     * @brief Fetch the page older than `after` (empty: the newest page);
+     *        false if the request failed. Must not send once `cancelled`
+     *        is set.
+     */
+    using FetchPage = std::function<bool(const std::string& after, std::vector<T>& page,
+                                         const std::atomic<bool>& cancelled)>;
+
+    /**
+     * @brief Cursor value of a record (what `after` takes)
+     */
+    using CursorOf = std::function<std::string(const T&)>;
+
+    struct Options {
+        size_t page_size = 100;                     // The limit sent with each request
+        int max_retries = 3;                        // Per page, after the first attempt
+        std::chrono::milliseconds retry_delay{200}; // Doubles on every retry
+        bool prefetch = true;
+    };
+
+    HistoryPager(FetchPage fetch, CursorOf cursor_of, const Options& options, std::string after = "")
+        : fetch_(std::move(fetch))
+        , cursor_of_(std::move(cursor_of))
+        , options_(options)
+        , after_(after)
+        , resume_(std::move(after))
+        , position_(0)
+        , started_(false)
+        , exhausted_(false)
+        , failed_(false)
+        , pages_(0)
+        , records_(0)
+        , shared_(std::make_shared<Shared>()) {}
+
+    ~HistoryPager() {
+        if (shared_) {
+            shared_->cancelled.store(true);
+        }
+        if (next_.valid()) {
+            next_.wait();
+        }
+    }
+
+    HistoryPager(HistoryPager&&) = default;
+    HistoryPager& operator=(HistoryPager&&) = default;
+    HistoryPager(const HistoryPager&) = delete;
+    HistoryPager& operator=(const HistoryPager&) = delete;
+
+    /**
+     * @brief Next record, older than the previous one
+     * @return false at the end of the history or if a page failed
+     */
+    bool Next(T& out) {
+        if (position_ >= page_.size() && !Advance()) {
+            return false;
+        }
+        resume_ = cursor_of_(page_[position_]);
+        out = std::move(page_[position_++]);
+        records_++;
+        return true;
+    }
+
+    bool Failed() const { return failed_; }
+    size_t Pages() const { return pages_; }
+    size_t Records() const { return records_; }
+
+    /**
+     * @brief Cursor of the last record returned; a walk started with it as
+     *        `after` continues with the next record
+     */
+    const std::string& Cursor() const { return resume_; }
+
+    /**
+     * @brief Records held in memory (rest of the current page plus the
+     *        prefetched one, if it has arrived)
+     */
+    size_t Buffered() const {
+        size_t buffered = page_.size() - position_;
+        if (next_.valid() && next_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            buffered += shared_->prefetched.load();
+        }
+        return buffered;
+    }
+
+    // ==================== Range support ====================
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        Iterator() : pager_(nullptr) {}
+        explicit Iterator(HistoryPager* pager) : pager_(pager) { ++*this; }
+
+        reference operator*() const { return current_; }
+        pointer operator->() const { return &current_; }
+
+        Iterator& operator++() {
+            if (pager_ && !pager_->Next(current_)) {
+                pager_ = nullptr;
+            }
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return pager_ == other.pager_; }
+        bool operator!=(const Iterator& other) const { return pager_ != other.pager_; }
+
+    private:
+        HistoryPager* pager_;
+        T current_;
+    };
+
+    Iterator begin() { return Iterator(this); }
+    Iterator end() { return Iterator(); }
+
+private:
+    struct PageResult {
+        bool ok = false;
+        std::vector<T> records;
+    };
+
+    // State the prefetch thread shares with the pager
+    struct Shared {
+        std::atomic<bool> cancelled{false};
+        std::atomic<size_t> prefetched{0};  // Records in the last prefetched page
+    };
+
+    // Sleep for delay, waking early on cancel; false if cancelled
+    static bool Backoff(std::chrono::milliseconds delay, const std::atomic<bool>& cancelled) {
+        auto until = std::chrono::steady_clock::now() + delay;
+        while (!cancelled.load()) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= until) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                until - now, std::chrono::milliseconds(10)));
+        }
+        return false;
+    }
+
+    // Runs on the prefetch thread as well, so it only touches its arguments
+    static PageResult Load(const FetchPage& fetch, const std::string& after, const Options& options,
+                           const std::shared_ptr<Shared>& shared) {
+        PageResult result;
+        std::chrono::milliseconds delay = options.retry_delay;
+        for (int attempt = 0; attempt <= options.max_retries && !shared->cancelled.load(); attempt++) {
+            if (attempt > 0) {
+                if (!Backoff(delay, shared->cancelled)) {
+                    break;
+                }
+                delay *= 2;
+            }
+            result.records.clear();
+            if (fetch(after, result.records, shared->cancelled)) {
+                result.ok = true;
+                break;
+            }
+        }
+        shared->prefetched.store(result.records.size());
+        return result;
+    }
+
+    void StartFetch() {
+        if (options_.prefetch) {
+            next_ = std::async(std::launch::async, &HistoryPager::Load, fetch_, after_, options_, shared_);
+        }
+    }
+
+    // Swap in the next page; false when there is none
+    bool Advance() {
+        if (exhausted_) {
+            return false;
+        }
+
+        PageResult result;
+        if (!started_) {
+            started_ = true;
+            result = Load(fetch_, after_, options_, shared_);
+        } else if (next_.valid()) {
+            result = next_.get();
+        } else {
+            result = Load(fetch_, after_, options_, shared_);
+        }
+
+        page_ = std::move(result.records);
+        position_ = 0;
+        if (!result.ok) {
+            failed_ = true;
+            exhausted_ = true;
+            page_.clear();
+            return false;
+        }
+        pages_++;
+        if (page_.empty()) {
+            exhausted_ = true;
+            return false;
+        }
+
+        after_ = cursor_of_(page_.back());
+        if (page_.size() < options_.page_size || after_.empty()) {
+            exhausted_ = true;
+        } else {
+            StartFetch();
+        }
+        return true;
+    }
+
+    FetchPage fetch_;
+    CursorOf cursor_of_;
+    Options options_;
+    std::string after_;         // Cursor of the next page to fetch
+    std::string resume_;
+
+    std::vector<T> page_;
+    size_t position_;
+    std::future<PageResult> next_;
+
+    bool started_;
+    bool exhausted_;
+    bool failed_;
+    size_t pages_;
+    size_t records_;
+    std::shared_ptr<Shared> shared_;
+};
+
+#endif // HISTORY_PAGER_H
@@ -0,0 +1,108 @@
+#ifndef HTTP_ASYNC_ENGINE_H
+#define HTTP_ASYNC_ENGINE_H
+
+#include "http_client.h"
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief curl_multi based request engine driven by one I/O thread
+ *
+ * Requests are queued by any thread and picked up by the I/O thread,
+ * which multiplexes all transfers over the multi handle's connection
+ * cache. Completion callbacks run on the I/O thread, so they must be
+ * short; hand heavy work off to another thread.
+ *
+ * Failed transfers are not retried: an order POST that timed out may
+ * still have reached the exchange, and the caller is in a better
+ * position to decide whether to resend.
+ */
+class HttpAsyncEngine {
+public:
+    using Callback = std::function<void(HttpClient::Response&)>;
+
+    struct Request {
+        std::string method;
+        std::string url;
+        std::string body;
+        struct curl_slist* headers = nullptr;  // Owned by the engine once submitted
+        Callback on_complete;
+        
+        // Earliest start time (rate limiting); default starts immediately
+        std::chrono::steady_clock::time_point not_before;
+    };
+
+    /**
+     * @param options Timeouts, TLS and proxy settings applied to every transfer
+     * @param share Optional CURLSH (DNS / TLS session cache) to attach
+     */
+    HttpAsyncEngine(const HttpClient::RequestOptions& options, CURLSH* share);
+    ~HttpAsyncEngine();
+
+    HttpAsyncEngine(const HttpAsyncEngine&) = delete;
+    HttpAsyncEngine& operator=(const HttpAsyncEngine&) = delete;
+
+    /**
+     * @brief Start the I/O thread
+     */
+    bool Start();
+
+    /**
+     * @brief Stop the I/O thread; unfinished requests complete with status 0
+     */
+    void Stop();
+
+    /**
+     * @brief Queue a request
+     * @return Completion token (non-zero), 0 if the engine is not running
+     */
+    uint64_t Submit(Request request);
+
+    /**
+     * @brief Number of requests queued or in flight
+     */
+    size_t InFlight() const { return in_flight_.load(std::memory_order_relaxed); }
+
+private:
+    struct Transfer {
+        uint64_t token;
+        Request request;
+        HttpClient::Response response;
+        std::chrono::steady_clock::time_point start_time;
+    };
+
+    void Run();
+    void StartTransfers(std::vector<std::unique_ptr<Transfer>>& batch);
+    int PollTimeoutMs() const;
+    void FinishTransfer(CURL* handle, CURLcode result);
+    void Complete(Transfer& transfer);
+    CURL* TakeHandle();
+
+private:
+    HttpClient::RequestOptions options_;
+    CURLSH* share_;
+    CURLM* multi_;
+
+    std::thread io_thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> next_token_;
+    std::atomic<size_t> in_flight_;
+
+    // Submission queue (any thread -> I/O thread)
+    std::mutex queue_mutex_;
+    std::vector<std::unique_ptr<Transfer>> queue_;
+
+    // Owned by the I/O thread
+    std::vector<std::unique_ptr<Transfer>> deferred_;  // Waiting for not_before
+    std::vector<CURL*> idle_handles_;
+    std::vector<CURL*> all_handles_;
+};
+
+#endif // HTTP_ASYNC_ENGINE_H
@@ -8,24 +8,53 @@
 #include <memory>
 #include <chrono>    // ← 添加这个
 #include <mutex>     // ← 添加这个
+#include <condition_variable>
+#include <future>
+#include <vector>
+#include "rate_limiter.h"
+#include "latency_histogram.h"
+
+class HttpAsyncEngine;
 
 /**
  * @brief High-performance HTTP client with connection pooling
  * 
  * Features:
- * - Connection reuse (keep-alive)
+ * - Pool of CURL easy handles, each keeping its own connection
+ * - Connection reuse (keep-alive), shared DNS/TLS session cache
  * - Automatic retry with exponential backoff
  * - Timeout management
  * - Custom headers support
- * - Thread-safe
+ * - Thread-safe: requests check a handle out of the pool and run in
+ *   parallel; no lock is held across the network round trip
  */
 class HttpClient {
 public:
+    /**
+     * @brief libcurl phase timings of the last attempt, in nanoseconds
+     *        (libcurl measures in microseconds)
+     */
+    struct Timings {
+        int64_t dns_ns = 0;          // Name lookup
+        int64_t connect_ns = 0;      // TCP connect after the lookup
+        int64_t tls_ns = 0;          // TLS handshake after the connect
+        int64_t ttfb_ns = 0;         // Start of transfer to first response byte
+        int64_t total_ns = 0;        // Whole transfer
+        bool new_connection = false; // false: reused, dns/connect/tls are 0
+        
+        /**
+         * @brief Add the phases to an endpoint's kDns..kTotal histograms
+         */
+        void RecordTo(LatencyRegistry::Endpoint& endpoint) const;
+    };
+    
     struct Response {
         int status_code;
         std::string body;
         std::map<std::string, std::string> headers;
         long response_time_ms;  // Response time in milliseconds
+        int64_t response_time_ns = 0;  // Same, including retries and pool waits
+        Timings timings;        // Zero if the transfer failed
         
         bool IsSuccess() const { return status_code >= 200 && status_code < 300; }
     };
@@ -38,7 +67,12 @@ public:
         bool follow_redirects;
         std::map<std::string, std::string> headers;
         
-        // Rate limiting
+        // Connection pool
+        int pool_size;                       // Number of CURL handles
+        int checkout_timeout_ms;             // Max wait for a free handle
+        
+        // Client-wide rate limit (token bucket, burst of one second);
+        // 0 disables it, e.g. when the caller limits per endpoint itself
         int max_requests_per_second;
         
         // Proxy settings (optional)
@@ -51,6 +85,8 @@ public:
             , max_retries(3)
             , verify_ssl(true)
             , follow_redirects(true)
+            , pool_size(4)
+            , checkout_timeout_ms(5000)
             , max_requests_per_second(10)
         {}
     };
@@ -103,6 +139,59 @@ public:
                  const std::string& body,
                  const std::map<std::string, std::string>& headers = {});
     
+    /**
+     * @brief Pre-built request for the allocation-free path
+     * 
+     * Everything is borrowed from the caller; headers must be complete
+     * (default headers are not added).
+     */
+    struct RawRequest {
+        const char* method = "POST";     // GET, POST, DELETE or PUT
+        const char* url = nullptr;       // NUL-terminated
+        const char* body = nullptr;
+        size_t body_length = 0;
+        const struct curl_slist* headers = nullptr;
+        Timings* timings = nullptr;      // Filled on completion if set
+    };
+    
+    /**
+     * @brief Perform a pre-built request without building anything per call
+     * 
+     * No header list, map or Response is created. The body is written
+     * into response_body, whose capacity is kept across calls.
+     * Response headers are not collected.
+     * 
+     * @return HTTP status code, 0 on transport failure (response_body holds the error)
+     */
+    int PerformRaw(const RawRequest& request, std::string& response_body);
+    
+    /**
+     * @brief Callback invoked on the I/O thread when an async request completes
+     */
+    using CompletionCallback = std::function<void(const Response&)>;
+    
+    /**
+     * @brief Submit a request without blocking the calling thread
+     * 
+     * The request runs on a curl_multi engine with a dedicated I/O thread
+     * (started on first use). The callback, if any, runs on that thread
+     * before the future becomes ready. Async requests are not retried.
+     * 
+     * @param method GET, POST, DELETE or PUT
+     * @param url The URL to request
+     * @param body Request body (ignored for GET/DELETE)
+     * @param headers Custom headers (optional)
+     * @param callback Completion callback (optional)
+     * @param not_before Earliest send time, e.g. a RateLimiter reservation
+     * @return Future holding the response
+     */
+    std::future<Response> SubmitAsync(const std::string& method,
+                                      const std::string& url,
+                                      const std::string& body = "",
+                                      const std::map<std::string, std::string>& headers = {},
+                                      CompletionCallback callback = nullptr,
+                                      std::chrono::steady_clock::time_point not_before = {});
+    
     /**
      * @brief Set default headers for all requests
      */
@@ -120,10 +209,32 @@ public:
         double avg_response_time_ms = 0.0;
     };
     
-    Statistics GetStatistics() const { return stats_; }
+    Statistics GetStatistics() const;
     void ResetStatistics();
     
+    /**
+     * @brief Distribution of response times (all requests, ns)
+     */
+    LatencyHistogram::Snapshot GetResponseTimeHistogram() const;
+    
+    /**
+     * @brief Get connection pool statistics
+     */
+    struct PoolStatistics {
+        uint64_t pool_size = 0;          // Handles owned by the pool
+        uint64_t in_use = 0;             // Handles currently checked out
+        uint64_t peak_in_use = 0;        // High-water mark of in_use
+        uint64_t checkouts = 0;          // Successful checkouts
+        uint64_t checkout_waits = 0;     // Checkouts that had to wait
+        uint64_t checkout_timeouts = 0;  // Checkouts that gave up
+        double total_wait_ms = 0.0;      // Time spent waiting for a handle
+    };
+    
+    PoolStatistics GetPoolStatistics() const;
+    
 private:
+    friend class HttpAsyncEngine;
+    
     Response PerformRequest(const std::string& method,
                            const std::string& url,
                            const std::string& body,
@@ -136,16 +247,87 @@ private:
     // Apply rate limiting
     void RateLimit();
     
+    // Reserve the next send slot without sleeping
+    std::chrono::steady_clock::time_point ReserveSlot();
+    
+    // Default + custom headers as a curl list (caller frees)
+    struct curl_slist* BuildHeaderList(const std::map<std::string, std::string>& headers) const;
+    
+    // Record a finished request in stats_
+    void RecordRequest(bool success, size_t bytes_sent, size_t bytes_received,
+                       int64_t response_time_ns);
+    
+    // Phase timings of the transfer just completed on a handle
+    static void ReadTimings(CURL* curl, Timings& timings);
+    
+    // Set URL, method and body on a handle
+    static void SetMethod(CURL* curl, const char* method,
+                          const char* body, size_t body_length);
+    
+    // Collect the body and headers of the next transfer into response
+    static void BindResponse(CURL* curl, Response& response);
+    
+    // Async engine, created on first SubmitAsync()
+    HttpAsyncEngine* GetAsyncEngine();
+    
+    // New handle with the options every transfer shares (timeouts, TLS,
+    // keep-alive, proxy); used by the pool and the async engine
+    static CURL* CreateHandle(const RequestOptions& options, CURLSH* share);
+    
+    // Connection pool
+    CURL* AcquireHandle();
+    void ReleaseHandle(CURL* handle);
+    void DestroyPool();
+    
+    // Lock callbacks for the CURLSH shared between pooled handles
+    static void ShareLock(CURL* handle, curl_lock_data data,
+                          curl_lock_access access, void* userptr);
+    static void ShareUnlock(CURL* handle, curl_lock_data data, void* userptr);
+    
+    /**
+     * @brief RAII checkout of a pooled handle
+     */
+    class HandleLease {
+    public:
+        explicit HandleLease(HttpClient& owner)
+            : owner_(owner), handle_(owner.AcquireHandle()) {}
+        ~HandleLease() { if (handle_) owner_.ReleaseHandle(handle_); }
+        
+        HandleLease(const HandleLease&) = delete;
+        HandleLease& operator=(const HandleLease&) = delete;
+        
+        CURL* get() const { return handle_; }
+        
+    private:
+        HttpClient& owner_;
+        CURL* handle_;
+    };
+    
 private:
-    CURL* curl_;
     RequestOptions options_;
     std::map<std::string, std::string> default_headers_;
+    
+    // Connection pool
+    std::vector<CURL*> handles_;        // All handles owned by the pool
+    std::vector<CURL*> idle_handles_;   // Handles available for checkout
+    CURLSH* share_;
+    std::mutex share_mutexes_[CURL_LOCK_DATA_LAST];
+    mutable std::mutex pool_mutex_;
+    std::condition_variable pool_cv_;
+    PoolStatistics pool_stats_;
+    
+    // Async engine
+    std::unique_ptr<HttpAsyncEngine> async_engine_;
+    
+    // Statistics
+    mutable std::mutex stats_mutex_;
     Statistics stats_;
+    LatencyHistogram response_times_;
     
     // Rate limiting
-    std::chrono::steady_clock::time_point last_request_time_;
+    RateLimiter rate_limiter_;
     
-    // Thread safety
+    // Protects options_ and default_headers_
     mutable std::mutex mutex_;
 };
 
@@ -0,0 +1,120 @@
+#ifndef INSTRUMENT_REGISTRY_H
+#define INSTRUMENT_REGISTRY_H
+
+#include "fixed_point.h"
+#include "symbol_table.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Config;
+
+/**
+ * @brief Instruments traded by this process, by dense integer id
+ *
+ * Built once at start-up (from Config, then OKXRestAPI::LoadInstruments
+ * fills tick/lot/contract sizes in one /public/instruments request per
+ * instType) and read-only afterwards, so lookups take no lock. Strings
+ * are resolved to an id once at the edges (config, subscriptions, the
+ * SymbolTable id of a TickPOD); hot paths then index by id.
+ *
+ * Each instrument maps OKX inst_id <-> MT5 symbol <-> id.
+ */
+class InstrumentRegistry {
+public:
+    using Id = uint32_t;
+    static constexpr Id kInvalidId = UINT32_MAX;
+
+    enum class InstType : uint8_t { kSpot, kSwap, kFutures, kOption };
+
+    struct Instrument {
+        Id id = kInvalidId;
+        InstType inst_type = InstType::kSpot;
+        std::string base;                 // Config key, e.g. "XAUT"
+        std::string inst_id;              // OKX, e.g. "XAUT-USDT-SWAP"
+        std::string mt5_symbol;           // e.g. "XAUUSD" (empty if none)
+        SymbolTable::Id symbol_id = SymbolTable::kInvalidId;   // Of inst_id
+
+        // From /api/v5/public/instruments (0 until loaded)
+        double contract_val = 0;
+        double tick_size = 0;
+        double lot_size = 0;
+        double min_size = 0;
+        InstrumentScale scale;
+        bool loaded = false;
+    };
+
+public:
+    InstrumentRegistry() = default;
+
+    InstrumentRegistry(const InstrumentRegistry&) = delete;
+    InstrumentRegistry& operator=(const InstrumentRegistry&) = delete;
+
+    // ==================== Building ====================
+
+    /**
+     * @brief Register an instrument; returns the existing id if inst_id is known
+     */
+    Id Add(const std::string& base, const std::string& inst_id, const std::string& mt5_symbol = "");
+
+    /**
+     * @brief Register every okx.symbols entry (with its mt5.symbols match)
+     * @return Number of instruments registered
+     */
+    size_t LoadFromConfig(const Config& config);
+
+    /**
+     * @brief Record instrument specs and derive the fixed-point scale
+     * @return false if id is unknown or tick/lot size is not a valid grid
+     */
+    bool SetSpecs(Id id, double contract_val, double tick_size, double lot_size, double min_size);
+
+    // ==================== Lookups ====================
+
+    Id FindByInstId(std::string_view inst_id) const;
+    Id FindByMT5Symbol(std::string_view symbol) const;
+    Id FindByBase(std::string_view base) const;
+
+    /**
+     * @brief Id of a SymbolTable::Global() id (inst_id or MT5 symbol); array lookup
+     */
+    Id FindBySymbolId(SymbolTable::Id symbol_id) const {
+        return symbol_id < by_symbol_id_.size() ? by_symbol_id_[symbol_id] : kInvalidId;
+    }
+
+    /**
+     * @brief Instrument by id (id must be < Size())
+     */
+    const Instrument& Get(Id id) const { return instruments_[id]; }
+
+    size_t Size() const { return instruments_.size(); }
+
+    /**
+     * @brief Distinct instTypes present (one batch request each)
+     */
+    std::vector<InstType> InstTypes() const;
+
+    // ==================== instType ====================
+
+    /**
+     * @brief instType implied by an OKX inst_id
+     *
+     * BTC-USDT-SWAP is SWAP, BTC-USD-240628 (6-digit expiry) FUTURES,
+     * BTC-USD-240628-50000-C / -P OPTION, anything else SPOT.
+     */
+    static InstType InstTypeFromInstId(std::string_view inst_id);
+    static const char* InstTypeName(InstType inst_type);
+
+private:
+    // deque: instruments never move, so the maps can key on views of them
+    std::deque<Instrument> instruments_;
+    std::unordered_map<std::string_view, Id> by_inst_id_;
+    std::unordered_map<std::string_view, Id> by_mt5_symbol_;
+    std::unordered_map<std::string_view, Id> by_base_;
+    std::vector<Id> by_symbol_id_;
+};
+
+#endif // INSTRUMENT_REGISTRY_H
@@ -0,0 +1,176 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "nlohmann/json.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Lock-free latency histogram in nanoseconds (HdrHistogram layout)
+ *
+ * Values below 2^kSubBucketBits ns get a bucket each; above that every
+ * power of two is split into 2^(kSubBucketBits - 1) linear sub-buckets, so
+ * any recorded value is known to within 1/64 (1.6%) from 1 ns up to
+ * 2^kMaxBits ns (~69 s, larger values land in the last bucket). Record()
+ * is a handful of relaxed atomic adds and never allocates, so it can sit
+ * on the order path and the WebSocket I/O thread. Percentiles come from
+ * a Snapshot, which copies the counters.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr int kMaxBits = 36;
+    static constexpr size_t kSubBucketHalf = size_t(1) << (kSubBucketBits - 1);
+    static constexpr size_t kBucketCount = (kMaxBits - kSubBucketBits + 2) * kSubBucketHalf;
+
+    /**
+     * @brief Point-in-time copy of a histogram
+     */
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t min_ns = 0;
+        uint64_t max_ns = 0;
+        uint64_t sum_ns = 0;
+        std::vector<uint64_t> counts;    // kBucketCount entries, or empty if count == 0
+
+        double Mean() const { return count ? static_cast<double>(sum_ns) / count : 0.0; }
+
+        /**
+         * @brief Highest value of the bucket holding the p-th percentile
+         *        (0 < p <= 100), clamped to [min_ns, max_ns]
+         */
+        uint64_t ValueAtPercentile(double percentile) const;
+
+        void Merge(const Snapshot& other);
+
+        /**
+         * @brief {"count","min_ns","max_ns","mean_ns","p50_ns","p90_ns","p99_ns",
+         *         "p999_ns","p9999_ns","buckets":[[upper_ns,count],..]} (non-empty buckets)
+         */
+        nlohmann::json ToJson() const;
+    };
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one value; negative values count as 0
+     */
+    void Record(int64_t ns);
+
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+
+    Snapshot GetSnapshot() const;
+    void Reset();
+
+    static size_t BucketIndex(uint64_t ns);
+    static uint64_t BucketLowerBound(size_t index);
+    static uint64_t BucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint64_t> counts_[kBucketCount];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+/**
+ * @brief Where the time of one request / message went
+ *
+ * kDns .. kTotal come from libcurl's transfer timings (kDns, kConnect and
+ * kTls only when a new connection was opened; kTtfb and kTotal are
+ * measured from the start of the transfer). kParse is decoding the
+ * response or message, kDispatch handing the result to callbacks /
+ * rings, and kNetwork the one-way exchange-to-receipt latency of
+ * WebSocket market data.
+ */
+enum class LatencyStage : uint8_t {
+    kDns, kConnect, kTls, kTtfb, kTotal, kParse, kDispatch, kNetwork, kCount
+};
+
+const char* LatencyStageName(LatencyStage stage);
+
+/**
+ * @brief One LatencyHistogram per stage per endpoint
+ *
+ * Endpoints are keyed like the rate limiter ("POST /api/v5/trade/order")
+ * or by WebSocket channel. Get() returns a reference that stays valid
+ * for the registry's lifetime, so hot paths resolve their Endpoint once.
+ */
+class LatencyRegistry {
+public:
+    static constexpr size_t kStageCount = static_cast<size_t>(LatencyStage::kCount);
+
+    struct Endpoint {
+        LatencyHistogram stages[kStageCount];
+
+        void Record(LatencyStage stage, int64_t ns) {
+            stages[static_cast<size_t>(stage)].Record(ns);
+        }
+        const LatencyHistogram& Stage(LatencyStage stage) const {
+            return stages[static_cast<size_t>(stage)];
+        }
+    };
+
+    struct EndpointSnapshot {
+        LatencyHistogram::Snapshot stages[kStageCount];
+
+        const LatencyHistogram::Snapshot& Stage(LatencyStage stage) const {
+            return stages[static_cast<size_t>(stage)];
+        }
+    };
+
+    using Snapshot = std::map<std::string, EndpointSnapshot>;
+
+    /**
+     * @brief Records the time from construction to destruction; no-op
+     *        for a null endpoint
+     */
+    class Timer {
+    public:
+        Timer(Endpoint* endpoint, LatencyStage stage)
+            : endpoint_(endpoint), stage_(stage), start_ns_(endpoint ? NowNs() : 0) {}
+        ~Timer() {
+            if (endpoint_) {
+                endpoint_->Record(stage_, NowNs() - start_ns_);
+            }
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+    private:
+        Endpoint* endpoint_;
+        LatencyStage stage_;
+        int64_t start_ns_;
+    };
+
+    Endpoint& Get(const std::string& name);
+
+    Snapshot GetSnapshot() const;
+    void Reset();
+
+    /**
+     * @brief {endpoint: {stage: histogram json}}, stages with no samples left out
+     */
+    static nlohmann::json ToJson(const Snapshot& snapshot);
+
+    // steady_clock, ns
+    static int64_t NowNs();
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<Endpoint>> endpoints_;
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // LATENCY_HISTOGRAM_H
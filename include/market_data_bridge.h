@@ -0,0 +1,134 @@
+#ifndef MARKET_DATA_BRIDGE_H
+#define MARKET_DATA_BRIDGE_H
+
+#include "data_types.h"
+#include "okx_bridge_c.h"
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Shared-memory table of the latest quote and book per symbol
+ *
+ * Replaces handing JSON strings to MT5 through the DLL: the writer
+ * (OKXWebSocket / OKXRestAPI) stores packed POD quotes and books into a
+ * named shared-memory segment, and any local process reads them through
+ * the C API in okx_bridge_c.h with a plain memory copy.
+ *
+ * Layout: a header followed by slot_count fixed-size slots, one per
+ * symbol, each on its own cache lines. Every slot is a seqlock: the
+ * writer makes the sequence odd, writes, and makes it even again;
+ * readers retry if the sequence was odd or changed during the copy.
+ * The odd/even step is a CAS, so several writer threads (REST and
+ * WebSocket) may publish the same symbol. Symbols are only ever
+ * appended, so a slot index stays valid for the life of the segment.
+ *
+ * POSIX shm_open/mmap on Linux, named file mappings on Windows.
+ */
+class MarketDataBridge {
+public:
+    static constexpr uint32_t kMagic = 0x42584B4F;   // "OKXB"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr uint32_t kDefaultSlots = 64;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t slot_size;
+        std::atomic<uint32_t> symbol_count;
+        char reserved[44];
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> quote_sequence;   // Odd while the quote is written
+        std::atomic<uint32_t> book_sequence;    // Odd while the book is written
+        char symbol[OKX_BRIDGE_SYMBOL_SIZE];
+        OKXBridgeQuote quote;
+        OKXBridgeBook book;
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+                  "Seqlock counters must be lock-free to live in shared memory");
+
+public:
+    MarketDataBridge();
+    ~MarketDataBridge();
+
+    MarketDataBridge(const MarketDataBridge&) = delete;
+    MarketDataBridge& operator=(const MarketDataBridge&) = delete;
+
+    /**
+     * @brief Create (or reset) the segment for writing
+     * @param name Segment name, e.g. "okx_market_data"
+     */
+    bool Create(const std::string& name, uint32_t slot_count = kDefaultSlots);
+
+    /**
+     * @brief Map an existing segment read-only
+     */
+    bool Open(const std::string& name);
+
+    void Close();
+
+    /**
+     * @brief Remove the segment name (POSIX); mappings stay valid
+     */
+    static void Unlink(const std::string& name);
+
+    bool IsOpen() const { return header_ != nullptr; }
+
+    // ==================== Writer ====================
+
+    /**
+     * @brief Slot of a symbol, added if new; -1 if read-only or full
+     */
+    int AddSymbol(std::string_view symbol);
+
+    bool PublishQuote(int slot, const OKXBridgeQuote& quote);
+    bool PublishBook(int slot, const OKXBridgeBook& book);
+
+    /**
+     * @brief Publish by inst_id (slot added on first use)
+     */
+    bool PublishTick(const Tick& tick);
+    bool PublishDepth(const Depth& depth);
+
+    // ==================== Reader ====================
+
+    int FindSymbol(std::string_view symbol) const;
+    int SymbolCount() const;
+
+    /**
+     * @brief Consistent copy of a slot; false if never published
+     */
+    bool ReadQuote(int slot, OKXBridgeQuote& quote) const;
+    bool ReadBook(int slot, OKXBridgeBook& book) const;
+
+    static int64_t NowNs();
+
+private:
+    static std::string SegmentName(const std::string& name);
+    static size_t SegmentSize(uint32_t slot_count);
+    bool Map(const std::string& name, size_t size, bool create);
+    Slot* GetSlot(int slot) const;
+
+private:
+    void* memory_;
+    size_t size_;
+    bool writable_;
+    Header* header_;
+    Slot* slots_;
+#if defined(_WIN32)
+    void* mapping_;
+#endif
+
+    // Writer-side symbol -> slot index
+    std::unordered_map<std::string, int> slot_index_;
+    mutable std::shared_mutex index_mutex_;
+};
+
+#endif // MARKET_DATA_BRIDGE_H
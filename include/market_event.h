@@ -0,0 +1,86 @@
+#ifndef MARKET_EVENT_H
+#define MARKET_EVENT_H
+
+#include "data_types.h"
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Fixed-size, trivially copyable record of one decoded event
+ *
+ * What the WebSocket I/O thread publishes into an event ring instead of
+ * running callbacks: strings are truncated into fixed char arrays (always
+ * NUL-terminated) and depth is cut to the top kDepthLevels, so a record
+ * is moved with a plain copy and never allocates. The full Tick / Depth /
+ * Order can be rebuilt on the consumer side with the To* helpers.
+ */
+struct MarketEvent {
+    static constexpr size_t kInstIdSize = 32;
+    static constexpr size_t kDepthLevels = 5;
+
+    enum class Type : uint8_t { kNone, kTick, kDepth, kOrder };
+
+    struct TickData {
+        double bid;
+        double ask;
+        double last;
+        double bid_size;
+        double ask_size;
+    };
+
+    struct DepthData {
+        uint8_t bid_count;
+        uint8_t ask_count;
+        double bid_price[kDepthLevels];
+        double bid_size[kDepthLevels];
+        double ask_price[kDepthLevels];
+        double ask_size[kDepthLevels];
+    };
+
+    struct OrderData {
+        char order_id[24];
+        char client_order_id[32];
+        char state[20];
+        char side[8];
+        double price;
+        double size;
+        double filled_size;
+        double avg_price;
+        double fee;
+    };
+
+    Type type;
+    char inst_id[kInstIdSize];
+    Timestamp exchange_time;     // Exchange timestamp (ms)
+    int64_t receive_time_ns;     // steady_clock time the frame was read
+    int64_t latency_us;          // One-way exchange -> local latency (0: not measured)
+
+    union {
+        TickData tick;
+        DepthData depth;
+        OrderData order;
+    };
+
+    // ==================== Conversions ====================
+
+    static void FromTick(const Tick& tick, int64_t receive_time_ns, MarketEvent& event);
+    static void FromDepth(const Depth& depth, int64_t receive_time_ns, MarketEvent& event);
+    static void FromOrder(const Order& order, int64_t receive_time_ns, MarketEvent& event);
+
+    void ToTick(Tick& tick) const;
+    void ToDepth(Depth& depth) const;
+    void ToOrder(Order& order) const;
+
+    std::string_view InstId() const { return std::string_view(inst_id); }
+
+    /**
+     * @brief Copy text truncated to size - 1 bytes, always NUL-terminated
+     */
+    static void CopyText(char* out, size_t size, std::string_view text);
+};
+
+static_assert(std::is_trivially_copyable<MarketEvent>::value,
+              "MarketEvent must stay trivially copyable");
+
+#endif // MARKET_EVENT_H
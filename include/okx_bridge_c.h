@@ -0,0 +1,80 @@
+#ifndef OKX_BRIDGE_C_H
+#define OKX_BRIDGE_C_H
+
+/*
+ * Plain C reader API for the shared-memory market data bridge
+ * (see market_data_bridge.h for the writer side and the layout).
+ *
+ * A reader opens the segment once, resolves each symbol to a slot once,
+ * and then copies the latest quote / book straight out of shared memory
+ * under a seqlock: no JSON, no strings, no locks shared with the writer.
+ *
+ * Return codes: 1 = data copied, 0 = nothing published yet, -1 = error.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define OKX_BRIDGE_CALL __stdcall
+#if defined(OKX_BRIDGE_BUILD_DLL)
+#define OKX_BRIDGE_API __declspec(dllexport)
+#else
+#define OKX_BRIDGE_API
+#endif
+#else
+#define OKX_BRIDGE_CALL
+#define OKX_BRIDGE_API
+#endif
+
+#define OKX_BRIDGE_SYMBOL_SIZE 32
+#define OKX_BRIDGE_BOOK_LEVELS 10
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct OKXBridgeQuote {
+    double bid;
+    double ask;
+    double last;
+    double bid_size;
+    double ask_size;
+    uint64_t exchange_time;     /* Exchange timestamp (ms) */
+    int64_t update_time_ns;     /* Writer clock, see OKX_BridgeNowNs() */
+    uint64_t update_count;      /* Quotes published to this slot so far */
+} OKXBridgeQuote;
+
+typedef struct OKXBridgeBook {
+    uint32_t bid_count;
+    uint32_t ask_count;
+    double bid_price[OKX_BRIDGE_BOOK_LEVELS];
+    double bid_size[OKX_BRIDGE_BOOK_LEVELS];
+    double ask_price[OKX_BRIDGE_BOOK_LEVELS];
+    double ask_size[OKX_BRIDGE_BOOK_LEVELS];
+    uint64_t exchange_time;
+    int64_t update_time_ns;
+    uint64_t update_count;
+} OKXBridgeBook;
+
+/* Map an existing segment read-only; returns a handle >= 0 or -1 */
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeOpen(const char* name);
+
+/* Unmap and free the handle. Must not run concurrently with any other
+ * call on the same handle: the reads take no lock. */
+OKX_BRIDGE_API void OKX_BRIDGE_CALL OKX_BridgeClose(int handle);
+
+/* Slot index of a symbol (OKX inst_id), -1 if the writer has not added it */
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeFindSymbol(int handle, const char* symbol);
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeSymbolCount(int handle);
+
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeReadQuote(int handle, int slot, OKXBridgeQuote* out);
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeReadBook(int handle, int slot, OKXBridgeBook* out);
+
+/* Monotonic clock the writer stamps update_time_ns with (quote age) */
+OKX_BRIDGE_API int64_t OKX_BRIDGE_CALL OKX_BridgeNowNs(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OKX_BRIDGE_C_H */
@@ -0,0 +1,106 @@
+#ifndef OKX_FAST_PARSER_H
+#define OKX_FAST_PARSER_H
+
+#include "data_types.h"
+#include "fixed_point.h"
+#include <string>
+#include <string_view>
+
+/**
+ * @brief DOM-free parser for OKX v5 REST responses
+ *
+ * OKX responses share one envelope: {"code":"0","msg":"","data":[...]}
+ * with every number sent as a string. Instead of building a json DOM
+ * this scans the response buffer once and hands out string_views into
+ * it, and the typed parsers fill Tick / Depth / Order / Position
+ * directly. Nothing is allocated except the std::string fields of the
+ * output structs and the depth vectors (whose capacity is reused when
+ * the caller passes the same Depth again).
+ *
+ * Parsers return false on malformed input; callers fall back to the
+ * json DOM path in that case.
+ */
+class OKXFastParser {
+public:
+    /**
+     * @brief Top-level fields of an OKX response
+     */
+    struct Envelope {
+        std::string_view code;
+        std::string_view msg;
+        std::string_view data;   // Raw JSON text of the "data" array
+    };
+
+    /**
+     * @brief Iterates the elements of a JSON array
+     */
+    class ArrayReader {
+    public:
+        explicit ArrayReader(std::string_view array);
+
+        /**
+         * @brief Next element; strings are returned without quotes,
+         *        objects/arrays/literals as raw text
+         */
+        bool Next(std::string_view& element);
+
+        /**
+         * @brief false if malformed input was met
+         */
+        bool Ok() const { return ok_; }
+
+    private:
+        const char* p_;
+        const char* end_;
+        bool ok_;
+        bool first_;
+    };
+
+    /**
+     * @brief Iterates the members of a JSON object
+     */
+    class ObjectReader {
+    public:
+        explicit ObjectReader(std::string_view object);
+
+        /**
+         * @brief Next member; value as in ArrayReader::Next
+         */
+        bool Next(std::string_view& key, std::string_view& value);
+
+        bool Ok() const { return ok_; }
+
+    private:
+        const char* p_;
+        const char* end_;
+        bool ok_;
+        bool first_;
+    };
+
+public:
+    static bool ParseEnvelope(std::string_view body, Envelope& envelope);
+
+    /**
+     * @brief First element of "data" (false if missing or empty)
+     */
+    static bool FirstDataElement(std::string_view body, std::string_view& element);
+
+    /**
+     * @brief Typed parsers; with a scale, prices and sizes are also read
+     *        exactly into ticks/lots (Tick bid/ask, book levels, order px/sz)
+     */
+    static bool ParseTicker(std::string_view object, Tick& tick,
+                            const InstrumentScale* scale = nullptr);
+    static bool ParseOrderBook(std::string_view object, Depth& depth,
+                               const InstrumentScale* scale = nullptr);
+    static bool ParseOrder(std::string_view object, Order& order,
+                           const InstrumentScale* scale = nullptr);
+    static bool ParsePosition(std::string_view object, Position& position);
+
+    /**
+     * @brief Assign a raw (still escaped) JSON string value
+     */
+    static void AssignString(std::string& out, std::string_view raw);
+};
+
+#endif // OKX_FAST_PARSER_H
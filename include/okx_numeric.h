@@ -0,0 +1,39 @@
+#ifndef OKX_NUMERIC_H
+#define OKX_NUMERIC_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief Locale-free, non-throwing number conversion for OKX fields
+ *
+ * OKX sends every number as a JSON string ("2350.5", "", "1700000000123").
+ * These helpers read such a field straight from a string_view into the
+ * response buffer using std::from_chars, so no std::string temporary is
+ * needed and the process locale (decimal comma etc.) has no effect.
+ *
+ * Empty or malformed text yields false / the default value; nothing
+ * here throws.
+ */
+class OKXNumeric {
+public:
+    /**
+     * @brief Parse the whole of `text`; false if empty or malformed
+     */
+    static bool TryParse(std::string_view text, double& value);
+    static bool TryParse(std::string_view text, uint64_t& value);
+    static bool TryParse(std::string_view text, int64_t& value);
+
+    /**
+     * @brief Integer parse that also accepts and truncates a fractional
+     *        part ("10.0" -> 10), as OKX does for some leverage fields
+     */
+    static bool TryParse(std::string_view text, int& value);
+
+    static double ToDouble(std::string_view text, double default_value = 0.0);
+    static uint64_t ToUint64(std::string_view text, uint64_t default_value = 0);
+    static int64_t ToInt64(std::string_view text, int64_t default_value = 0);
+    static int ToInt(std::string_view text, int default_value = 0);
+};
+
+#endif // OKX_NUMERIC_H
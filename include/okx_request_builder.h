@@ -0,0 +1,198 @@
+#ifndef OKX_REQUEST_BUILDER_H
+#define OKX_REQUEST_BUILDER_H
+
+#include "data_types.h"
+#include "fixed_point.h"
+#include <curl/curl.h>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * @brief Append-only writer over a fixed char buffer
+ *
+ * Never allocates; once the capacity is exceeded further writes are
+ * dropped and Overflowed() reports it.
+ */
+class FixedWriter {
+public:
+    FixedWriter(char* data, size_t capacity)
+        : data_(data), capacity_(capacity), length_(0), overflow_(false) {}
+
+    void Append(std::string_view text);
+    void Append(char c);
+
+    /**
+     * @brief Append a JSON string literal (quotes and escapes included)
+     */
+    void AppendJsonString(std::string_view text);
+
+    /**
+     * @brief Append a number in the same format as std::to_string(double)
+     */
+    void AppendFixed(double value, int precision = 6);
+
+    /**
+     * @brief Append a grid value exactly ("1", "2350.5")
+     */
+    void AppendScaled(int64_t steps, const FixedScale& scale);
+
+    void Clear() { length_ = 0; overflow_ = false; }
+
+    const char* Data() const { return data_; }
+    size_t Length() const { return length_; }
+    bool Overflowed() const { return overflow_; }
+    std::string_view View() const { return std::string_view(data_, length_); }
+
+    /**
+     * @brief NUL-terminate (needed before handing the buffer to curl)
+     */
+    void Terminate();
+
+private:
+    char* data_;
+    size_t capacity_;
+    size_t length_;
+    bool overflow_;
+};
+
+/**
+ * @brief Reusable buffers for one signed trading request
+ *
+ * Holds the JSON body, the timestamp and signature headers, and two
+ * curl_slist nodes pointing at those headers. The nodes are linked in
+ * front of a shared, pre-built list of static headers, so sending a
+ * request builds no header list at all. Meant to be kept per thread and
+ * reused; after the first request nothing here allocates.
+ */
+struct OKXRequestBuffer {
+    static constexpr size_t kBodyCapacity = 1024;
+    static constexpr size_t kResponseReserve = 4096;
+
+    char body[kBodyCapacity];
+    size_t body_length = 0;
+
+    char timestamp[32];
+    char timestamp_header[64];   // "OK-ACCESS-TIMESTAMP: ..."
+    char sign_header[96];        // "OK-ACCESS-SIGN: ..."
+
+    struct curl_slist timestamp_node;
+    struct curl_slist sign_node;
+
+    std::string response;        // Capacity kept between requests
+
+    OKXRequestBuffer() {
+        body[0] = '\0';
+        timestamp[0] = '\0';
+        timestamp_header[0] = '\0';
+        sign_header[0] = '\0';
+        timestamp_node.data = timestamp_header;
+        timestamp_node.next = &sign_node;
+        sign_node.data = sign_header;
+        sign_node.next = nullptr;
+        response.reserve(kResponseReserve);
+    }
+
+    OKXRequestBuffer(const OKXRequestBuffer&) = delete;
+    OKXRequestBuffer& operator=(const OKXRequestBuffer&) = delete;
+};
+
+/**
+ * @brief Writes OKX trading request bodies straight into fixed buffers
+ *
+ * Field layout matches OKXRestAPI's json-built bodies so the exchange
+ * sees the same request either way.
+ */
+class OKXRequestBuilder {
+public:
+    /**
+     * @brief Body for POST /api/v5/trade/order
+     *
+     * With a scale, px/sz come from price_ticks/size_lots (or price/size
+     * snapped to the grid) and are written exactly; without one they use
+     * the std::to_string format as before.
+     *
+     * @return false if the body did not fit
+     */
+    static bool BuildPlaceOrder(const Order& order, OKXRequestBuffer& buffer,
+                                const InstrumentScale* scale = nullptr);
+
+    /**
+     * @brief Body for POST /api/v5/trade/cancel-order
+     */
+    static bool BuildCancelOrder(std::string_view inst_id,
+                                 std::string_view order_id,
+                                 std::string_view client_order_id,
+                                 OKXRequestBuffer& buffer);
+
+    /**
+     * @brief Body for POST /api/v5/trade/amend-order
+     */
+    static bool BuildAmendOrder(std::string_view inst_id,
+                                std::string_view order_id,
+                                std::string_view new_size,
+                                std::string_view new_price,
+                                OKXRequestBuffer& buffer);
+};
+
+/**
+ * @brief Pre-armed POST /api/v5/trade/order body for one instrument/side/size
+ *
+ * Arm() validates the order once and renders every field except clOrdId
+ * and px, leaving a slot where the price goes. Render() then only copies
+ * the armed text around the client order ID and the formatted price, so
+ * a hedge leg goes from signal to signed body without touching the
+ * Order struct. Bodies are byte-identical to
+ * OKXRequestBuilder::BuildPlaceOrder for the same order.
+ *
+ * Order types that take no price (market, optimal_limit_ioc) are armed
+ * without a px field and ignore the price passed to Render().
+ */
+class OKXOrderTemplate {
+public:
+    static constexpr size_t kCapacity = 512;
+    static constexpr size_t kMaxClientOrderId = 32;
+
+    OKXOrderTemplate() : length_(0), price_at_(0), armed_(false), has_price_(false), has_scale_(false) {}
+
+    /**
+     * @brief Validate and pre-render `order` (client_order_id and price
+     *        are ignored); with a scale, size and px are exact on the grid
+     * @return false (and reports why on stderr) if the order is not sendable
+     */
+    bool Arm(const Order& order, const InstrumentScale* scale = nullptr);
+
+    bool Armed() const { return armed_; }
+    bool HasPrice() const { return has_price_; }
+
+    /**
+     * @brief Write the body with this price and client order ID (may be
+     *        empty; otherwise up to 32 letters and digits, as OKX requires)
+     * @return false if the price or ID is invalid or the template not armed
+     */
+    bool Render(Price price, std::string_view client_order_id, OKXRequestBuffer& buffer) const;
+
+    /**
+     * @brief As Render(), with the price already in ticks (needs a scale)
+     */
+    bool RenderTicks(PriceTicks price, std::string_view client_order_id, OKXRequestBuffer& buffer) const;
+
+    /**
+     * @brief Whether an order type is sent with a px field
+     */
+    static bool NeedsPrice(std::string_view order_type);
+
+private:
+    bool RenderWith(std::string_view price, std::string_view client_order_id, OKXRequestBuffer& buffer) const;
+
+    // Fields after clOrdId up to the closing brace; px goes at price_at_
+    char text_[kCapacity];
+    size_t length_;
+    size_t price_at_;
+    bool armed_;
+    bool has_price_;
+    bool has_scale_;
+    FixedScale price_scale_;
+};
+
+#endif // OKX_REQUEST_BUILDER_H
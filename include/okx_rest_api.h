@@ -3,11 +3,22 @@
 
 #include "http_client.h"
 #include "okx_signer.h"
+#include "rate_limiter.h"
+#include "okx_request_builder.h"
+#include "fixed_point.h"
+#include "instrument_registry.h"
 #include "data_types.h"
+#include "market_data_bridge.h"
+#include "latency_histogram.h"
+#include "history_pager.h"
 #include "nlohmann/json.hpp"
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <mutex>     // ← 添加这个
+#include <shared_mutex>
+#include <unordered_map>
+#include <future>
 
 using json = nlohmann::json;
 
@@ -17,8 +28,12 @@ using json = nlohmann::json;
  * Features:
  * - All public and private endpoints
  * - Complete field mapping (100+ fields)
+ * - DOM-free response parsing for market data, orders and positions
+ * - Allocation-free hot path for PlaceOrder / CancelOrder / AmendOrder,
+ *   plus pre-armed order templates for hedge legs
+ * - Lazy, prefetching iterators over paginated order / fill / bill history
  * - Automatic retry and error handling
- * - Rate limiting (10 requests/second)
+ * - Per-endpoint token-bucket rate limiting (OKX published limits)
  * - Connection pooling
  * 
  * API Documentation: https://www.okx.com/docs-v5/en/
@@ -33,6 +48,9 @@ public:
         bool is_simulation = false;  // true for demo trading
         int timeout_ms = 5000;
         int max_retries = 3;
+        int http_pool_size = 4;      // Parallel connections to OKX
+        int rate_limit_max_wait_ms = 2000;  // Queue up to this long, then reject
+        bool fast_parse = true;      // DOM-free parsing of ticker/books/orders/positions
     };
     
 public:
@@ -61,6 +79,12 @@ public:
      */
     Depth GetOrderBook(const std::string& inst_id, int depth_size = 5);
     
+    /**
+     * @brief Also store GetTicker / GetOrderBook results in a shared-memory
+     *        bridge for out-of-process readers (nullptr to stop)
+     */
+    void SetMarketDataBridge(MarketDataBridge* bridge);
+    
     /**
      * @brief Get funding rate
      * @param inst_id Instrument ID
@@ -105,14 +129,42 @@ public:
         std::string base_ccy;
         std::string quote_ccy;
         std::string settle_ccy;
-        double contract_val;
-        double tick_size;
-        double lot_size;
-        double min_size;
+        double contract_val = 0;
+        double tick_size = 0;
+        double lot_size = 0;
+        double min_size = 0;
         std::string state;  // live, suspend, expired
     };
     InstrumentInfo GetInstrumentInfo(const std::string& inst_id);
     
+    /**
+     * @brief All instruments of one instType ("SPOT", "SWAP", ...) in one request
+     */
+    std::vector<InstrumentInfo> GetInstruments(const std::string& inst_type);
+    
+    /**
+     * @brief Fill a registry's specs with one GetInstruments() call per
+     *        instType it contains, and use its scales from then on
+     *
+     * Call at start-up, before orders are sent; the registry must outlive
+     * this object. Orders with instrument_id set then find their scale by
+     * array index, without hashing inst_id or taking a lock.
+     * @return Number of registry instruments loaded
+     */
+    size_t LoadInstruments(InstrumentRegistry& registry);
+    
+    /**
+     * @brief Fetch tickSz/lotSz and register the instrument's fixed-point scale
+     *
+     * Once registered, orders for the instrument are sent with exact px/sz
+     * text (price_ticks/size_lots, or price/size snapped to the grid), and
+     * ticker/book/order responses also fill the tick/lot fields.
+     */
+    bool LoadInstrumentScale(const std::string& inst_id);
+    void SetInstrumentScale(const std::string& inst_id, const InstrumentScale& scale);
+    bool GetInstrumentScale(const std::string& inst_id, InstrumentScale& scale) const;
+    bool GetInstrumentScale(InstrumentRegistry::Id id, InstrumentScale& scale) const;
+    
     // ==================== Account API (Private) ====================
     
     /**
@@ -159,6 +211,31 @@ public:
      */
     std::string PlaceOrder(const Order& order);
     
+    /**
+     * @brief Pre-build a place-order body for one instrument/side/size
+     *
+     * Uses the instrument's scale when one is registered, so px and sz are
+     * sent exactly on the grid. Re-arm after the scale changes.
+     * @return false if the order is not sendable
+     */
+    bool ArmOrderTemplate(const Order& order, OKXOrderTemplate& order_template) const;
+    
+    /**
+     * @brief Place an order from an armed template; only px and clOrdId
+     *        are written before signing
+     * @param price Ignored for market / optimal_limit_ioc templates
+     * @return Order ID if successful, empty string otherwise
+     */
+    std::string PlaceOrder(const OKXOrderTemplate& order_template, Price price,
+                           std::string_view client_order_id = {});
+    
+    /**
+     * @brief Place order without blocking the calling thread
+     * @param order Order details
+     * @return Future holding the order ID (empty string on failure)
+     */
+    std::future<std::string> PlaceOrderAsync(const Order& order);
+    
     /**
      * @brief Batch place orders (up to 20 orders)
      */
@@ -174,6 +251,14 @@ public:
                      const std::string& order_id = "",
                      const std::string& client_order_id = "");
     
+    /**
+     * @brief Cancel order without blocking the calling thread
+     * @return Future holding true if OKX accepted the cancel
+     */
+    std::future<bool> CancelOrderAsync(const std::string& inst_id,
+                                       const std::string& order_id = "",
+                                       const std::string& client_order_id = "");
+    
     /**
      * @brief Cancel batch orders (up to 20 orders)
      */
@@ -206,20 +291,27 @@ public:
     
     /**
      * @brief Get order history (last 7 days)
+     *
+     * One page, newest first. after / before are ordId cursors: records
+     * older / newer than that order. IterateOrderHistory() walks every page.
      */
     std::vector<Order> GetOrderHistory(const std::string& inst_id = "",
                                        const std::string& state = "",
                                        uint64_t begin_time = 0,
                                        uint64_t end_time = 0,
-                                       int limit = 100);
+                                       int limit = 100,
+                                       const std::string& after = "",
+                                       const std::string& before = "");
     
     /**
-     * @brief Get order archive (last 3 months)
+     * @brief Get order archive (last 3 months); cursors as GetOrderHistory
      */
     std::vector<Order> GetOrderArchive(const std::string& inst_id = "",
                                        uint64_t begin_time = 0,
                                        uint64_t end_time = 0,
-                                       int limit = 100);
+                                       int limit = 100,
+                                       const std::string& after = "",
+                                       const std::string& before = "");
     
     // ==================== Trade History ====================
     
@@ -227,6 +319,7 @@ public:
      * @brief Get fills (trade execution records)
      */
     struct Fill {
+        std::string bill_id;    // Pagination cursor
         std::string inst_id;
         std::string order_id;
         std::string trade_id;
@@ -239,10 +332,13 @@ public:
         uint64_t fill_time;
         std::string exec_type;  // T: taker, M: maker
     };
+    // after / before are billId cursors
     std::vector<Fill> GetFills(const std::string& inst_id = "",
                                uint64_t begin_time = 0,
                                uint64_t end_time = 0,
-                               int limit = 100);
+                               int limit = 100,
+                               const std::string& after = "",
+                               const std::string& before = "");
     
     // ==================== Bills (Account Ledger) ====================
     
@@ -261,11 +357,43 @@ public:
         uint64_t timestamp;
         std::string notes;
     };
+    // after / before are billId cursors
     std::vector<Bill> GetBills(const std::string& inst_id = "",
                                int bill_type = -1,
                                uint64_t begin_time = 0,
                                uint64_t end_time = 0,
-                               int limit = 100);
+                               int limit = 100,
+                               const std::string& after = "",
+                               const std::string& before = "");
+    
+    // ==================== History Iteration ====================
+    
+    /**
+     * @brief Filter and paging for the Iterate* walks
+     */
+    struct HistoryQuery {
+        std::string inst_type;      // SPOT / MARGIN / SWAP / FUTURES / OPTION (required for orders)
+        std::string inst_id;
+        std::string state;          // Orders: filled / canceled
+        int bill_type = -1;         // Bills
+        uint64_t begin_time = 0;
+        uint64_t end_time = 0;
+        std::string after;          // Start below this cursor, e.g. a saved HistoryPager::Cursor()
+        int page_size = 100;        // limit per request, 1..100
+        bool prefetch = true;       // Fetch the next page while the current one is consumed
+    };
+    
+    /**
+     * @brief Lazy newest-to-oldest walk over the whole matching history
+     *
+     * Pages are requested on demand through the endpoint's rate limiter
+     * (retried on failure), at most two held at a time. The returned
+     * pager calls back into this object, so it must not outlive it.
+     */
+    HistoryPager<Order> IterateOrderHistory(const HistoryQuery& query);
+    HistoryPager<Order> IterateOrderArchive(const HistoryQuery& query);
+    HistoryPager<Fill> IterateFills(const HistoryQuery& query);
+    HistoryPager<Bill> IterateBills(const HistoryQuery& query);
     
     // ==================== Utility ====================
     
@@ -274,6 +402,23 @@ public:
      */
     bool TestConnection();
     
+    /**
+     * @brief OKX server time (GET /api/v5/public/time), epoch ms; 0 on failure
+     *
+     * See ClockSync for turning this into a clock offset.
+     */
+    int64_t GetServerTime();
+    
+    /**
+     * @brief Server time with the local clock (ClockSync::LocalNowUs) at the
+     *        request going out and the first response byte coming back
+     *
+     * Both are taken from libcurl's timings of the attempt that succeeded,
+     * so rate-limiter and pool waits, failed attempts and retry backoff
+     * are not part of the round trip.
+     */
+    int64_t GetServerTime(int64_t& send_us, int64_t& receive_us);
+    
     /**
      * @brief Get API statistics
      */
@@ -281,18 +426,100 @@ public:
         uint64_t total_requests;
         uint64_t successful_requests;
         uint64_t failed_requests;
+        uint64_t rate_limited_requests;  // Rejected locally by the rate limiter
         double avg_response_time_ms;
         double success_rate;
     };
     APIStatistics GetStatistics() const;
     
+    /**
+     * @brief Per-endpoint rate limiter counters (key: "METHOD /path")
+     */
+    std::map<std::string, RateLimiter::BucketStatistics> GetRateLimitStatistics() const;
+    
+    /**
+     * @brief Per-endpoint latency histograms (key: "METHOD /path")
+     *
+     * dns/connect/tls/ttfb/total from libcurl, parse for decoding the
+     * response, dispatch for PlaceOrderAsync / CancelOrderAsync
+     * completions. LatencyRegistry::ToJson() turns it into JSON.
+     */
+    LatencyRegistry::Snapshot GetLatencySnapshot() const;
+    void ResetLatency();
+    
 private:
+    // Queues requests and sends them through MakeRequestAsync
+    friend class OrderBatcher;
+    
+    // Fully built HTTP request (URL with query, body, auth headers)
+    struct PreparedRequest {
+        std::string url;
+        std::string body;
+        std::map<std::string, std::string> headers;
+    };
+    
     // Helper functions
     json MakeRequest(const std::string& method,
                     const std::string& endpoint,
                     const json& params = json::object(),
                     bool is_private = false);
     
+    PreparedRequest PrepareRequest(const std::string& method,
+                                   const std::string& endpoint,
+                                   const json& params,
+                                   bool is_private);
+    
+    // Send the request and return the raw body; false on HTTP/transport failure.
+    // latency receives the endpoint's histograms so the caller can time its parse;
+    // once cancelled is set the request is dropped unsent, even mid limiter wait
+    bool MakeRawRequest(const std::string& method,
+                        const std::string& endpoint,
+                        const json& params,
+                        bool is_private,
+                        std::string& body,
+                        LatencyRegistry::Endpoint** latency = nullptr,
+                        HttpClient::Timings* timings = nullptr,
+                        const std::atomic<bool>* cancelled = nullptr);
+    
+    json HandleResponse(const HttpClient::Response& response);
+    bool RecordResponse(const HttpClient::Response& response);
+    json ParseBody(const std::string& body);
+    
+    // Take a token for the endpoint; false if the request must be rejected
+    bool AcquireRateLimit(const std::string& method,
+                          const std::string& endpoint,
+                          const json& params,
+                          RateLimiter::Clock::time_point& not_before);
+    
+    void ConfigureRateLimits();
+    
+    // Submit via HttpClient::SubmitAsync; on_response runs on the I/O thread
+    void MakeRequestAsync(const std::string& method,
+                          const std::string& endpoint,
+                          const json& params,
+                          bool is_private,
+                          std::function<void(const json&)> on_response);
+    
+    // Allocation-free trading path: body, timestamp and signature are
+    // written into a per-thread OKXRequestBuffer and sent with a cached
+    // static header list
+    struct HotEndpoint {
+        const char* path = nullptr;
+        std::string url;
+        RateLimiter::Bucket* bucket = nullptr;
+        LatencyRegistry::Endpoint* latency = nullptr;
+    };
+    
+    void InitializeHotPath();
+    bool SendHotRequest(const HotEndpoint& endpoint, OKXRequestBuffer& buffer);
+    
+    // By order.instrument_id when set, else by inst_id
+    bool OrderScale(const Order& order, InstrumentScale& scale) const;
+    json BuildOrderBody(const Order& order) const;
+    json BuildCancelBody(const std::string& inst_id,
+                         const std::string& order_id,
+                         const std::string& client_order_id) const;
+    
     std::map<std::string, std::string> GetAuthHeaders(const std::string& method,
                                                        const std::string& request_path,
                                                        const std::string& body);
@@ -304,15 +531,45 @@ private:
     Position ParsePosition(const json& data);
     Account ParseAccount(const json& data);
     
+    // DOM-free list parsers (OKXFastParser); false means fall back to json
+    bool ParseOrderList(const std::string& body, std::vector<Order>& orders);
+    bool ParsePositionList(const std::string& body, std::vector<Position>& positions);
+    
+    // Query string of one history page (limit = page_size, after / before cursors)
+    static json HistoryParams(const HistoryQuery& query, const std::string& before = "");
+    
+    // One page of a history endpoint; false on a failed request, non-zero code
+    // or cancel (nothing is sent once cancelled is set)
+    bool FetchOrderPage(const char* endpoint, const json& params, std::vector<Order>& orders,
+                        const std::atomic<bool>* cancelled = nullptr);
+    bool FetchFillPage(const json& params, std::vector<Fill>& fills,
+                       const std::atomic<bool>* cancelled = nullptr);
+    bool FetchBillPage(const json& params, std::vector<Bill>& bills,
+                       const std::atomic<bool>* cancelled = nullptr);
+    
 private:
     std::unique_ptr<HttpClient> http_client_;
     std::unique_ptr<OKXSigner> signer_;
+    RateLimiter rate_limiter_;
     APIConfig config_;
+    
+    // Hot path
+    HotEndpoint place_order_endpoint_;
+    HotEndpoint cancel_order_endpoint_;
+    HotEndpoint amend_order_endpoint_;
+    struct curl_slist* static_headers_;
     bool initialized_;
+    MarketDataBridge* bridge_;
+    const InstrumentRegistry* registry_;    // Read-only once loaded
+    
+    // Fixed-point scales by inst_id, for instruments outside the registry
+    std::unordered_map<std::string, InstrumentScale> instrument_scales_;
+    mutable std::shared_mutex scales_mutex_;
     
     // Statistics
     mutable std::mutex stats_mutex_;
     APIStatistics stats_;
+    LatencyRegistry latency_;
 };
 
 #endif // OKX_REST_API_H
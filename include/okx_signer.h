@@ -2,13 +2,23 @@
 #define OKX_SIGNER_H
 
 #include <string>
+#include <string_view>
 #include <ctime>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 
 /**
  * @brief OKX API signature generator
  * 
  * OKX API requires HMAC-SHA256 signature for authentication:
  * signature = base64(HMAC-SHA256(SecretKey, timestamp + method + requestPath + body))
+ *
+ * The HMAC key schedule (SHA-256 state after the ipad / opad blocks) is
+ * computed once in the constructor. Each signature copies those states
+ * on the stack, feeds the four parts without concatenating them, and
+ * base64-encodes the digest with a lookup table: no heap allocation and
+ * safe to call from several threads at once.
  */
 class OKXSigner {
 public:
@@ -36,11 +46,67 @@ public:
                     const std::string& body = "") const;
     
     /**
-     * @brief Get current ISO 8601 timestamp
+     * @brief Length of a Base64 HMAC-SHA256 signature
+     */
+    static constexpr size_t kSignatureLength = 44;
+    
+    /**
+     * @brief Length of an ISO 8601 timestamp with milliseconds
+     */
+    static constexpr size_t kTimestampLength = 24;
+    
+    /**
+     * @brief Generate signature into a caller-supplied buffer (no std::string)
+     * @param out Buffer of at least kSignatureLength + 1 bytes (NUL-terminated)
+     * @return Signature length, 0 on failure
+     */
+    size_t SignTo(std::string_view timestamp,
+                  std::string_view method,
+                  std::string_view request_path,
+                  std::string_view body,
+                  char* out) const;
+    
+    /**
+     * @brief Get current ISO 8601 timestamp (server clock, see SetClockOffsetMs)
      * @return Timestamp string (e.g., "2023-01-01T12:00:00.123Z")
      */
     static std::string GetTimestamp();
     
+    /**
+     * @brief Write current ISO 8601 timestamp into a caller-supplied buffer
+     * @param out Buffer of at least kTimestampLength + 1 bytes (NUL-terminated)
+     * @return Timestamp length
+     */
+    static size_t FormatTimestamp(char* out);
+    
+    /**
+     * @brief Write an epoch-milliseconds time as ISO 8601
+     *
+     * The "YYYY-MM-DDTHH:MM:SS." prefix is cached per thread for the
+     * current second, so consecutive calls only rewrite the milliseconds.
+     */
+    static size_t FormatTimestamp(int64_t epoch_ms, char* out);
+    
+    // ==================== Server Clock ====================
+    
+    /**
+     * @brief Offset added to the local clock for timestamps sent to OKX
+     *        (server time - local time, ms), e.g. from ClockSync
+     *
+     * OKX rejects requests whose timestamp is more than 30 s off, so a
+     * drifting local clock otherwise shows up as signature errors.
+     */
+    static void SetClockOffsetMs(int64_t offset_ms);
+    static int64_t GetClockOffsetMs();
+    static void SetClockOffsetUs(int64_t offset_us);
+    static int64_t GetClockOffsetUs();
+    
+    /**
+     * @brief Local time + offset, in epoch milliseconds / microseconds
+     */
+    static int64_t NowMs();
+    static int64_t NowUs();
+    
     /**
      * @brief Get API key
      */
@@ -51,21 +117,20 @@ public:
      */
     const std::string& GetPassphrase() const { return passphrase_; }
 
-private:
     /**
-     * @brief Calculate HMAC-SHA256
+     * @brief Table-driven Base64 (RFC 4648, padded)
+     * @param out Buffer of at least 4 * ceil(length / 3) + 1 bytes (NUL-terminated)
+     * @return Encoded length
      */
-    std::string HMACSHA256(const std::string& key, const std::string& data) const;
-    
-    /**
-     * @brief Encode to Base64
-     */
-    std::string Base64Encode(const unsigned char* data, size_t length) const;
+    static size_t Base64Encode(const unsigned char* data, size_t length, char* out);
+
+private:
+    struct KeySchedule;
 
 private:
     std::string api_key_;
-    std::string secret_key_;
     std::string passphrase_;
+    std::shared_ptr<const KeySchedule> key_schedule_;   // Immutable, shared by copies
 };
 
 #endif // OKX_SIGNER_H
@@ -2,32 +2,55 @@
 #define OKX_WEBSOCKET_H
 
 #include "data_types.h"
+#include "event_ring.h"
+#include "latency_histogram.h"
+#include "market_data_bridge.h"
+#include "market_event.h"
 #include "okx_signer.h"
-#include "nlohmann/json.hpp"
-#include <websocketpp/config/asio_client.hpp>
-#include <websocketpp/client.hpp>
-#include <string>
+#include "order_book.h"
+#include <curl/curl.h>
+#include <atomic>
+#include <chrono>
 #include <functional>
-#include <thread>
+#include <future>
+#include <memory>
 #include <mutex>
-#include <map>
-#include <set>
-
-using json = nlohmann::json;
-typedef websocketpp::client<websocketpp::config::asio_tls_client> WebSocketClient;
-typedef websocketpp::lib::shared_ptr<websocketpp::lib::asio::ssl::context> context_ptr;
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 /**
  * @brief OKX WebSocket client for real-time market data and private channels
- * 
+ *
  * Features:
- * - Public channels: tickers, depth, trades, candlesticks
- * - Private channels: orders, positions, account, balance
+ * - Public channels: tickers, depth (books5, bbo-tbt, books, books-l2-tbt)
+ * - Private channels: orders, positions, account
  * - Automatic reconnection with exponential backoff
- * - Heartbeat/ping-pong mechanism
- * - Subscription management
- * - Thread-safe callbacks
- * 
+ * - Heartbeat ("ping"/"pong" text frames as OKX expects)
+ * - Subscription management; subscriptions are replayed after reconnect
+ *
+ * libcurl opens the TCP/TLS connection (CURLOPT_CONNECT_ONLY, so proxy,
+ * TLS and the session cache are the same as for REST) and the upgrade and
+ * RFC 6455 framing are done here on top of curl_easy_send/recv; libcurl's
+ * own WebSocket API is still missing from many distribution builds.
+ * A single I/O thread owns the connection: it connects, reads frames,
+ * parses them and invokes the callbacks. Subscription tables live on that
+ * thread only; other threads hand subscribe/unsubscribe/send requests over
+ * through a small queue and wake it with curl_multi_wakeup(), so the
+ * receive -> callback path takes no lock. DNS results and TLS sessions go
+ * through a CURLSH, so a reconnect resumes the previous TLS session
+ * instead of doing a full handshake.
+ *
+ * Callbacks run on the I/O thread and must be short; the Tick / Depth /
+ * Order / Position passed to them is reused for the next message, copy
+ * it if it must outlive the call.
+ *
+ * OKX serves public and private channels on different endpoints: the
+ * client connects to private_url when an api_key is configured and to url
+ * otherwise, so use one instance per endpoint.
+ *
  * WebSocket Documentation: https://www.okx.com/docs-v5/en/#overview-websocket
  */
 class OKXWebSocket {
@@ -39,114 +62,166 @@ public:
     using PositionCallback = std::function<void(const Position&)>;
     using AccountCallback = std::function<void(const Account&)>;
     using ErrorCallback = std::function<void(const std::string&)>;
-    
+    using MessageCallback = std::function<void(std::string_view)>;
+
     struct WSConfig {
         std::string url = "wss://ws.okx.com:8443/ws/v5/public";
         std::string private_url = "wss://ws.okx.com:8443/ws/v5/private";
-        
+
         // Authentication (for private channels)
         std::string api_key;
         std::string secret_key;
         std::string passphrase;
-        
-        // Reconnection settings
+
+        // Connection settings
+        int connect_timeout_ms = 5000;
+        bool verify_ssl = true;
+        std::string proxy_url;
+
+        // Reconnection settings (delay doubles per failed attempt, capped at 60s)
         bool auto_reconnect = true;
         int reconnect_delay_seconds = 5;
         int max_reconnect_attempts = 10;
-        
-        // Ping settings
+
+        // Ping settings: "ping" after this long without traffic, reconnect
+        // if nothing arrives within another interval
         int ping_interval_seconds = 20;
+
+        // Levels kept per instrument for the incremental books channels
+        size_t book_depth = OrderBook::kDefaultDepth;
     };
-    
+
 public:
     OKXWebSocket();
     ~OKXWebSocket();
-    
+
+    OKXWebSocket(const OKXWebSocket&) = delete;
+    OKXWebSocket& operator=(const OKXWebSocket&) = delete;
+
     /**
      * @brief Initialize WebSocket
      */
     bool Initialize(const WSConfig& config);
-    
+
     /**
-     * @brief Connect to WebSocket server
+     * @brief Start the I/O thread and connect
+     * @return true once the first connection is established
      */
     bool Connect();
-    
+
     /**
-     * @brief Disconnect from WebSocket server
+     * @brief Close the connection and stop the I/O thread
      */
     void Disconnect();
-    
+
     /**
      * @brief Check if connected
      */
-    bool IsConnected() const;
-    
+    bool IsConnected() const { return connected_.load(std::memory_order_acquire); }
+
     // ==================== Public Channel Subscriptions ====================
-    
+
     /**
      * @brief Subscribe to ticker channel
      * @param inst_id Instrument ID (e.g., "XAUT-USDT-SWAP")
      * @param callback Callback function for tick updates
      */
     bool SubscribeTicker(const std::string& inst_id, TickCallback callback);
-    
+
     /**
      * @brief Subscribe to orderbook (depth) channel
      * @param inst_id Instrument ID
      * @param callback Callback function for depth updates
-     * @param depth_type "books" for full depth, "books5" for top 5 levels
+     * @param depth_type "books5" / "bbo-tbt" (full snapshot per push) or
+     *        "books" / "books-l2-tbt" / "books50-l2-tbt" (kept incrementally
+     *        in an OrderBook with checksum verification; resubscribed on
+     *        checksum or sequence errors)
      */
-    bool SubscribeDepth(const std::string& inst_id, 
+    bool SubscribeDepth(const std::string& inst_id,
                         DepthCallback callback,
                         const std::string& depth_type = "books5");
-    
+
     /**
      * @brief Unsubscribe from ticker
      */
     bool UnsubscribeTicker(const std::string& inst_id);
-    
+
     /**
      * @brief Unsubscribe from depth
      */
     bool UnsubscribeDepth(const std::string& inst_id);
-    
+
     // ==================== Private Channel Subscriptions ====================
-    
+
     /**
      * @brief Subscribe to orders channel (requires authentication)
      * @param inst_id Instrument ID (empty for all instruments)
      * @param callback Callback function for order updates
      */
     bool SubscribeOrders(const std::string& inst_id, OrderCallback callback);
-    
+
     /**
      * @brief Subscribe to positions channel
      * @param inst_id Instrument ID (empty for all instruments)
      * @param callback Callback function for position updates
      */
     bool SubscribePositions(const std::string& inst_id, PositionCallback callback);
-    
+
     /**
      * @brief Subscribe to account channel
      * @param callback Callback function for account updates
      */
     bool SubscribeAccount(AccountCallback callback);
-    
+
     /**
      * @brief Unsubscribe from private channels
      */
     bool UnsubscribeOrders(const std::string& inst_id);
     bool UnsubscribePositions(const std::string& inst_id);
     bool UnsubscribeAccount();
-    
+
+    // ==================== Event Ring ====================
+
+    /**
+     * @brief Publish decoded ticks / depth / orders as MarketEvent records
+     *        into a ring, in addition to any callbacks (set before Connect())
+     *
+     * The I/O thread then only decodes and copies a fixed-size record, and
+     * strategy code drains the ring on its own (pinned) thread, so slow
+     * strategy logic never delays frame reads. Subscribe with an empty
+     * callback to use the ring only. A full ring drops the event and
+     * counts an overrun in the ring's statistics.
+     */
+    void SetEventRing(SpscRing<MarketEvent>* ring);
+    void SetEventRing(MpscRing<MarketEvent>* ring);
+
+    /**
+     * @brief Also store ticks / depth in a shared-memory bridge for
+     *        out-of-process readers such as MT5 (set before Connect())
+     */
+    void SetMarketDataBridge(MarketDataBridge* bridge);
+
+    // ==================== Raw Access ====================
+
+    /**
+     * @brief Queue a text frame for the I/O thread to send
+     *        (dropped if the connection is down when it is picked up)
+     */
+    bool SendText(std::string_view message);
+
+    /**
+     * @brief Called with every received text message before it is parsed
+     *        (set before Connect())
+     */
+    void SetMessageCallback(MessageCallback callback);
+
     // ==================== Error Handling ====================
-    
+
     /**
-     * @brief Set error callback
+     * @brief Set error callback (set before Connect())
      */
     void SetErrorCallback(ErrorCallback callback);
-    
+
     /**
      * @brief Get connection statistics
      */
@@ -157,80 +232,180 @@ public:
         uint64_t subscription_count = 0;
         bool is_connected = false;
         std::chrono::steady_clock::time_point last_message_time;
+
+        // One-way market-data latency: receipt (on the clock OKXSigner /
+        // ClockSync keeps aligned with OKX) minus the message's ts
+        uint64_t latency_samples = 0;
+        int64_t last_latency_us = 0;
+        int64_t max_latency_us = 0;
+        double avg_latency_us = 0;
     };
-    
+
     Statistics GetStatistics() const;
-    
+
+    /**
+     * @brief Per-channel latency histograms (key: channel, e.g. "tickers")
+     *
+     * parse: decoding a frame, dispatch: rings, bridge and callbacks,
+     * network: one-way exchange-to-receipt latency of market data.
+     */
+    LatencyRegistry::Snapshot GetLatencySnapshot() const;
+
 private:
-    // WebSocket event handlers
-    void OnOpen(websocketpp::connection_hdl hdl);
-    void OnClose(websocketpp::connection_hdl hdl);
-    void OnFail(websocketpp::connection_hdl hdl);
-    void OnMessage(websocketpp::connection_hdl hdl, WebSocketClient::message_ptr msg);
-    
-    // SSL/TLS context handler
-    context_ptr OnTLSInit(websocketpp::connection_hdl hdl);
-    
+    enum class ChannelType { kTicker, kDepth, kBook, kOrders, kPositions, kAccount };
+
+    // One subscribed channel; owned by the I/O thread
+    struct Subscription {
+        ChannelType type;
+        std::string channel;
+        std::string inst_id;
+        TickCallback on_tick;
+        DepthCallback on_depth;
+        OrderCallback on_order;
+        PositionCallback on_position;
+        AccountCallback on_account;
+        std::unique_ptr<OrderBook> book;   // kBook only
+        LatencyRegistry::Endpoint* latency = nullptr;
+
+        bool IsPrivate() const {
+            return type == ChannelType::kOrders || type == ChannelType::kPositions ||
+                   type == ChannelType::kAccount;
+        }
+    };
+
+    // Request from any thread to the I/O thread
+    struct Command {
+        enum class Type { kSubscribe, kUnsubscribe, kSend };
+        Type type;
+        std::unique_ptr<Subscription> subscription;   // kSubscribe
+        std::string channel;                          // kUnsubscribe
+        std::string inst_id;                          // kUnsubscribe
+        std::string text;                             // kSend
+    };
+
+    bool Subscribe(std::unique_ptr<Subscription> subscription);
+    bool Unsubscribe(const std::string& channel, const std::string& inst_id);
+    bool Enqueue(Command command);
+
+    // WebSocket opcodes
+    static constexpr int kOpContinuation = 0x0;
+    static constexpr int kOpText = 0x1;
+    static constexpr int kOpBinary = 0x2;
+    static constexpr int kOpClose = 0x8;
+    static constexpr int kOpPing = 0x9;
+    static constexpr int kOpPong = 0xA;
+
+    // I/O thread
+    void RunEventLoop();
+    bool Open();
+    bool Handshake(const std::string& host, const std::string& path);
+    void Close(bool send_close_frame);
+    void DrainCommands();
+    bool ReadMessages();
+    bool ProcessFrames();
+    void DispatchMessage(std::string_view message);
+    bool WaitForEvents(int timeout_ms, bool writable = false);
+    bool SendFrame(std::string_view payload, int opcode);
+    bool SendAll(const char* data, size_t length);
+
     // Message processing
-    void ProcessMessage(const std::string& message);
-    void ProcessTickerMessage(const json& data);
-    void ProcessDepthMessage(const json& data);
-    void ProcessOrderMessage(const json& data);
-    void ProcessPositionMessage(const json& data);
-    void ProcessAccountMessage(const json& data);
-    
+    void ProcessMessage(std::string_view message);
+    void ProcessEvent(std::string_view event, std::string_view code, std::string_view msg);
+    void ProcessTickerMessage(Subscription& subscription, std::string_view data);
+    void ProcessDepthMessage(Subscription& subscription, std::string_view data);
+    void ProcessBookMessage(Subscription& subscription, std::string_view message);
+    void ProcessOrderMessage(Subscription& subscription, std::string_view data);
+    void ProcessPositionMessage(Subscription& subscription, std::string_view data);
+    void ProcessAccountMessage(Subscription& subscription, std::string_view data);
+    Subscription* FindSubscription(std::string_view channel, std::string_view inst_id);
+
     // Subscription management
-    bool SendSubscription(const std::string& channel, const std::string& inst_id = "");
-    bool SendUnsubscription(const std::string& channel, const std::string& inst_id = "");
-    
+    bool SendSubscription(const Subscription& subscription);
+    bool SendUnsubscription(const Subscription& subscription);
+    static std::string SubscriptionArg(const Subscription& subscription);
+    void SubscribeAll(bool private_channels);
+
     // Authentication
     bool Authenticate();
     std::string GenerateAuthSignature(const std::string& timestamp);
-    
+
     // Reconnection logic
-    void ReconnectionLoop();
     bool AttemptReconnect();
-    
+
     // Ping/Pong mechanism
-    void PingLoop();
-    void SendPing();
-    
-    // Helper functions
-    void RunEventLoop();
-    void StopEventLoop();
-    
+    bool CheckHeartbeat(std::chrono::steady_clock::time_point now);
+
+    void ReportError(const std::string& error);
+    void Publish();
+
+    // Latency of a market-data message received in the current frame
+    int64_t RecordLatency(Subscription& subscription, Timestamp exchange_time);
+
 private:
     WSConfig config_;
     std::unique_ptr<OKXSigner> signer_;
-    
-    // WebSocket client
-    WebSocketClient ws_client_;
-    websocketpp::connection_hdl connection_hdl_;
-    bool is_connected_;
-    bool should_reconnect_;
-    
+    bool initialized_;
+
+    // libcurl handles; curl_ is only touched by the I/O thread
+    CURL* curl_;
+    CURLM* multi_;      // No transfers: used for curl_multi_poll/wakeup
+    CURLSH* share_;     // DNS + TLS session cache, survives reconnects
+    curl_socket_t socket_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> connected_;
+    bool logged_in_;
+
     // Threading
-    std::unique_ptr<std::thread> event_thread_;
-    std::unique_ptr<std::thread> ping_thread_;
-    std::unique_ptr<std::thread> reconnect_thread_;
-    
-    // Callbacks
-    std::map<std::string, TickCallback> ticker_callbacks_;
-    std::map<std::string, DepthCallback> depth_callbacks_;
-    std::map<std::string, OrderCallback> order_callbacks_;
-    std::map<std::string, PositionCallback> position_callbacks_;
-    AccountCallback account_callback_;
+    std::thread event_thread_;
+    std::promise<bool> connect_result_;
+
+    // Callbacks and rings (set before Connect)
     ErrorCallback error_callback_;
-    
-    // Subscription tracking
-    std::set<std::string> active_subscriptions_;
-    
-    // Statistics
-    mutable std::mutex stats_mutex_;
-    Statistics stats_;
-    
-    // Thread safety
-    mutable std::mutex mutex_;
+    MessageCallback message_callback_;
+    SpscRing<MarketEvent>* spsc_ring_;
+    MpscRing<MarketEvent>* mpsc_ring_;
+    MarketDataBridge* bridge_;
+
+    // Command queue (any thread -> I/O thread)
+    std::mutex command_mutex_;
+    std::vector<Command> commands_;
+    std::atomic<bool> commands_pending_;
+
+    // Owned by the I/O thread
+    std::vector<std::unique_ptr<Subscription>> subscriptions_;
+    std::vector<char> receive_buffer_;   // Raw frames; messages parsed in place
+    size_t receive_length_;
+    std::string fragment_;               // Fragmented message being assembled
+    std::vector<char> send_buffer_;
+    std::mt19937 random_;                // Handshake key and frame masks
+    std::chrono::steady_clock::time_point last_receive_time_;
+    int64_t receive_server_us_;          // Frame receipt on the server clock
+    int64_t dispatch_ns_;                // Hand-off time within the current message
+    Subscription* dispatch_subscription_;
+    std::chrono::steady_clock::time_point ping_sent_time_;
+    bool ping_outstanding_;
+    int reconnect_attempts_;
+
+    // Reused per message so dispatch does not allocate
+    Tick tick_;
+    Depth depth_;
+    Order order_;
+    Position position_;
+    Account account_;
+    MarketEvent event_;
+
+    // Statistics (written by the I/O thread)
+    std::atomic<uint64_t> messages_received_;
+    std::atomic<uint64_t> messages_sent_;
+    std::atomic<uint64_t> reconnections_;
+    std::atomic<uint64_t> subscription_count_;
+    std::atomic<int64_t> last_message_ns_;
+    std::atomic<uint64_t> latency_samples_;
+    std::atomic<int64_t> latency_total_us_;
+    std::atomic<int64_t> last_latency_us_;
+    std::atomic<int64_t> max_latency_us_;
+    LatencyRegistry latency_;
 };
 
 #endif // OKX_WEBSOCKET_H
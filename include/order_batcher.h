@@ -0,0 +1,136 @@
+#ifndef ORDER_BATCHER_H
+#define ORDER_BATCHER_H
+
+#include "data_types.h"
+#include "nlohmann/json.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class OKXRestAPI;
+
+/**
+ * @brief Coalesces trade requests into OKX batch endpoints
+ *
+ * PlaceOrder / CancelOrder / AmendOrder calls are queued per kind. The
+ * first call into an empty queue opens a window (Options::window, 200 us
+ * by default); when it closes, or as soon as max_batch requests are
+ * waiting, the queue is sent as one /trade/batch-orders,
+ * /cancel-batch-orders or /amend-batch-orders request (a lone request
+ * goes to the single-order endpoint). Each item of the response's data
+ * array (sCode / sMsg / ordId) resolves the future of the call that
+ * queued it, so a ladder of entries or a mass cancel costs one round
+ * trip instead of twenty.
+ *
+ * Requests go out through OKXRestAPI's async path (rate limits, latency
+ * histograms); futures are completed on its I/O thread. The destructor
+ * sends whatever is still queued and waits for the responses.
+ */
+class OrderBatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+    using json = nlohmann::json;
+
+    static constexpr size_t kMaxBatch = 20;          // OKX limit per batch request
+
+    struct Options {
+        std::chrono::microseconds window{200};
+        size_t max_batch = kMaxBatch;                 // Clamped to [1, kMaxBatch]
+    };
+
+    /**
+     * @brief Outcome of one queued request (its item of the response data)
+     */
+    struct Result {
+        bool success = false;
+        std::string order_id;
+        std::string client_order_id;
+        std::string code;           // sCode; the response code if the request failed as a whole
+        std::string message;        // sMsg
+    };
+
+    struct Statistics {
+        uint64_t submitted;         // Calls queued
+        uint64_t requests;          // HTTP requests sent
+        uint64_t batched;           // Calls that shared a request with others
+        uint64_t failed;            // Calls resolved without success
+        size_t largest_batch;
+    };
+
+    explicit OrderBatcher(OKXRestAPI& api);
+    OrderBatcher(OKXRestAPI& api, const Options& options);
+    ~OrderBatcher();
+
+    OrderBatcher(const OrderBatcher&) = delete;
+    OrderBatcher& operator=(const OrderBatcher&) = delete;
+
+    std::future<Result> PlaceOrder(const Order& order);
+
+    std::future<Result> CancelOrder(const std::string& inst_id,
+                                    const std::string& order_id = "",
+                                    const std::string& client_order_id = "");
+
+    std::future<Result> AmendOrder(const std::string& inst_id,
+                                   const std::string& order_id,
+                                   const std::string& new_size = "",
+                                   const std::string& new_price = "");
+
+    /**
+     * @brief Send everything queued now instead of at the end of its window
+     */
+    void Flush();
+
+    Statistics GetStatistics() const;
+
+private:
+    enum class Kind : uint8_t { kPlace, kCancel, kAmend, kCount };
+    static constexpr size_t kKindCount = static_cast<size_t>(Kind::kCount);
+
+    struct Pending {
+        json item;
+        std::promise<Result> promise;
+    };
+
+    struct Queue {
+        std::vector<Pending> items;
+        Clock::time_point deadline;     // Window of the oldest item
+    };
+
+    using Batch = std::vector<Pending>;
+
+    std::future<Result> Enqueue(Kind kind, json item);
+    void Run();
+    void Send(Kind kind, std::shared_ptr<Batch> batch);
+    void Complete(Batch& batch, const json& response);
+
+    OKXRestAPI& api_;
+    Options options_;
+
+    Queue queues_[kKindCount];
+    bool running_;
+    bool flush_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+
+    // Responses still outstanding; the destructor waits for them
+    size_t in_flight_;
+    std::mutex in_flight_mutex_;
+    std::condition_variable in_flight_done_;
+
+    std::atomic<uint64_t> submitted_;
+    std::atomic<uint64_t> requests_;
+    std::atomic<uint64_t> batched_;
+    std::atomic<uint64_t> failed_;
+    std::atomic<size_t> largest_batch_;
+};
+
+#endif // ORDER_BATCHER_H
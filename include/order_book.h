@@ -0,0 +1,170 @@
+#ifndef ORDER_BOOK_H
+#define ORDER_BOOK_H
+
+#include "data_types.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Incrementally maintained L2 order book for OKX books / books-l2-tbt
+ *
+ * Each side is a sorted structure-of-arrays (prices, sizes, and the raw
+ * price/size text kept only for the checksum) ordered worst-to-best, so
+ * the best level is always the last element: best bid/ask are O(1), and
+ * the frequent top-of-book inserts and deletes shift only the few levels
+ * above them. All storage is allocated once in the constructor; applying
+ * an update never allocates.
+ *
+ * Updates are parsed straight from the push message with OKXFastParser
+ * readers, sizes of "0" delete a level, and the OKX CRC32 checksum over
+ * the top 25 levels is verified after every snapshot/update. The CRC
+ * state after each depth is cached, so an update only re-hashes from the
+ * shallowest level it touched (and nothing at all below depth 25).
+ * seqId / prevSeqId continuity is checked when the channel sends them.
+ *
+ * Not thread-safe: meant to be owned by the thread receiving the feed.
+ */
+class OrderBook {
+public:
+    static constexpr size_t kDefaultDepth = 400;
+    static constexpr size_t kChecksumLevels = 25;
+    static constexpr size_t kTextCapacity = 23;
+
+    enum class Result {
+        kOk,
+        kParseError,         // Malformed message or level text too long
+        kChecksumMismatch,   // Book no longer matches OKX; resubscribe
+        kSequenceGap,        // prevSeqId did not match the last seqId
+        kNotInitialized      // Update before the first snapshot
+    };
+
+    struct Statistics {
+        uint64_t snapshots = 0;
+        uint64_t updates = 0;
+        uint64_t levels_changed = 0;
+        uint64_t checksum_failures = 0;
+        uint64_t sequence_gaps = 0;
+        uint64_t parse_errors = 0;
+    };
+
+    explicit OrderBook(const std::string& inst_id = "", size_t max_depth = kDefaultDepth);
+
+    /**
+     * @brief Apply a full WebSocket push ({"arg":..,"action":..,"data":[..]})
+     *
+     * "action":"snapshot" replaces the book, anything else is an update.
+     */
+    Result ApplyMessage(std::string_view message);
+
+    /**
+     * @brief Apply one "data" element ({"asks":..,"bids":..,"ts":..,"checksum":..})
+     */
+    Result ApplySnapshot(std::string_view data);
+    Result ApplyUpdate(std::string_view data);
+
+    void Clear();
+
+    /**
+     * @brief Turn checksum verification off (e.g. for books5 which has none)
+     */
+    void SetVerifyChecksum(bool verify) { verify_checksum_ = verify; }
+
+    // ==================== Queries ====================
+
+    bool IsValid() const { return initialized_; }
+    const std::string& GetInstId() const { return inst_id_; }
+
+    size_t BidCount() const { return bids_.count; }
+    size_t AskCount() const { return asks_.count; }
+
+    // 0 when the side is empty
+    Price BestBid() const { return bids_.count ? bids_.price[bids_.count - 1] : 0; }
+    Price BestAsk() const { return asks_.count ? asks_.price[asks_.count - 1] : 0; }
+    Volume BestBidSize() const { return bids_.count ? bids_.size[bids_.count - 1] : 0; }
+    Volume BestAskSize() const { return asks_.count ? asks_.size[asks_.count - 1] : 0; }
+
+    /**
+     * @brief Level by depth, 0 = best
+     */
+    DepthLevel Bid(size_t depth) const { return bids_.Level(depth); }
+    DepthLevel Ask(size_t depth) const { return asks_.Level(depth); }
+
+    Timestamp GetTimestamp() const { return timestamp_; }
+    int64_t GetSeqId() const { return seq_id_; }
+
+    /**
+     * @brief OKX checksum (signed CRC32) of the current top 25 levels
+     */
+    int32_t ComputeChecksum() const;
+
+    /**
+     * @brief Copy the top `levels` of each side into a legacy Depth
+     */
+    void ToDepth(Depth& depth, size_t levels = kDefaultDepth) const;
+
+    const Statistics& GetStatistics() const { return stats_; }
+
+    /**
+     * @brief zlib-compatible CRC32 (as used by the OKX checksum)
+     */
+    static uint32_t Crc32(const char* data, size_t length);
+
+    /**
+     * @brief Continue a CRC32 (state = ~crc; start with 0xFFFFFFFF)
+     */
+    static uint32_t Crc32Update(uint32_t state, const char* data, size_t length);
+
+private:
+    struct LevelText {
+        char data[kTextCapacity];
+        uint8_t length;
+
+        std::string_view View() const { return std::string_view(data, length); }
+    };
+
+    // One side, sorted worst -> best (best at count - 1)
+    struct BookSide {
+        bool is_bid = false;
+        size_t count = 0;
+        size_t capacity = 0;
+        size_t changed_depth = 0;   // Shallowest depth touched since last checksum
+        std::vector<double> price;
+        std::vector<double> size;
+        std::vector<LevelText> price_text;
+        std::vector<LevelText> size_text;
+
+        void Reserve(size_t levels);
+        DepthLevel Level(size_t depth) const;
+
+        // Index of the first level not worse than `px` (insert position)
+        size_t Find(double px) const;
+
+        // Set (size > 0) or delete (size == 0) a level
+        bool Apply(double px, double sz, std::string_view px_text, std::string_view sz_text);
+    };
+
+    Result Apply(std::string_view data, bool snapshot);
+    bool ParseSide(std::string_view levels, BookSide& side, bool snapshot);
+
+    // Checksum re-hashing only from `from_depth`, using checksum_state_
+    int32_t UpdateChecksum(size_t from_depth);
+
+    std::string inst_id_;
+    BookSide bids_;
+    BookSide asks_;
+
+    Timestamp timestamp_;
+    int64_t seq_id_;
+    bool initialized_;
+    bool verify_checksum_;
+
+    // checksum_state_[d]: CRC state after all levels shallower than d
+    uint32_t checksum_state_[kChecksumLevels + 1];
+    int32_t checksum_;
+
+    Statistics stats_;
+};
+
+#endif // ORDER_BOOK_H
@@ -0,0 +1,138 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @brief Token-bucket rate limiter keyed by endpoint
+ *
+ * Each key (e.g. "POST /api/v5/trade/order") owns its own bucket, so
+ * heavy market-data polling cannot eat into the order-entry budget.
+ * Limits are expressed the way OKX publishes them: N requests per window.
+ * The bucket holds up to `burst` tokens and refills continuously.
+ *
+ * Acquire() never sleeps. A request either gets a token now, is queued
+ * (a future token is reserved and the caller is told when it may send),
+ * or is rejected because the wait would exceed the caller's limit.
+ * Waiting is left to the caller, so one throttled endpoint never stalls
+ * threads working on another.
+ */
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Limit {
+        double requests_per_second = 10.0;  // Refill rate
+        double burst = 10.0;                // Bucket capacity
+
+        /**
+         * @brief Build a limit from an OKX-style "requests per window"
+         */
+        static Limit PerWindow(int requests, std::chrono::milliseconds window) {
+            Limit limit;
+            limit.requests_per_second = requests * 1000.0 / window.count();
+            limit.burst = requests;
+            return limit;
+        }
+    };
+
+    struct Decision {
+        bool granted = false;           // false: rejected
+        Clock::time_point not_before;   // Send time (now if not queued)
+
+        bool IsQueued(Clock::time_point now) const { return granted && not_before > now; }
+    };
+
+    struct BucketStatistics {
+        uint64_t granted = 0;          // Served immediately
+        uint64_t queued = 0;           // Served after a reserved wait
+        uint64_t rejected = 0;         // Wait would exceed max_wait
+        double total_queue_ms = 0.0;   // Sum of reserved waits
+        double tokens = 0.0;           // Tokens left (negative: reserved ahead)
+        Limit limit;
+    };
+
+    /**
+     * @brief A key's bucket; resolve once with GetBucket() to skip the
+     *        key lookup on hot paths. Stays valid for the limiter's lifetime.
+     */
+    struct Bucket {
+        std::mutex mutex;
+        Limit limit;
+        double tokens = 0.0;
+        Clock::time_point last_refill;
+        BucketStatistics stats;
+
+        explicit Bucket(const Limit& l)
+            : limit(l), tokens(l.burst), last_refill(Clock::now()) {}
+
+        void Refill(Clock::time_point now);
+    };
+
+public:
+    RateLimiter() = default;
+
+    RateLimiter(const RateLimiter&) = delete;
+    RateLimiter& operator=(const RateLimiter&) = delete;
+
+    /**
+     * @brief Set the limit for one key (creates the bucket or updates it in place)
+     */
+    void SetLimit(const std::string& key, const Limit& limit);
+
+    /**
+     * @brief Limit applied to keys without an explicit SetLimit()
+     */
+    void SetDefaultLimit(const Limit& limit);
+
+    /**
+     * @brief Take `cost` tokens from the key's bucket
+     * @param key Bucket key
+     * @param max_wait Longest acceptable queueing delay (0: reject when empty)
+     * @param cost Tokens consumed (e.g. number of orders in a batch)
+     */
+    Decision Acquire(const std::string& key,
+                     std::chrono::milliseconds max_wait,
+                     double cost = 1.0);
+
+    /**
+     * @brief Resolve (creating with the default limit if needed) a key's bucket
+     */
+    Bucket* GetBucket(const std::string& key) { return FindOrCreate(key); }
+
+    /**
+     * @brief Acquire() on a pre-resolved bucket; no lookup, no allocation
+     */
+    Decision Acquire(Bucket* bucket,
+                     std::chrono::milliseconds max_wait,
+                     double cost = 1.0);
+
+    /**
+     * @brief Counters for one key (zeroed if the key was never used)
+     */
+    BucketStatistics GetStatistics(const std::string& key) const;
+
+    /**
+     * @brief Counters for every bucket
+     */
+    std::map<std::string, BucketStatistics> GetAllStatistics() const;
+
+    void ResetStatistics();
+
+private:
+    Bucket* FindOrCreate(const std::string& key);
+
+private:
+    mutable std::shared_mutex map_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Bucket>> buckets_;
+    Limit default_limit_;
+};
+
+#endif // RATE_LIMITER_H
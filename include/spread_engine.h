@@ -0,0 +1,193 @@
+#ifndef SPREAD_ENGINE_H
+#define SPREAD_ENGINE_H
+
+#include "data_types.h"
+#include "symbol_table.h"
+#include "tick_pod.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Event-driven OKX / MT5 hedge-pair grid on cached top-of-book
+ *
+ * Two independent ladders, one per direction:
+ *
+ *     kShortOkx: spread = okx.bid - mt5.ask   (OKX sells, MT5 buys)
+ *     kShortMt5: spread = mt5.bid - okx.ask   (MT5 sells, OKX buys)
+ *
+ * The spread is taken net of the round-trip fees of one unit on both
+ * legs (2 * (px * fee_rate) per leg, at the entry prices). Level n of a
+ * ladder (0-based) opens when the net spread exceeds
+ * first_order + n * next_order, up to max_orders open groups; a new
+ * group takes the lowest level not held by an open one, so a level freed
+ * by a close is refilled before deeper ones. Every open
+ * group is marked like the strategy spec says: the short leg at the ask,
+ * the long leg at the bid, sizes okx_order_size / mt5_order_size, less
+ * the opening fees and the fees of closing at the current prices; a
+ * group whose PnL exceeds take_profit is closed.
+ *
+ * OnQuote() caches the leg's bid/ask and, once both legs have a quote,
+ * re-evaluates both ladders: closes first, then at most one open per
+ * direction (a single off-market print can't fill the whole ladder).
+ * Decisions are written to a caller-provided array and applied to the
+ * engine's own book at the quoted prices; UpdateEntry() replaces them
+ * with the actual fills. Groups live in fixed arrays, so a quote update
+ * never allocates. Not thread-safe: drive it from one thread, e.g. the
+ * consumer of the market-data ring.
+ */
+class SpreadEngine {
+public:
+    static constexpr size_t kMaxLevels = 32;        // Config rejects a larger max_orders
+    static constexpr size_t kMaxDecisions = 2 * kMaxLevels + 2;   // Enough for any single quote
+
+    enum class Direction : uint8_t { kShortOkx, kShortMt5 };
+    enum class Action : uint8_t { kNone, kOpen, kClose };
+
+    /**
+     * @brief One open hedge pair
+     */
+    struct Group {
+        int group_id;
+        uint8_t level;              // Ladder level it was opened at
+        Price okx_entry;
+        Price mt5_entry;
+        double open_fee;            // Fees paid on both legs when opening
+        Timestamp open_time;        // Quote timestamp (ms)
+    };
+
+    /**
+     * @brief Market orders to send for one group
+     *
+     * kOpen: sell the short leg at the bid, buy the long leg at the ask.
+     * kClose: buy back the short leg at the ask, sell the long leg at the bid.
+     */
+    struct Decision {
+        Action action;
+        Direction direction;
+        uint8_t level;
+        int group_id;
+        Price okx_price;            // Top-of-book price the OKX leg should fill at
+        Price mt5_price;
+        double net_spread;          // Fee-inclusive spread when the decision was taken
+        double pnl;                 // kClose: group PnL after all fees
+        Timestamp timestamp;
+    };
+
+    struct Statistics {
+        uint64_t quotes;            // Quotes accepted for either leg
+        uint64_t evaluations;       // Quotes with both legs known
+        uint64_t opens;
+        uint64_t closes;
+        double realized_pnl;        // Sum of PnL of closed groups
+    };
+
+    SpreadEngine(const StrategyParams& params, SymbolTable::Id okx_symbol, SymbolTable::Id mt5_symbol);
+
+    /**
+     * @brief Swap parameters (e.g. from a ConfigSnapshot); open groups stay,
+     *        a lower max_orders only stops new opens
+     */
+    void SetParams(const StrategyParams& params);
+    const StrategyParams& Params() const { return params_; }
+
+    // ==================== Quote events ====================
+
+    /**
+     * @brief Route a tick by platform and symbol id; other instruments
+     *        are ignored
+     * @return Decisions written to out (at most capacity)
+     */
+    size_t OnQuote(const TickPOD& tick, Decision* out, size_t capacity);
+
+    size_t OnOkxQuote(Price bid, Price ask, Timestamp timestamp, Decision* out, size_t capacity);
+    size_t OnMt5Quote(Price bid, Price ask, Timestamp timestamp, Decision* out, size_t capacity);
+
+    // ==================== State ====================
+
+    /**
+     * @brief Fee-inclusive spread at the cached quotes; 0 until both legs are known
+     */
+    double NetSpread(Direction direction) const;
+
+    /**
+     * @brief Net spread the next level needs; 0 when the ladder is full
+     */
+    double NextThreshold(Direction direction) const;
+
+    size_t OpenCount(Direction direction) const { return LadderFor(direction).count; }
+    const Group& OpenGroup(Direction direction, size_t index) const {
+        return LadderFor(direction).groups[index];
+    }
+
+    /**
+     * @brief Replace the assumed entry prices of a group with its fills
+     * @return false if no open group has that id
+     */
+    bool UpdateEntry(int group_id, Price okx_fill, Price mt5_fill);
+
+    /**
+     * @brief Legacy OrderGroup for an open group (allocates; for display / logging)
+     */
+    void ToOrderGroup(Direction direction, const Group& group, OrderGroup& out) const;
+
+    Statistics GetStatistics() const { return stats_; }
+
+    /**
+     * @brief Forget quotes, open groups and statistics; group ids keep counting
+     */
+    void Reset();
+
+private:
+    struct Quote {
+        Price bid;
+        Price ask;
+        Timestamp timestamp;
+        bool valid;
+    };
+
+    struct Ladder {
+        Group groups[kMaxLevels];   // In opening order
+        size_t count;
+        uint32_t levels;            // Bit n set: level n held by an open group
+    };
+    static_assert(kMaxLevels <= 32, "Ladder::levels has one bit per level");
+
+    // The two legs of a direction: the one sold on open and the one bought
+    struct Legs {
+        const Quote* short_quote;
+        const Quote* long_quote;
+        double short_size;
+        double long_size;
+        double short_fee_rate;
+        double long_fee_rate;
+        bool okx_is_short;
+    };
+
+    Ladder& LadderFor(Direction direction) {
+        return ladders_[static_cast<size_t>(direction)];
+    }
+    const Ladder& LadderFor(Direction direction) const {
+        return ladders_[static_cast<size_t>(direction)];
+    }
+
+    Legs LegsFor(Direction direction) const;
+    static double NetSpread(const Legs& legs);
+
+    size_t Evaluate(Decision* out, size_t capacity);
+    size_t EvaluateDirection(Direction direction, Timestamp now, Decision* out, size_t capacity);
+    static size_t FreeLevel(const Ladder& ladder);
+
+    StrategyParams params_;
+    size_t max_levels_;
+
+    SymbolTable::Id okx_symbol_;
+    SymbolTable::Id mt5_symbol_;
+    Quote okx_;
+    Quote mt5_;
+
+    Ladder ladders_[2];
+    int next_group_id_;
+    Statistics stats_;
+};
+
+#endif // SPREAD_ENGINE_H
@@ -0,0 +1,70 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Process-wide interning of symbol names to small integer ids
+ *
+ * Ids are dense (0, 1, 2, ... in order of first use) and never reused,
+ * so they can index plain arrays and be stored in POD records such as
+ * TickPOD instead of a std::string. Find(), Name() and Intern() of a
+ * known name are lock-free (an open-addressing index that is only ever
+ * added to); only the first Intern() of a name takes the lock. Names
+ * returned by Name() stay valid for the life of the table.
+ */
+class SymbolTable {
+public:
+    using Id = uint32_t;
+    static constexpr Id kInvalidId = UINT32_MAX;
+    static constexpr size_t kChunkSize = 256;
+    static constexpr size_t kMaxChunks = 64;          // Up to 16384 names
+    static constexpr size_t kIndexSize = 2 * kChunkSize * kMaxChunks;   // At most half full
+
+    SymbolTable();
+    ~SymbolTable();
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    /**
+     * @brief Table shared by TickPOD conversions and the rest of the process
+     */
+    static SymbolTable& Global();
+
+    /**
+     * @brief Id of a name, added if new; kInvalidId if empty or full
+     */
+    Id Intern(std::string_view name);
+
+    /**
+     * @brief Id of a known name, kInvalidId otherwise (never adds)
+     */
+    Id Find(std::string_view name) const;
+
+    /**
+     * @brief Name of an id; empty string for unknown ids
+     */
+    const std::string& Name(Id id) const;
+
+    size_t Size() const { return size_.load(std::memory_order_acquire); }
+
+private:
+    // Names live in fixed chunks that are never moved, so readers can
+    // index them without the lock once they have seen size_
+    std::unique_ptr<std::string[]> chunks_[kMaxChunks];
+    std::atomic<uint32_t> size_;
+
+    // Linear-probing index of id + 1 (0: empty). An entry is stored after
+    // its name, never changes and is never removed, so a reader that finds
+    // an empty entry knows the name was not interned when it looked
+    std::unique_ptr<std::atomic<uint32_t>[]> index_;
+    std::mutex mutex_;                                  // Serialises adds
+};
+
+#endif // SYMBOL_TABLE_H
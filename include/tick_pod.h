@@ -0,0 +1,56 @@
+#ifndef TICK_POD_H
+#define TICK_POD_H
+
+#include "data_types.h"
+#include "symbol_table.h"
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief One-cache-line, trivially copyable quote
+ *
+ * The legacy Tick carries three std::strings and duplicated price fields
+ * (~250 bytes, allocates when copied). TickPOD keeps only what a quote
+ * consumer needs and replaces the instrument name with a SymbolTable id,
+ * so rings, shared memory and recorders can move it with memcpy.
+ * FromTick / ToTick convert to and from the legacy struct; 24h stats,
+ * funding rate and fixed-point ticks are not carried.
+ */
+struct alignas(64) TickPOD {
+    enum class Platform : uint8_t { kUnknown, kOKX, kMT5 };
+
+    SymbolTable::Id symbol_id;      // SymbolTable::Global() id of inst_id
+    Platform platform;
+    uint8_t reserved[3];
+
+    Price bid;
+    Price ask;
+    Price last;
+    Volume bid_size;
+    Volume ask_size;
+    Price mark_price;
+    Timestamp timestamp;            // Exchange timestamp (ms)
+
+    // ==================== Conversions ====================
+
+    /**
+     * @brief Pack a legacy Tick, interning its inst_id (or symbol if empty)
+     */
+    static void FromTick(const Tick& tick, TickPOD& pod);
+
+    /**
+     * @brief Rebuild a legacy Tick; symbol and inst_id both get the name
+     */
+    void ToTick(Tick& tick) const;
+
+    const std::string& Symbol() const { return SymbolTable::Global().Name(symbol_id); }
+
+    static Platform PlatformFromString(std::string_view platform);
+    static const char* PlatformName(Platform platform);
+};
+
+static_assert(sizeof(TickPOD) <= 64, "TickPOD must fit one cache line");
+static_assert(std::is_trivially_copyable<TickPOD>::value, "TickPOD must be trivially copyable");
+
+#endif // TICK_POD_H
@@ -0,0 +1,283 @@
+#ifndef TRADE_STORE_H
+#define TRADE_STORE_H
+
+#include "okx_rest_api.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Local append-only columnar store of fills, orders and bills
+ *
+ * Keeps account history on disk so PnL and fee reports run without
+ * touching the network. Each table is a set of column files in one
+ * directory (fills.fee.col, bills.ts.col, ...), each a flat array of
+ * fixed-width values that is memory-mapped and grown in steps of
+ * kGrowRows; a mapped <table>.meta header holds the committed row count
+ * and the highest id stored. Strings (instId, currency, side, state...)
+ * are dictionary-encoded into strings.dict, so every column is 4 or 8
+ * bytes wide and a scan touches only the columns it reads.
+ *
+ * Rows are only ever appended, each id (billId, ordId) once, and become
+ * visible when the row count in the header is advanced after their
+ * values (and any new dictionary entries) are written, so a crash
+ * mid-append loses at most that append. Sync* pulls what is new through
+ * the Iterate* pagers of OKXRestAPI and appends it in one go; how far
+ * back each query has been synced is kept per query in sync.marks.
+ *
+ * Appends take an exclusive lock, reads a shared one. POSIX mmap on
+ * Linux, file mappings on Windows.
+ */
+class TradeStore {
+public:
+    static constexpr uint32_t kMagic = 0x53584B4F;       // "OKXS"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kGrowRows = 16384;           // Column growth step
+    static constexpr uint64_t kDayMs = 86400000;
+    static constexpr uint64_t kOrderLookbackMs = kDayMs; // Default SetOrderLookback()
+
+    enum class Table : uint8_t {
+        kFills,
+        kOrders,
+        kBills,
+        kCount
+    };
+
+    /**
+     * @brief Row filter; empty / zero fields match everything
+     */
+    struct Filter {
+        std::string inst_id;
+        std::string currency;       // Fee currency of fills, ccy of bills
+        uint64_t begin_time = 0;    // Inclusive, ms (fillTime / cTime / ts)
+        uint64_t end_time = 0;      // Exclusive, ms
+    };
+
+    /**
+     * @brief Fills of one UTC day, instrument and fee currency
+     */
+    struct DailyFees {
+        uint64_t day;               // Start of the day, ms
+        std::string inst_id;
+        std::string currency;
+        size_t fills;
+        double volume;              // Sum of fill sizes
+        double notional;            // Sum of price * size
+        double fee;                 // Sum of fees (negative when paid)
+    };
+
+    /**
+     * @brief Bills of one UTC day, currency and bill type
+     */
+    struct DailyBills {
+        uint64_t day;
+        std::string currency;
+        int bill_type;
+        size_t bills;
+        double balance_change;
+        double fee;
+    };
+
+    TradeStore();
+    ~TradeStore();
+
+    TradeStore(const TradeStore&) = delete;
+    TradeStore& operator=(const TradeStore&) = delete;
+
+    /**
+     * @brief Open the store in a directory, creating it and its files if needed
+     */
+    bool Open(const std::string& directory);
+    void Close();
+    bool IsOpen() const { return open_; }
+
+    /**
+     * @brief Write mapped pages back to disk
+     */
+    bool Flush();
+
+    // ==================== Writing ====================
+
+    /**
+     * @brief Append records whose id is not stored yet
+     *
+     * Records may come in any order (OKX pages are newest first); each
+     * batch is stored by ascending id, and ids already in the table are
+     * skipped. Returns the number of rows added.
+     */
+    size_t AppendFills(const std::vector<OKXRestAPI::Fill>& fills);
+    size_t AppendOrders(const std::vector<Order>& orders);
+    size_t AppendBills(const std::vector<OKXRestAPI::Bill>& bills);
+
+    /**
+     * @brief Fetch and append what earlier syncs of the same query missed
+     *
+     * Every distinct query (instType, instId, state, type, begin / end
+     * time) keeps its own mark, so syncing one instrument never hides the
+     * older records of another. Fills and bills walk newest to oldest down
+     * to the highest billId the query has stored.
+     *
+     * Orders come from orders-history, which lists an order only once it
+     * is filled or canceled, so an order created before the last sync can
+     * turn up below ordIds already stored. The order walk goes back to the
+     * newest cTime the query has seen less the order lookback, and skips
+     * ordIds already stored; orders left live for longer than the lookback
+     * are missed unless it is widened.
+     *
+     * Pages are fetched one at a time, without prefetch, so a sync that
+     * stops in the first page costs one request. If a page fails nothing
+     * is appended and the mark is kept, so the next sync retries the
+     * whole gap.
+     */
+    bool SyncFills(OKXRestAPI& api, const OKXRestAPI::HistoryQuery& query, size_t* added = nullptr);
+    bool SyncOrders(OKXRestAPI& api, const OKXRestAPI::HistoryQuery& query, size_t* added = nullptr);
+    bool SyncBills(OKXRestAPI& api, const OKXRestAPI::HistoryQuery& query, size_t* added = nullptr);
+
+    void SetOrderLookback(uint64_t lookback_ms) { order_lookback_ms_ = lookback_ms; }
+
+    // ==================== Reading ====================
+
+    size_t Rows(Table table) const;
+
+    /**
+     * @brief Highest billId (fills, bills) or ordId (orders) stored; 0 if empty
+     */
+    uint64_t LastId(Table table) const;
+
+    bool GetFill(size_t row, OKXRestAPI::Fill& fill) const;
+    bool GetOrder(size_t row, Order& order) const;
+    bool GetBill(size_t row, OKXRestAPI::Bill& bill) const;
+
+    /**
+     * @brief Call visit for every matching row, in row order; returns the count
+     */
+    size_t ScanFills(const Filter& filter, const std::function<void(const OKXRestAPI::Fill&)>& visit) const;
+    size_t ScanOrders(const Filter& filter, const std::function<void(const Order&)>& visit) const;
+    size_t ScanBills(const Filter& filter, const std::function<void(const OKXRestAPI::Bill&)>& visit) const;
+
+    /**
+     * @brief Fees per UTC day per instrument, ordered by day, instId, currency
+     */
+    std::vector<DailyFees> FeesByDay(const Filter& filter) const;
+
+    /**
+     * @brief Bills per UTC day per currency and type, ordered the same way
+     */
+    std::vector<DailyBills> BillsByDay(const Filter& filter) const;
+
+private:
+    static constexpr size_t kTableCount = static_cast<size_t>(Table::kCount);
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t table;
+        uint32_t column_count;
+        uint64_t rows;              // Committed rows
+        uint64_t last_id;
+        char reserved[32];
+    };
+    static_assert(sizeof(Header) == 64, "Table header must be one cache line");
+
+    // A file mapped read-write, grown by remapping
+    class MappedFile {
+    public:
+        MappedFile();
+        ~MappedFile();
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::string& path, size_t min_size);
+        bool Grow(size_t size);
+        bool Sync();
+        void Close();
+
+        char* Data() const { return data_; }
+        size_t Size() const { return size_; }
+
+    private:
+        bool Map(size_t size);
+        void Unmap();
+
+        std::string path_;
+        char* data_;
+        size_t size_;
+#if defined(_WIN32)
+        void* file_;
+        void* mapping_;
+#else
+        int fd_;
+#endif
+    };
+
+    struct TableState {
+        Header* header = nullptr;
+        MappedFile meta;
+        std::vector<MappedFile> columns;
+        std::vector<uint32_t> widths;
+        size_t capacity = 0;        // Rows every column file can hold
+        std::unordered_set<uint64_t> ids;   // Every id stored (column 0)
+    };
+
+    // Row resolved against the filter's dictionary ids
+    struct CompiledFilter {
+        bool empty = false;         // Names a string the store has never seen
+        uint32_t inst_id = 0;
+        uint32_t currency = 0;
+        bool by_inst = false;
+        bool by_currency = false;
+        uint64_t begin_time = 0;
+        uint64_t end_time = 0;
+    };
+
+    bool OpenTable(Table table);
+    bool LoadMarks();
+    bool SaveMarks();
+    bool Reserve(TableState& state, size_t rows);
+    void Commit(TableState& state, size_t rows, uint64_t last_id);
+
+    template <typename V>
+    V* Column(Table table, size_t column) const {
+        return reinterpret_cast<V*>(tables_[static_cast<size_t>(table)].columns[column].Data());
+    }
+
+    // Dictionary (caller holds the exclusive lock for Intern)
+    uint32_t Intern(const std::string& value);
+    const std::string& Lookup(uint32_t id) const;
+    bool FlushDictionary();
+    CompiledFilter Compile(const Filter& filter) const;
+    static bool Matches(const CompiledFilter& filter, uint32_t inst_id, uint32_t currency, uint64_t time);
+
+    void ReadFill(size_t row, OKXRestAPI::Fill& fill) const;
+    void ReadOrder(size_t row, Order& order) const;
+    void ReadBill(size_t row, OKXRestAPI::Bill& bill) const;
+
+    // Sync marks: highest billId (fills, bills) or cTime (orders) per query
+    static std::string SyncKey(Table table, const OKXRestAPI::HistoryQuery& query);
+    uint64_t GetMark(const std::string& key) const;
+    // Raises the mark once every id in ids is stored
+    bool CommitMark(Table table, const std::string& key, uint64_t mark, const std::vector<uint64_t>& ids);
+
+    bool open_;
+    std::string directory_;
+    TableState tables_[kTableCount];
+
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, uint32_t> string_ids_;
+    std::string pending_strings_;   // Interned, not yet written to strings.dict
+
+    std::map<std::string, uint64_t> marks_;
+    uint64_t order_lookback_ms_;
+
+    mutable std::shared_mutex mutex_;
+};
+
+#endif // TRADE_STORE_H
@@ -0,0 +1,161 @@
+#include "clock_sync.h"
+#include "okx_rest_api.h"
+#include "okx_signer.h"
+#include <cmath>
+
+// Times only the request on the wire, not the wait for the rate limiter or retries
+ClockSync::ClockSync(OKXRestAPI& api)
+    : ClockSync(TimedServerTimeSource([&api](int64_t& send_us, int64_t& receive_us) {
+        return api.GetServerTime(send_us, receive_us);
+    })) {
+}
+
+ClockSync::ClockSync(ServerTimeSource source)
+    : ClockSync(source ? TimedServerTimeSource([source](int64_t& send_us, int64_t& receive_us) {
+        send_us = LocalNowUs();
+        int64_t server_ms = source();
+        receive_us = LocalNowUs();
+        return server_ms;
+    }) : TimedServerTimeSource()) {
+}
+
+ClockSync::ClockSync(TimedServerTimeSource source)
+    : source_(std::move(source))
+    , window_{}
+    , window_count_(0)
+    , window_next_(0)
+    , max_rtt_us_(2000000)
+    , running_(false) {
+}
+
+ClockSync::~ClockSync() {
+    Stop();
+}
+
+bool ClockSync::SyncOnce() {
+    int64_t send_us = 0, receive_us = 0;
+    int64_t server_ms = source_ ? source_(send_us, receive_us) : 0;
+
+    if (server_ms <= 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        estimate_.rejected++;
+        return false;
+    }
+    if (!AddSample(send_us, server_ms, receive_us)) {
+        return false;
+    }
+    Apply();
+    return true;
+}
+
+int ClockSync::Sync(int rounds) {
+    int accepted = 0;
+    for (int i = 0; i < rounds; i++) {
+        accepted += SyncOnce() ? 1 : 0;
+    }
+    return accepted;
+}
+
+bool ClockSync::AddSample(int64_t send_us, int64_t server_ms, int64_t receive_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int64_t rtt_us = receive_us - send_us;
+    if (rtt_us < 0 || rtt_us > max_rtt_us_) {
+        estimate_.rejected++;
+        return false;
+    }
+
+    // Middle of the reported millisecond vs middle of the round trip
+    Sample& sample = window_[window_next_];
+    sample.offset_us = server_ms * 1000 + 500 - (send_us + rtt_us / 2);
+    sample.rtt_us = rtt_us;
+    window_next_ = (window_next_ + 1) % kWindow;
+    if (window_count_ < kWindow) {
+        window_count_++;
+    }
+
+    estimate_.samples++;
+    UpdateEstimate();
+    return true;
+}
+
+void ClockSync::UpdateEstimate() {
+    const Sample* best = &window_[0];
+    for (size_t i = 1; i < window_count_; i++) {
+        if (window_[i].rtt_us < best->rtt_us) {
+            best = &window_[i];
+        }
+    }
+
+    double sum_squares = 0;
+    for (size_t i = 0; i < window_count_; i++) {
+        double delta = static_cast<double>(window_[i].offset_us - best->offset_us);
+        sum_squares += delta * delta;
+    }
+
+    estimate_.offset_us = best->offset_us;
+    estimate_.rtt_us = best->rtt_us;
+    estimate_.jitter_us = static_cast<int64_t>(std::sqrt(sum_squares / window_count_));
+    estimate_.valid = true;
+}
+
+ClockSync::Estimate ClockSync::GetEstimate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return estimate_;
+}
+
+void ClockSync::Apply() const {
+    Estimate estimate = GetEstimate();
+    if (estimate.valid) {
+        OKXSigner::SetClockOffsetUs(estimate.offset_us);
+    }
+}
+
+void ClockSync::SetMaxRtt(std::chrono::microseconds max_rtt) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_rtt_us_ = max_rtt.count();
+}
+
+bool ClockSync::Start(std::chrono::milliseconds interval) {
+    if (running_.exchange(true)) {
+        return false;
+    }
+    thread_ = std::thread([this, interval] { Run(interval); });
+    return true;
+}
+
+void ClockSync::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void ClockSync::Run(std::chrono::milliseconds interval) {
+    // A short burst first so the min-RTT filter has something to choose from
+    const int burst = 4;
+    for (int i = 0; i < burst && running_; i++) {
+        SyncOnce();
+    }
+
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (running_) {
+        if (wake_.wait_for(lock, interval, [this] { return !running_; })) {
+            break;
+        }
+        lock.unlock();
+        SyncOnce();
+        lock.lock();
+    }
+}
+
+int64_t ClockSync::LocalNowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
@@ -1,102 +1,257 @@
 #include "config.h"
+#include "spread_engine.h"
 #include <fstream>
 #include <iostream>
 
+namespace {
+    template <typename T>
+    T Field(const json& object, const char* key) {
+        return object.at(key).get<T>();
+    }
+
+    // 可选的节：存在时必须是对象
+    const json* Section(const json& object, const std::string& key) {
+        auto it = object.find(key);
+        if (it == object.end()) {
+            return nullptr;
+        }
+        if (!it->is_object()) {
+            throw std::invalid_argument("\"" + key + "\" is not an object");
+        }
+        return &*it;
+    }
+
+    void ReadSymbols(const json* section, std::map<std::string, std::string>& symbols) {
+        const json* mapping = section ? Section(*section, "symbols") : nullptr;
+        if (mapping) {
+            for (auto it = mapping->begin(); it != mapping->end(); ++it) {
+                symbols[it.key()] = it.value().get<std::string>();
+            }
+        }
+    }
+
+    std::string ValidateStrategy(const StrategyParams& p) {
+        if (p.first_order < 0 || p.next_order < 0 || p.take_profit < 0) {
+            return "strategy spreads must not be negative";
+        }
+        if (p.max_orders < 0 || p.max_orders > static_cast<int>(SpreadEngine::kMaxLevels)) {
+            return "strategy.max_orders must be in [0, " + std::to_string(SpreadEngine::kMaxLevels) + "]";
+        }
+        if (p.okx_fee_rate < 0 || p.okx_fee_rate >= 0.1 || p.mt5_fee_rate < 0 || p.mt5_fee_rate >= 0.1) {
+            return "strategy fee rates must be in [0, 0.1)";
+        }
+        if (p.okx_order_size < 0 || p.mt5_order_size < 0) {
+            return "strategy order sizes must not be negative";
+        }
+        return "";
+    }
+}
+
+// ==================== ConfigSnapshot ====================
+
+bool ConfigSnapshot::Build(const json& config, const std::string& environment,
+                           ConfigSnapshot& snapshot, std::string& error) {
+    try {
+        snapshot = ConfigSnapshot();
+        snapshot.environment = environment.empty() ? Field<std::string>(config, "environment") : environment;
+
+        const json* okx = Section(config, "okx");
+        const json* okx_account = okx ? Section(*okx, snapshot.environment) : nullptr;
+        if (okx_account) {
+            snapshot.okx.api_key = Field<std::string>(*okx_account, "api_key");
+            snapshot.okx.secret_key = Field<std::string>(*okx_account, "secret_key");
+            snapshot.okx.passphrase = Field<std::string>(*okx_account, "passphrase");
+            snapshot.okx.rest_url = Field<std::string>(*okx_account, "rest_url");
+            snapshot.okx.ws_public = Field<std::string>(*okx_account, "ws_public");
+            snapshot.okx.ws_private = Field<std::string>(*okx_account, "ws_private");
+        }
+        ReadSymbols(okx, snapshot.okx_symbols);
+
+        const json* mt5 = Section(config, "mt5");
+        const json* mt5_account = mt5 ? Section(*mt5, snapshot.environment) : nullptr;
+        if (mt5_account) {
+            snapshot.mt5.server = Field<std::string>(*mt5_account, "server");
+            snapshot.mt5.login = Field<int>(*mt5_account, "login");
+            snapshot.mt5.password = Field<std::string>(*mt5_account, "password");
+        }
+        ReadSymbols(mt5, snapshot.mt5_symbols);
+
+        const json* strategy = Section(config, "strategy");
+        if (strategy) {
+            StrategyParams& p = snapshot.strategy;
+            p.first_order = Field<double>(*strategy, "first_order");
+            p.next_order = Field<double>(*strategy, "next_order");
+            p.max_orders = Field<int>(*strategy, "max_orders");
+            p.take_profit = Field<double>(*strategy, "take_profit");
+            p.okx_fee_rate = Field<double>(*strategy, "okx_fee_rate");
+            p.mt5_fee_rate = Field<double>(*strategy, "mt5_fee_rate");
+            p.okx_order_size = Field<double>(*strategy, "okx_order_size");
+            p.mt5_order_size = Field<double>(*strategy, "mt5_order_size");
+        }
+    }
+    catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+
+    error = ValidateStrategy(snapshot.strategy);
+    return error.empty();
+}
+
+// ==================== Config ====================
+
+Config::Config()
+    : snapshot_(std::make_shared<const ConfigSnapshot>())
+    , version_(0) {
+}
+
 bool Config::Load(const std::string& filepath) {
+    json config;
     try {
         std::ifstream file(filepath);
         if (!file.is_open()) {
             std::cerr << "Failed to open config file: " << filepath << std::endl;
             return false;
         }
-        
-        file >> config_;
-        environment_ = config_["environment"].get<std::string>();
-        
-        std::cout << "Config loaded successfully, environment: " << environment_ << std::endl;
-        return true;
+        file >> config;
     }
     catch (const std::exception& e) {
         std::cerr << "Failed to load config: " << e.what() << std::endl;
         return false;
     }
+
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    if (!Publish(config, environment_)) {
+        return false;
+    }
+    config_ = std::move(config);
+
+    std::cout << "Config loaded successfully, environment: " << GetEnvironment() << std::endl;
+    return true;
+}
+
+void Config::SetEnvironment(const std::string& env) {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    if (Publish(config_, env)) {
+        environment_ = env;
+    }
+}
+
+bool Config::Publish(const json& config, const std::string& environment) {
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+    std::string error;
+    if (!ConfigSnapshot::Build(config, environment, *snapshot, error)) {
+        std::cerr << "Failed to load config: " << error << std::endl;
+        return false;
+    }
+
+    snapshot->version = version_.load(std::memory_order_relaxed) + 1;
+    std::atomic_store_explicit(&snapshot_, std::shared_ptr<const ConfigSnapshot>(std::move(snapshot)),
+                               std::memory_order_release);
+    version_.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+std::shared_ptr<const ConfigSnapshot> Config::GetSnapshot() const {
+    return std::atomic_load_explicit(&snapshot_, std::memory_order_acquire);
 }
 
 // OKX配置
 std::string Config::GetOKXAPIKey() const {
-    return config_["okx"][environment_]["api_key"].get<std::string>();
+    return GetSnapshot()->okx.api_key;
 }
 
 std::string Config::GetOKXSecretKey() const {
-    return config_["okx"][environment_]["secret_key"].get<std::string>();
+    return GetSnapshot()->okx.secret_key;
 }
 
 std::string Config::GetOKXPassphrase() const {
-    return config_["okx"][environment_]["passphrase"].get<std::string>();
+    return GetSnapshot()->okx.passphrase;
 }
 
 std::string Config::GetOKXRESTURL() const {
-    return config_["okx"][environment_]["rest_url"].get<std::string>();
+    return GetSnapshot()->okx.rest_url;
 }
 
 std::string Config::GetOKXWSPublic() const {
-    return config_["okx"][environment_]["ws_public"].get<std::string>();
+    return GetSnapshot()->okx.ws_public;
 }
 
 std::string Config::GetOKXWSPrivate() const {
-    return config_["okx"][environment_]["ws_private"].get<std::string>();
+    return GetSnapshot()->okx.ws_private;
 }
 
 std::string Config::GetOKXSymbol(const std::string& base) const {
-    return config_["okx"]["symbols"][base].get<std::string>();
+    auto snapshot = GetSnapshot();
+    auto it = snapshot->okx_symbols.find(base);
+    return it != snapshot->okx_symbols.end() ? it->second : std::string();
+}
+
+std::vector<std::string> Config::GetSymbolBases() const {
+    auto snapshot = GetSnapshot();
+    std::vector<std::string> bases;
+    for (const auto& entry : snapshot->okx_symbols) {
+        bases.push_back(entry.first);
+    }
+    return bases;
 }
 
 // MT5配置
 std::string Config::GetMT5Server() const {
-    return config_["mt5"][environment_]["server"].get<std::string>();
+    return GetSnapshot()->mt5.server;
 }
 
 int Config::GetMT5Login() const {
-    return config_["mt5"][environment_]["login"].get<int>();
+    return GetSnapshot()->mt5.login;
 }
 
 std::string Config::GetMT5Password() const {
-    return config_["mt5"][environment_]["password"].get<std::string>();
+    return GetSnapshot()->mt5.password;
 }
 
 std::string Config::GetMT5Symbol(const std::string& base) const {
-    return config_["mt5"]["symbols"][base].get<std::string>();
+    auto snapshot = GetSnapshot();
+    auto it = snapshot->mt5_symbols.find(base);
+    return it != snapshot->mt5_symbols.end() ? it->second : std::string();
+}
+
+bool Config::HasMT5Symbol(const std::string& base) const {
+    return GetSnapshot()->mt5_symbols.count(base) != 0;
 }
 
 // 策略配置
+StrategyParams Config::GetStrategyParams() const {
+    return GetSnapshot()->strategy;
+}
+
 double Config::GetFirstOrder() const {
-    return config_["strategy"]["first_order"].get<double>();
+    return GetSnapshot()->strategy.first_order;
 }
 
 double Config::GetNextOrder() const {
-    return config_["strategy"]["next_order"].get<double>();
+    return GetSnapshot()->strategy.next_order;
 }
 
 int Config::GetMaxOrders() const {
-    return config_["strategy"]["max_orders"].get<int>();
+    return GetSnapshot()->strategy.max_orders;
 }
 
 double Config::GetTakeProfit() const {
-    return config_["strategy"]["take_profit"].get<double>();
+    return GetSnapshot()->strategy.take_profit;
 }
 
 double Config::GetOKXFeeRate() const {
-    return config_["strategy"]["okx_fee_rate"].get<double>();
+    return GetSnapshot()->strategy.okx_fee_rate;
 }
 
 double Config::GetMT5FeeRate() const {
-    return config_["strategy"]["mt5_fee_rate"].get<double>();
+    return GetSnapshot()->strategy.mt5_fee_rate;
 }
 
 double Config::GetOKXOrderSize() const {
-    return config_["strategy"]["okx_order_size"].get<double>();
+    return GetSnapshot()->strategy.okx_order_size;
 }
 
 double Config::GetMT5OrderSize() const {
-    return config_["strategy"]["mt5_order_size"].get<double>();
+    return GetSnapshot()->strategy.mt5_order_size;
 }
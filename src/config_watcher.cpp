@@ -0,0 +1,157 @@
+#include "config_watcher.h"
+#include <chrono>
+#include <iostream>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#endif
+
+ConfigWatcher::ConfigWatcher(Config& config)
+    : config_(config)
+    , running_(false)
+    , notify_fd_(-1)
+    , wake_fd_{-1, -1}
+    , accepted_(0)
+    , rejected_(0) {
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    Stop();
+}
+
+void ConfigWatcher::SetReloadCallback(ReloadCallback callback) {
+    reload_callback_ = std::move(callback);
+}
+
+bool ConfigWatcher::Start(const std::string& path) {
+    if (running_) {
+        return false;
+    }
+
+    path_ = path;
+    size_t slash = path.find_last_of("/\\");
+    directory_ = slash == std::string::npos ? "." : path.substr(0, slash);
+    file_name_ = slash == std::string::npos ? path : path.substr(slash + 1);
+
+#if defined(__linux__)
+    notify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify_fd_ < 0) {
+        std::cerr << "ConfigWatcher: inotify_init1 failed" << std::endl;
+        return false;
+    }
+    // Watch the directory: editors and deploy tools replace the file by rename
+    if (inotify_add_watch(notify_fd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+        pipe(wake_fd_) != 0) {
+        std::cerr << "ConfigWatcher: cannot watch " << directory_ << std::endl;
+        close(notify_fd_);
+        notify_fd_ = -1;
+        return false;
+    }
+#endif
+
+    running_ = true;
+    thread_ = std::thread([this] { Run(); });
+    return true;
+}
+
+void ConfigWatcher::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+#if defined(__linux__)
+    char wake = 1;
+    if (write(wake_fd_[1], &wake, 1) < 0) {
+        // The poll timeout still ends the thread
+    }
+#endif
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+#if defined(__linux__)
+    close(notify_fd_);
+    close(wake_fd_[0]);
+    close(wake_fd_[1]);
+    notify_fd_ = wake_fd_[0] = wake_fd_[1] = -1;
+#endif
+}
+
+bool ConfigWatcher::Reload() {
+    if (!config_.Load(path_)) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    accepted_.fetch_add(1, std::memory_order_relaxed);
+    if (reload_callback_) {
+        reload_callback_(*config_.GetSnapshot());
+    }
+    return true;
+}
+
+ConfigWatcher::Statistics ConfigWatcher::GetStatistics() const {
+    Statistics stats;
+    stats.accepted = accepted_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#if defined(__linux__)
+
+void ConfigWatcher::Run() {
+    alignas(inotify_event) char buffer[4096];
+    pollfd fds[2] = {{notify_fd_, POLLIN, 0}, {wake_fd_[0], POLLIN, 0}};
+    bool pending = false;
+
+    while (running_) {
+        // While a change is pending, wait only for the settle time
+        int ready = poll(fds, 2, pending ? kSettleMs : 1000);
+        if (!running_) {
+            break;
+        }
+
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            ssize_t length;
+            while ((length = read(notify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + length;) {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    if (event->len > 0 && file_name_ == event->name) {
+                        pending = true;
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+            continue;
+        }
+
+        if (ready == 0 && pending) {
+            pending = false;
+            Reload();
+        }
+    }
+}
+
+#else
+
+void ConfigWatcher::Run() {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::file_time_type last_write = fs::last_write_time(path_, error);
+
+    while (running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        fs::file_time_type write_time = fs::last_write_time(path_, error);
+        if (!error && write_time != last_write) {
+            last_write = write_time;
+            std::this_thread::sleep_for(std::chrono::milliseconds(kSettleMs));
+            Reload();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,164 @@
+#include "depth_pricer.h"
+#include "order_book.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    // Index of the lowest set bit; mask is non-zero
+    inline size_t LowestBit(int mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, static_cast<unsigned long>(mask));
+        return static_cast<size_t>(index);
+#else
+        return static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+#endif
+    }
+}
+
+void DepthPricer::Table::Add(double px, double sz) {
+    double prev_filled = count ? filled[count - 1] : 0.0;
+    double prev_cost = count ? cost[count - 1] : 0.0;
+
+    if (count == price.size()) {
+        price.push_back(px);
+        filled.push_back(prev_filled + sz);
+        cost.push_back(prev_cost + px * sz);
+    } else {
+        price[count] = px;
+        filled[count] = prev_filled + sz;
+        cost[count] = prev_cost + px * sz;
+    }
+    count++;
+}
+
+void DepthPricer::Build(const Depth& depth) {
+    bids_.Clear();
+    asks_.Clear();
+    for (const auto& level : depth.bids) {
+        bids_.Add(level.price, level.size);
+    }
+    for (const auto& level : depth.asks) {
+        asks_.Add(level.price, level.size);
+    }
+}
+
+void DepthPricer::Build(const OrderBook& book, size_t max_levels) {
+    bids_.Clear();
+    asks_.Clear();
+    for (size_t i = 0; i < book.BidCount() && i < max_levels; i++) {
+        DepthLevel level = book.Bid(i);
+        bids_.Add(level.price, level.size);
+    }
+    for (size_t i = 0; i < book.AskCount() && i < max_levels; i++) {
+        DepthLevel level = book.Ask(i);
+        asks_.Add(level.price, level.size);
+    }
+}
+
+size_t DepthPricer::FindLevel(const Table& table, size_t start, double target) {
+    const double* filled = table.filled.data();
+    size_t n = table.count;
+    size_t i = start;
+
+#if defined(__AVX__)
+    __m256d t4 = _mm256_set1_pd(target);
+    for (; i + 4 <= n; i += 4) {
+        int mask = _mm256_movemask_pd(
+            _mm256_cmp_pd(_mm256_loadu_pd(filled + i), t4, _CMP_GE_OQ));
+        if (mask) {
+            return i + LowestBit(mask);
+        }
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128d t2 = _mm_set1_pd(target);
+    for (; i + 4 <= n; i += 4) {
+        int lo = _mm_movemask_pd(_mm_cmpge_pd(_mm_loadu_pd(filled + i), t2));
+        int hi = _mm_movemask_pd(_mm_cmpge_pd(_mm_loadu_pd(filled + i + 2), t2));
+        int mask = lo | (hi << 2);
+        if (mask) {
+            return i + LowestBit(mask);
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (filled[i] >= target) {
+            return i;
+        }
+    }
+    return n;
+}
+
+Price DepthPricer::PriceAt(const Table& table, size_t level, double target) {
+    double filled_before = level ? table.filled[level - 1] : 0.0;
+    double cost_before = level ? table.cost[level - 1] : 0.0;
+    return (cost_before + (target - filled_before) * table.price[level]) / target;
+}
+
+Price DepthPricer::AvgPrice(Side side, Volume target_size) const {
+    const Table& table = TableFor(side);
+    if (target_size <= 0) {
+        return 0;
+    }
+
+    size_t level = FindLevel(table, 0, target_size);
+    return level < table.count ? PriceAt(table, level, target_size) : 0;
+}
+
+void DepthPricer::AvgPrices(Side side, const Volume* targets, size_t count, Price* out) const {
+    const Table& table = TableFor(side);
+    size_t level = 0;
+    double previous = 0;
+
+    for (size_t j = 0; j < count; j++) {
+        double target = targets[j];
+        if (target <= 0) {
+            out[j] = 0;
+            continue;
+        }
+
+        // Sorted ladders continue from the previous level
+        if (target < previous) {
+            level = 0;
+        }
+        previous = target;
+
+        level = FindLevel(table, level, target);
+        out[j] = level < table.count ? PriceAt(table, level, target) : 0;
+    }
+}
+
+void DepthPricer::AvgPrices(Side side, const std::vector<Volume>& targets,
+                            std::vector<Price>& out) const {
+    out.resize(targets.size());
+    AvgPrices(side, targets.data(), targets.size(), out.data());
+}
+
+void DepthPricer::AvgPricesForLadder(Side side, Volume step, size_t count, Price* out) const {
+    const Table& table = TableFor(side);
+    size_t level = 0;
+
+    for (size_t j = 0; j < count; j++) {
+        double target = step * static_cast<double>(j + 1);
+        if (target <= 0) {
+            out[j] = 0;
+            continue;
+        }
+        level = FindLevel(table, level, target);
+        out[j] = level < table.count ? PriceAt(table, level, target) : 0;
+    }
+}
+
+Volume DepthPricer::AvailableSize(Side side) const {
+    const Table& table = TableFor(side);
+    return table.count ? table.filled[table.count - 1] : 0;
+}
@@ -0,0 +1,166 @@
+#include "fixed_point.h"
+#include <charconv>
+#include <cmath>
+
+namespace {
+    const int64_t kPow10[] = {
+        1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+        100000000LL, 1000000000LL, 10000000000LL, 100000000000LL,
+        1000000000000LL, 10000000000000LL, 100000000000000LL,
+        1000000000000000LL
+    };
+
+    inline bool IsDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // Plain decimal text -> integer units of 10^-decimals. Digits beyond
+    // `decimals` must be zero. No exponent form (OKX never sends one).
+    bool ParseUnits(std::string_view text, int decimals, int64_t& units) {
+        bool negative = false;
+        size_t i = 0;
+        if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+            negative = text[i] == '-';
+            i++;
+        }
+
+        uint64_t value = 0;
+        int fraction_digits = 0;
+        bool any_digit = false;
+        bool in_fraction = false;
+
+        for (; i < text.size(); i++) {
+            char c = text[i];
+            if (c == '.' && !in_fraction) {
+                in_fraction = true;
+                continue;
+            }
+            if (!IsDigit(c)) {
+                return false;
+            }
+            any_digit = true;
+
+            if (in_fraction && fraction_digits == decimals) {
+                if (c != '0') {
+                    return false;  // Finer than the grid
+                }
+                continue;
+            }
+            if (in_fraction) {
+                fraction_digits++;
+            }
+
+            if (value > (static_cast<uint64_t>(INT64_MAX) - 9) / 10) {
+                return false;
+            }
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+
+        if (!any_digit) {
+            return false;
+        }
+
+        int64_t scale = kPow10[decimals - fraction_digits];
+        if (value > static_cast<uint64_t>(INT64_MAX / scale)) {
+            return false;
+        }
+
+        units = static_cast<int64_t>(value) * scale;
+        if (negative) {
+            units = -units;
+        }
+        return true;
+    }
+}
+
+bool FixedScale::FromStep(std::string_view step, FixedScale& scale) {
+    size_t dot = step.find('.');
+    int decimals = 0;
+    if (dot != std::string_view::npos) {
+        // "0.010" has the same grid as "0.01"
+        size_t last = step.find_last_not_of('0');
+        decimals = last > dot ? static_cast<int>(last - dot) : 0;
+    }
+    if (decimals > kMaxDecimals) {
+        return false;
+    }
+
+    int64_t units = 0;
+    if (!ParseUnits(step, decimals, units) || units <= 0) {
+        return false;
+    }
+
+    scale.decimals_ = decimals;
+    scale.step_ = units;
+    return true;
+}
+
+bool FixedScale::FromStep(double step, FixedScale& scale) {
+    if (!(step > 0)) {
+        return false;
+    }
+
+    char text[64];
+    auto result = std::to_chars(text, text + sizeof(text), step, std::chars_format::fixed);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    return FromStep(std::string_view(text, static_cast<size_t>(result.ptr - text)), scale);
+}
+
+bool FixedScale::Parse(std::string_view text, int64_t& steps) const {
+    int64_t units = 0;
+    if (!Valid() || !ParseUnits(text, decimals_, units) || units % step_ != 0) {
+        return false;
+    }
+    steps = units / step_;
+    return true;
+}
+
+int64_t FixedScale::Round(double value) const {
+    if (!Valid()) {
+        return 0;
+    }
+    return std::llround(value * static_cast<double>(kPow10[decimals_]) /
+                        static_cast<double>(step_));
+}
+
+double FixedScale::ToDouble(int64_t steps) const {
+    // Exact integer divided by an exact power of ten: correctly rounded
+    return static_cast<double>(steps * step_) / static_cast<double>(kPow10[decimals_]);
+}
+
+size_t FixedScale::Format(int64_t steps, char* out) const {
+    int64_t units = steps * step_;
+    uint64_t magnitude = units < 0 ? 0 - static_cast<uint64_t>(units)
+                                   : static_cast<uint64_t>(units);
+    uint64_t divisor = static_cast<uint64_t>(kPow10[decimals_]);
+    uint64_t integer = magnitude / divisor;
+    uint64_t fraction = magnitude % divisor;
+
+    char* p = out;
+    if (units < 0) {
+        *p++ = '-';
+    }
+    p = std::to_chars(p, out + kMaxFormatLength, integer).ptr;
+
+    if (fraction != 0) {
+        *p++ = '.';
+        char* digits = p;
+        for (int i = decimals_ - 1; i >= 0; i--) {
+            digits[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        p += decimals_;
+        while (p[-1] == '0') {
+            --p;
+        }
+    }
+
+    return static_cast<size_t>(p - out);
+}
+
+std::string FixedScale::ToString(int64_t steps) const {
+    char text[kMaxFormatLength];
+    return std::string(text, Format(steps, text));
+}
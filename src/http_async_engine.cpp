@@ -0,0 +1,262 @@
+#include "http_async_engine.h"
+#include <iostream>
+
+HttpAsyncEngine::HttpAsyncEngine(const HttpClient::RequestOptions& options, CURLSH* share)
+    : options_(options)
+    , share_(share)
+    , multi_(nullptr)
+    , running_(false)
+    , next_token_(1)
+    , in_flight_(0) {
+}
+
+HttpAsyncEngine::~HttpAsyncEngine() {
+    Stop();
+}
+
+bool HttpAsyncEngine::Start() {
+    if (running_) {
+        return true;
+    }
+
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        std::cerr << "Failed to initialize CURL multi handle" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    io_thread_ = std::thread(&HttpAsyncEngine::Run, this);
+    return true;
+}
+
+void HttpAsyncEngine::Stop() {
+    // Cleared under queue_mutex_ so no Submit() can queue behind the I/O
+    // thread's final drain or wake multi_ after it is cleaned up
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        curl_multi_wakeup(multi_);
+    }
+
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+
+    for (CURL* handle : all_handles_) {
+        curl_easy_cleanup(handle);
+    }
+    all_handles_.clear();
+    idle_handles_.clear();
+
+    curl_multi_cleanup(multi_);
+    multi_ = nullptr;
+}
+
+uint64_t HttpAsyncEngine::Submit(Request request) {
+    if (!running_) {
+        curl_slist_free_all(request.headers);
+        return 0;
+    }
+
+    auto transfer = std::make_unique<Transfer>();
+    transfer->token = next_token_.fetch_add(1, std::memory_order_relaxed);
+    transfer->request = std::move(request);
+    transfer->response.status_code = 0;
+    transfer->response.response_time_ms = 0;
+    transfer->start_time = std::chrono::steady_clock::now();
+
+    uint64_t token = transfer->token;
+
+    // running_ is rechecked under the lock Stop() clears it with: a queued
+    // transfer is always seen by the I/O thread, and multi_ is still alive
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (!running_) {
+        curl_slist_free_all(transfer->request.headers);
+        return 0;
+    }
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    queue_.push_back(std::move(transfer));
+    curl_multi_wakeup(multi_);
+    return token;
+}
+
+void HttpAsyncEngine::Run() {
+    std::vector<std::unique_ptr<Transfer>> batch;
+
+    while (running_) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            batch.swap(queue_);
+        }
+        StartTransfers(batch);
+
+        int still_running = 0;
+        curl_multi_perform(multi_, &still_running);
+
+        int msgs_left = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+            if (msg->msg == CURLMSG_DONE) {
+                FinishTransfer(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        // Sleeps until socket activity, a timeout, or curl_multi_wakeup()
+        curl_multi_poll(multi_, nullptr, 0, PollTimeoutMs(), nullptr);
+    }
+
+    // Fail everything that did not finish so no caller waits forever
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        batch.swap(queue_);
+    }
+    for (auto& transfer : deferred_) {
+        batch.push_back(std::move(transfer));
+    }
+    deferred_.clear();
+    for (auto& transfer : batch) {
+        transfer->response.body = "Async engine stopped";
+        curl_slist_free_all(transfer->request.headers);
+        Complete(*transfer);
+    }
+    batch.clear();
+
+    for (CURL* handle : all_handles_) {
+        Transfer* transfer = nullptr;
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &transfer);
+        if (transfer) {
+            curl_multi_remove_handle(multi_, handle);
+            std::unique_ptr<Transfer> owned(transfer);
+            owned->response.body = "Async engine stopped";
+            curl_slist_free_all(owned->request.headers);
+            curl_easy_setopt(handle, CURLOPT_PRIVATE, nullptr);
+            Complete(*owned);
+        }
+    }
+}
+
+void HttpAsyncEngine::StartTransfers(std::vector<std::unique_ptr<Transfer>>& batch) {
+    auto now = std::chrono::steady_clock::now();
+
+    // Requests still held back by the rate limiter join this round if due
+    for (auto it = deferred_.begin(); it != deferred_.end();) {
+        if ((*it)->request.not_before <= now) {
+            batch.push_back(std::move(*it));
+            it = deferred_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto& owned : batch) {
+        if (owned->request.not_before > now) {
+            deferred_.push_back(std::move(owned));
+            continue;
+        }
+
+        Transfer* transfer = owned.release();
+        const Request& request = transfer->request;
+
+        CURL* curl = TakeHandle();
+        if (!curl) {
+            std::unique_ptr<Transfer> failed(transfer);
+            failed->response.body = "Failed to initialize CURL";
+            curl_slist_free_all(failed->request.headers);
+            Complete(*failed);
+            continue;
+        }
+
+        curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+
+        HttpClient::SetMethod(curl, request.method.c_str(),
+                              request.body.c_str(), request.body.size());
+
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request.headers);
+        HttpClient::BindResponse(curl, transfer->response);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, transfer);
+
+        curl_multi_add_handle(multi_, curl);
+    }
+    batch.clear();
+}
+
+int HttpAsyncEngine::PollTimeoutMs() const {
+    int timeout_ms = 1000;
+    auto now = std::chrono::steady_clock::now();
+
+    for (const auto& transfer : deferred_) {
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+            transfer->request.not_before - now).count() + 1;
+        if (wait < timeout_ms) {
+            timeout_ms = wait > 0 ? static_cast<int>(wait) : 0;
+        }
+    }
+
+    return timeout_ms;
+}
+
+void HttpAsyncEngine::FinishTransfer(CURL* handle, CURLcode result) {
+    Transfer* transfer = nullptr;
+    curl_easy_getinfo(handle, CURLINFO_PRIVATE, &transfer);
+    curl_multi_remove_handle(multi_, handle);
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, nullptr);
+    curl_easy_setopt(handle, CURLOPT_HTTPHEADER, nullptr);
+    idle_handles_.push_back(handle);
+
+    if (!transfer) {
+        return;
+    }
+    std::unique_ptr<Transfer> owned(transfer);
+
+    if (result == CURLE_OK) {
+        long http_code = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &http_code);
+        owned->response.status_code = static_cast<int>(http_code);
+        HttpClient::ReadTimings(handle, owned->response.timings);
+    } else {
+        owned->response.body = curl_easy_strerror(result);
+        owned->response.status_code = 0;
+    }
+
+    curl_slist_free_all(owned->request.headers);
+    owned->request.headers = nullptr;
+    Complete(*owned);
+}
+
+void HttpAsyncEngine::Complete(Transfer& transfer) {
+    transfer.response.response_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - transfer.start_time).count();
+    transfer.response.response_time_ms = static_cast<long>(transfer.response.response_time_ns / 1000000);
+
+    if (transfer.request.on_complete) {
+        try {
+            transfer.request.on_complete(transfer.response);
+        } catch (const std::exception& e) {
+            std::cerr << "Async completion callback threw: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Async completion callback threw" << std::endl;
+        }
+    }
+
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+CURL* HttpAsyncEngine::TakeHandle() {
+    if (!idle_handles_.empty()) {
+        CURL* handle = idle_handles_.back();
+        idle_handles_.pop_back();
+        return handle;
+    }
+
+    // Same setup as HttpClient's pooled handles
+    CURL* curl = HttpClient::CreateHandle(options_, share_);
+    if (!curl) {
+        return nullptr;
+    }
+
+    all_handles_.push_back(curl);
+    return curl;
+}
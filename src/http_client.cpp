@@ -1,50 +1,188 @@
 #include "http_client.h"
+#include "http_async_engine.h"
 #include <chrono>
 #include <thread>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 HttpClient::HttpClient() 
-    : curl_(nullptr) {
+    : share_(nullptr) {
 }
 
 HttpClient::~HttpClient() {
-    if (curl_) {
-        curl_easy_cleanup(curl_);
-    }
+    // Stop the I/O thread before the shared CURLSH goes away
+    async_engine_.reset();
+    DestroyPool();
 }
 
 bool HttpClient::Initialize(const RequestOptions& options) {
     std::lock_guard<std::mutex> lock(mutex_);
     
     options_ = options;
+    if (options_.pool_size <= 0) {
+        options_.pool_size = 1;
+    }
+    
+    if (options_.max_requests_per_second > 0) {
+        RateLimiter::Limit limit;
+        limit.requests_per_second = options_.max_requests_per_second;
+        limit.burst = options_.max_requests_per_second;
+        rate_limiter_.SetLimit("*", limit);
+    }
     
     // Initialize libcurl
     curl_global_init(CURL_GLOBAL_DEFAULT);
-    curl_ = curl_easy_init();
     
-    if (!curl_) {
-        std::cerr << "Failed to initialize CURL" << std::endl;
-        return false;
+    async_engine_.reset();
+    DestroyPool();
+    
+    // DNS cache and TLS sessions are shared so a fresh handle can resume
+    // a session another handle already negotiated
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, ShareLock);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, ShareUnlock);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+    
+    std::lock_guard<std::mutex> pool_lock(pool_mutex_);
+    for (int i = 0; i < options_.pool_size; i++) {
+        CURL* handle = CreateHandle(options_, share_);
+        if (!handle) {
+            std::cerr << "Failed to initialize CURL" << std::endl;
+            for (CURL* h : handles_) {
+                curl_easy_cleanup(h);
+            }
+            handles_.clear();
+            idle_handles_.clear();
+            return false;
+        }
+        handles_.push_back(handle);
+        idle_handles_.push_back(handle);
+    }
+    
+    pool_stats_ = PoolStatistics();
+    pool_stats_.pool_size = handles_.size();
+    
+    return true;
+}
+
+CURL* HttpClient::CreateHandle(const RequestOptions& options, CURLSH* share) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return nullptr;
     }
     
     // Set default options
-    curl_easy_setopt(curl_, CURLOPT_TIMEOUT_MS, options_.timeout_ms);
-    curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT_MS, options_.connect_timeout_ms);
-    curl_easy_setopt(curl_, CURLOPT_FOLLOWLOCATION, options_.follow_redirects ? 1L : 0L);
-    curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, options_.verify_ssl ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, options.timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, options.connect_timeout_ms);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, options.follow_redirects ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, options.verify_ssl ? 1L : 0L);
+    
+    // Handles are used from several threads; never raise signals
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
     
     // Enable keep-alive for connection reuse
-    curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(curl_, CURLOPT_TCP_KEEPIDLE, 120L);
-    curl_easy_setopt(curl_, CURLOPT_TCP_KEEPINTVL, 60L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 120L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 60L);
+    
+    if (share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share);
+    }
     
     // Proxy settings
-    if (!options_.proxy_url.empty()) {
-        curl_easy_setopt(curl_, CURLOPT_PROXY, options_.proxy_url.c_str());
+    if (!options.proxy_url.empty()) {
+        curl_easy_setopt(curl, CURLOPT_PROXY, options.proxy_url.c_str());
     }
     
-    return true;
+    return curl;
+}
+
+void HttpClient::BindResponse(CURL* curl, Response& response) {
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response.body);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response.headers);
+}
+
+CURL* HttpClient::AcquireHandle() {
+    auto wait_start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(pool_mutex_);
+    
+    if (handles_.empty()) {
+        return nullptr;
+    }
+    
+    bool waited = false;
+    if (idle_handles_.empty()) {
+        waited = true;
+        pool_stats_.checkout_waits++;
+        
+        bool available = pool_cv_.wait_for(
+            lock,
+            std::chrono::milliseconds(options_.checkout_timeout_ms),
+            [this] { return !idle_handles_.empty(); });
+        
+        if (!available) {
+            pool_stats_.checkout_timeouts++;
+            return nullptr;
+        }
+    }
+    
+    CURL* handle = idle_handles_.back();
+    idle_handles_.pop_back();
+    
+    pool_stats_.checkouts++;
+    pool_stats_.in_use++;
+    if (pool_stats_.in_use > pool_stats_.peak_in_use) {
+        pool_stats_.peak_in_use = pool_stats_.in_use;
+    }
+    if (waited) {
+        pool_stats_.total_wait_ms += std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - wait_start).count();
+    }
+    
+    return handle;
+}
+
+void HttpClient::ReleaseHandle(CURL* handle) {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        idle_handles_.push_back(handle);
+        pool_stats_.in_use--;
+    }
+    pool_cv_.notify_one();
+}
+
+void HttpClient::DestroyPool() {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    
+    for (CURL* handle : handles_) {
+        curl_easy_cleanup(handle);
+    }
+    handles_.clear();
+    idle_handles_.clear();
+    
+    if (share_) {
+        curl_share_cleanup(share_);
+        share_ = nullptr;
+    }
+}
+
+void HttpClient::ShareLock(CURL* /*handle*/, curl_lock_data data,
+                           curl_lock_access /*access*/, void* userptr) {
+    auto* self = static_cast<HttpClient*>(userptr);
+    self->share_mutexes_[data].lock();
+}
+
+void HttpClient::ShareUnlock(CURL* /*handle*/, curl_lock_data data, void* userptr) {
+    auto* self = static_cast<HttpClient*>(userptr);
+    self->share_mutexes_[data].unlock();
 }
 
 HttpClient::Response HttpClient::Get(const std::string& url, 
@@ -74,35 +212,63 @@ void HttpClient::SetDefaultHeaders(const std::map<std::string, std::string>& hea
     default_headers_ = headers;
 }
 
+HttpClient::Statistics HttpClient::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
 void HttpClient::ResetStatistics() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    stats_ = Statistics();
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_ = Statistics();
+    }
+    response_times_.Reset();
+    
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    uint64_t in_use = pool_stats_.in_use;
+    pool_stats_ = PoolStatistics();
+    pool_stats_.pool_size = handles_.size();
+    pool_stats_.in_use = in_use;
+    pool_stats_.peak_in_use = in_use;
+}
+
+LatencyHistogram::Snapshot HttpClient::GetResponseTimeHistogram() const {
+    return response_times_.GetSnapshot();
+}
+
+HttpClient::PoolStatistics HttpClient::GetPoolStatistics() const {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return pool_stats_;
 }
 
 HttpClient::Response HttpClient::PerformRequest(const std::string& method,
                                                 const std::string& url,
                                                 const std::string& body,
                                                 const std::map<std::string, std::string>& headers) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     Response response;
     response.status_code = 0;
-    
-    if (!curl_) {
-        response.body = "CURL not initialized";
-        return response;
-    }
+    response.response_time_ms = 0;
     
     // Rate limiting
     RateLimit();
     
     auto start_time = std::chrono::steady_clock::now();
     
+    HandleLease lease(*this);
+    CURL* curl = lease.get();
+    
     // Retry logic
     int attempts = 0;
     bool success = false;
     
-    while (attempts < options_.max_retries && !success) {
+    // Build headers once; they do not change between attempts
+    struct curl_slist* chunk = curl ? BuildHeaderList(headers) : nullptr;
+    
+    if (!curl) {
+        response.body = "CURL not initialized or connection pool exhausted";
+    }
+    
+    while (curl && attempts < options_.max_retries && !success) {
         attempts++;
         
         // Reset response
@@ -110,65 +276,32 @@ HttpClient::Response HttpClient::PerformRequest(const std::string& method,
         response.headers.clear();
         
         // Set URL
-        curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         
         // Set method
-        if (method == "GET") {
-            curl_easy_setopt(curl_, CURLOPT_HTTPGET, 1L);
-        } else if (method == "POST") {
-            curl_easy_setopt(curl_, CURLOPT_POST, 1L);
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.c_str());
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, body.size());
-        } else if (method == "DELETE") {
-            curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, "DELETE");
-        } else if (method == "PUT") {
-            curl_easy_setopt(curl_, CURLOPT_CUSTOMREQUEST, "PUT");
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDS, body.c_str());
-            curl_easy_setopt(curl_, CURLOPT_POSTFIELDSIZE, body.size());
-        }
+        SetMethod(curl, method.c_str(), body.c_str(), body.size());
         
-        // Set headers
-        struct curl_slist* chunk = nullptr;
-        
-        // Add default headers
-        for (const auto& [key, value] : default_headers_) {
-            std::string header = key + ": " + value;
-            chunk = curl_slist_append(chunk, header.c_str());
-        }
-        
-        // Add custom headers (override defaults)
-        for (const auto& [key, value] : headers) {
-            std::string header = key + ": " + value;
-            chunk = curl_slist_append(chunk, header.c_str());
-        }
-        
-        curl_easy_setopt(curl_, CURLOPT_HTTPHEADER, chunk);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, chunk);
         
         // Set callbacks
-        curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response.body);
-        curl_easy_setopt(curl_, CURLOPT_HEADERFUNCTION, HeaderCallback);
-        curl_easy_setopt(curl_, CURLOPT_HEADERDATA, &response.headers);
+        BindResponse(curl, response);
         
         // Perform request
-        CURLcode res = curl_easy_perform(curl_);
-        
-        // Clean up headers
-        curl_slist_free_all(chunk);
+        CURLcode res = curl_easy_perform(curl);
         
         if (res == CURLE_OK) {
             // Get response code
             long http_code = 0;
-            curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &http_code);
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
             response.status_code = static_cast<int>(http_code);
+            ReadTimings(curl, response.timings);
             
             success = true;
-            stats_.successful_requests++;
         } else {
             response.body = curl_easy_strerror(res);
             response.status_code = 0;
             
-            // Exponential backoff for retry
+            // Exponential backoff for retry (only this handle is held)
             if (attempts < options_.max_retries) {
                 int delay_ms = 100 * (1 << attempts); // 100ms, 200ms, 400ms, ...
                 std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
@@ -176,23 +309,255 @@ HttpClient::Response HttpClient::PerformRequest(const std::string& method,
         }
     }
     
+    if (curl) {
+        // Drop references to this call's buffers before the handle is reused
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+    }
+    
+    // Clean up headers
+    curl_slist_free_all(chunk);
+    
     auto end_time = std::chrono::steady_clock::now();
-    response.response_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+    response.response_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
         end_time - start_time).count();
+    response.response_time_ms = static_cast<long>(response.response_time_ns / 1000000);
     
     // Update statistics
+    RecordRequest(success, body.size(), response.body.size(), response.response_time_ns);
+    
+    return response;
+}
+
+int HttpClient::PerformRaw(const RawRequest& request, std::string& response_body) {
+    auto start_time = std::chrono::steady_clock::now();
+    
+    // Rate limiting
+    RateLimit();
+    
+    HandleLease lease(*this);
+    CURL* curl = lease.get();
+    
+    int status_code = 0;
+    int attempts = 0;
+    bool success = false;
+    
+    if (!curl) {
+        response_body = "CURL not initialized or connection pool exhausted";
+    }
+    
+    while (curl && attempts < options_.max_retries && !success) {
+        attempts++;
+        response_body.clear();
+        
+        curl_easy_setopt(curl, CURLOPT_URL, request.url);
+        SetMethod(curl, request.method, request.body, request.body_length);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, request.headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_body);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, nullptr);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, nullptr);
+        
+        CURLcode res = curl_easy_perform(curl);
+        
+        if (res == CURLE_OK) {
+            long http_code = 0;
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
+            status_code = static_cast<int>(http_code);
+            if (request.timings) {
+                ReadTimings(curl, *request.timings);
+            }
+            success = true;
+        } else {
+            response_body = curl_easy_strerror(res);
+            if (attempts < options_.max_retries) {
+                int delay_ms = 100 * (1 << attempts);
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            }
+        }
+    }
+    
+    if (curl) {
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+    }
+    
+    int64_t response_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_time).count();
+    RecordRequest(success, request.body_length, response_body.size(), response_time_ns);
+    
+    return status_code;
+}
+
+void HttpClient::SetMethod(CURL* curl, const char* method,
+                           const char* body, size_t body_length) {
+    // Handles are reused, so clear any previous custom verb first
+    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, nullptr);
+    
+    if (std::strcmp(method, "GET") == 0) {
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+    } else if (std::strcmp(method, "POST") == 0) {
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body_length));
+    } else if (std::strcmp(method, "DELETE") == 0) {
+        curl_easy_setopt(curl, CURLOPT_HTTPGET, 1L);
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
+    } else if (std::strcmp(method, "PUT") == 0) {
+        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "PUT");
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body_length));
+    }
+}
+
+std::future<HttpClient::Response> HttpClient::SubmitAsync(const std::string& method,
+                                                          const std::string& url,
+                                                          const std::string& body,
+                                                          const std::map<std::string, std::string>& headers,
+                                                          CompletionCallback callback,
+                                                          std::chrono::steady_clock::time_point not_before) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    std::future<Response> future = promise->get_future();
+    
+    HttpAsyncEngine* engine = GetAsyncEngine();
+    if (!engine) {
+        Response response;
+        response.status_code = 0;
+        response.response_time_ms = 0;
+        response.body = "CURL not initialized";
+        RecordRequest(false, body.size(), response.body.size(), 0);
+        if (callback) callback(response);
+        promise->set_value(std::move(response));
+        return future;
+    }
+    
+    HttpAsyncEngine::Request request;
+    // Engine holds the request back until its slot; the caller never sleeps
+    request.not_before = std::max(ReserveSlot(), not_before);
+    request.method = method;
+    request.url = url;
+    request.body = body;
+    request.headers = BuildHeaderList(headers);
+    
+    size_t bytes_sent = body.size();
+    std::function<void(Response&)> on_complete = [this, promise, callback = std::move(callback), bytes_sent](
+        Response& response) {
+        RecordRequest(response.status_code != 0, bytes_sent, response.body.size(),
+                      response.response_time_ns);
+        if (callback) callback(response);
+        promise->set_value(std::move(response));
+    };
+    request.on_complete = on_complete;
+    
+    if (engine->Submit(std::move(request)) == 0) {
+        // Engine stopping: it dropped the request, so complete it here
+        Response response;
+        response.status_code = 0;
+        response.response_time_ms = 0;
+        response.body = "Async engine stopped";
+        on_complete(response);
+    }
+    return future;
+}
+
+HttpAsyncEngine* HttpClient::GetAsyncEngine() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (!async_engine_) {
+        {
+            std::lock_guard<std::mutex> pool_lock(pool_mutex_);
+            if (handles_.empty()) {
+                return nullptr;  // Not initialized
+            }
+        }
+        
+        auto engine = std::make_unique<HttpAsyncEngine>(options_, share_);
+        if (!engine->Start()) {
+            return nullptr;
+        }
+        async_engine_ = std::move(engine);
+    }
+    
+    return async_engine_.get();
+}
+
+struct curl_slist* HttpClient::BuildHeaderList(
+    const std::map<std::string, std::string>& headers) const {
+    struct curl_slist* chunk = nullptr;
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        
+        // Add default headers
+        for (const auto& [key, value] : default_headers_) {
+            std::string header = key + ": " + value;
+            chunk = curl_slist_append(chunk, header.c_str());
+        }
+    }
+    
+    // Add custom headers (override defaults)
+    for (const auto& [key, value] : headers) {
+        std::string header = key + ": " + value;
+        chunk = curl_slist_append(chunk, header.c_str());
+    }
+    
+    return chunk;
+}
+
+void HttpClient::RecordRequest(bool success, size_t bytes_sent, size_t bytes_received,
+                               int64_t response_time_ns) {
+    response_times_.Record(response_time_ns);
+    
+    std::lock_guard<std::mutex> lock(stats_mutex_);
     stats_.total_requests++;
-    if (!success) {
+    if (success) {
+        stats_.successful_requests++;
+    } else {
         stats_.failed_requests++;
     }
-    stats_.total_bytes_sent += body.size();
-    stats_.total_bytes_received += response.body.size();
+    stats_.total_bytes_sent += bytes_sent;
+    stats_.total_bytes_received += bytes_received;
     
     // Update average response time
     double total_time = stats_.avg_response_time_ms * (stats_.total_requests - 1);
-    stats_.avg_response_time_ms = (total_time + response.response_time_ms) / stats_.total_requests;
+    stats_.avg_response_time_ms = (total_time + response_time_ns / 1e6) / stats_.total_requests;
+}
+
+void HttpClient::ReadTimings(CURL* curl, Timings& timings) {
+    curl_off_t name_lookup = 0, connect = 0, app_connect = 0, start_transfer = 0, total = 0;
+    long connects = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &name_lookup);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connect);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &app_connect);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &start_transfer);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &total);
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects);
     
-    return response;
+    // libcurl reports cumulative microseconds from the start of the transfer
+    timings.new_connection = connects > 0;
+    if (timings.new_connection) {
+        timings.dns_ns = static_cast<int64_t>(name_lookup) * 1000;
+        timings.connect_ns = static_cast<int64_t>(std::max<curl_off_t>(connect - name_lookup, 0)) * 1000;
+        timings.tls_ns = app_connect > 0
+            ? static_cast<int64_t>(std::max<curl_off_t>(app_connect - connect, 0)) * 1000 : 0;
+    } else {
+        timings.dns_ns = timings.connect_ns = timings.tls_ns = 0;
+    }
+    timings.ttfb_ns = static_cast<int64_t>(start_transfer) * 1000;
+    timings.total_ns = static_cast<int64_t>(total) * 1000;
+}
+
+void HttpClient::Timings::RecordTo(LatencyRegistry::Endpoint& endpoint) const {
+    if (new_connection) {
+        endpoint.Record(LatencyStage::kDns, dns_ns);
+        endpoint.Record(LatencyStage::kConnect, connect_ns);
+        if (tls_ns > 0) {
+            endpoint.Record(LatencyStage::kTls, tls_ns);
+        }
+    }
+    endpoint.Record(LatencyStage::kTtfb, ttfb_ns);
+    endpoint.Record(LatencyStage::kTotal, total_ns);
 }
 
 size_t HttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
@@ -228,17 +593,14 @@ void HttpClient::RateLimit() {
         return;
     }
     
-    auto now = std::chrono::steady_clock::now();
-    auto min_interval = std::chrono::milliseconds(1000 / options_.max_requests_per_second);
-    
-    if (last_request_time_.time_since_epoch().count() > 0) {
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - last_request_time_);
-        
-        if (elapsed < min_interval) {
-            std::this_thread::sleep_for(min_interval - elapsed);
-        }
+    std::this_thread::sleep_until(ReserveSlot());
+}
+
+std::chrono::steady_clock::time_point HttpClient::ReserveSlot() {
+    if (options_.max_requests_per_second <= 0) {
+        return std::chrono::steady_clock::now();
     }
     
-    last_request_time_ = std::chrono::steady_clock::now();
+    // Queue without bound: the client-wide limit only paces, never rejects
+    return rate_limiter_.Acquire("*", std::chrono::hours(24)).not_before;
 }
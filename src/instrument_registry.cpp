@@ -0,0 +1,142 @@
+#include "instrument_registry.h"
+#include "config.h"
+#include <algorithm>
+
+namespace {
+    InstrumentRegistry::Id Lookup(const std::unordered_map<std::string_view, InstrumentRegistry::Id>& map,
+                                  std::string_view key) {
+        auto it = map.find(key);
+        return it != map.end() ? it->second : InstrumentRegistry::kInvalidId;
+    }
+}
+
+InstrumentRegistry::Id InstrumentRegistry::Add(const std::string& base, const std::string& inst_id,
+                                               const std::string& mt5_symbol) {
+    if (inst_id.empty()) {
+        return kInvalidId;
+    }
+    Id existing = FindByInstId(inst_id);
+    if (existing != kInvalidId) {
+        return existing;
+    }
+
+    Id id = static_cast<Id>(instruments_.size());
+    instruments_.emplace_back();
+    Instrument& instrument = instruments_.back();
+    instrument.id = id;
+    instrument.inst_type = InstTypeFromInstId(inst_id);
+    instrument.base = base;
+    instrument.inst_id = inst_id;
+    instrument.mt5_symbol = mt5_symbol;
+
+    by_inst_id_.emplace(instrument.inst_id, id);
+    if (!instrument.mt5_symbol.empty()) {
+        by_mt5_symbol_.emplace(instrument.mt5_symbol, id);
+    }
+    if (!instrument.base.empty()) {
+        by_base_.emplace(instrument.base, id);
+    }
+
+    // Ticks from either platform carry a SymbolTable id; map both names
+    SymbolTable& symbols = SymbolTable::Global();
+    instrument.symbol_id = symbols.Intern(inst_id);
+    for (SymbolTable::Id symbol_id : {instrument.symbol_id, symbols.Intern(mt5_symbol)}) {
+        if (symbol_id == SymbolTable::kInvalidId) {
+            continue;
+        }
+        if (symbol_id >= by_symbol_id_.size()) {
+            by_symbol_id_.resize(symbol_id + 1, kInvalidId);
+        }
+        by_symbol_id_[symbol_id] = id;
+    }
+    return id;
+}
+
+size_t InstrumentRegistry::LoadFromConfig(const Config& config) {
+    size_t added = 0;
+    for (const std::string& base : config.GetSymbolBases()) {
+        std::string inst_id = config.GetOKXSymbol(base);
+        std::string mt5_symbol;
+        if (config.HasMT5Symbol(base)) {
+            mt5_symbol = config.GetMT5Symbol(base);
+        }
+        if (Add(base, inst_id, mt5_symbol) != kInvalidId) {
+            added++;
+        }
+    }
+    return added;
+}
+
+bool InstrumentRegistry::SetSpecs(Id id, double contract_val, double tick_size,
+                                  double lot_size, double min_size) {
+    if (id >= instruments_.size()) {
+        return false;
+    }
+
+    Instrument& instrument = instruments_[id];
+    instrument.contract_val = contract_val;
+    instrument.tick_size = tick_size;
+    instrument.lot_size = lot_size;
+    instrument.min_size = min_size;
+    instrument.loaded = FixedScale::FromStep(tick_size, instrument.scale.price) &&
+                        FixedScale::FromStep(lot_size, instrument.scale.size);
+    return instrument.loaded;
+}
+
+InstrumentRegistry::Id InstrumentRegistry::FindByInstId(std::string_view inst_id) const {
+    return Lookup(by_inst_id_, inst_id);
+}
+
+InstrumentRegistry::Id InstrumentRegistry::FindByMT5Symbol(std::string_view symbol) const {
+    return Lookup(by_mt5_symbol_, symbol);
+}
+
+InstrumentRegistry::Id InstrumentRegistry::FindByBase(std::string_view base) const {
+    return Lookup(by_base_, base);
+}
+
+std::vector<InstrumentRegistry::InstType> InstrumentRegistry::InstTypes() const {
+    std::vector<InstType> types;
+    for (const Instrument& instrument : instruments_) {
+        if (std::find(types.begin(), types.end(), instrument.inst_type) == types.end()) {
+            types.push_back(instrument.inst_type);
+        }
+    }
+    return types;
+}
+
+InstrumentRegistry::InstType InstrumentRegistry::InstTypeFromInstId(std::string_view inst_id) {
+    // BASE-QUOTE[-SWAP | -YYMMDD[-STRIKE-C|P]]
+    std::string_view parts[6];
+    size_t count = 0;
+    while (count < 6) {
+        size_t dash = inst_id.find('-');
+        parts[count++] = inst_id.substr(0, dash);
+        if (dash == std::string_view::npos) {
+            break;
+        }
+        inst_id.remove_prefix(dash + 1);
+    }
+
+    if (count == 3 && parts[2] == "SWAP") {
+        return InstType::kSwap;
+    }
+    bool expiry = count >= 3 && parts[2].size() == 6 &&
+                  std::all_of(parts[2].begin(), parts[2].end(), [](char c) { return c >= '0' && c <= '9'; });
+    if (expiry && count == 3) {
+        return InstType::kFutures;
+    }
+    if (expiry && count == 5 && (parts[4] == "C" || parts[4] == "P")) {
+        return InstType::kOption;
+    }
+    return InstType::kSpot;
+}
+
+const char* InstrumentRegistry::InstTypeName(InstType inst_type) {
+    switch (inst_type) {
+        case InstType::kSwap: return "SWAP";
+        case InstType::kFutures: return "FUTURES";
+        case InstType::kOption: return "OPTION";
+        default: return "SPOT";
+    }
+}
@@ -0,0 +1,233 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    int HighestBit(uint64_t value) {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+}
+
+// ==================== LatencyHistogram ====================
+
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t ns) {
+    if (ns < (uint64_t(1) << kSubBucketBits)) {
+        return static_cast<size_t>(ns);
+    }
+    int bit = HighestBit(ns);
+    if (bit >= kMaxBits) {
+        return kBucketCount - 1;
+    }
+    // Top kSubBucketBits bits: a mantissa in [half, 2 * half)
+    int shift = bit - kSubBucketBits + 1;
+    size_t mantissa = static_cast<size_t>(ns >> shift);
+    return static_cast<size_t>(shift + 1) * kSubBucketHalf + (mantissa - kSubBucketHalf);
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(size_t index) {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    int shift = static_cast<int>(index / kSubBucketHalf) - 1;
+    uint64_t mantissa = kSubBucketHalf + index % kSubBucketHalf;
+    return mantissa << shift;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < (size_t(1) << kSubBucketBits)) {
+        return index;
+    }
+    int shift = static_cast<int>(index / kSubBucketHalf) - 1;
+    return BucketLowerBound(index) + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int64_t ns) {
+    uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+    counts_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+    Snapshot snapshot;
+    if (count_.load(std::memory_order_relaxed) == 0) {
+        return snapshot;
+    }
+
+    // Counters move while we copy; derive the count from the buckets so
+    // percentiles stay consistent with what was copied
+    snapshot.counts.resize(kBucketCount);
+    for (size_t i = 0; i < kBucketCount; i++) {
+        snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    snapshot.sum_ns = sum_.load(std::memory_order_relaxed);
+    snapshot.min_ns = min_.load(std::memory_order_relaxed);
+    snapshot.max_ns = max_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Snapshot::ValueAtPercentile(double percentile) const {
+    if (count == 0 || counts.empty()) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    // Rounded like HdrHistogram, so 99.9 of 10000 is the 9990th value
+    uint64_t target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            return std::min(std::max(BucketUpperBound(i), min_ns), max_ns);
+        }
+    }
+    return max_ns;
+}
+
+void LatencyHistogram::Snapshot::Merge(const Snapshot& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] += other.counts[i];
+    }
+    count += other.count;
+    sum_ns += other.sum_ns;
+    min_ns = std::min(min_ns, other.min_ns);
+    max_ns = std::max(max_ns, other.max_ns);
+}
+
+nlohmann::json LatencyHistogram::Snapshot::ToJson() const {
+    nlohmann::json out = {
+        {"count", count},
+        {"min_ns", count ? min_ns : 0},
+        {"max_ns", max_ns},
+        {"mean_ns", Mean()},
+        {"p50_ns", ValueAtPercentile(50)},
+        {"p90_ns", ValueAtPercentile(90)},
+        {"p99_ns", ValueAtPercentile(99)},
+        {"p999_ns", ValueAtPercentile(99.9)},
+        {"p9999_ns", ValueAtPercentile(99.99)},
+    };
+    nlohmann::json buckets = nlohmann::json::array();
+    for (size_t i = 0; i < counts.size(); i++) {
+        if (counts[i] != 0) {
+            buckets.push_back({BucketUpperBound(i), counts[i]});
+        }
+    }
+    out["buckets"] = std::move(buckets);
+    return out;
+}
+
+// ==================== LatencyRegistry ====================
+
+const char* LatencyStageName(LatencyStage stage) {
+    switch (stage) {
+    case LatencyStage::kDns:      return "dns";
+    case LatencyStage::kConnect:  return "connect";
+    case LatencyStage::kTls:      return "tls";
+    case LatencyStage::kTtfb:     return "ttfb";
+    case LatencyStage::kTotal:    return "total";
+    case LatencyStage::kParse:    return "parse";
+    case LatencyStage::kDispatch: return "dispatch";
+    case LatencyStage::kNetwork:  return "network";
+    default:                      return "unknown";
+    }
+}
+
+LatencyRegistry::Endpoint& LatencyRegistry::Get(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = endpoints_.find(name);
+        if (it != endpoints_.end()) {
+            return *it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& endpoint = endpoints_[name];
+    if (!endpoint) {
+        endpoint = std::make_unique<Endpoint>();
+    }
+    return *endpoint;
+}
+
+LatencyRegistry::Snapshot LatencyRegistry::GetSnapshot() const {
+    Snapshot snapshot;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (const auto& [name, endpoint] : endpoints_) {
+        EndpointSnapshot& out = snapshot[name];
+        for (size_t i = 0; i < kStageCount; i++) {
+            out.stages[i] = endpoint->stages[i].GetSnapshot();
+        }
+    }
+    return snapshot;
+}
+
+void LatencyRegistry::Reset() {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (auto& [name, endpoint] : endpoints_) {
+        for (auto& stage : endpoint->stages) {
+            stage.Reset();
+        }
+    }
+}
+
+nlohmann::json LatencyRegistry::ToJson(const Snapshot& snapshot) {
+    nlohmann::json out = nlohmann::json::object();
+    for (const auto& [name, endpoint] : snapshot) {
+        nlohmann::json stages = nlohmann::json::object();
+        for (size_t i = 0; i < kStageCount; i++) {
+            if (endpoint.stages[i].count > 0) {
+                stages[LatencyStageName(static_cast<LatencyStage>(i))] = endpoint.stages[i].ToJson();
+            }
+        }
+        out[name] = std::move(stages);
+    }
+    return out;
+}
+
+int64_t LatencyRegistry::NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
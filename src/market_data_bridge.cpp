@@ -0,0 +1,463 @@
+#include "market_data_bridge.h"
+#include "event_ring.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(MarketDataBridge::Header) == 64, "Bridge header must be one cache line");
+
+namespace {
+    // Seqlock write: CAS even -> odd, write, release even. With count set,
+    // update_count becomes the stored one plus 1, read while the slot is held
+    template <typename Data>
+    void SeqlockWrite(std::atomic<uint32_t>& sequence, Data& target, const Data& value, bool count = false) {
+        uint32_t current = sequence.load(std::memory_order_relaxed);
+        for (;;) {
+            if (current & 1) {
+                EventRing::CpuRelax();
+                current = sequence.load(std::memory_order_relaxed);
+            } else if (sequence.compare_exchange_weak(current, current + 1,
+                                                      std::memory_order_acquire)) {
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        uint64_t update_count = target.update_count + 1;
+        std::memcpy(&target, &value, sizeof(Data));
+        if (count) {
+            target.update_count = update_count;
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    template <typename Data>
+    bool SeqlockRead(const std::atomic<uint32_t>& sequence, const Data& source, Data& out) {
+        for (;;) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                EventRing::CpuRelax();
+                continue;
+            }
+            std::memcpy(&out, &source, sizeof(Data));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                return before != 0;
+            }
+        }
+    }
+}
+
+MarketDataBridge::MarketDataBridge()
+    : memory_(nullptr)
+    , size_(0)
+    , writable_(false)
+    , header_(nullptr)
+    , slots_(nullptr)
+#if defined(_WIN32)
+    , mapping_(nullptr)
+#endif
+{
+}
+
+MarketDataBridge::~MarketDataBridge() {
+    Close();
+}
+
+std::string MarketDataBridge::SegmentName(const std::string& name) {
+#if defined(_WIN32)
+    return "Local\\" + name;
+#else
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+#endif
+}
+
+size_t MarketDataBridge::SegmentSize(uint32_t slot_count) {
+    return sizeof(Header) + static_cast<size_t>(slot_count) * sizeof(Slot);
+}
+
+bool MarketDataBridge::Create(const std::string& name, uint32_t slot_count) {
+    Close();
+    if (slot_count == 0) {
+        return false;
+    }
+    if (!Map(name, SegmentSize(slot_count), true)) {
+        return false;
+    }
+
+    // Fresh table; readers check magic/version before trusting it
+    std::memset(memory_, 0, size_);
+    header_->version = kVersion;
+    header_->slot_count = slot_count;
+    header_->slot_size = sizeof(Slot);
+    header_->symbol_count.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kMagic;
+    return true;
+}
+
+bool MarketDataBridge::Open(const std::string& name) {
+    Close();
+    if (!Map(name, 0, false)) {
+        return false;
+    }
+
+    if (header_->magic != kMagic || header_->version != kVersion ||
+        header_->slot_size != sizeof(Slot) || SegmentSize(header_->slot_count) > size_) {
+        std::cerr << "MarketDataBridge: " << name << " has an incompatible layout" << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MarketDataBridge::Map(const std::string& name, size_t size, bool create) {
+    std::string segment = SegmentName(name);
+
+#if defined(_WIN32)
+    HANDLE mapping;
+    if (create) {
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                     static_cast<DWORD>(size & 0xFFFFFFFFu), segment.c_str());
+    } else {
+        mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, segment.c_str());
+    }
+    if (!mapping) {
+        std::cerr << "MarketDataBridge: cannot map " << segment << std::endl;
+        return false;
+    }
+    void* memory = MapViewOfFile(mapping, create ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (!memory) {
+        CloseHandle(mapping);
+        std::cerr << "MarketDataBridge: cannot map " << segment << std::endl;
+        return false;
+    }
+    if (!create) {
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(memory, &info, sizeof(info));
+        size = info.RegionSize;
+    }
+    mapping_ = mapping;
+#else
+    int fd = create ? shm_open(segment.c_str(), O_CREAT | O_RDWR, 0600)
+                    : shm_open(segment.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "MarketDataBridge: cannot open " << segment << std::endl;
+        return false;
+    }
+
+    if (create) {
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            close(fd);
+            std::cerr << "MarketDataBridge: cannot size " << segment << std::endl;
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+            close(fd);
+            std::cerr << "MarketDataBridge: " << segment << " is not initialized" << std::endl;
+            return false;
+        }
+        size = static_cast<size_t>(info.st_size);
+    }
+
+    void* memory = mmap(nullptr, size, create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        std::cerr << "MarketDataBridge: cannot map " << segment << std::endl;
+        return false;
+    }
+#endif
+
+    memory_ = memory;
+    size_ = size;
+    writable_ = create;
+    header_ = static_cast<Header*>(memory);
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(memory) + sizeof(Header));
+    return true;
+}
+
+void MarketDataBridge::Close() {
+    if (!memory_) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(memory_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    munmap(memory_, size_);
+#endif
+
+    memory_ = nullptr;
+    size_ = 0;
+    header_ = nullptr;
+    slots_ = nullptr;
+    writable_ = false;
+
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    slot_index_.clear();
+}
+
+void MarketDataBridge::Unlink(const std::string& name) {
+#if !defined(_WIN32)
+    shm_unlink(SegmentName(name).c_str());
+#else
+    (void)name;   // Windows removes the mapping with its last handle
+#endif
+}
+
+MarketDataBridge::Slot* MarketDataBridge::GetSlot(int slot) const {
+    if (!header_ || slot < 0 ||
+        static_cast<uint32_t>(slot) >= header_->symbol_count.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &slots_[slot];
+}
+
+// ==================== Writer ====================
+
+int MarketDataBridge::AddSymbol(std::string_view symbol) {
+    if (!writable_ || symbol.empty() || symbol.size() >= OKX_BRIDGE_SYMBOL_SIZE) {
+        return -1;
+    }
+
+    std::string key(symbol);
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        auto it = slot_index_.find(key);
+        if (it != slot_index_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(index_mutex_);
+    auto it = slot_index_.find(key);
+    if (it != slot_index_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = header_->symbol_count.load(std::memory_order_relaxed);
+    if (index >= header_->slot_count) {
+        return -1;
+    }
+
+    // Name first, then publish the count so readers never see a blank slot
+    Slot& slot = slots_[index];
+    std::memcpy(slot.symbol, symbol.data(), symbol.size());
+    slot.symbol[symbol.size()] = '\0';
+    header_->symbol_count.store(index + 1, std::memory_order_release);
+
+    slot_index_.emplace(std::move(key), static_cast<int>(index));
+    return static_cast<int>(index);
+}
+
+bool MarketDataBridge::PublishQuote(int slot, const OKXBridgeQuote& quote) {
+    Slot* target = writable_ ? GetSlot(slot) : nullptr;
+    if (!target) {
+        return false;
+    }
+    SeqlockWrite(target->quote_sequence, target->quote, quote);
+    return true;
+}
+
+bool MarketDataBridge::PublishBook(int slot, const OKXBridgeBook& book) {
+    Slot* target = writable_ ? GetSlot(slot) : nullptr;
+    if (!target) {
+        return false;
+    }
+    SeqlockWrite(target->book_sequence, target->book, book);
+    return true;
+}
+
+bool MarketDataBridge::PublishTick(const Tick& tick) {
+    int slot;
+    {
+        // Hot path: an existing symbol is one shared-lock lookup
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        auto it = slot_index_.find(tick.inst_id);
+        slot = it != slot_index_.end() ? it->second : -1;
+    }
+    if (slot < 0) {
+        slot = AddSymbol(tick.inst_id);
+    }
+    if (slot < 0) {
+        return false;
+    }
+
+    OKXBridgeQuote quote;
+    quote.bid = tick.bid_price;
+    quote.ask = tick.ask_price;
+    quote.last = tick.last_price;
+    quote.bid_size = tick.bid_size;
+    quote.ask_size = tick.ask_size;
+    quote.exchange_time = tick.timestamp;
+    quote.update_time_ns = NowNs();
+    if (!writable_) {
+        return false;
+    }
+    SeqlockWrite(slots_[slot].quote_sequence, slots_[slot].quote, quote, true);
+    return true;
+}
+
+bool MarketDataBridge::PublishDepth(const Depth& depth) {
+    int slot;
+    {
+        std::shared_lock<std::shared_mutex> lock(index_mutex_);
+        auto it = slot_index_.find(depth.inst_id);
+        slot = it != slot_index_.end() ? it->second : -1;
+    }
+    if (slot < 0) {
+        slot = AddSymbol(depth.inst_id);
+    }
+    if (slot < 0) {
+        return false;
+    }
+
+    OKXBridgeBook book;
+    std::memset(&book, 0, sizeof(book));
+    book.bid_count = static_cast<uint32_t>(std::min<size_t>(depth.bids.size(), OKX_BRIDGE_BOOK_LEVELS));
+    book.ask_count = static_cast<uint32_t>(std::min<size_t>(depth.asks.size(), OKX_BRIDGE_BOOK_LEVELS));
+    for (uint32_t i = 0; i < book.bid_count; i++) {
+        book.bid_price[i] = depth.bids[i].price;
+        book.bid_size[i] = depth.bids[i].size;
+    }
+    for (uint32_t i = 0; i < book.ask_count; i++) {
+        book.ask_price[i] = depth.asks[i].price;
+        book.ask_size[i] = depth.asks[i].size;
+    }
+    book.exchange_time = depth.timestamp;
+    book.update_time_ns = NowNs();
+    if (!writable_) {
+        return false;
+    }
+    SeqlockWrite(slots_[slot].book_sequence, slots_[slot].book, book, true);
+    return true;
+}
+
+// ==================== Reader ====================
+
+int MarketDataBridge::FindSymbol(std::string_view symbol) const {
+    if (!header_) {
+        return -1;
+    }
+    uint32_t count = header_->symbol_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++) {
+        if (symbol == slots_[i].symbol) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int MarketDataBridge::SymbolCount() const {
+    return header_ ? static_cast<int>(header_->symbol_count.load(std::memory_order_acquire)) : 0;
+}
+
+bool MarketDataBridge::ReadQuote(int slot, OKXBridgeQuote& quote) const {
+    const Slot* source = GetSlot(slot);
+    return source && SeqlockRead(source->quote_sequence, source->quote, quote);
+}
+
+bool MarketDataBridge::ReadBook(int slot, OKXBridgeBook& book) const {
+    const Slot* source = GetSlot(slot);
+    return source && SeqlockRead(source->book_sequence, source->book, book);
+}
+
+int64_t MarketDataBridge::NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ==================== C API ====================
+
+namespace {
+    constexpr int kMaxHandles = 16;
+    std::mutex handles_mutex;       // Serialises open and close
+    std::atomic<MarketDataBridge*> handles[kMaxHandles] = {};
+
+    // Lock-free for the read calls; OKX_BridgeClose must not race with them
+    MarketDataBridge* FromHandle(int handle) {
+        return handle >= 0 && handle < kMaxHandles ? handles[handle].load(std::memory_order_acquire) : nullptr;
+    }
+}
+
+extern "C" {
+
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeOpen(const char* name) {
+    if (!name) {
+        return -1;
+    }
+
+    auto bridge = new MarketDataBridge();
+    if (!bridge->Open(name)) {
+        delete bridge;
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(handles_mutex);
+    for (int i = 0; i < kMaxHandles; i++) {
+        if (!handles[i].load(std::memory_order_relaxed)) {
+            handles[i].store(bridge, std::memory_order_release);
+            return i;
+        }
+    }
+    delete bridge;
+    return -1;
+}
+
+OKX_BRIDGE_API void OKX_BRIDGE_CALL OKX_BridgeClose(int handle) {
+    MarketDataBridge* bridge = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(handles_mutex);
+        if (handle >= 0 && handle < kMaxHandles) {
+            bridge = handles[handle].exchange(nullptr, std::memory_order_acq_rel);
+        }
+    }
+    delete bridge;
+}
+
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeFindSymbol(int handle, const char* symbol) {
+    MarketDataBridge* bridge = FromHandle(handle);
+    return bridge && symbol ? bridge->FindSymbol(symbol) : -1;
+}
+
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeSymbolCount(int handle) {
+    MarketDataBridge* bridge = FromHandle(handle);
+    return bridge ? bridge->SymbolCount() : -1;
+}
+
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeReadQuote(int handle, int slot, OKXBridgeQuote* out) {
+    MarketDataBridge* bridge = FromHandle(handle);
+    if (!bridge || !out || slot < 0 || slot >= bridge->SymbolCount()) {
+        return -1;
+    }
+    return bridge->ReadQuote(slot, *out) ? 1 : 0;
+}
+
+OKX_BRIDGE_API int OKX_BRIDGE_CALL OKX_BridgeReadBook(int handle, int slot, OKXBridgeBook* out) {
+    MarketDataBridge* bridge = FromHandle(handle);
+    if (!bridge || !out || slot < 0 || slot >= bridge->SymbolCount()) {
+        return -1;
+    }
+    return bridge->ReadBook(slot, *out) ? 1 : 0;
+}
+
+OKX_BRIDGE_API int64_t OKX_BRIDGE_CALL OKX_BridgeNowNs(void) {
+    return MarketDataBridge::NowNs();
+}
+
+}
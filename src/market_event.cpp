@@ -0,0 +1,107 @@
+#include "market_event.h"
+#include <algorithm>
+#include <cstring>
+
+void MarketEvent::CopyText(char* out, size_t size, std::string_view text) {
+    size_t length = std::min(text.size(), size - 1);
+    std::memcpy(out, text.data(), length);
+    out[length] = '\0';
+}
+
+void MarketEvent::FromTick(const Tick& tick, int64_t receive_time_ns, MarketEvent& event) {
+    event.type = Type::kTick;
+    CopyText(event.inst_id, kInstIdSize, tick.inst_id);
+    event.exchange_time = tick.timestamp;
+    event.receive_time_ns = receive_time_ns;
+    event.latency_us = tick.latency_us;
+    event.tick.bid = tick.bid_price;
+    event.tick.ask = tick.ask_price;
+    event.tick.last = tick.last_price;
+    event.tick.bid_size = tick.bid_size;
+    event.tick.ask_size = tick.ask_size;
+}
+
+void MarketEvent::FromDepth(const Depth& depth, int64_t receive_time_ns, MarketEvent& event) {
+    event.type = Type::kDepth;
+    CopyText(event.inst_id, kInstIdSize, depth.inst_id);
+    event.exchange_time = depth.timestamp;
+    event.receive_time_ns = receive_time_ns;
+    event.latency_us = depth.latency_us;
+
+    size_t bids = std::min(depth.bids.size(), kDepthLevels);
+    size_t asks = std::min(depth.asks.size(), kDepthLevels);
+    event.depth.bid_count = static_cast<uint8_t>(bids);
+    event.depth.ask_count = static_cast<uint8_t>(asks);
+    for (size_t i = 0; i < bids; i++) {
+        event.depth.bid_price[i] = depth.bids[i].price;
+        event.depth.bid_size[i] = depth.bids[i].size;
+    }
+    for (size_t i = 0; i < asks; i++) {
+        event.depth.ask_price[i] = depth.asks[i].price;
+        event.depth.ask_size[i] = depth.asks[i].size;
+    }
+}
+
+void MarketEvent::FromOrder(const Order& order, int64_t receive_time_ns, MarketEvent& event) {
+    event.type = Type::kOrder;
+    CopyText(event.inst_id, kInstIdSize, order.inst_id);
+    event.exchange_time = order.update_time;
+    event.receive_time_ns = receive_time_ns;
+    event.latency_us = 0;
+    CopyText(event.order.order_id, sizeof(event.order.order_id), order.order_id);
+    CopyText(event.order.client_order_id, sizeof(event.order.client_order_id),
+             order.client_order_id);
+    CopyText(event.order.state, sizeof(event.order.state), order.state);
+    CopyText(event.order.side, sizeof(event.order.side), order.side);
+    event.order.price = order.price;
+    event.order.size = order.size;
+    event.order.filled_size = order.filled_size;
+    event.order.avg_price = order.avg_fill_price;
+    event.order.fee = order.fee;
+}
+
+void MarketEvent::ToTick(Tick& out) const {
+    out.inst_id = inst_id;
+    out.symbol = inst_id;
+    out.platform = "okx";
+    out.timestamp = exchange_time;
+    out.latency_us = latency_us;
+    out.bid = out.bid_price = tick.bid;
+    out.ask = out.ask_price = tick.ask;
+    out.last = out.last_price = tick.last;
+    out.bid_size = tick.bid_size;
+    out.ask_size = tick.ask_size;
+}
+
+void MarketEvent::ToDepth(Depth& out) const {
+    out.inst_id = inst_id;
+    out.symbol = inst_id;
+    out.platform = "okx";
+    out.timestamp = exchange_time;
+    out.latency_us = latency_us;
+    out.fixed_point = false;
+    out.bids.clear();
+    out.asks.clear();
+    for (size_t i = 0; i < depth.bid_count; i++) {
+        out.bids.emplace_back(depth.bid_price[i], depth.bid_size[i]);
+    }
+    for (size_t i = 0; i < depth.ask_count; i++) {
+        out.asks.emplace_back(depth.ask_price[i], depth.ask_size[i]);
+    }
+}
+
+void MarketEvent::ToOrder(Order& out) const {
+    out.inst_id = inst_id;
+    out.symbol = inst_id;
+    out.platform = "okx";
+    out.update_time = exchange_time;
+    out.order_id = order.order_id;
+    out.client_order_id = order.client_order_id;
+    out.state = order.state;
+    out.side = order.side;
+    out.price = order.price;
+    out.size = order.size;
+    out.filled_size = order.filled_size;
+    out.avg_fill_price = out.avg_price = order.avg_price;
+    out.fee = order.fee;
+}
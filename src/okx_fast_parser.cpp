@@ -0,0 +1,473 @@
+#include "okx_fast_parser.h"
+#include "okx_numeric.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+    inline void SkipWhitespace(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) {
+            ++p;
+        }
+    }
+
+    // p at the opening quote; on success p is past the closing quote
+    bool ScanString(const char*& p, const char* end, std::string_view& out) {
+        const char* start = ++p;
+        while (p < end) {
+            const char* quote = static_cast<const char*>(std::memchr(p, '"', end - p));
+            if (!quote) {
+                return false;
+            }
+
+            // A quote preceded by an odd number of backslashes is escaped
+            const char* q = quote;
+            size_t backslashes = 0;
+            while (q > start && *(q - 1) == '\\') {
+                --q;
+                ++backslashes;
+            }
+            if (backslashes % 2 == 0) {
+                out = std::string_view(start, quote - start);
+                p = quote + 1;
+                return true;
+            }
+            p = quote + 1;
+        }
+        return false;
+    }
+
+    // Skip a nested object/array; p at '{' or '['
+    bool ScanContainer(const char*& p, const char* end) {
+        int depth = 0;
+        while (p < end) {
+            char c = *p;
+            if (c == '"') {
+                std::string_view ignored;
+                if (!ScanString(p, end, ignored)) {
+                    return false;
+                }
+                continue;
+            }
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0) {
+                    ++p;
+                    return true;
+                }
+            }
+            ++p;
+        }
+        return false;
+    }
+
+    // Strings come back without quotes, everything else as raw text
+    bool ScanValue(const char*& p, const char* end, std::string_view& out) {
+        SkipWhitespace(p, end);
+        if (p >= end) {
+            return false;
+        }
+
+        if (*p == '"') {
+            return ScanString(p, end, out);
+        }
+
+        const char* start = p;
+        if (*p == '{' || *p == '[') {
+            if (!ScanContainer(p, end)) {
+                return false;
+            }
+        } else {
+            while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+                   *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') {
+                ++p;
+            }
+        }
+        out = std::string_view(start, p - start);
+        return p > start;
+    }
+
+    void AppendUtf8(std::string& out, unsigned code) {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+}
+
+// ==================== Readers ====================
+
+OKXFastParser::ArrayReader::ArrayReader(std::string_view array)
+    : p_(array.data()), end_(array.data() + array.size()), ok_(true), first_(true) {
+    SkipWhitespace(p_, end_);
+    if (p_ < end_ && *p_ == '[') {
+        ++p_;
+    } else {
+        ok_ = false;
+    }
+}
+
+bool OKXFastParser::ArrayReader::Next(std::string_view& element) {
+    if (!ok_) {
+        return false;
+    }
+
+    SkipWhitespace(p_, end_);
+    if (p_ >= end_) {
+        ok_ = false;
+        return false;
+    }
+    if (*p_ == ']') {
+        return false;
+    }
+    if (!first_) {
+        if (*p_ != ',') {
+            ok_ = false;
+            return false;
+        }
+        ++p_;
+    }
+    first_ = false;
+
+    if (!ScanValue(p_, end_, element)) {
+        ok_ = false;
+        return false;
+    }
+    return true;
+}
+
+OKXFastParser::ObjectReader::ObjectReader(std::string_view object)
+    : p_(object.data()), end_(object.data() + object.size()), ok_(true), first_(true) {
+    SkipWhitespace(p_, end_);
+    if (p_ < end_ && *p_ == '{') {
+        ++p_;
+    } else {
+        ok_ = false;
+    }
+}
+
+bool OKXFastParser::ObjectReader::Next(std::string_view& key, std::string_view& value) {
+    if (!ok_) {
+        return false;
+    }
+
+    SkipWhitespace(p_, end_);
+    if (p_ >= end_) {
+        ok_ = false;
+        return false;
+    }
+    if (*p_ == '}') {
+        return false;
+    }
+    if (!first_) {
+        if (*p_ != ',') {
+            ok_ = false;
+            return false;
+        }
+        ++p_;
+        SkipWhitespace(p_, end_);
+    }
+    first_ = false;
+
+    if (p_ >= end_ || *p_ != '"' || !ScanString(p_, end_, key)) {
+        ok_ = false;
+        return false;
+    }
+
+    SkipWhitespace(p_, end_);
+    if (p_ >= end_ || *p_ != ':') {
+        ok_ = false;
+        return false;
+    }
+    ++p_;
+
+    if (!ScanValue(p_, end_, value)) {
+        ok_ = false;
+        return false;
+    }
+    return true;
+}
+
+// ==================== Envelope ====================
+
+bool OKXFastParser::ParseEnvelope(std::string_view body, Envelope& envelope) {
+    envelope = Envelope();
+
+    ObjectReader reader(body);
+    std::string_view key, value;
+    bool has_data = false;
+
+    while (reader.Next(key, value)) {
+        if (key == "code") {
+            envelope.code = value;
+        } else if (key == "msg") {
+            envelope.msg = value;
+        } else if (key == "data") {
+            envelope.data = value;
+            has_data = true;
+        }
+    }
+
+    return reader.Ok() && has_data;
+}
+
+bool OKXFastParser::FirstDataElement(std::string_view body, std::string_view& element) {
+    Envelope envelope;
+    if (!ParseEnvelope(body, envelope)) {
+        return false;
+    }
+
+    ArrayReader data(envelope.data);
+    return data.Next(element) && !element.empty() && element.front() == '{';
+}
+
+// ==================== Typed parsers ====================
+//
+// Field sets mirror OKXRestAPI's json-based Parse* helpers.
+
+namespace {
+    // Exact grid value of a number field; off-grid text is rounded
+    int64_t ToSteps(const FixedScale& scale, std::string_view text) {
+        int64_t steps = 0;
+        if (!scale.Parse(text, steps)) {
+            steps = scale.Round(OKXNumeric::ToDouble(text));
+        }
+        return steps;
+    }
+}
+
+bool OKXFastParser::ParseTicker(std::string_view object, Tick& tick,
+                                const InstrumentScale* scale) {
+    ObjectReader reader(object);
+    std::string_view key, value;
+
+    while (reader.Next(key, value)) {
+        if (key == "instId") {
+            AssignString(tick.inst_id, value);
+        } else if (key == "last") {
+            tick.last_price = OKXNumeric::ToDouble(value);
+        } else if (key == "bidPx") {
+            tick.bid_price = OKXNumeric::ToDouble(value);
+            if (scale) {
+                tick.bid_ticks = ToSteps(scale->price, value);
+            }
+        } else if (key == "bidSz") {
+            tick.bid_size = OKXNumeric::ToDouble(value);
+        } else if (key == "askPx") {
+            tick.ask_price = OKXNumeric::ToDouble(value);
+            if (scale) {
+                tick.ask_ticks = ToSteps(scale->price, value);
+            }
+        } else if (key == "askSz") {
+            tick.ask_size = OKXNumeric::ToDouble(value);
+        } else if (key == "high24h") {
+            tick.high_24h = OKXNumeric::ToDouble(value);
+        } else if (key == "low24h") {
+            tick.low_24h = OKXNumeric::ToDouble(value);
+        } else if (key == "vol24h") {
+            tick.volume_24h = OKXNumeric::ToDouble(value);
+        } else if (key == "volCcy24h") {
+            tick.volume_currency_24h = OKXNumeric::ToDouble(value);
+        } else if (key == "ts") {
+            tick.timestamp = OKXNumeric::ToUint64(value);
+        }
+    }
+
+    return reader.Ok();
+}
+
+namespace {
+    bool ParseLevels(std::string_view array, std::vector<DepthLevel>& levels,
+                     const InstrumentScale* scale) {
+        levels.clear();
+
+        OKXFastParser::ArrayReader rows(array);
+        std::string_view row;
+        while (rows.Next(row)) {
+            // ["price", "size", "liquidated orders", "order count"]
+            OKXFastParser::ArrayReader fields(row);
+            std::string_view price, size;
+            if (fields.Next(price) && fields.Next(size)) {
+                if (scale) {
+                    levels.emplace_back(OKXNumeric::ToDouble(price), OKXNumeric::ToDouble(size),
+                                        ToSteps(scale->price, price), ToSteps(scale->size, size));
+                } else {
+                    levels.emplace_back(OKXNumeric::ToDouble(price), OKXNumeric::ToDouble(size));
+                }
+            }
+        }
+
+        return rows.Ok();
+    }
+}
+
+bool OKXFastParser::ParseOrderBook(std::string_view object, Depth& depth,
+                                   const InstrumentScale* scale) {
+    depth.bids.clear();
+    depth.asks.clear();
+    depth.fixed_point = scale != nullptr;
+
+    ObjectReader reader(object);
+    std::string_view key, value;
+
+    while (reader.Next(key, value)) {
+        if (key == "ts") {
+            depth.timestamp = OKXNumeric::ToUint64(value);
+        } else if (key == "bids") {
+            if (!ParseLevels(value, depth.bids, scale)) {
+                return false;
+            }
+        } else if (key == "asks") {
+            if (!ParseLevels(value, depth.asks, scale)) {
+                return false;
+            }
+        }
+    }
+
+    return reader.Ok();
+}
+
+bool OKXFastParser::ParseOrder(std::string_view object, Order& order,
+                               const InstrumentScale* scale) {
+    ObjectReader reader(object);
+    std::string_view key, value;
+
+    while (reader.Next(key, value)) {
+        if (key == "ordId") {
+            AssignString(order.order_id, value);
+        } else if (key == "clOrdId") {
+            AssignString(order.client_order_id, value);
+        } else if (key == "instId") {
+            AssignString(order.inst_id, value);
+        } else if (key == "side") {
+            AssignString(order.side, value);
+        } else if (key == "posSide") {
+            AssignString(order.position_side, value);
+        } else if (key == "ordType") {
+            AssignString(order.order_type, value);
+        } else if (key == "tdMode") {
+            AssignString(order.trade_mode, value);
+        } else if (key == "px") {
+            order.price = OKXNumeric::ToDouble(value);
+            if (scale) {
+                order.price_ticks = ToSteps(scale->price, value);
+            }
+        } else if (key == "sz") {
+            order.size = OKXNumeric::ToDouble(value);
+            if (scale) {
+                order.size_lots = ToSteps(scale->size, value);
+            }
+        } else if (key == "accFillSz") {
+            order.filled_size = OKXNumeric::ToDouble(value);
+        } else if (key == "avgPx") {
+            order.avg_fill_price = OKXNumeric::ToDouble(value);
+        } else if (key == "state") {
+            AssignString(order.state, value);
+        } else if (key == "fee") {
+            order.fee = OKXNumeric::ToDouble(value);
+        } else if (key == "pnl") {
+            order.pnl = OKXNumeric::ToDouble(value);
+        } else if (key == "cTime") {
+            order.create_time = OKXNumeric::ToUint64(value);
+        } else if (key == "uTime") {
+            order.update_time = OKXNumeric::ToUint64(value);
+        } else if (key == "lever") {
+            order.leverage = OKXNumeric::ToInt(value);
+        } else if (key == "tpTriggerPx") {
+            order.tp_trigger_price = OKXNumeric::ToDouble(value);
+        } else if (key == "tpOrdPx") {
+            order.tp_order_price = OKXNumeric::ToDouble(value);
+        } else if (key == "slTriggerPx") {
+            order.sl_trigger_price = OKXNumeric::ToDouble(value);
+        } else if (key == "slOrdPx") {
+            order.sl_order_price = OKXNumeric::ToDouble(value);
+        }
+    }
+
+    return reader.Ok();
+}
+
+bool OKXFastParser::ParsePosition(std::string_view object, Position& pos) {
+    ObjectReader reader(object);
+    std::string_view key, value;
+
+    while (reader.Next(key, value)) {
+        if (key == "instId") {
+            AssignString(pos.inst_id, value);
+        } else if (key == "posSide") {
+            AssignString(pos.position_side, value);
+        } else if (key == "pos") {
+            pos.position = OKXNumeric::ToDouble(value);
+        } else if (key == "availPos") {
+            pos.available_position = OKXNumeric::ToDouble(value);
+        } else if (key == "avgPx") {
+            pos.avg_price = OKXNumeric::ToDouble(value);
+        } else if (key == "markPx") {
+            pos.mark_price = OKXNumeric::ToDouble(value);
+        } else if (key == "liqPx") {
+            pos.liquidation_price = OKXNumeric::ToDouble(value);
+        } else if (key == "upl") {
+            pos.unrealized_pnl = OKXNumeric::ToDouble(value);
+        } else if (key == "uplRatio") {
+            pos.unrealized_pnl_ratio = OKXNumeric::ToDouble(value);
+        } else if (key == "lever") {
+            pos.leverage = OKXNumeric::ToInt(value);
+        } else if (key == "margin") {
+            pos.margin = OKXNumeric::ToDouble(value);
+        } else if (key == "mgnRatio") {
+            pos.margin_ratio = OKXNumeric::ToDouble(value);
+        } else if (key == "imr") {
+            pos.initial_margin = OKXNumeric::ToDouble(value);
+        } else if (key == "mmr") {
+            pos.maintenance_margin = OKXNumeric::ToDouble(value);
+        } else if (key == "mgnMode") {
+            AssignString(pos.trade_mode, value);
+        } else if (key == "cTime") {
+            pos.create_time = OKXNumeric::ToUint64(value);
+        } else if (key == "uTime") {
+            pos.update_time = OKXNumeric::ToUint64(value);
+        }
+    }
+
+    return reader.Ok();
+}
+
+void OKXFastParser::AssignString(std::string& out, std::string_view raw) {
+    if (raw.find('\\') == std::string_view::npos) {
+        out.assign(raw.data(), raw.size());
+        return;
+    }
+
+    out.clear();
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+
+        char e = raw[++i];
+        switch (e) {
+            case 'n': out += '\n'; break;
+            case 't': out += '\t'; break;
+            case 'r': out += '\r'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'u':
+                if (i + 4 < raw.size()) {
+                    unsigned code = 0;
+                    std::from_chars(raw.data() + i + 1, raw.data() + i + 5, code, 16);
+                    AppendUtf8(out, code);
+                    i += 4;
+                }
+                break;
+            default: out += e; break;  // \" \\ \/
+        }
+    }
+}
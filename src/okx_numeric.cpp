@@ -0,0 +1,88 @@
+#include "okx_numeric.h"
+#include <charconv>
+
+namespace {
+    // from_chars rejects a leading '+', which stod accepted
+    std::string_view StripPlus(std::string_view text) {
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+        return text;
+    }
+
+    template <typename T>
+    bool ParseInteger(std::string_view text, T& value) {
+        text = StripPlus(text);
+        if (text.empty()) {
+            return false;
+        }
+
+        const char* end = text.data() + text.size();
+        T parsed = 0;
+        auto [ptr, ec] = std::from_chars(text.data(), end, parsed);
+        if (ec != std::errc() || ptr != end) {
+            return false;
+        }
+
+        value = parsed;
+        return true;
+    }
+}
+
+bool OKXNumeric::TryParse(std::string_view text, double& value) {
+    text = StripPlus(text);
+    if (text.empty()) {
+        return false;
+    }
+
+    const char* end = text.data() + text.size();
+    double parsed = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), end, parsed);
+    if (ec != std::errc() || ptr != end) {
+        return false;
+    }
+
+    value = parsed;
+    return true;
+}
+
+bool OKXNumeric::TryParse(std::string_view text, uint64_t& value) {
+    return ParseInteger(text, value);
+}
+
+bool OKXNumeric::TryParse(std::string_view text, int64_t& value) {
+    return ParseInteger(text, value);
+}
+
+bool OKXNumeric::TryParse(std::string_view text, int& value) {
+    size_t dot = text.find('.');
+    if (dot != std::string_view::npos) {
+        for (size_t i = dot + 1; i < text.size(); i++) {
+            if (text[i] < '0' || text[i] > '9') {
+                return false;
+            }
+        }
+        text = text.substr(0, dot);
+    }
+    return ParseInteger(text, value);
+}
+
+double OKXNumeric::ToDouble(std::string_view text, double default_value) {
+    double value;
+    return TryParse(text, value) ? value : default_value;
+}
+
+uint64_t OKXNumeric::ToUint64(std::string_view text, uint64_t default_value) {
+    uint64_t value;
+    return TryParse(text, value) ? value : default_value;
+}
+
+int64_t OKXNumeric::ToInt64(std::string_view text, int64_t default_value) {
+    int64_t value;
+    return TryParse(text, value) ? value : default_value;
+}
+
+int OKXNumeric::ToInt(std::string_view text, int default_value) {
+    int value;
+    return TryParse(text, value) ? value : default_value;
+}
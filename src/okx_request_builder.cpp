@@ -0,0 +1,320 @@
+#include "okx_request_builder.h"
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+// ==================== FixedWriter ====================
+
+void FixedWriter::Append(std::string_view text) {
+    if (overflow_ || text.size() > capacity_ - length_) {
+        overflow_ = true;
+        return;
+    }
+    std::memcpy(data_ + length_, text.data(), text.size());
+    length_ += text.size();
+}
+
+void FixedWriter::Append(char c) {
+    if (overflow_ || length_ >= capacity_) {
+        overflow_ = true;
+        return;
+    }
+    data_[length_++] = c;
+}
+
+void FixedWriter::AppendJsonString(std::string_view text) {
+    static const char kHex[] = "0123456789abcdef";
+
+    Append('"');
+    for (char c : text) {
+        switch (c) {
+            case '"':  Append("\\\""); break;
+            case '\\': Append("\\\\"); break;
+            case '\b': Append("\\b"); break;
+            case '\f': Append("\\f"); break;
+            case '\n': Append("\\n"); break;
+            case '\r': Append("\\r"); break;
+            case '\t': Append("\\t"); break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    Append("\\u00");
+                    Append(kHex[(c >> 4) & 0x0F]);
+                    Append(kHex[c & 0x0F]);
+                } else {
+                    Append(c);
+                }
+        }
+    }
+    Append('"');
+}
+
+void FixedWriter::AppendFixed(double value, int precision) {
+    char digits[64];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value,
+                                std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+        overflow_ = true;
+        return;
+    }
+    Append(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+void FixedWriter::AppendScaled(int64_t steps, const FixedScale& scale) {
+    char digits[FixedScale::kMaxFormatLength];
+    Append(std::string_view(digits, scale.Format(steps, digits)));
+}
+
+void FixedWriter::Terminate() {
+    if (length_ < capacity_) {
+        data_[length_] = '\0';
+    } else {
+        overflow_ = true;
+    }
+}
+
+// ==================== OKXRequestBuilder ====================
+//
+// Keys are written in sorted order, which is how nlohmann::json (std::map
+// backed) serializes objects, so the bodies are byte-identical to
+// OKXRestAPI's json::dump() output.
+
+namespace {
+    void AppendKey(FixedWriter& w, bool& first, std::string_view key) {
+        if (!first) w.Append(',');
+        first = false;
+        w.AppendJsonString(key);
+        w.Append(':');
+    }
+
+    void AppendStringField(FixedWriter& w, bool& first,
+                           std::string_view key, std::string_view value) {
+        AppendKey(w, first, key);
+        w.AppendJsonString(value);
+    }
+
+    void AppendFixedField(FixedWriter& w, bool& first,
+                          std::string_view key, double value) {
+        AppendKey(w, first, key);
+        w.Append('"');
+        w.AppendFixed(value);
+        w.Append('"');
+    }
+
+    // Exact on the instrument grid when a scale is known; a non-zero
+    // `steps` wins over `value`
+    void AppendDecimalField(FixedWriter& w, bool& first, std::string_view key,
+                            double value, int64_t steps, const FixedScale* scale) {
+        if (!scale) {
+            AppendFixedField(w, first, key, value);
+            return;
+        }
+        AppendKey(w, first, key);
+        w.Append('"');
+        w.AppendScaled(steps != 0 ? steps : scale->Round(value), *scale);
+        w.Append('"');
+    }
+
+    // Every place-order field after clOrdId, in key order. With price_at
+    // set, px is left empty and its position inside the quotes recorded
+    void AppendOrderFields(FixedWriter& w, bool& first, const Order& order,
+                           const InstrumentScale* scale, bool has_price, size_t* price_at) {
+        const FixedScale* price_scale = scale ? &scale->price : nullptr;
+        const FixedScale* size_scale = scale ? &scale->size : nullptr;
+
+        AppendStringField(w, first, "instId", order.inst_id);
+        AppendStringField(w, first, "ordType", order.order_type);
+        if (!order.position_side.empty()) {
+            AppendStringField(w, first, "posSide", order.position_side);
+        }
+        if (has_price && price_at) {
+            AppendKey(w, first, "px");
+            w.Append('"');
+            *price_at = w.Length();
+            w.Append('"');
+        } else if (has_price) {
+            AppendDecimalField(w, first, "px", order.price, order.price_ticks, price_scale);
+        }
+        AppendStringField(w, first, "side", order.side);
+        if (order.sl_trigger_price > 0) {
+            AppendDecimalField(w, first, "slOrdPx", order.sl_order_price, 0, price_scale);
+            AppendDecimalField(w, first, "slTriggerPx", order.sl_trigger_price, 0, price_scale);
+        }
+        AppendDecimalField(w, first, "sz", order.size, order.size_lots, size_scale);
+        AppendStringField(w, first, "tdMode", order.trade_mode);
+        if (order.tp_trigger_price > 0) {
+            AppendDecimalField(w, first, "tpOrdPx", order.tp_order_price, 0, price_scale);
+            AppendDecimalField(w, first, "tpTriggerPx", order.tp_trigger_price, 0, price_scale);
+        }
+    }
+
+    bool Finish(FixedWriter& w, OKXRequestBuffer& buffer) {
+        w.Append('}');
+        w.Terminate();
+        buffer.body_length = w.Overflowed() ? 0 : w.Length();
+        return !w.Overflowed();
+    }
+}
+
+bool OKXRequestBuilder::BuildPlaceOrder(const Order& order, OKXRequestBuffer& buffer,
+                                        const InstrumentScale* scale) {
+    FixedWriter w(buffer.body, OKXRequestBuffer::kBodyCapacity);
+    bool first = true;
+
+    w.Append('{');
+    if (!order.client_order_id.empty()) {
+        AppendStringField(w, first, "clOrdId", order.client_order_id);
+    }
+    bool has_price = order.price > 0 || (scale && order.price_ticks > 0);
+    AppendOrderFields(w, first, order, scale, has_price, nullptr);
+
+    return Finish(w, buffer);
+}
+
+bool OKXRequestBuilder::BuildCancelOrder(std::string_view inst_id,
+                                         std::string_view order_id,
+                                         std::string_view client_order_id,
+                                         OKXRequestBuffer& buffer) {
+    FixedWriter w(buffer.body, OKXRequestBuffer::kBodyCapacity);
+    bool first = true;
+
+    w.Append('{');
+    if (!client_order_id.empty()) {
+        AppendStringField(w, first, "clOrdId", client_order_id);
+    }
+    AppendStringField(w, first, "instId", inst_id);
+    if (!order_id.empty()) {
+        AppendStringField(w, first, "ordId", order_id);
+    }
+
+    return Finish(w, buffer);
+}
+
+bool OKXRequestBuilder::BuildAmendOrder(std::string_view inst_id,
+                                        std::string_view order_id,
+                                        std::string_view new_size,
+                                        std::string_view new_price,
+                                        OKXRequestBuffer& buffer) {
+    FixedWriter w(buffer.body, OKXRequestBuffer::kBodyCapacity);
+    bool first = true;
+
+    w.Append('{');
+    AppendStringField(w, first, "instId", inst_id);
+    if (!new_price.empty()) {
+        AppendStringField(w, first, "newPx", new_price);
+    }
+    if (!new_size.empty()) {
+        AppendStringField(w, first, "newSz", new_size);
+    }
+    AppendStringField(w, first, "ordId", order_id);
+
+    return Finish(w, buffer);
+}
+
+// ==================== OKXOrderTemplate ====================
+
+bool OKXOrderTemplate::NeedsPrice(std::string_view order_type) {
+    return order_type != "market" && order_type != "optimal_limit_ioc";
+}
+
+bool OKXOrderTemplate::Arm(const Order& order, const InstrumentScale* scale) {
+    armed_ = false;
+
+    const char* problem = nullptr;
+    if (order.inst_id.empty()) {
+        problem = "instId is empty";
+    } else if (order.side != "buy" && order.side != "sell") {
+        problem = "side must be buy or sell";
+    } else if (order.order_type.empty()) {
+        problem = "ordType is empty";
+    } else if (order.trade_mode.empty()) {
+        problem = "tdMode is empty";
+    } else if (scale && !scale->Valid()) {
+        problem = "instrument scale is not valid";
+    } else if (scale ? (order.size_lots != 0 ? order.size_lots : scale->size.Round(order.size)) <= 0
+                     : order.size <= 0) {
+        problem = "size is not positive (or rounds to zero lots)";
+    }
+    if (problem) {
+        std::cerr << "Order template for " << order.inst_id << ": " << problem << std::endl;
+        return false;
+    }
+
+    has_price_ = NeedsPrice(order.order_type);
+    has_scale_ = scale != nullptr;
+    price_scale_ = scale ? scale->price : FixedScale();
+
+    FixedWriter w(text_, kCapacity);
+    bool first = true;
+    AppendOrderFields(w, first, order, scale, has_price_, &price_at_);
+    w.Append('}');
+    if (w.Overflowed()) {
+        std::cerr << "Order template for " << order.inst_id << ": body too long" << std::endl;
+        return false;
+    }
+    length_ = w.Length();
+    if (!has_price_) {
+        price_at_ = length_;
+    }
+    armed_ = true;
+    return true;
+}
+
+bool OKXOrderTemplate::Render(Price price, std::string_view client_order_id,
+                              OKXRequestBuffer& buffer) const {
+    if (!has_price_) {
+        return RenderWith(std::string_view(), client_order_id, buffer);
+    }
+    if (!(price > 0)) {
+        return false;
+    }
+
+    // Same text BuildPlaceOrder would write for this price
+    char digits[64];
+    FixedWriter w(digits, sizeof(digits));
+    if (has_scale_) {
+        w.AppendScaled(price_scale_.Round(price), price_scale_);
+    } else {
+        w.AppendFixed(price);
+    }
+    return !w.Overflowed() && RenderWith(w.View(), client_order_id, buffer);
+}
+
+bool OKXOrderTemplate::RenderTicks(PriceTicks price, std::string_view client_order_id,
+                                   OKXRequestBuffer& buffer) const {
+    if (!has_price_) {
+        return RenderWith(std::string_view(), client_order_id, buffer);
+    }
+    if (!has_scale_ || price <= 0) {
+        return false;
+    }
+    char digits[FixedScale::kMaxFormatLength];
+    return RenderWith(std::string_view(digits, price_scale_.Format(price, digits)), client_order_id, buffer);
+}
+
+bool OKXOrderTemplate::RenderWith(std::string_view price, std::string_view client_order_id,
+                                  OKXRequestBuffer& buffer) const {
+    if (!armed_ || client_order_id.size() > kMaxClientOrderId) {
+        return false;
+    }
+    for (char c : client_order_id) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+
+    FixedWriter w(buffer.body, OKXRequestBuffer::kBodyCapacity);
+    w.Append('{');
+    if (!client_order_id.empty()) {
+        // Letters and digits only, so no escaping needed
+        w.Append("\"clOrdId\":\"");
+        w.Append(client_order_id);
+        w.Append("\",");
+    }
+    w.Append(std::string_view(text_, price_at_));
+    w.Append(price);
+    w.Append(std::string_view(text_ + price_at_, length_ - price_at_));
+    w.Terminate();
+    buffer.body_length = w.Overflowed() ? 0 : w.Length();
+    return !w.Overflowed();
+}
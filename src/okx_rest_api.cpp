@@ -1,63 +1,132 @@
 #include "okx_rest_api.h"
+#include "clock_sync.h"
+#include "okx_fast_parser.h"
+#include "okx_numeric.h"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
-// 辅助函数：从 inst_id 推断 instType
-// 在文件开头，GetInstType() 函数之后添加：
 namespace {
-    std::string GetInstType(const std::string& inst_id) {
-        if (inst_id.find("-SWAP") != std::string::npos) {
-            return "SWAP";
-        } else if (inst_id.find("-FUTURES-") != std::string::npos) {
-            return "FUTURES";
-        } else if (inst_id.find("-OPTION-") != std::string::npos) {
-            return "OPTION";
-        } else {
-            return "SPOT";
+    // Numeric json node; OKX sends numbers as strings ("" when unset)
+    double JsonDouble(const json& value, double default_value = 0.0) {
+        if (value.is_string()) {
+            return OKXNumeric::ToDouble(value.get_ref<const std::string&>(), default_value);
         }
+        return value.is_number() ? value.get<double>() : default_value;
     }
 
-    // 添加安全的字符串转换函数
-    double SafeStod(const std::string& str, double default_value = 0.0) {
-        if (str.empty()) {
-            return default_value;
-        }
-        try {
-            return std::stod(str);
-        } catch (...) {
-            return default_value;
+    double JsonDouble(const json& object, const char* key, double default_value = 0.0) {
+        auto it = object.find(key);
+        return it != object.end() ? JsonDouble(*it, default_value) : default_value;
+    }
+
+    uint64_t JsonUint64(const json& value, uint64_t default_value = 0) {
+        if (value.is_string()) {
+            return OKXNumeric::ToUint64(value.get_ref<const std::string&>(), default_value);
         }
+        return value.is_number_unsigned() ? value.get<uint64_t>() : default_value;
+    }
+
+    uint64_t JsonUint64(const json& object, const char* key, uint64_t default_value = 0) {
+        auto it = object.find(key);
+        return it != object.end() ? JsonUint64(*it, default_value) : default_value;
     }
 
-    uint64_t SafeStoull(const std::string& str, uint64_t default_value = 0) {
-        if (str.empty()) {
+    int JsonInt(const json& object, const char* key, int default_value = 0) {
+        auto it = object.find(key);
+        if (it == object.end()) {
             return default_value;
         }
-        try {
-            return std::stoull(str);
-        } catch (...) {
-            return default_value;
+        if (it->is_string()) {
+            return OKXNumeric::ToInt(it->get_ref<const std::string&>(), default_value);
         }
+        return it->is_number() ? it->get<int>() : default_value;
     }
 
-    int SafeStoi(const std::string& str, int default_value = 0) {
-        if (str.empty()) {
-            return default_value;
+    OKXRestAPI::InstrumentInfo ParseInstrumentInfo(const json& data) {
+        OKXRestAPI::InstrumentInfo info;
+        info.inst_id = data.value("instId", "");
+        info.inst_type = data.value("instType", "");
+        info.underlying = data.value("uly", "");
+        info.base_ccy = data.value("baseCcy", "");
+        info.quote_ccy = data.value("quoteCcy", "");
+        info.settle_ccy = data.value("settleCcy", "");
+        info.contract_val = JsonDouble(data, "ctVal");
+        info.tick_size = JsonDouble(data, "tickSz");
+        info.lot_size = JsonDouble(data, "lotSz");
+        info.min_size = JsonDouble(data, "minSz");
+        info.state = data.value("state", "");
+        return info;
+    }
+
+    // True if an OKX response envelope carries code "0"
+    bool IsSuccessCode(std::string_view body) {
+        OKXFastParser::Envelope envelope;
+        return OKXFastParser::ParseEnvelope(body, envelope) && envelope.code == "0";
+    }
+
+    // OKX history endpoints answer at most 100 records per request
+    constexpr int kMaxHistoryPage = 100;
+
+    int HistoryPageSize(int page_size) {
+        return std::min(std::max(page_size, 1), kMaxHistoryPage);
+    }
+
+    // Pager over a history endpoint, sized like the requests it sends
+    template <typename T, typename Query>
+    HistoryPager<T> MakeHistoryPager(const Query& query,
+                                     typename HistoryPager<T>::FetchPage fetch,
+                                     typename HistoryPager<T>::CursorOf cursor_of) {
+        typename HistoryPager<T>::Options options;
+        options.page_size = static_cast<size_t>(HistoryPageSize(query.page_size));
+        options.prefetch = query.prefetch;
+        return HistoryPager<T>(std::move(fetch), std::move(cursor_of), options, query.after);
+    }
+
+    // A string field of the first "data" element (e.g. ordId)
+    std::string_view FirstDataField(std::string_view body, std::string_view name) {
+        std::string_view element, key, value;
+        if (OKXFastParser::FirstDataElement(body, element)) {
+            OKXFastParser::ObjectReader reader(element);
+            while (reader.Next(key, value)) {
+                if (key == name) {
+                    return value;
+                }
+            }
         }
-        try {
-            return SafeStoi(str);
-        } catch (...) {
-            return default_value;
+        return {};
+    }
+
+    // Price/size text for a request body: exact on the instrument grid
+    // when a scale is known, std::to_string format otherwise
+    std::string FormatDecimal(double value, int64_t steps, const FixedScale* scale) {
+        if (!scale) {
+            return std::to_string(value);
         }
+        return scale->ToString(steps != 0 ? steps : scale->Round(value));
+    }
+
+    // Per-thread buffers for the allocation-free trading path
+    OKXRequestBuffer& HotPathBuffer() {
+        thread_local OKXRequestBuffer buffer;
+        return buffer;
     }
 }
 
 
 OKXRestAPI::OKXRestAPI()
-    : initialized_(false) {
+    : static_headers_(nullptr)
+    , initialized_(false)
+    , bridge_(nullptr)
+    , registry_(nullptr)
+    , stats_() {
 }
 
 OKXRestAPI::~OKXRestAPI() {
+    // Release pooled connections before the header list they may reference
+    http_client_.reset();
+    curl_slist_free_all(static_headers_);
 }
 
 bool OKXRestAPI::Initialize(const APIConfig& config) {
@@ -68,7 +137,8 @@ bool OKXRestAPI::Initialize(const APIConfig& config) {
     HttpClient::RequestOptions options;
     options.timeout_ms = config.timeout_ms;
     options.max_retries = config.max_retries;
-    options.max_requests_per_second = 10;  // OKX rate limit
+    options.pool_size = config.http_pool_size;
+    options.max_requests_per_second = 0;  // Limited per endpoint below
 
     if (!http_client_->Initialize(options)) {
         std::cerr << "Failed to initialize HTTP client" << std::endl;
@@ -81,6 +151,8 @@ bool OKXRestAPI::Initialize(const APIConfig& config) {
     headers["Accept"] = "application/json";
     http_client_->SetDefaultHeaders(headers);
 
+    ConfigureRateLimits();
+
     // Initialize signer
     if (!config.api_key.empty()) {
         signer_ = std::make_unique<OKXSigner>(
@@ -90,6 +162,8 @@ bool OKXRestAPI::Initialize(const APIConfig& config) {
         );
     }
 
+    InitializeHotPath();
+
     initialized_ = true;
     return true;
 }
@@ -101,11 +175,37 @@ Tick OKXRestAPI::GetTicker(const std::string& inst_id) {
         {"instId", inst_id}  // ← 删除了instType那行
     };
 
-    json response = MakeRequest("GET", "/api/v5/market/ticker", params, false);
-
     Tick tick;
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/market/ticker", params, false, body, &latency)) {
+        return tick;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+
+    InstrumentScale scale;
+    bool has_scale = GetInstrumentScale(inst_id, scale);
+
+    std::string_view element;
+    if (config_.fast_parse && OKXFastParser::FirstDataElement(body, element) &&
+        OKXFastParser::ParseTicker(element, tick, has_scale ? &scale : nullptr)) {
+        if (bridge_) {
+            bridge_->PublishTick(tick);
+        }
+        return tick;
+    }
+    tick = Tick();
+
+    json response = ParseBody(body);
     if (!response.empty() && response.contains("data") && !response["data"].empty()) {
         tick = ParseTicker(response["data"][0]);
+        if (has_scale) {
+            tick.bid_ticks = scale.price.Round(tick.bid_price);
+            tick.ask_ticks = scale.price.Round(tick.ask_price);
+        }
+        if (bridge_) {
+            bridge_->PublishTick(tick);
+        }
     }
 
     return tick;
@@ -117,16 +217,50 @@ Depth OKXRestAPI::GetOrderBook(const std::string& inst_id, int depth_size) {
         {"sz", std::to_string(depth_size)}  // ← 删除了instType那行
     };
 
-    json response = MakeRequest("GET", "/api/v5/market/books", params, false);
-
     Depth depth;
     depth.inst_id = inst_id;
-    depth.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    depth.timestamp = static_cast<Timestamp>(OKXSigner::NowMs());
+
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/market/books", params, false, body, &latency)) {
+        return depth;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+
+    InstrumentScale scale;
+    bool has_scale = GetInstrumentScale(inst_id, scale);
+
+    std::string_view element;
+    if (config_.fast_parse && OKXFastParser::FirstDataElement(body, element)) {
+        depth.bids.reserve(depth_size);
+        depth.asks.reserve(depth_size);
+        if (OKXFastParser::ParseOrderBook(element, depth, has_scale ? &scale : nullptr)) {
+            if (bridge_) {
+                bridge_->PublishDepth(depth);
+            }
+            return depth;
+        }
+    }
+
+    json response = ParseBody(body);
 
     if (!response.empty() && response.contains("data") && !response["data"].empty()) {
         depth = ParseOrderBook(response["data"][0]);
         depth.inst_id = inst_id;
+
+        if (has_scale) {
+            for (auto* levels : {&depth.bids, &depth.asks}) {
+                for (auto& level : *levels) {
+                    level.price_ticks = scale.price.Round(level.price);
+                    level.size_lots = scale.size.Round(level.size);
+                }
+            }
+            depth.fixed_point = true;
+        }
+        if (bridge_) {
+            bridge_->PublishDepth(depth);
+        }
     }
 
     return depth;
@@ -144,10 +278,10 @@ OKXRestAPI::FundingRate OKXRestAPI::GetFundingRate(const std::string& inst_id) {
 
     if (!response.empty() && response.contains("data") && !response["data"].empty()) {
         const auto& data = response["data"][0];
-        rate.funding_rate = std::stod(data.value("fundingRate", "0"));
-        rate.funding_time = std::stod(data.value("fundingTime", "0"));
-        rate.next_funding_rate = std::stod(data.value("nextFundingRate", "0"));
-        rate.next_funding_time = std::stod(data.value("nextFundingTime", "0"));
+        rate.funding_rate = JsonDouble(data, "fundingRate");
+        rate.funding_time = JsonDouble(data, "fundingTime");
+        rate.next_funding_rate = JsonDouble(data, "nextFundingRate");
+        rate.next_funding_time = JsonDouble(data, "nextFundingTime");
     }
 
     return rate;
@@ -172,13 +306,13 @@ std::vector<OKXRestAPI::Candlestick> OKXRestAPI::GetCandlesticks(
         for (const auto& item : response["data"]) {
             if (item.is_array() && item.size() >= 7) {
                 Candlestick candle;
-                candle.timestamp = std::stoull(item[0].get<std::string>());
-                candle.open = std::stod(item[1].get<std::string>());
-                candle.high = std::stod(item[2].get<std::string>());
-                candle.low = std::stod(item[3].get<std::string>());
-                candle.close = std::stod(item[4].get<std::string>());
-                candle.volume = std::stod(item[5].get<std::string>());
-                candle.volume_currency = std::stod(item[6].get<std::string>());
+                candle.timestamp = JsonUint64(item[0]);
+                candle.open = JsonDouble(item[1]);
+                candle.high = JsonDouble(item[2]);
+                candle.low = JsonDouble(item[3]);
+                candle.close = JsonDouble(item[4]);
+                candle.volume = JsonDouble(item[5]);
+                candle.volume_currency = JsonDouble(item[6]);
                 candles.push_back(candle);
             }
         }
@@ -190,7 +324,7 @@ std::vector<OKXRestAPI::Candlestick> OKXRestAPI::GetCandlesticks(
 OKXRestAPI::InstrumentInfo OKXRestAPI::GetInstrumentInfo(const std::string& inst_id) {
     json params = {
         {"instId", inst_id},
-        {"instType", GetInstType(inst_id)}
+        {"instType", InstrumentRegistry::InstTypeName(InstrumentRegistry::InstTypeFromInstId(inst_id))}
     };
 
     json response = MakeRequest("GET", "/api/v5/public/instruments", params, false);
@@ -199,22 +333,106 @@ OKXRestAPI::InstrumentInfo OKXRestAPI::GetInstrumentInfo(const std::string& inst
     info.inst_id = inst_id;
 
     if (!response.empty() && response.contains("data") && !response["data"].empty()) {
-        const auto& data = response["data"][0];
-        info.inst_type = data.value("instType", "");
-        info.underlying = data.value("uly", "");
-        info.base_ccy = data.value("baseCcy", "");
-        info.quote_ccy = data.value("quoteCcy", "");
-        info.settle_ccy = data.value("settleCcy", "");
-        info.contract_val = std::stod(data.value("ctVal", "0"));
-        info.tick_size = std::stod(data.value("tickSz", "0"));
-        info.lot_size = std::stod(data.value("lotSz", "0"));
-        info.min_size = std::stod(data.value("minSz", "0"));
-        info.state = data.value("state", "");
+        info = ParseInstrumentInfo(response["data"][0]);
+        info.inst_id = inst_id;
     }
 
     return info;
 }
 
+std::vector<OKXRestAPI::InstrumentInfo> OKXRestAPI::GetInstruments(const std::string& inst_type) {
+    json params = {
+        {"instType", inst_type}
+    };
+
+    json response = MakeRequest("GET", "/api/v5/public/instruments", params, false);
+
+    std::vector<InstrumentInfo> instruments;
+    if (!response.empty() && response.contains("data") && response["data"].is_array()) {
+        instruments.reserve(response["data"].size());
+        for (const auto& data : response["data"]) {
+            instruments.push_back(ParseInstrumentInfo(data));
+        }
+    }
+    return instruments;
+}
+
+size_t OKXRestAPI::LoadInstruments(InstrumentRegistry& registry) {
+    size_t loaded = 0;
+    for (InstrumentRegistry::InstType type : registry.InstTypes()) {
+        for (const InstrumentInfo& info : GetInstruments(InstrumentRegistry::InstTypeName(type))) {
+            InstrumentRegistry::Id id = registry.FindByInstId(info.inst_id);
+            if (id == InstrumentRegistry::kInvalidId) {
+                continue;
+            }
+            if (registry.SetSpecs(id, info.contract_val, info.tick_size, info.lot_size, info.min_size)) {
+                loaded++;
+            }
+        }
+    }
+
+    for (InstrumentRegistry::Id id = 0; id < registry.Size(); id++) {
+        const InstrumentRegistry::Instrument& instrument = registry.Get(id);
+        if (!instrument.loaded) {
+            std::cerr << "No instrument specs for " << instrument.inst_id << std::endl;
+        }
+    }
+    registry_ = &registry;
+    return loaded;
+}
+
+bool OKXRestAPI::LoadInstrumentScale(const std::string& inst_id) {
+    InstrumentInfo info = GetInstrumentInfo(inst_id);
+
+    InstrumentScale scale;
+    if (!FixedScale::FromStep(info.tick_size, scale.price) ||
+        !FixedScale::FromStep(info.lot_size, scale.size)) {
+        std::cerr << "No tick/lot size for " << inst_id << std::endl;
+        return false;
+    }
+
+    SetInstrumentScale(inst_id, scale);
+    return true;
+}
+
+void OKXRestAPI::SetMarketDataBridge(MarketDataBridge* bridge) {
+    bridge_ = bridge;
+}
+
+void OKXRestAPI::SetInstrumentScale(const std::string& inst_id, const InstrumentScale& scale) {
+    std::unique_lock<std::shared_mutex> lock(scales_mutex_);
+    instrument_scales_[inst_id] = scale;
+}
+
+bool OKXRestAPI::GetInstrumentScale(const std::string& inst_id, InstrumentScale& scale) const {
+    if (registry_ && GetInstrumentScale(registry_->FindByInstId(inst_id), scale)) {
+        return true;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(scales_mutex_);
+    auto it = instrument_scales_.find(inst_id);
+    if (it == instrument_scales_.end()) {
+        return false;
+    }
+    scale = it->second;
+    return true;
+}
+
+bool OKXRestAPI::GetInstrumentScale(InstrumentRegistry::Id id, InstrumentScale& scale) const {
+    if (!registry_ || id >= registry_->Size() || !registry_->Get(id).loaded) {
+        return false;
+    }
+    scale = registry_->Get(id).scale;
+    return true;
+}
+
+bool OKXRestAPI::OrderScale(const Order& order, InstrumentScale& scale) const {
+    if (order.instrument_id != InstrumentRegistry::kInvalidId) {
+        return GetInstrumentScale(order.instrument_id, scale);
+    }
+    return GetInstrumentScale(order.inst_id, scale);
+}
+
 // ==================== Account API ====================
 
 Account OKXRestAPI::GetAccountBalance() {
@@ -235,9 +453,19 @@ std::vector<Position> OKXRestAPI::GetPositions(const std::string& inst_id) {
         params["instId"] = inst_id;
     }
 
-    json response = MakeRequest("GET", "/api/v5/account/positions", params, true);
-
     std::vector<Position> positions;
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/account/positions", params, true, body, &latency)) {
+        return positions;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+
+    if (config_.fast_parse && ParsePositionList(body, positions)) {
+        return positions;
+    }
+
+    json response = ParseBody(body);
 
     if (!response.empty() && response.contains("data")) {
         for (const auto& item : response["data"]) {
@@ -255,9 +483,9 @@ OKXRestAPI::AccountConfig OKXRestAPI::GetAccountConfig() {
 
     if (!response.empty() && response.contains("data") && !response["data"].empty()) {
         const auto& data = response["data"][0];
-        config.position_mode = SafeStoi(data.value("posMode", "0"));
+        config.position_mode = JsonInt(data, "posMode");
         config.auto_loan = data.value("autoLoan", false);
-        config.level = SafeStoi(data.value("level", "0"));
+        config.level = JsonInt(data, "level");
         config.account_level = data.value("acctLv", "");
     }
 
@@ -281,41 +509,113 @@ bool OKXRestAPI::SetLeverage(const std::string& inst_id,
 // ==================== Trading API ====================
 
 std::string OKXRestAPI::PlaceOrder(const Order& order) {
+    OKXRequestBuffer& buffer = HotPathBuffer();
+    InstrumentScale scale;
+    bool has_scale = OrderScale(order, scale);
+
+    if (initialized_ && signer_ &&
+        OKXRequestBuilder::BuildPlaceOrder(order, buffer, has_scale ? &scale : nullptr)) {
+        if (!SendHotRequest(place_order_endpoint_, buffer)) {
+            return "";
+        }
+        LatencyRegistry::Timer parse_timer(place_order_endpoint_.latency, LatencyStage::kParse);
+        if (!IsSuccessCode(buffer.response)) {
+            return "";
+        }
+        return std::string(FirstDataField(buffer.response, "ordId"));
+    }
+
+    json body = BuildOrderBody(order);
+
+    json response = MakeRequest("POST", "/api/v5/trade/order", body, true);
+
+    if (!response.empty() && response.value("code", "") == "0" &&
+        response.contains("data") && !response["data"].empty()) {
+        return response["data"][0].value("ordId", "");
+    }
+
+    return "";
+}
+
+bool OKXRestAPI::ArmOrderTemplate(const Order& order, OKXOrderTemplate& order_template) const {
+    InstrumentScale scale;
+    bool has_scale = OrderScale(order, scale);
+    return order_template.Arm(order, has_scale ? &scale : nullptr);
+}
+
+std::string OKXRestAPI::PlaceOrder(const OKXOrderTemplate& order_template, Price price,
+                                   std::string_view client_order_id) {
+    if (!initialized_ || !signer_) {
+        std::cerr << "API not initialized" << std::endl;
+        return "";
+    }
+
+    OKXRequestBuffer& buffer = HotPathBuffer();
+    if (!order_template.Render(price, client_order_id, buffer)) {
+        std::cerr << "Order template rejected price / clOrdId" << std::endl;
+        return "";
+    }
+    if (!SendHotRequest(place_order_endpoint_, buffer)) {
+        return "";
+    }
+    LatencyRegistry::Timer parse_timer(place_order_endpoint_.latency, LatencyStage::kParse);
+    if (!IsSuccessCode(buffer.response)) {
+        return "";
+    }
+    return std::string(FirstDataField(buffer.response, "ordId"));
+}
+
+std::future<std::string> OKXRestAPI::PlaceOrderAsync(const Order& order) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    std::future<std::string> future = promise->get_future();
+
+    MakeRequestAsync("POST", "/api/v5/trade/order", BuildOrderBody(order), true,
+        [promise](const json& response) {
+            std::string order_id;
+            if (!response.empty() && response.value("code", "") == "0" &&
+                response.contains("data") && !response["data"].empty()) {
+                order_id = response["data"][0].value("ordId", "");
+            }
+            promise->set_value(order_id);
+        });
+
+    return future;
+}
+
+json OKXRestAPI::BuildOrderBody(const Order& order) const {
+    InstrumentScale scale;
+    bool has_scale = OrderScale(order, scale);
+    const FixedScale* price_scale = has_scale ? &scale.price : nullptr;
+    const FixedScale* size_scale = has_scale ? &scale.size : nullptr;
+
     json body = {
         {"instId", order.inst_id},
         {"tdMode", order.trade_mode},
         {"side", order.side},
         {"ordType", order.order_type},
-        {"sz", std::to_string(order.size)}
+        {"sz", FormatDecimal(order.size, order.size_lots, size_scale)}
     };
 
     // Optional fields
     if (!order.position_side.empty()) {
         body["posSide"] = order.position_side;
     }
-    if (order.price > 0) {
-        body["px"] = std::to_string(order.price);
+    if (order.price > 0 || (has_scale && order.price_ticks > 0)) {
+        body["px"] = FormatDecimal(order.price, order.price_ticks, price_scale);
     }
     if (!order.client_order_id.empty()) {
         body["clOrdId"] = order.client_order_id;
     }
     if (order.tp_trigger_price > 0) {
-        body["tpTriggerPx"] = std::to_string(order.tp_trigger_price);
-        body["tpOrdPx"] = std::to_string(order.tp_order_price);
+        body["tpTriggerPx"] = FormatDecimal(order.tp_trigger_price, 0, price_scale);
+        body["tpOrdPx"] = FormatDecimal(order.tp_order_price, 0, price_scale);
     }
     if (order.sl_trigger_price > 0) {
-        body["slTriggerPx"] = std::to_string(order.sl_trigger_price);
-        body["slOrdPx"] = std::to_string(order.sl_order_price);
+        body["slTriggerPx"] = FormatDecimal(order.sl_trigger_price, 0, price_scale);
+        body["slOrdPx"] = FormatDecimal(order.sl_order_price, 0, price_scale);
     }
 
-    json response = MakeRequest("POST", "/api/v5/trade/order", body, true);
-
-    if (!response.empty() && response.value("code", "") == "0" &&
-        response.contains("data") && !response["data"].empty()) {
-        return response["data"][0].value("ordId", "");
-    }
-
-    return "";
+    return body;
 }
 
 std::vector<std::string> OKXRestAPI::PlaceBatchOrders(const std::vector<Order>& orders) {
@@ -325,19 +625,23 @@ std::vector<std::string> OKXRestAPI::PlaceBatchOrders(const std::vector<Order>&
 
     json order_array = json::array();
     for (const auto& order : orders) {
+        InstrumentScale scale;
+        bool has_scale = OrderScale(order, scale);
+
         json order_json = {
             {"instId", order.inst_id},
             {"tdMode", order.trade_mode},
             {"side", order.side},
             {"ordType", order.order_type},
-            {"sz", std::to_string(order.size)}
+            {"sz", FormatDecimal(order.size, order.size_lots, has_scale ? &scale.size : nullptr)}
         };
 
         if (!order.position_side.empty()) {
             order_json["posSide"] = order.position_side;
         }
-        if (order.price > 0) {
-            order_json["px"] = std::to_string(order.price);
+        if (order.price > 0 || (has_scale && order.price_ticks > 0)) {
+            order_json["px"] = FormatDecimal(order.price, order.price_ticks,
+                                             has_scale ? &scale.price : nullptr);
         }
         if (!order.client_order_id.empty()) {
             order_json["clOrdId"] = order.client_order_id;
@@ -366,6 +670,41 @@ std::vector<std::string> OKXRestAPI::PlaceBatchOrders(const std::vector<Order>&
 bool OKXRestAPI::CancelOrder(const std::string& inst_id,
                              const std::string& order_id,
                              const std::string& client_order_id) {
+    OKXRequestBuffer& buffer = HotPathBuffer();
+    if (initialized_ && signer_ &&
+        OKXRequestBuilder::BuildCancelOrder(inst_id, order_id, client_order_id, buffer)) {
+        if (!SendHotRequest(cancel_order_endpoint_, buffer)) {
+            return false;
+        }
+        LatencyRegistry::Timer parse_timer(cancel_order_endpoint_.latency, LatencyStage::kParse);
+        return IsSuccessCode(buffer.response);
+    }
+
+    json body = BuildCancelBody(inst_id, order_id, client_order_id);
+
+    json response = MakeRequest("POST", "/api/v5/trade/cancel-order", body, true);
+
+    return !response.empty() && response.value("code", "") == "0";
+}
+
+std::future<bool> OKXRestAPI::CancelOrderAsync(const std::string& inst_id,
+                                               const std::string& order_id,
+                                               const std::string& client_order_id) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+
+    MakeRequestAsync("POST", "/api/v5/trade/cancel-order",
+        BuildCancelBody(inst_id, order_id, client_order_id), true,
+        [promise](const json& response) {
+            promise->set_value(!response.empty() && response.value("code", "") == "0");
+        });
+
+    return future;
+}
+
+json OKXRestAPI::BuildCancelBody(const std::string& inst_id,
+                                 const std::string& order_id,
+                                 const std::string& client_order_id) const {
     json body = {
         {"instId", inst_id}
     };
@@ -377,9 +716,7 @@ bool OKXRestAPI::CancelOrder(const std::string& inst_id,
         body["clOrdId"] = client_order_id;
     }
 
-    json response = MakeRequest("POST", "/api/v5/trade/cancel-order", body, true);
-
-    return !response.empty() && response.value("code", "") == "0";
+    return body;
 }
 
 std::vector<bool> OKXRestAPI::CancelBatchOrders(const std::vector<CancelRequest>& requests) {
@@ -420,6 +757,16 @@ bool OKXRestAPI::AmendOrder(const std::string& inst_id,
                            const std::string& order_id,
                            const std::string& new_size,
                            const std::string& new_price) {
+    OKXRequestBuffer& buffer = HotPathBuffer();
+    if (initialized_ && signer_ &&
+        OKXRequestBuilder::BuildAmendOrder(inst_id, order_id, new_size, new_price, buffer)) {
+        if (!SendHotRequest(amend_order_endpoint_, buffer)) {
+            return false;
+        }
+        LatencyRegistry::Timer parse_timer(amend_order_endpoint_.latency, LatencyStage::kParse);
+        return IsSuccessCode(buffer.response);
+    }
+
     json body = {
         {"instId", inst_id},
         {"ordId", order_id}
@@ -451,12 +798,32 @@ Order OKXRestAPI::GetOrder(const std::string& inst_id,
         params["clOrdId"] = client_order_id;
     }
 
-    json response = MakeRequest("GET", "/api/v5/trade/order", params, true);
-
     Order order;
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/trade/order", params, true, body, &latency)) {
+        return order;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+
+    InstrumentScale scale;
+    bool has_scale = GetInstrumentScale(inst_id, scale);
+
+    std::string_view element;
+    if (config_.fast_parse && OKXFastParser::FirstDataElement(body, element) &&
+        OKXFastParser::ParseOrder(element, order, has_scale ? &scale : nullptr)) {
+        return order;
+    }
+    order = Order();
+
+    json response = ParseBody(body);
 
     if (!response.empty() && response.contains("data") && !response["data"].empty()) {
         order = ParseOrder(response["data"][0]);
+        if (has_scale) {
+            order.price_ticks = scale.price.Round(order.price);
+            order.size_lots = scale.size.Round(order.size);
+        }
     }
 
     return order;
@@ -468,9 +835,19 @@ std::vector<Order> OKXRestAPI::GetPendingOrders(const std::string& inst_id) {
         params["instId"] = inst_id;
     }
 
-    json response = MakeRequest("GET", "/api/v5/trade/orders-pending", params, true);
-
     std::vector<Order> orders;
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/trade/orders-pending", params, true, body, &latency)) {
+        return orders;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+
+    if (config_.fast_parse && ParseOrderList(body, orders)) {
+        return orders;
+    }
+
+    json response = ParseBody(body);
 
     if (!response.empty() && response.contains("data")) {
         for (const auto& item : response["data"]) {
@@ -485,63 +862,37 @@ std::vector<Order> OKXRestAPI::GetOrderHistory(const std::string& inst_id,
                                                const std::string& state,
                                                uint64_t begin_time,
                                                uint64_t end_time,
-                                               int limit) {
-    json params = json::object();
-
-    if (!inst_id.empty()) {
-        params["instId"] = inst_id;
-    }
-    if (!state.empty()) {
-        params["state"] = state;
-    }
-    if (begin_time > 0) {
-        params["begin"] = std::to_string(begin_time);
-    }
-    if (end_time > 0) {
-        params["end"] = std::to_string(end_time);
-    }
-    params["limit"] = std::to_string(limit);
-
-    json response = MakeRequest("GET", "/api/v5/trade/orders-history", params, true);
+                                               int limit,
+                                               const std::string& after,
+                                               const std::string& before) {
+    HistoryQuery query;
+    query.inst_id = inst_id;
+    query.state = state;
+    query.begin_time = begin_time;
+    query.end_time = end_time;
+    query.page_size = limit;
+    query.after = after;
 
     std::vector<Order> orders;
-
-    if (!response.empty() && response.contains("data")) {
-        for (const auto& item : response["data"]) {
-            orders.push_back(ParseOrder(item));
-        }
-    }
-
+    FetchOrderPage("/api/v5/trade/orders-history", HistoryParams(query, before), orders);
     return orders;
 }
 
 std::vector<Order> OKXRestAPI::GetOrderArchive(const std::string& inst_id,
                                                uint64_t begin_time,
                                                uint64_t end_time,
-                                               int limit) {
-    json params = json::object();
-
-    if (!inst_id.empty()) {
-        params["instId"] = inst_id;
-    }
-    if (begin_time > 0) {
-        params["begin"] = std::to_string(begin_time);
-    }
-    if (end_time > 0) {
-        params["end"] = std::to_string(end_time);
-    }
-    params["limit"] = std::to_string(limit);
-
-    json response = MakeRequest("GET", "/api/v5/trade/orders-history-archive", params, true);
+                                               int limit,
+                                               const std::string& after,
+                                               const std::string& before) {
+    HistoryQuery query;
+    query.inst_id = inst_id;
+    query.begin_time = begin_time;
+    query.end_time = end_time;
+    query.page_size = limit;
+    query.after = after;
 
     std::vector<Order> orders;
-
-    if (!response.empty() && response.contains("data")) {
-        for (const auto& item : response["data"]) {
-            orders.push_back(ParseOrder(item));
-        }
-    }
-
+    FetchOrderPage("/api/v5/trade/orders-history-archive", HistoryParams(query, before), orders);
     return orders;
 }
 
@@ -550,90 +901,221 @@ std::vector<Order> OKXRestAPI::GetOrderArchive(const std::string& inst_id,
 std::vector<OKXRestAPI::Fill> OKXRestAPI::GetFills(const std::string& inst_id,
                                                    uint64_t begin_time,
                                                    uint64_t end_time,
-                                                   int limit) {
+                                                   int limit,
+                                                   const std::string& after,
+                                                   const std::string& before) {
+    HistoryQuery query;
+    query.inst_id = inst_id;
+    query.begin_time = begin_time;
+    query.end_time = end_time;
+    query.page_size = limit;
+    query.after = after;
+
+    std::vector<Fill> fills;
+    FetchFillPage(HistoryParams(query, before), fills);
+    return fills;
+}
+
+// ==================== Bills ====================
+
+std::vector<OKXRestAPI::Bill> OKXRestAPI::GetBills(const std::string& inst_id,
+                                                   int bill_type,
+                                                   uint64_t begin_time,
+                                                   uint64_t end_time,
+                                                   int limit,
+                                                   const std::string& after,
+                                                   const std::string& before) {
+    HistoryQuery query;
+    query.inst_id = inst_id;
+    query.bill_type = bill_type;
+    query.begin_time = begin_time;
+    query.end_time = end_time;
+    query.page_size = limit;
+    query.after = after;
+
+    std::vector<Bill> bills;
+    FetchBillPage(HistoryParams(query, before), bills);
+    return bills;
+}
+
+// ==================== History Iteration ====================
+
+json OKXRestAPI::HistoryParams(const HistoryQuery& query, const std::string& before) {
     json params = json::object();
 
-    if (!inst_id.empty()) {
-        params["instId"] = inst_id;
+    if (!query.inst_type.empty()) {
+        params["instType"] = query.inst_type;
+    }
+    if (!query.inst_id.empty()) {
+        params["instId"] = query.inst_id;
+    }
+    if (!query.state.empty()) {
+        params["state"] = query.state;
     }
-    if (begin_time > 0) {
-        params["begin"] = std::to_string(begin_time);
+    if (query.bill_type >= 0) {
+        params["type"] = std::to_string(query.bill_type);
     }
-    if (end_time > 0) {
-        params["end"] = std::to_string(end_time);
+    if (!query.after.empty()) {
+        params["after"] = query.after;
     }
-    params["limit"] = std::to_string(limit);
+    if (!before.empty()) {
+        params["before"] = before;
+    }
+    if (query.begin_time > 0) {
+        params["begin"] = std::to_string(query.begin_time);
+    }
+    if (query.end_time > 0) {
+        params["end"] = std::to_string(query.end_time);
+    }
+    params["limit"] = std::to_string(HistoryPageSize(query.page_size));
 
-    json response = MakeRequest("GET", "/api/v5/trade/fills", params, true);
+    return params;
+}
 
-    std::vector<Fill> fills;
+bool OKXRestAPI::FetchOrderPage(const char* endpoint, const json& params, std::vector<Order>& orders,
+                                const std::atomic<bool>* cancelled) {
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", endpoint, params, true, body, &latency, nullptr, cancelled)) {
+        return false;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+
+    if (!IsSuccessCode(body)) {
+        std::cerr << "GET " << endpoint << " failed: " << body << std::endl;
+        return false;
+    }
+
+    if (config_.fast_parse && ParseOrderList(body, orders)) {
+        return true;
+    }
+
+    orders.clear();
+    json response = ParseBody(body);
 
     if (!response.empty() && response.contains("data")) {
+        for (const auto& item : response["data"]) {
+            orders.push_back(ParseOrder(item));
+        }
+    }
+
+    return true;
+}
+
+bool OKXRestAPI::FetchFillPage(const json& params, std::vector<Fill>& fills,
+                               const std::atomic<bool>* cancelled) {
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/trade/fills", params, true, body, &latency, nullptr, cancelled)) {
+        return false;
+    }
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+    json response = ParseBody(body);
+
+    if (response.value("code", "") != "0") {
+        if (!response.empty()) {
+            std::cerr << "GET /api/v5/trade/fills failed: " << response.dump() << std::endl;
+        }
+        return false;
+    }
+
+    if (response.contains("data")) {
         for (const auto& item : response["data"]) {
             Fill fill;
+            fill.bill_id = item.value("billId", "");
             fill.inst_id = item.value("instId", "");
             fill.order_id = item.value("ordId", "");
             fill.trade_id = item.value("tradeId", "");
             fill.fill_id = item.value("fillId", "");
             fill.side = item.value("side", "");
-            fill.fill_price = std::stod(item.value("fillPx", "0"));
-            fill.fill_size = std::stod(item.value("fillSz", "0"));
-            fill.fee = std::stod(item.value("fee", "0"));
+            fill.fill_price = JsonDouble(item, "fillPx");
+            fill.fill_size = JsonDouble(item, "fillSz");
+            fill.fee = JsonDouble(item, "fee");
             fill.fee_currency = item.value("feeCcy", "");
-            fill.fill_time = std::stoull(item.value("fillTime", "0"));
+            fill.fill_time = JsonUint64(item, "fillTime");
             fill.exec_type = item.value("execType", "");
             fills.push_back(fill);
         }
     }
 
-    return fills;
+    return true;
 }
 
-// ==================== Bills ====================
-
-std::vector<OKXRestAPI::Bill> OKXRestAPI::GetBills(const std::string& inst_id,
-                                                   int bill_type,
-                                                   uint64_t begin_time,
-                                                   uint64_t end_time,
-                                                   int limit) {
-    json params = json::object();
-
-    if (!inst_id.empty()) {
-        params["instId"] = inst_id;
-    }
-    if (bill_type >= 0) {
-        params["type"] = std::to_string(bill_type);
-    }
-    if (begin_time > 0) {
-        params["begin"] = std::to_string(begin_time);
-    }
-    if (end_time > 0) {
-        params["end"] = std::to_string(end_time);
+bool OKXRestAPI::FetchBillPage(const json& params, std::vector<Bill>& bills,
+                               const std::atomic<bool>* cancelled) {
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest("GET", "/api/v5/account/bills", params, true, body, &latency, nullptr, cancelled)) {
+        return false;
     }
-    params["limit"] = std::to_string(limit);
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+    json response = ParseBody(body);
 
-    json response = MakeRequest("GET", "/api/v5/account/bills", params, true);
-
-    std::vector<Bill> bills;
+    if (response.value("code", "") != "0") {
+        if (!response.empty()) {
+            std::cerr << "GET /api/v5/account/bills failed: " << response.dump() << std::endl;
+        }
+        return false;
+    }
 
-    if (!response.empty() && response.contains("data")) {
+    if (response.contains("data")) {
         for (const auto& item : response["data"]) {
             Bill bill;
             bill.bill_id = item.value("billId", "");
             bill.inst_id = item.value("instId", "");
             bill.currency = item.value("ccy", "");
-            bill.bill_type = SafeStoi(item.value("type", "0"));
+            bill.bill_type = JsonInt(item, "type");
             bill.bill_sub_type = item.value("subType", "");
-            bill.balance_change = std::stod(item.value("balChg", "0"));
-            bill.balance = std::stod(item.value("bal", "0"));
-            bill.fee = std::stod(item.value("fee", "0"));
-            bill.timestamp = std::stoull(item.value("ts", "0"));
+            bill.balance_change = JsonDouble(item, "balChg");
+            bill.balance = JsonDouble(item, "bal");
+            bill.fee = JsonDouble(item, "fee");
+            bill.timestamp = JsonUint64(item, "ts");
             bill.notes = item.value("notes", "");
             bills.push_back(bill);
         }
     }
 
-    return bills;
+    return true;
+}
+
+HistoryPager<Order> OKXRestAPI::IterateOrderHistory(const HistoryQuery& query) {
+    return MakeHistoryPager<Order>(query,
+        [this, query](const std::string& after, std::vector<Order>& page, const std::atomic<bool>& cancelled) {
+            HistoryQuery next = query;
+            next.after = after;
+            return FetchOrderPage("/api/v5/trade/orders-history", HistoryParams(next), page, &cancelled);
+        },
+        [](const Order& order) { return order.order_id; });
+}
+
+HistoryPager<Order> OKXRestAPI::IterateOrderArchive(const HistoryQuery& query) {
+    return MakeHistoryPager<Order>(query,
+        [this, query](const std::string& after, std::vector<Order>& page, const std::atomic<bool>& cancelled) {
+            HistoryQuery next = query;
+            next.after = after;
+            return FetchOrderPage("/api/v5/trade/orders-history-archive", HistoryParams(next), page, &cancelled);
+        },
+        [](const Order& order) { return order.order_id; });
+}
+
+HistoryPager<OKXRestAPI::Fill> OKXRestAPI::IterateFills(const HistoryQuery& query) {
+    return MakeHistoryPager<Fill>(query,
+        [this, query](const std::string& after, std::vector<Fill>& page, const std::atomic<bool>& cancelled) {
+            HistoryQuery next = query;
+            next.after = after;
+            return FetchFillPage(HistoryParams(next), page, &cancelled);
+        },
+        [](const Fill& fill) { return fill.bill_id; });
+}
+
+HistoryPager<OKXRestAPI::Bill> OKXRestAPI::IterateBills(const HistoryQuery& query) {
+    return MakeHistoryPager<Bill>(query,
+        [this, query](const std::string& after, std::vector<Bill>& page, const std::atomic<bool>& cancelled) {
+            HistoryQuery next = query;
+            next.after = after;
+            return FetchBillPage(HistoryParams(next), page, &cancelled);
+        },
+        [](const Bill& bill) { return bill.bill_id; });
 }
 
 // ==================== Utility ====================
@@ -647,6 +1129,39 @@ bool OKXRestAPI::TestConnection() {
     }
 }
 
+int64_t OKXRestAPI::GetServerTime() {
+    int64_t send_us, receive_us;
+    return GetServerTime(send_us, receive_us);
+}
+
+int64_t OKXRestAPI::GetServerTime(int64_t& send_us, int64_t& receive_us) {
+    std::string body;
+    HttpClient::Timings timings;
+    send_us = ClockSync::LocalNowUs();
+    bool sent = MakeRawRequest("GET", "/api/v5/public/time", json::object(), false, body, nullptr, &timings);
+    int64_t end_us = ClockSync::LocalNowUs();
+    if (!sent) {
+        return 0;
+    }
+
+    // Cumulative from the start of the last attempt: setup, then request, then first byte
+    receive_us = end_us;
+    if (timings.total_ns > 0) {
+        int64_t setup_ns = timings.dns_ns + timings.connect_ns + timings.tls_ns;
+        receive_us = end_us - (timings.total_ns - timings.ttfb_ns) / 1000;
+        send_us = std::max(send_us, end_us - (timings.total_ns - setup_ns) / 1000);
+    }
+
+    try {
+        json response = ParseBody(body);
+        if (response.contains("data") && response["data"].is_array() && !response["data"].empty()) {
+            return static_cast<int64_t>(JsonUint64(response["data"][0], "ts"));
+        }
+    } catch (...) {
+    }
+    return 0;
+}
+
 OKXRestAPI::APIStatistics OKXRestAPI::GetStatistics() const {
     std::lock_guard<std::mutex> lock(stats_mutex_);
 
@@ -665,20 +1180,305 @@ OKXRestAPI::APIStatistics OKXRestAPI::GetStatistics() const {
     return stats;
 }
 
+std::map<std::string, RateLimiter::BucketStatistics> OKXRestAPI::GetRateLimitStatistics() const {
+    return rate_limiter_.GetAllStatistics();
+}
+
+LatencyRegistry::Snapshot OKXRestAPI::GetLatencySnapshot() const {
+    return latency_.GetSnapshot();
+}
+
+void OKXRestAPI::ResetLatency() {
+    latency_.Reset();
+}
+
 // ==================== Private Helper Functions ====================
 
 json OKXRestAPI::MakeRequest(const std::string& method,
                              const std::string& endpoint,
                              const json& params,
                              bool is_private) {
+    std::string body;
+    LatencyRegistry::Endpoint* latency = nullptr;
+    if (!MakeRawRequest(method, endpoint, params, is_private, body, &latency)) {
+        return json::object();
+    }
+
+    LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+    return ParseBody(body);
+}
+
+bool OKXRestAPI::MakeRawRequest(const std::string& method,
+                                const std::string& endpoint,
+                                const json& params,
+                                bool is_private,
+                                std::string& body,
+                                LatencyRegistry::Endpoint** latency,
+                                HttpClient::Timings* timings,
+                                const std::atomic<bool>* cancelled) {
     if (!initialized_) {
         std::cerr << "API not initialized" << std::endl;
-        return json::object();
+        return false;
     }
 
-    std::string url = config_.base_url + endpoint;
-    std::string body;
-    std::map<std::string, std::string> headers;
+    LatencyRegistry::Endpoint& stages = latency_.Get(method + " " + endpoint);
+    if (latency) {
+        *latency = &stages;
+    }
+
+    if (cancelled && cancelled->load()) {
+        return false;
+    }
+    RateLimiter::Clock::time_point not_before;
+    if (!AcquireRateLimit(method, endpoint, params, not_before)) {
+        return false;
+    }
+    if (!cancelled) {
+        std::this_thread::sleep_until(not_before);
+    } else {
+        // Queued behind the limiter: wake now and then to see if still wanted
+        while (!cancelled->load() && RateLimiter::Clock::now() < not_before) {
+            std::this_thread::sleep_until(std::min(not_before,
+                                                   RateLimiter::Clock::now() + std::chrono::milliseconds(10)));
+        }
+        if (cancelled->load()) {
+            return false;
+        }
+    }
+
+    PreparedRequest request = PrepareRequest(method, endpoint, params, is_private);
+
+    // Make HTTP request
+    HttpClient::Response response;
+
+    if (method == "GET") {
+        response = http_client_->Get(request.url, request.headers);
+    } else if (method == "POST") {
+        response = http_client_->Post(request.url, request.body, request.headers);
+    } else if (method == "DELETE") {
+        response = http_client_->Delete(request.url, request.headers);
+    } else if (method == "PUT") {
+        response = http_client_->Put(request.url, request.body, request.headers);
+    }
+
+    if (response.status_code != 0) {
+        response.timings.RecordTo(stages);
+    }
+    if (timings) {
+        *timings = response.timings;
+    }
+    bool success = RecordResponse(response);
+    body = std::move(response.body);
+    return success;
+}
+
+void OKXRestAPI::MakeRequestAsync(const std::string& method,
+                                  const std::string& endpoint,
+                                  const json& params,
+                                  bool is_private,
+                                  std::function<void(const json&)> on_response) {
+    if (!initialized_) {
+        std::cerr << "API not initialized" << std::endl;
+        on_response(json::object());
+        return;
+    }
+
+    RateLimiter::Clock::time_point not_before;
+    if (!AcquireRateLimit(method, endpoint, params, not_before)) {
+        on_response(json::object());
+        return;
+    }
+
+    PreparedRequest request = PrepareRequest(method, endpoint, params, is_private);
+    LatencyRegistry::Endpoint* latency = &latency_.Get(method + " " + endpoint);
+
+    http_client_->SubmitAsync(method, request.url, request.body, request.headers,
+        [this, latency, on_response = std::move(on_response)](const HttpClient::Response& response) {
+            if (response.status_code != 0) {
+                response.timings.RecordTo(*latency);
+            }
+            json parsed;
+            {
+                LatencyRegistry::Timer parse_timer(latency, LatencyStage::kParse);
+                parsed = HandleResponse(response);
+            }
+            LatencyRegistry::Timer dispatch_timer(latency, LatencyStage::kDispatch);
+            on_response(parsed);
+        },
+        not_before);
+}
+
+bool OKXRestAPI::AcquireRateLimit(const std::string& method,
+                                  const std::string& endpoint,
+                                  const json& params,
+                                  RateLimiter::Clock::time_point& not_before) {
+    // Batch endpoints are limited by the number of orders, not requests
+    double cost = params.is_array() ? static_cast<double>(params.size()) : 1.0;
+
+    RateLimiter::Decision decision = rate_limiter_.Acquire(
+        method + " " + endpoint,
+        std::chrono::milliseconds(config_.rate_limit_max_wait_ms),
+        cost);
+
+    not_before = decision.not_before;
+    if (decision.granted) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.total_requests++;
+        stats_.failed_requests++;
+        stats_.rate_limited_requests++;
+    }
+    std::cerr << "Rate limit exceeded: " << method << " " << endpoint << std::endl;
+    return false;
+}
+
+void OKXRestAPI::InitializeHotPath() {
+    place_order_endpoint_.path = "/api/v5/trade/order";
+    cancel_order_endpoint_.path = "/api/v5/trade/cancel-order";
+    amend_order_endpoint_.path = "/api/v5/trade/amend-order";
+
+    for (HotEndpoint* endpoint : {&place_order_endpoint_, &cancel_order_endpoint_,
+                                  &amend_order_endpoint_}) {
+        endpoint->url = config_.base_url + endpoint->path;
+        endpoint->bucket = rate_limiter_.GetBucket(std::string("POST ") + endpoint->path);
+        endpoint->latency = &latency_.Get(std::string("POST ") + endpoint->path);
+    }
+
+    // Headers that never change; each request links its timestamp and
+    // signature nodes in front of this list
+    curl_slist_free_all(static_headers_);
+    static_headers_ = nullptr;
+    static_headers_ = curl_slist_append(static_headers_, "Content-Type: application/json");
+    static_headers_ = curl_slist_append(static_headers_, "Accept: application/json");
+    if (signer_) {
+        std::string key = "OK-ACCESS-KEY: " + signer_->GetAPIKey();
+        std::string passphrase = "OK-ACCESS-PASSPHRASE: " + signer_->GetPassphrase();
+        static_headers_ = curl_slist_append(static_headers_, key.c_str());
+        static_headers_ = curl_slist_append(static_headers_, passphrase.c_str());
+    }
+    if (config_.is_simulation) {
+        static_headers_ = curl_slist_append(static_headers_, "x-simulated-trading: 1");
+    }
+}
+
+bool OKXRestAPI::SendHotRequest(const HotEndpoint& endpoint, OKXRequestBuffer& buffer) {
+    RateLimiter::Decision decision = rate_limiter_.Acquire(
+        endpoint.bucket, std::chrono::milliseconds(config_.rate_limit_max_wait_ms));
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.total_requests++;
+        if (!decision.granted) {
+            stats_.failed_requests++;
+            stats_.rate_limited_requests++;
+        }
+    }
+    if (!decision.granted) {
+        std::cerr << "Rate limit exceeded: POST " << endpoint.path << std::endl;
+        return false;
+    }
+    std::this_thread::sleep_until(decision.not_before);
+
+    // Timestamp and signature headers
+    size_t timestamp_length = OKXSigner::FormatTimestamp(buffer.timestamp);
+    std::string_view timestamp(buffer.timestamp, timestamp_length);
+
+    FixedWriter timestamp_header(buffer.timestamp_header, sizeof(buffer.timestamp_header));
+    timestamp_header.Append("OK-ACCESS-TIMESTAMP: ");
+    timestamp_header.Append(timestamp);
+    timestamp_header.Terminate();
+
+    char signature[OKXSigner::kSignatureLength + 1];
+    size_t signature_length = signer_->SignTo(
+        timestamp, "POST", endpoint.path,
+        std::string_view(buffer.body, buffer.body_length), signature);
+
+    FixedWriter sign_header(buffer.sign_header, sizeof(buffer.sign_header));
+    sign_header.Append("OK-ACCESS-SIGN: ");
+    sign_header.Append(std::string_view(signature, signature_length));
+    sign_header.Terminate();
+
+    buffer.sign_node.next = static_headers_;
+
+    HttpClient::RawRequest request;
+    request.method = "POST";
+    request.url = endpoint.url.c_str();
+    request.body = buffer.body;
+    request.body_length = buffer.body_length;
+    request.headers = &buffer.timestamp_node;
+    HttpClient::Timings timings;
+    request.timings = &timings;
+
+    int status_code = http_client_->PerformRaw(request, buffer.response);
+    if (status_code != 0 && endpoint.latency) {
+        timings.RecordTo(*endpoint.latency);
+    }
+    bool success = status_code >= 200 && status_code < 300;
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        if (success) {
+            stats_.successful_requests++;
+        } else {
+            stats_.failed_requests++;
+        }
+    }
+
+    if (!success) {
+        std::cerr << "HTTP request failed: " << status_code << std::endl;
+        std::cerr << "Response: " << buffer.response << std::endl;
+    }
+
+    return success;
+}
+
+void OKXRestAPI::ConfigureRateLimits() {
+    using std::chrono::seconds;
+    auto per_2s = [](int requests) {
+        return RateLimiter::Limit::PerWindow(requests, seconds(2));
+    };
+
+    // https://www.okx.com/docs-v5/en/ (limits per 2 seconds)
+    rate_limiter_.SetDefaultLimit(per_2s(10));
+
+    // Market data (per IP)
+    rate_limiter_.SetLimit("GET /api/v5/market/ticker", per_2s(20));
+    rate_limiter_.SetLimit("GET /api/v5/market/books", per_2s(40));
+    rate_limiter_.SetLimit("GET /api/v5/market/candles", per_2s(40));
+    rate_limiter_.SetLimit("GET /api/v5/public/funding-rate", per_2s(20));
+    rate_limiter_.SetLimit("GET /api/v5/public/instruments", per_2s(20));
+    rate_limiter_.SetLimit("GET /api/v5/public/time", per_2s(10));
+
+    // Account
+    rate_limiter_.SetLimit("GET /api/v5/account/balance", per_2s(10));
+    rate_limiter_.SetLimit("GET /api/v5/account/positions", per_2s(10));
+    rate_limiter_.SetLimit("GET /api/v5/account/config", per_2s(5));
+    rate_limiter_.SetLimit("POST /api/v5/account/set-leverage", per_2s(20));
+    rate_limiter_.SetLimit("GET /api/v5/account/bills", RateLimiter::Limit::PerWindow(5, seconds(1)));
+
+    // Trading (batch endpoints count orders)
+    rate_limiter_.SetLimit("POST /api/v5/trade/order", per_2s(60));
+    rate_limiter_.SetLimit("POST /api/v5/trade/batch-orders", per_2s(300));
+    rate_limiter_.SetLimit("POST /api/v5/trade/cancel-order", per_2s(60));
+    rate_limiter_.SetLimit("POST /api/v5/trade/cancel-batch-orders", per_2s(300));
+    rate_limiter_.SetLimit("POST /api/v5/trade/amend-order", per_2s(60));
+    rate_limiter_.SetLimit("POST /api/v5/trade/amend-batch-orders", per_2s(300));
+    rate_limiter_.SetLimit("GET /api/v5/trade/order", per_2s(60));
+    rate_limiter_.SetLimit("GET /api/v5/trade/orders-pending", per_2s(60));
+    rate_limiter_.SetLimit("GET /api/v5/trade/orders-history", per_2s(40));
+    rate_limiter_.SetLimit("GET /api/v5/trade/orders-history-archive", per_2s(20));
+    rate_limiter_.SetLimit("GET /api/v5/trade/fills", per_2s(60));
+}
+
+OKXRestAPI::PreparedRequest OKXRestAPI::PrepareRequest(const std::string& method,
+                                                       const std::string& endpoint,
+                                                       const json& params,
+                                                       bool is_private) {
+    PreparedRequest request;
+    std::string request_path = endpoint;   // What OKX signs: path plus query string
 
     // Update statistics
     {
@@ -688,40 +1488,41 @@ json OKXRestAPI::MakeRequest(const std::string& method,
 
     if (method == "GET" && !params.empty()) {
         // Add query parameters to URL
-        url += "?";
+        std::string query = "?";
         bool first = true;
         for (auto& [key, value] : params.items()) {
-            if (!first) url += "&";
-            url += key + "=" + value.get<std::string>();
+            if (!first) query += "&";
+            query += key + "=" + value.get<std::string>();
             first = false;
         }
+        request_path += query;
     } else if (method == "POST" && !params.empty()) {
-        body = params.dump();
+        request.body = params.dump();
     }
+    request.url = config_.base_url + request_path;
 
     // Add authentication headers for private endpoints
     if (is_private && signer_) {
-        headers = GetAuthHeaders(method, endpoint, body);
+        request.headers = GetAuthHeaders(method, request_path, request.body);
     }
 
     // Add simulation flag if needed
     if (config_.is_simulation) {
-        headers["x-simulated-trading"] = "1";
+        request.headers["x-simulated-trading"] = "1";
     }
 
-    // Make HTTP request
-    HttpClient::Response response;
+    return request;
+}
 
-    if (method == "GET") {
-        response = http_client_->Get(url, headers);
-    } else if (method == "POST") {
-        response = http_client_->Post(url, body, headers);
-    } else if (method == "DELETE") {
-        response = http_client_->Delete(url, headers);
-    } else if (method == "PUT") {
-        response = http_client_->Put(url, body, headers);
+json OKXRestAPI::HandleResponse(const HttpClient::Response& response) {
+    if (!RecordResponse(response)) {
+        return json::object();
     }
 
+    return ParseBody(response.body);
+}
+
+bool OKXRestAPI::RecordResponse(const HttpClient::Response& response) {
     // Update statistics
     {
         std::lock_guard<std::mutex> lock(stats_mutex_);
@@ -732,23 +1533,27 @@ json OKXRestAPI::MakeRequest(const std::string& method,
         }
     }
 
-    // Parse JSON response
-    if (response.IsSuccess() && !response.body.empty()) {
-        try {
-            return json::parse(response.body);
-        } catch (const json::exception& e) {
-            std::cerr << "JSON parse error: " << e.what() << std::endl;
-            std::cerr << "Response: " << response.body << std::endl;
-            return json::object();
-        }
-    }
-
     if (!response.IsSuccess()) {
         std::cerr << "HTTP request failed: " << response.status_code << std::endl;
         std::cerr << "Response: " << response.body << std::endl;
     }
 
-    return json::object();
+    return response.IsSuccess();
+}
+
+json OKXRestAPI::ParseBody(const std::string& body) {
+    if (body.empty()) {
+        return json::object();
+    }
+
+    // Parse JSON response
+    try {
+        return json::parse(body);
+    } catch (const json::exception& e) {
+        std::cerr << "JSON parse error: " << e.what() << std::endl;
+        std::cerr << "Response: " << body << std::endl;
+        return json::object();
+    }
 }
 
 std::map<std::string, std::string> OKXRestAPI::GetAuthHeaders(
@@ -769,20 +1574,68 @@ std::map<std::string, std::string> OKXRestAPI::GetAuthHeaders(
 
 // ==================== Parse Response Helpers ====================
 
+bool OKXRestAPI::ParseOrderList(const std::string& body, std::vector<Order>& orders) {
+    OKXFastParser::Envelope envelope;
+    if (!OKXFastParser::ParseEnvelope(body, envelope)) {
+        return false;
+    }
+
+    OKXFastParser::ArrayReader data(envelope.data);
+    std::string_view element;
+    while (data.Next(element)) {
+        Order order;
+        if (!OKXFastParser::ParseOrder(element, order)) {
+            orders.clear();
+            return false;
+        }
+        orders.push_back(std::move(order));
+    }
+
+    if (!data.Ok()) {
+        orders.clear();
+        return false;
+    }
+    return true;
+}
+
+bool OKXRestAPI::ParsePositionList(const std::string& body, std::vector<Position>& positions) {
+    OKXFastParser::Envelope envelope;
+    if (!OKXFastParser::ParseEnvelope(body, envelope)) {
+        return false;
+    }
+
+    OKXFastParser::ArrayReader data(envelope.data);
+    std::string_view element;
+    while (data.Next(element)) {
+        Position position;
+        if (!OKXFastParser::ParsePosition(element, position)) {
+            positions.clear();
+            return false;
+        }
+        positions.push_back(std::move(position));
+    }
+
+    if (!data.Ok()) {
+        positions.clear();
+        return false;
+    }
+    return true;
+}
+
 Tick OKXRestAPI::ParseTicker(const json& data) {
     Tick tick;
 
     tick.inst_id = data.value("instId", "");
-    tick.last_price = std::stod(data.value("last", "0"));
-    tick.bid_price = std::stod(data.value("bidPx", "0"));
-    tick.bid_size = std::stod(data.value("bidSz", "0"));
-    tick.ask_price = std::stod(data.value("askPx", "0"));
-    tick.ask_size = std::stod(data.value("askSz", "0"));
-    tick.high_24h = std::stod(data.value("high24h", "0"));
-    tick.low_24h = std::stod(data.value("low24h", "0"));
-    tick.volume_24h = std::stod(data.value("vol24h", "0"));
-    tick.volume_currency_24h = std::stod(data.value("volCcy24h", "0"));
-    tick.timestamp = std::stoull(data.value("ts", "0"));
+    tick.last_price = JsonDouble(data, "last");
+    tick.bid_price = JsonDouble(data, "bidPx");
+    tick.bid_size = JsonDouble(data, "bidSz");
+    tick.ask_price = JsonDouble(data, "askPx");
+    tick.ask_size = JsonDouble(data, "askSz");
+    tick.high_24h = JsonDouble(data, "high24h");
+    tick.low_24h = JsonDouble(data, "low24h");
+    tick.volume_24h = JsonDouble(data, "vol24h");
+    tick.volume_currency_24h = JsonDouble(data, "volCcy24h");
+    tick.timestamp = JsonUint64(data, "ts");
 
     return tick;
 }
@@ -790,15 +1643,15 @@ Tick OKXRestAPI::ParseTicker(const json& data) {
 Depth OKXRestAPI::ParseOrderBook(const json& data) {
     Depth depth;
 
-    depth.timestamp = std::stoull(data.value("ts", "0"));
+    depth.timestamp = JsonUint64(data, "ts");
 
     // Parse bids
     if (data.contains("bids") && data["bids"].is_array()) {
         for (const auto& bid : data["bids"]) {
             if (bid.is_array() && bid.size() >= 2) {
                 DepthLevel level;
-                level.price = std::stod(bid[0].get<std::string>());
-                level.size = std::stod(bid[1].get<std::string>());
+                level.price = JsonDouble(bid[0]);
+                level.size = JsonDouble(bid[1]);
                 depth.bids.push_back(level);
             }
         }
@@ -809,8 +1662,8 @@ Depth OKXRestAPI::ParseOrderBook(const json& data) {
         for (const auto& ask : data["asks"]) {
             if (ask.is_array() && ask.size() >= 2) {
                 DepthLevel level;
-                level.price = std::stod(ask[0].get<std::string>());
-                level.size = std::stod(ask[1].get<std::string>());
+                level.price = JsonDouble(ask[0]);
+                level.size = JsonDouble(ask[1]);
                 depth.asks.push_back(level);
             }
         }
@@ -829,31 +1682,31 @@ Order OKXRestAPI::ParseOrder(const json& data) {
     order.position_side = data.value("posSide", "");
     order.order_type = data.value("ordType", "");
     order.trade_mode = data.value("tdMode", "");
-    order.price = std::stod(data.value("px", "0"));
-    order.size = std::stod(data.value("sz", "0"));
-    order.filled_size = std::stod(data.value("accFillSz", "0"));
-        order.avg_fill_price = std::stod(data.value("avgPx", "0"));
+    order.price = JsonDouble(data, "px");
+    order.size = JsonDouble(data, "sz");
+    order.filled_size = JsonDouble(data, "accFillSz");
+        order.avg_fill_price = JsonDouble(data, "avgPx");
     order.state = data.value("state", "");
-    order.fee = std::stod(data.value("fee", "0"));
-    order.pnl = std::stod(data.value("pnl", "0"));
-    order.create_time = std::stoull(data.value("cTime", "0"));
-    order.update_time = std::stoull(data.value("uTime", "0"));
+    order.fee = JsonDouble(data, "fee");
+    order.pnl = JsonDouble(data, "pnl");
+    order.create_time = JsonUint64(data, "cTime");
+    order.update_time = JsonUint64(data, "uTime");
 
     // Optional fields
     if (data.contains("lever")) {
-        order.leverage = SafeStoi(data["lever"].get<std::string>());
+        order.leverage = JsonInt(data, "lever");
     }
     if (data.contains("tpTriggerPx")) {
-        order.tp_trigger_price = std::stod(data["tpTriggerPx"].get<std::string>());
+        order.tp_trigger_price = JsonDouble(data, "tpTriggerPx");
     }
     if (data.contains("tpOrdPx")) {
-        order.tp_order_price = std::stod(data["tpOrdPx"].get<std::string>());
+        order.tp_order_price = JsonDouble(data, "tpOrdPx");
     }
     if (data.contains("slTriggerPx")) {
-        order.sl_trigger_price = std::stod(data["slTriggerPx"].get<std::string>());
+        order.sl_trigger_price = JsonDouble(data, "slTriggerPx");
     }
     if (data.contains("slOrdPx")) {
-        order.sl_order_price = std::stod(data["slOrdPx"].get<std::string>());
+        order.sl_order_price = JsonDouble(data, "slOrdPx");
     }
 
     return order;
@@ -864,21 +1717,21 @@ Position OKXRestAPI::ParsePosition(const json& data) {
 
     pos.inst_id = data.value("instId", "");
     pos.position_side = data.value("posSide", "");
-    pos.position = std::stod(data.value("pos", "0"));
-    pos.available_position = std::stod(data.value("availPos", "0"));
-    pos.avg_price = std::stod(data.value("avgPx", "0"));
-    pos.mark_price = std::stod(data.value("markPx", "0"));
-    pos.liquidation_price = std::stod(data.value("liqPx", "0"));
-    pos.unrealized_pnl = std::stod(data.value("upl", "0"));
-    pos.unrealized_pnl_ratio = std::stod(data.value("uplRatio", "0"));
-    pos.leverage = SafeStoi(data.value("lever", "0"));
-    pos.margin = std::stod(data.value("margin", "0"));
-    pos.margin_ratio = std::stod(data.value("mgnRatio", "0"));
-    pos.initial_margin = std::stod(data.value("imr", "0"));
-    pos.maintenance_margin = std::stod(data.value("mmr", "0"));
+    pos.position = JsonDouble(data, "pos");
+    pos.available_position = JsonDouble(data, "availPos");
+    pos.avg_price = JsonDouble(data, "avgPx");
+    pos.mark_price = JsonDouble(data, "markPx");
+    pos.liquidation_price = JsonDouble(data, "liqPx");
+    pos.unrealized_pnl = JsonDouble(data, "upl");
+    pos.unrealized_pnl_ratio = JsonDouble(data, "uplRatio");
+    pos.leverage = JsonInt(data, "lever");
+    pos.margin = JsonDouble(data, "margin");
+    pos.margin_ratio = JsonDouble(data, "mgnRatio");
+    pos.initial_margin = JsonDouble(data, "imr");
+    pos.maintenance_margin = JsonDouble(data, "mmr");
     pos.trade_mode = data.value("mgnMode", "");
-    pos.create_time = std::stoull(data.value("cTime", "0"));
-    pos.update_time = std::stoull(data.value("uTime", "0"));
+    pos.create_time = JsonUint64(data, "cTime");
+    pos.update_time = JsonUint64(data, "uTime");
 
     return pos;
 }
@@ -886,27 +1739,26 @@ Position OKXRestAPI::ParsePosition(const json& data) {
 Account OKXRestAPI::ParseAccount(const json& data) {
     Account account;
 
-    // 第889-895行 - 全部改为 SafeStod/SafeStoull
-    account.total_equity = SafeStod(data.value("totalEq", "0"));              // ✅
-    account.isolated_equity = SafeStod(data.value("isoEq", "0"));            // ✅
-    account.adj_equity = SafeStod(data.value("adjEq", "0"));                 // ✅
-    account.margin_ratio = SafeStod(data.value("mgnRatio", "0"));            // ✅
-    account.maintenance_margin_ratio = SafeStod(data.value("mmr", "0"));     // ✅
-    account.initial_margin_ratio = SafeStod(data.value("imr", "0"));         // ✅
-    account.update_time = SafeStoull(data.value("uTime", "0"));              // ✅
+    account.total_equity = JsonDouble(data, "totalEq");
+    account.isolated_equity = JsonDouble(data, "isoEq");
+    account.adj_equity = JsonDouble(data, "adjEq");
+    account.margin_ratio = JsonDouble(data, "mgnRatio");
+    account.maintenance_margin_ratio = JsonDouble(data, "mmr");
+    account.initial_margin_ratio = JsonDouble(data, "imr");
+    account.update_time = JsonUint64(data, "uTime");
 
     // Parse details (currency-specific balances)
     if (data.contains("details") && data["details"].is_array()) {
         for (const auto& detail : data["details"]) {
             Account::Detail d;
             d.currency = detail.value("ccy", "");
-                d.equity = SafeStod(detail.value("eq", "0"));                            // ✅
-                d.cash_balance = SafeStod(detail.value("cashBal", "0"));                 // ✅
-                d.available_balance = SafeStod(detail.value("availBal", "0"));           // ✅
-                d.frozen_balance = SafeStod(detail.value("frozenBal", "0"));             // ✅
-                d.order_frozen = SafeStod(detail.value("ordFrozen", "0"));               // ✅
-                d.available_equity = SafeStod(detail.value("availEq", "0"));             // ✅
-                d.unrealized_pnl = SafeStod(detail.value("upl", "0"));                   // ✅
+                d.equity = JsonDouble(detail, "eq");
+                d.cash_balance = JsonDouble(detail, "cashBal");
+                d.available_balance = JsonDouble(detail, "availBal");
+                d.frozen_balance = JsonDouble(detail, "frozenBal");
+                d.order_frozen = JsonDouble(detail, "ordFrozen");
+                d.available_equity = JsonDouble(detail, "availEq");
+                d.unrealized_pnl = JsonDouble(detail, "upl");
                 account.details.push_back(d);
         }
     }
@@ -1,87 +1,209 @@
 #include "okx_signer.h"
-#include <openssl/hmac.h>
+
+// The key schedule is kept as two plain SHA256_CTX structs that are copied
+// per signature. OpenSSL 3 deprecates this API, but its EVP equivalent
+// (EVP_MD_CTX_copy_ex) allocates on every copy in 3.0.
+#ifndef OPENSSL_SUPPRESS_DEPRECATED
+#define OPENSSL_SUPPRESS_DEPRECATED
+#endif
+#include <openssl/crypto.h>
 #include <openssl/sha.h>
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
-#include <openssl/evp.h>
-#include <iomanip>
-#include <sstream>
+#include <cstdint>
+#include <atomic>
 #include <chrono>
+#include <climits>
+#include <cstring>
+
+struct OKXSigner::KeySchedule {
+    SHA256_CTX inner;   // State after (key ^ ipad)
+    SHA256_CTX outer;   // State after (key ^ opad)
+};
+
+namespace {
+    constexpr size_t kBlockSize = SHA256_CBLOCK;   // 64
+
+    inline void Update(SHA256_CTX& ctx, std::string_view part) {
+        if (!part.empty()) {
+            SHA256_Update(&ctx, part.data(), part.size());
+        }
+    }
+}
 
 OKXSigner::OKXSigner(const std::string& api_key,
                      const std::string& secret_key,
                      const std::string& passphrase)
     : api_key_(api_key)
-    , secret_key_(secret_key)
     , passphrase_(passphrase) {
+    // RFC 2104: keys longer than a block are hashed first
+    unsigned char key[kBlockSize] = {0};
+    if (secret_key.size() > kBlockSize) {
+        SHA256(reinterpret_cast<const unsigned char*>(secret_key.data()), secret_key.size(), key);
+    } else {
+        std::memcpy(key, secret_key.data(), secret_key.size());
+    }
+
+    unsigned char ipad[kBlockSize];
+    unsigned char opad[kBlockSize];
+    for (size_t i = 0; i < kBlockSize; i++) {
+        ipad[i] = key[i] ^ 0x36;
+        opad[i] = key[i] ^ 0x5c;
+    }
+
+    auto schedule = std::make_shared<KeySchedule>();
+    SHA256_Init(&schedule->inner);
+    SHA256_Update(&schedule->inner, ipad, kBlockSize);
+    SHA256_Init(&schedule->outer);
+    SHA256_Update(&schedule->outer, opad, kBlockSize);
+    key_schedule_ = std::move(schedule);
+
+    OPENSSL_cleanse(key, sizeof(key));
+    OPENSSL_cleanse(ipad, sizeof(ipad));
+    OPENSSL_cleanse(opad, sizeof(opad));
 }
 
 std::string OKXSigner::Sign(const std::string& timestamp,
                             const std::string& method,
                             const std::string& request_path,
                             const std::string& body) const {
-    // OKX signature format: timestamp + method + requestPath + body
-    std::string prehash = timestamp + method + request_path + body;
-    
-    // Calculate HMAC-SHA256
-    std::string hmac = HMACSHA256(secret_key_, prehash);
-    
-    // Encode to Base64
-    return Base64Encode(reinterpret_cast<const unsigned char*>(hmac.c_str()), hmac.length());
+    char signature[kSignatureLength + 1];
+    size_t length = SignTo(timestamp, method, request_path, body, signature);
+    return std::string(signature, length);
+}
+
+size_t OKXSigner::SignTo(std::string_view timestamp,
+                         std::string_view method,
+                         std::string_view request_path,
+                         std::string_view body,
+                         char* out) const {
+    // OKX signature format: timestamp + method + requestPath + body,
+    // fed part by part into a copy of the precomputed inner state
+    SHA256_CTX ctx = key_schedule_->inner;
+    Update(ctx, timestamp);
+    Update(ctx, method);
+    Update(ctx, request_path);
+    Update(ctx, body);
+
+    unsigned char digest[SHA256_DIGEST_LENGTH];
+    SHA256_Final(digest, &ctx);
+
+    ctx = key_schedule_->outer;
+    SHA256_Update(&ctx, digest, sizeof(digest));
+    SHA256_Final(digest, &ctx);
+
+    return Base64Encode(digest, sizeof(digest), out);
+}
+
+size_t OKXSigner::Base64Encode(const unsigned char* data, size_t length, char* out) {
+    static constexpr char kAlphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    char* p = out;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        p[0] = kAlphabet[v >> 18];
+        p[1] = kAlphabet[(v >> 12) & 0x3F];
+        p[2] = kAlphabet[(v >> 6) & 0x3F];
+        p[3] = kAlphabet[v & 0x3F];
+        p += 4;
+    }
+    if (i < length) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (i + 1 < length) {
+            v |= uint32_t(data[i + 1]) << 8;
+        }
+        p[0] = kAlphabet[v >> 18];
+        p[1] = kAlphabet[(v >> 12) & 0x3F];
+        p[2] = i + 1 < length ? kAlphabet[(v >> 6) & 0x3F] : '=';
+        p[3] = '=';
+        p += 4;
+    }
+    *p = '\0';
+    return static_cast<size_t>(p - out);
 }
 
 std::string OKXSigner::GetTimestamp() {
-    using namespace std::chrono;
-    
-    // Get current time with milliseconds
-    auto now = system_clock::now();
-    auto ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
-    auto timer = system_clock::to_time_t(now);
-    
-    std::tm tm;
+    char buffer[kTimestampLength + 1];
+    return std::string(buffer, FormatTimestamp(buffer));
+}
+
+size_t OKXSigner::FormatTimestamp(char* out) {
+    return FormatTimestamp(NowMs(), out);
+}
+
+size_t OKXSigner::FormatTimestamp(int64_t epoch_ms, char* out) {
+    // Prefix "2023-01-01T12:00:00." of the second last formatted on this thread
+    thread_local int64_t cached_second = INT64_MIN;
+    thread_local char cached_prefix[20];
+
+    int64_t second = epoch_ms >= 0 ? epoch_ms / 1000 : (epoch_ms - 999) / 1000;
+    int ms = static_cast<int>(epoch_ms - second * 1000);
+
+    auto put2 = [](char* p, int v) { p[0] = static_cast<char>('0' + v / 10); p[1] = static_cast<char>('0' + v % 10); };
+
+    if (second != cached_second) {
+        std::time_t timer = static_cast<std::time_t>(second);
+        std::tm tm;
 #ifdef _WIN32
-    gmtime_s(&tm, &timer);
+        gmtime_s(&tm, &timer);
 #else
-    gmtime_r(&timer, &tm);
+        gmtime_r(&timer, &tm);
 #endif
-    
+        char* p = cached_prefix;
+        int year = tm.tm_year + 1900;
+        put2(p, year / 100);
+        put2(p + 2, year % 100);
+        p[4] = '-';
+        put2(p + 5, tm.tm_mon + 1);
+        p[7] = '-';
+        put2(p + 8, tm.tm_mday);
+        p[10] = 'T';
+        put2(p + 11, tm.tm_hour);
+        p[13] = ':';
+        put2(p + 14, tm.tm_min);
+        p[16] = ':';
+        put2(p + 17, tm.tm_sec);
+        p[19] = '.';
+        cached_second = second;
+    }
+
     // Format: 2023-01-01T12:00:00.123Z
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count() << 'Z';
-    
-    return oss.str();
+    std::memcpy(out, cached_prefix, sizeof(cached_prefix));
+    out[20] = static_cast<char>('0' + ms / 100);
+    put2(out + 21, ms % 100);
+    out[23] = 'Z';
+    out[24] = '\0';
+
+    return kTimestampLength;
+}
+
+namespace {
+    std::atomic<int64_t> g_clock_offset_us{0};
 }
 
-std::string OKXSigner::HMACSHA256(const std::string& key, const std::string& data) const {
-    unsigned char* digest;
-    unsigned int len = SHA256_DIGEST_LENGTH;
-    
-    digest = HMAC(EVP_sha256(),
-                  key.c_str(), key.length(),
-                  reinterpret_cast<const unsigned char*>(data.c_str()), data.length(),
-                  nullptr, nullptr);
-    
-    return std::string(reinterpret_cast<char*>(digest), len);
+void OKXSigner::SetClockOffsetMs(int64_t offset_ms) {
+    g_clock_offset_us.store(offset_ms * 1000, std::memory_order_relaxed);
 }
 
-std::string OKXSigner::Base64Encode(const unsigned char* data, size_t length) const {
-    BIO *bio, *b64;
-    BUF_MEM *buffer_ptr;
-    
-    b64 = BIO_new(BIO_f_base64());
-    bio = BIO_new(BIO_s_mem());
-    bio = BIO_push(b64, bio);
-    
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO_write(bio, data, length);
-    BIO_flush(bio);
-    
-    BIO_get_mem_ptr(bio, &buffer_ptr);
-    
-    std::string result(buffer_ptr->data, buffer_ptr->length);
-    
-    BIO_free_all(bio);
-    
-    return result;
+int64_t OKXSigner::GetClockOffsetMs() {
+    return g_clock_offset_us.load(std::memory_order_relaxed) / 1000;
+}
+
+void OKXSigner::SetClockOffsetUs(int64_t offset_us) {
+    g_clock_offset_us.store(offset_us, std::memory_order_relaxed);
+}
+
+int64_t OKXSigner::GetClockOffsetUs() {
+    return g_clock_offset_us.load(std::memory_order_relaxed);
+}
+
+int64_t OKXSigner::NowMs() {
+    int64_t now_us = NowUs();
+    return now_us >= 0 ? now_us / 1000 : (now_us - 999) / 1000;
+}
+
+int64_t OKXSigner::NowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count() +
+           g_clock_offset_us.load(std::memory_order_relaxed);
 }
@@ -0,0 +1,1237 @@
+#include "okx_websocket.h"
+#include "okx_fast_parser.h"
+#include "okx_numeric.h"
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    constexpr size_t kInitialReceiveBuffer = 64 * 1024;
+    constexpr size_t kMinReceiveSpace = 16 * 1024;
+    constexpr int kMaxReconnectDelaySeconds = 60;
+    constexpr size_t kMaxMessageSize = 64 * 1024 * 1024;
+    constexpr int kMaxPollMs = 1000;
+
+    int64_t SteadyNanos(std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    // Adds the lifetime of the scope to a running total
+    class ScopedDuration {
+    public:
+        explicit ScopedDuration(int64_t& total) : total_(total), start_(LatencyRegistry::NowNs()) {}
+        ~ScopedDuration() { total_ += LatencyRegistry::NowNs() - start_; }
+
+    private:
+        int64_t& total_;
+        int64_t start_;
+    };
+
+    bool IsBookChannel(const std::string& channel) {
+        return channel == "books" || channel == "books-l2-tbt" || channel == "books50-l2-tbt";
+    }
+
+    void ParseAccountDetail(std::string_view object, Account::Detail& detail) {
+        OKXFastParser::ObjectReader reader(object);
+        std::string_view key, value;
+        while (reader.Next(key, value)) {
+            if (key == "ccy") {
+                OKXFastParser::AssignString(detail.currency, value);
+            } else if (key == "eq") {
+                detail.equity = OKXNumeric::ToDouble(value);
+            } else if (key == "cashBal") {
+                detail.cash_balance = OKXNumeric::ToDouble(value);
+            } else if (key == "availBal") {
+                detail.available_balance = OKXNumeric::ToDouble(value);
+            } else if (key == "frozenBal") {
+                detail.frozen_balance = OKXNumeric::ToDouble(value);
+            } else if (key == "ordFrozen") {
+                detail.order_frozen = OKXNumeric::ToDouble(value);
+            } else if (key == "availEq") {
+                detail.available_equity = OKXNumeric::ToDouble(value);
+            } else if (key == "upl") {
+                detail.unrealized_pnl = OKXNumeric::ToDouble(value);
+            }
+        }
+    }
+
+    // Same fields as OKXRestAPI::ParseAccount, without the json DOM
+    bool ParseAccount(std::string_view object, Account& account) {
+        account.details.clear();
+
+        OKXFastParser::ObjectReader reader(object);
+        std::string_view key, value;
+        while (reader.Next(key, value)) {
+            if (key == "totalEq") {
+                account.total_equity = OKXNumeric::ToDouble(value);
+            } else if (key == "isoEq") {
+                account.isolated_equity = OKXNumeric::ToDouble(value);
+            } else if (key == "adjEq") {
+                account.adj_equity = OKXNumeric::ToDouble(value);
+            } else if (key == "mgnRatio") {
+                account.margin_ratio = OKXNumeric::ToDouble(value);
+            } else if (key == "mmr") {
+                account.maintenance_margin_ratio = OKXNumeric::ToDouble(value);
+            } else if (key == "imr") {
+                account.initial_margin_ratio = OKXNumeric::ToDouble(value);
+            } else if (key == "uTime") {
+                account.update_time = OKXNumeric::ToUint64(value);
+            } else if (key == "details") {
+                OKXFastParser::ArrayReader details(value);
+                std::string_view element;
+                while (details.Next(element)) {
+                    account.details.emplace_back();
+                    ParseAccountDetail(element, account.details.back());
+                }
+            }
+        }
+
+        return reader.Ok();
+    }
+}
+
+OKXWebSocket::OKXWebSocket()
+    : initialized_(false)
+    , curl_(nullptr)
+    , multi_(nullptr)
+    , share_(nullptr)
+    , socket_(CURL_SOCKET_BAD)
+    , running_(false)
+    , connected_(false)
+    , logged_in_(false)
+    , spsc_ring_(nullptr)
+    , mpsc_ring_(nullptr)
+    , bridge_(nullptr)
+    , commands_pending_(false)
+    , receive_length_(0)
+    , random_(std::random_device{}())
+    , receive_server_us_(0)
+    , dispatch_ns_(0)
+    , dispatch_subscription_(nullptr)
+    , ping_outstanding_(false)
+    , reconnect_attempts_(0)
+    , messages_received_(0)
+    , messages_sent_(0)
+    , reconnections_(0)
+    , subscription_count_(0)
+    , last_message_ns_(0)
+    , latency_samples_(0)
+    , latency_total_us_(0)
+    , last_latency_us_(0)
+    , max_latency_us_(0) {
+}
+
+OKXWebSocket::~OKXWebSocket() {
+    Disconnect();
+
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+        multi_ = nullptr;
+    }
+    if (share_) {
+        curl_share_cleanup(share_);
+        share_ = nullptr;
+    }
+}
+
+bool OKXWebSocket::Initialize(const WSConfig& config) {
+    if (running_) {
+        std::cerr << "OKXWebSocket: Initialize called while connected" << std::endl;
+        return false;
+    }
+
+    config_ = config;
+    if (!config_.api_key.empty()) {
+        signer_ = std::make_unique<OKXSigner>(config_.api_key, config_.secret_key,
+                                              config_.passphrase);
+    } else {
+        signer_.reset();
+    }
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    if (!multi_) {
+        multi_ = curl_multi_init();
+    }
+    if (!share_) {
+        // Only the I/O thread uses the share, so no lock callbacks are needed
+        share_ = curl_share_init();
+        if (share_) {
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
+    }
+    if (!multi_) {
+        std::cerr << "Failed to initialize CURL multi handle" << std::endl;
+        return false;
+    }
+
+    receive_buffer_.resize(kInitialReceiveBuffer);
+    initialized_ = true;
+    return true;
+}
+
+bool OKXWebSocket::Connect() {
+    if (!initialized_) {
+        std::cerr << "OKXWebSocket: not initialized" << std::endl;
+        return false;
+    }
+    if (running_) {
+        return IsConnected();
+    }
+
+    connect_result_ = std::promise<bool>();
+    std::future<bool> result = connect_result_.get_future();
+    reconnect_attempts_ = 0;
+
+    running_ = true;
+    event_thread_ = std::thread(&OKXWebSocket::RunEventLoop, this);
+
+    if (result.get()) {
+        return true;
+    }
+
+    Disconnect();
+    return false;
+}
+
+void OKXWebSocket::Disconnect() {
+    if (!running_.exchange(false)) {
+        if (event_thread_.joinable()) {
+            event_thread_.join();
+        }
+        return;
+    }
+
+    curl_multi_wakeup(multi_);
+    if (event_thread_.joinable()) {
+        event_thread_.join();
+    }
+}
+
+// ==================== Subscriptions ====================
+
+bool OKXWebSocket::SubscribeTicker(const std::string& inst_id, TickCallback callback) {
+    auto subscription = std::make_unique<Subscription>();
+    subscription->type = ChannelType::kTicker;
+    subscription->channel = "tickers";
+    subscription->inst_id = inst_id;
+    subscription->on_tick = std::move(callback);
+    return Subscribe(std::move(subscription));
+}
+
+bool OKXWebSocket::SubscribeDepth(const std::string& inst_id,
+                                  DepthCallback callback,
+                                  const std::string& depth_type) {
+    auto subscription = std::make_unique<Subscription>();
+    subscription->channel = depth_type;
+    subscription->inst_id = inst_id;
+    subscription->on_depth = std::move(callback);
+    if (IsBookChannel(depth_type)) {
+        subscription->type = ChannelType::kBook;
+        subscription->book = std::make_unique<OrderBook>(inst_id, config_.book_depth);
+    } else {
+        subscription->type = ChannelType::kDepth;
+    }
+    return Subscribe(std::move(subscription));
+}
+
+bool OKXWebSocket::UnsubscribeTicker(const std::string& inst_id) {
+    return Unsubscribe("tickers", inst_id);
+}
+
+bool OKXWebSocket::UnsubscribeDepth(const std::string& inst_id) {
+    // Any depth channel of this instrument
+    return Unsubscribe("", inst_id);
+}
+
+bool OKXWebSocket::SubscribeOrders(const std::string& inst_id, OrderCallback callback) {
+    auto subscription = std::make_unique<Subscription>();
+    subscription->type = ChannelType::kOrders;
+    subscription->channel = "orders";
+    subscription->inst_id = inst_id;
+    subscription->on_order = std::move(callback);
+    return Subscribe(std::move(subscription));
+}
+
+bool OKXWebSocket::SubscribePositions(const std::string& inst_id, PositionCallback callback) {
+    auto subscription = std::make_unique<Subscription>();
+    subscription->type = ChannelType::kPositions;
+    subscription->channel = "positions";
+    subscription->inst_id = inst_id;
+    subscription->on_position = std::move(callback);
+    return Subscribe(std::move(subscription));
+}
+
+bool OKXWebSocket::SubscribeAccount(AccountCallback callback) {
+    auto subscription = std::make_unique<Subscription>();
+    subscription->type = ChannelType::kAccount;
+    subscription->channel = "account";
+    subscription->on_account = std::move(callback);
+    return Subscribe(std::move(subscription));
+}
+
+bool OKXWebSocket::UnsubscribeOrders(const std::string& inst_id) {
+    return Unsubscribe("orders", inst_id);
+}
+
+bool OKXWebSocket::UnsubscribePositions(const std::string& inst_id) {
+    return Unsubscribe("positions", inst_id);
+}
+
+bool OKXWebSocket::UnsubscribeAccount() {
+    return Unsubscribe("account", "");
+}
+
+bool OKXWebSocket::Subscribe(std::unique_ptr<Subscription> subscription) {
+    if (subscription->IsPrivate() && !signer_) {
+        std::cerr << "OKXWebSocket: " << subscription->channel
+                  << " requires api_key/secret_key/passphrase" << std::endl;
+        return false;
+    }
+
+    subscription->latency = &latency_.Get(subscription->channel);
+
+    Command command;
+    command.type = Command::Type::kSubscribe;
+    command.subscription = std::move(subscription);
+    return Enqueue(std::move(command));
+}
+
+bool OKXWebSocket::Unsubscribe(const std::string& channel, const std::string& inst_id) {
+    Command command;
+    command.type = Command::Type::kUnsubscribe;
+    command.channel = channel;
+    command.inst_id = inst_id;
+    return Enqueue(std::move(command));
+}
+
+bool OKXWebSocket::SendText(std::string_view message) {
+    Command command;
+    command.type = Command::Type::kSend;
+    command.text.assign(message.data(), message.size());
+    return Enqueue(std::move(command));
+}
+
+bool OKXWebSocket::Enqueue(Command command) {
+    if (!initialized_) {
+        std::cerr << "OKXWebSocket: not initialized" << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(command_mutex_);
+        commands_.push_back(std::move(command));
+    }
+    commands_pending_.store(true, std::memory_order_release);
+
+    // Picked up when the I/O thread starts if not connected yet
+    curl_multi_wakeup(multi_);
+    return true;
+}
+
+void OKXWebSocket::SetMessageCallback(MessageCallback callback) {
+    message_callback_ = std::move(callback);
+}
+
+void OKXWebSocket::SetErrorCallback(ErrorCallback callback) {
+    error_callback_ = std::move(callback);
+}
+
+void OKXWebSocket::SetEventRing(SpscRing<MarketEvent>* ring) {
+    spsc_ring_ = ring;
+}
+
+void OKXWebSocket::SetEventRing(MpscRing<MarketEvent>* ring) {
+    mpsc_ring_ = ring;
+}
+
+void OKXWebSocket::SetMarketDataBridge(MarketDataBridge* bridge) {
+    bridge_ = bridge;
+}
+
+OKXWebSocket::Statistics OKXWebSocket::GetStatistics() const {
+    Statistics stats;
+    stats.total_messages_received = messages_received_.load(std::memory_order_relaxed);
+    stats.total_messages_sent = messages_sent_.load(std::memory_order_relaxed);
+    stats.reconnection_count = reconnections_.load(std::memory_order_relaxed);
+    stats.subscription_count = subscription_count_.load(std::memory_order_relaxed);
+    stats.is_connected = IsConnected();
+    stats.last_message_time = std::chrono::steady_clock::time_point(
+        std::chrono::nanoseconds(last_message_ns_.load(std::memory_order_relaxed)));
+    stats.latency_samples = latency_samples_.load(std::memory_order_relaxed);
+    stats.last_latency_us = last_latency_us_.load(std::memory_order_relaxed);
+    stats.max_latency_us = max_latency_us_.load(std::memory_order_relaxed);
+    if (stats.latency_samples > 0) {
+        stats.avg_latency_us = static_cast<double>(latency_total_us_.load(std::memory_order_relaxed)) /
+                               static_cast<double>(stats.latency_samples);
+    }
+    return stats;
+}
+
+LatencyRegistry::Snapshot OKXWebSocket::GetLatencySnapshot() const {
+    return latency_.GetSnapshot();
+}
+
+// ==================== I/O Thread ====================
+
+void OKXWebSocket::RunEventLoop() {
+    bool open = Open();
+    connect_result_.set_value(open);
+    if (!open) {
+        return;
+    }
+
+    while (running_) {
+        if (!curl_ && !AttemptReconnect()) {
+            break;
+        }
+
+        if (commands_pending_.load(std::memory_order_acquire)) {
+            DrainCommands();
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!ReadMessages() || !CheckHeartbeat(now)) {
+            Close(false);
+            if (!config_.auto_reconnect) {
+                ReportError("WebSocket connection lost");
+                break;
+            }
+            continue;
+        }
+
+        // Sleep until data arrives, the ping is due, or curl_multi_wakeup()
+        auto ping_due = last_receive_time_ + std::chrono::seconds(config_.ping_interval_seconds);
+        auto wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            ping_due - std::chrono::steady_clock::now()).count() + 1;
+        WaitForEvents(static_cast<int>(std::clamp<int64_t>(wait_ms, 0, kMaxPollMs)));
+    }
+
+    Close(true);
+}
+
+bool OKXWebSocket::Open() {
+    const std::string& url = signer_ ? config_.private_url : config_.url;
+
+    // wss://host:port/path -> https://host:port (TLS only) + path for the upgrade
+    size_t scheme_end = url.find("://");
+    if (scheme_end == std::string::npos) {
+        ReportError("Invalid WebSocket URL: " + url);
+        return false;
+    }
+    std::string scheme = url.substr(0, scheme_end);
+    size_t host_begin = scheme_end + 3;
+    size_t path_begin = url.find('/', host_begin);
+    std::string host = url.substr(host_begin, path_begin == std::string::npos ?
+                                              std::string::npos : path_begin - host_begin);
+    std::string path = path_begin == std::string::npos ? "/" : url.substr(path_begin);
+    std::string connect_url = (scheme == "ws" ? "http://" : "https://") + host + "/";
+
+    curl_ = curl_easy_init();
+    if (!curl_) {
+        ReportError("Failed to initialize CURL");
+        return false;
+    }
+
+    curl_easy_setopt(curl_, CURLOPT_URL, connect_url.c_str());
+    curl_easy_setopt(curl_, CURLOPT_CONNECT_ONLY, 1L);   // TCP + TLS only, framing is ours
+    curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(config_.connect_timeout_ms));
+    curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYPEER, config_.verify_ssl ? 1L : 0L);
+    curl_easy_setopt(curl_, CURLOPT_SSL_VERIFYHOST, config_.verify_ssl ? 2L : 0L);
+    curl_easy_setopt(curl_, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl_, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl_, CURLOPT_TCP_KEEPALIVE, 1L);
+    if (share_) {
+        curl_easy_setopt(curl_, CURLOPT_SHARE, share_);
+    }
+    if (!config_.proxy_url.empty()) {
+        curl_easy_setopt(curl_, CURLOPT_PROXY, config_.proxy_url.c_str());
+        curl_easy_setopt(curl_, CURLOPT_HTTPPROXYTUNNEL, 1L);
+    }
+
+    CURLcode result = curl_easy_perform(curl_);
+    if (result == CURLE_OK) {
+        result = curl_easy_getinfo(curl_, CURLINFO_ACTIVESOCKET, &socket_);
+    }
+    if (result != CURLE_OK || socket_ == CURL_SOCKET_BAD) {
+        ReportError(std::string("WebSocket connect to ") + url + " failed: " +
+                    curl_easy_strerror(result));
+        Close(false);
+        return false;
+    }
+
+    receive_length_ = 0;
+    fragment_.clear();
+    if (!Handshake(host, path)) {
+        Close(false);
+        return false;
+    }
+
+    last_receive_time_ = std::chrono::steady_clock::now();
+    ping_outstanding_ = false;
+    logged_in_ = false;
+    reconnect_attempts_ = 0;
+    connected_.store(true, std::memory_order_release);
+
+    // Replay what was subscribed before; private channels wait for login.
+    // Subscriptions still queued are sent when the loop drains them.
+    if (signer_) {
+        Authenticate();
+    } else {
+        SubscribeAll(false);
+    }
+    return true;
+}
+
+bool OKXWebSocket::Handshake(const std::string& host, const std::string& path) {
+    unsigned char nonce[16];
+    for (size_t i = 0; i < sizeof(nonce); i += 4) {
+        uint32_t value = random_();
+        std::memcpy(nonce + i, &value, 4);
+    }
+    char key[32];
+    EVP_EncodeBlock(reinterpret_cast<unsigned char*>(key), nonce, sizeof(nonce));
+
+    std::string request = "GET " + path + " HTTP/1.1\r\n"
+                          "Host: " + host + "\r\n"
+                          "Upgrade: websocket\r\n"
+                          "Connection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: " + key + "\r\n"
+                          "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (!SendAll(request.data(), request.size())) {
+        return false;
+    }
+
+    // Response headers; anything after them is already frame data
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(config_.connect_timeout_ms);
+    std::string_view received;
+    size_t header_end = std::string_view::npos;
+    while (header_end == std::string_view::npos) {
+        size_t count = 0;
+        CURLcode result = curl_easy_recv(curl_, receive_buffer_.data() + receive_length_,
+                                         receive_buffer_.size() - receive_length_, &count);
+        if (result == CURLE_AGAIN) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                ReportError("WebSocket handshake timed out");
+                return false;
+            }
+            WaitForEvents(kMaxPollMs);
+            continue;
+        }
+        if (result != CURLE_OK || count == 0) {
+            ReportError(std::string("WebSocket handshake failed: ") + curl_easy_strerror(result));
+            return false;
+        }
+        receive_length_ += count;
+        received = std::string_view(receive_buffer_.data(), receive_length_);
+        header_end = received.find("\r\n\r\n");
+        if (header_end == std::string_view::npos && receive_length_ == receive_buffer_.size()) {
+            ReportError("WebSocket handshake response too large");
+            return false;
+        }
+    }
+
+    std::string headers(received.substr(0, header_end));
+    std::transform(headers.begin(), headers.end(), headers.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    // Sec-WebSocket-Accept = base64(SHA1(key + GUID))
+    std::string accept_source = std::string(key) + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(accept_source.data()), accept_source.size(), digest);
+    char accept[32];
+    EVP_EncodeBlock(reinterpret_cast<unsigned char*>(accept), digest, SHA_DIGEST_LENGTH);
+    std::string expected(accept);
+    std::transform(expected.begin(), expected.end(), expected.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (headers.compare(0, 12, "http/1.1 101") != 0 ||
+        headers.find("sec-websocket-accept: " + expected) == std::string::npos) {
+        ReportError("WebSocket upgrade rejected: " +
+                    std::string(received.substr(0, received.find("\r\n"))));
+        return false;
+    }
+
+    receive_length_ -= header_end + 4;
+    std::memmove(receive_buffer_.data(), receive_buffer_.data() + header_end + 4, receive_length_);
+    return true;
+}
+
+void OKXWebSocket::Close(bool send_close_frame) {
+    if (!curl_) {
+        return;
+    }
+
+    if (send_close_frame && connected_) {
+        SendFrame("\x03\xE8", kOpClose);   // 1000 normal closure
+    }
+
+    curl_easy_cleanup(curl_);
+    curl_ = nullptr;
+    socket_ = CURL_SOCKET_BAD;
+    connected_.store(false, std::memory_order_release);
+    logged_in_ = false;
+
+    // Incremental books must start again from a snapshot
+    for (auto& subscription : subscriptions_) {
+        if (subscription->book) {
+            subscription->book->Clear();
+        }
+    }
+}
+
+void OKXWebSocket::DrainCommands() {
+    std::vector<Command> commands;
+    {
+        std::lock_guard<std::mutex> lock(command_mutex_);
+        commands.swap(commands_);
+        commands_pending_.store(false, std::memory_order_relaxed);
+    }
+
+    for (auto& command : commands) {
+        switch (command.type) {
+        case Command::Type::kSubscribe: {
+            Subscription& added = *command.subscription;
+            // Re-subscribing replaces the callback
+            for (auto it = subscriptions_.begin(); it != subscriptions_.end(); ++it) {
+                if ((*it)->channel == added.channel && (*it)->inst_id == added.inst_id) {
+                    subscriptions_.erase(it);
+                    break;
+                }
+            }
+            subscriptions_.push_back(std::move(command.subscription));
+            if (curl_ && (!added.IsPrivate() || logged_in_)) {
+                SendSubscription(added);
+            }
+            break;
+        }
+        case Command::Type::kUnsubscribe:
+            for (auto it = subscriptions_.begin(); it != subscriptions_.end();) {
+                const Subscription& existing = **it;
+                bool depth = existing.type == ChannelType::kDepth || existing.type == ChannelType::kBook;
+                bool match = existing.inst_id == command.inst_id &&
+                             (command.channel.empty() ? depth : existing.channel == command.channel);
+                if (match) {
+                    if (curl_) {
+                        SendUnsubscription(existing);
+                    }
+                    it = subscriptions_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            break;
+        case Command::Type::kSend:
+            if (curl_) {
+                SendFrame(command.text, kOpText);
+            }
+            break;
+        }
+    }
+
+    subscription_count_.store(subscriptions_.size(), std::memory_order_relaxed);
+}
+
+bool OKXWebSocket::ReadMessages() {
+    if (!curl_) {
+        return false;
+    }
+
+    // Whatever the handshake read past its headers is parsed first
+    if (receive_length_ > 0 && !ProcessFrames()) {
+        return false;
+    }
+
+    for (;;) {
+        if (receive_buffer_.size() - receive_length_ < kMinReceiveSpace) {
+            receive_buffer_.resize(receive_buffer_.size() * 2);
+        }
+
+        size_t received = 0;
+        CURLcode result = curl_easy_recv(curl_, receive_buffer_.data() + receive_length_,
+                                         receive_buffer_.size() - receive_length_, &received);
+        if (result == CURLE_AGAIN) {
+            return true;
+        }
+        if (result != CURLE_OK) {
+            ReportError(std::string("WebSocket receive failed: ") + curl_easy_strerror(result));
+            return false;
+        }
+        if (received == 0) {
+            ReportError("WebSocket closed by server");
+            return false;
+        }
+
+        receive_length_ += received;
+        last_receive_time_ = std::chrono::steady_clock::now();
+        ping_outstanding_ = false;
+
+        if (!ProcessFrames()) {
+            return false;
+        }
+    }
+}
+
+bool OKXWebSocket::ProcessFrames() {
+    char* data = receive_buffer_.data();
+    size_t position = 0;
+
+    while (receive_length_ - position >= 2) {
+        const unsigned char* head = reinterpret_cast<const unsigned char*>(data + position);
+        size_t available = receive_length_ - position;
+        bool fin = (head[0] & 0x80) != 0;
+        int opcode = head[0] & 0x0F;
+        bool masked = (head[1] & 0x80) != 0;
+
+        uint64_t length = head[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) break;
+            length = (static_cast<uint64_t>(head[2]) << 8) | head[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; i++) {
+                length = (length << 8) | head[2 + i];
+            }
+            header = 10;
+        }
+        if (length > kMaxMessageSize) {
+            ReportError("WebSocket frame too large");
+            return false;
+        }
+        size_t mask_offset = header;
+        if (masked) {
+            header += 4;   // Servers must not mask, but tolerate it
+        }
+        if (available < header + length) {
+            break;         // Rest of the frame still in flight
+        }
+
+        char* payload = data + position + header;
+        if (masked) {
+            const unsigned char* mask = head + mask_offset;
+            for (size_t i = 0; i < length; i++) {
+                payload[i] ^= mask[i & 3];
+            }
+        }
+        position += header + static_cast<size_t>(length);
+
+        switch (opcode) {
+        case kOpText:
+        case kOpBinary:
+            if (fin) {
+                // Common case: parse in place, no copy
+                DispatchMessage(std::string_view(payload, static_cast<size_t>(length)));
+            } else {
+                fragment_.assign(payload, static_cast<size_t>(length));
+            }
+            break;
+        case kOpContinuation:
+            fragment_.append(payload, static_cast<size_t>(length));
+            if (fin) {
+                DispatchMessage(fragment_);
+                fragment_.clear();
+            }
+            break;
+        case kOpClose:
+            ReportError("WebSocket closed by server");
+            return false;
+        case kOpPing:
+            SendFrame(std::string_view(payload, static_cast<size_t>(length)), kOpPong);
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Keep a partial frame at the front of the buffer
+    if (position > 0) {
+        receive_length_ -= position;
+        std::memmove(data, data + position, receive_length_);
+    }
+    return true;
+}
+
+void OKXWebSocket::DispatchMessage(std::string_view message) {
+    messages_received_.fetch_add(1, std::memory_order_relaxed);
+    last_message_ns_.store(SteadyNanos(last_receive_time_), std::memory_order_relaxed);
+    receive_server_us_ = OKXSigner::NowUs();
+
+    int64_t start_ns = LatencyRegistry::NowNs();
+    dispatch_ns_ = 0;
+    dispatch_subscription_ = nullptr;
+    ProcessMessage(message);
+
+    // Everything but the hand-off to rings / bridge / callbacks is parsing
+    if (dispatch_subscription_) {
+        LatencyRegistry::Endpoint& latency = *dispatch_subscription_->latency;
+        latency.Record(LatencyStage::kParse, LatencyRegistry::NowNs() - start_ns - dispatch_ns_);
+        latency.Record(LatencyStage::kDispatch, dispatch_ns_);
+    }
+}
+
+int64_t OKXWebSocket::RecordLatency(Subscription& subscription, Timestamp exchange_time) {
+    if (exchange_time == 0) {
+        return 0;
+    }
+    // Only the I/O thread writes these, so plain load/store is enough
+    int64_t latency_us = receive_server_us_ - static_cast<int64_t>(exchange_time) * 1000;
+    latency_samples_.store(latency_samples_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    latency_total_us_.store(latency_total_us_.load(std::memory_order_relaxed) + latency_us,
+                            std::memory_order_relaxed);
+    last_latency_us_.store(latency_us, std::memory_order_relaxed);
+    if (latency_us > max_latency_us_.load(std::memory_order_relaxed)) {
+        max_latency_us_.store(latency_us, std::memory_order_relaxed);
+    }
+    subscription.latency->Record(LatencyStage::kNetwork, latency_us * 1000);
+    return latency_us;
+}
+
+bool OKXWebSocket::WaitForEvents(int timeout_ms, bool writable) {
+    struct curl_waitfd wait_fd;
+    wait_fd.fd = socket_;
+    wait_fd.events = writable ? CURL_WAIT_POLLOUT : CURL_WAIT_POLLIN;
+    wait_fd.revents = 0;
+
+    int count = socket_ != CURL_SOCKET_BAD ? 1 : 0;
+    CURLMcode result = curl_multi_poll(multi_, count ? &wait_fd : nullptr, count, timeout_ms, nullptr);
+    return result == CURLM_OK;
+}
+
+bool OKXWebSocket::SendFrame(std::string_view payload, int opcode) {
+    if (!curl_) {
+        return false;
+    }
+
+    // Client frames are always masked (RFC 6455 5.3)
+    size_t length = payload.size();
+    size_t header = length < 126 ? 6 : (length <= 0xFFFF ? 8 : 14);
+    if (send_buffer_.size() < header + length) {
+        send_buffer_.resize(header + length);
+    }
+
+    unsigned char* out = reinterpret_cast<unsigned char*>(send_buffer_.data());
+    out[0] = static_cast<unsigned char>(0x80 | opcode);
+    size_t p = 2;
+    if (length < 126) {
+        out[1] = static_cast<unsigned char>(0x80 | length);
+    } else if (length <= 0xFFFF) {
+        out[1] = 0x80 | 126;
+        out[p++] = static_cast<unsigned char>(length >> 8);
+        out[p++] = static_cast<unsigned char>(length);
+    } else {
+        out[1] = 0x80 | 127;
+        for (int i = 7; i >= 0; i--) {
+            out[p++] = static_cast<unsigned char>(static_cast<uint64_t>(length) >> (i * 8));
+        }
+    }
+
+    uint32_t mask_value = random_();
+    unsigned char mask[4];
+    std::memcpy(mask, &mask_value, 4);
+    std::memcpy(out + p, mask, 4);
+    p += 4;
+
+    for (size_t i = 0; i < length; i++) {
+        out[p + i] = static_cast<unsigned char>(payload[i]) ^ mask[i & 3];
+    }
+
+    if (!SendAll(send_buffer_.data(), header + length)) {
+        return false;
+    }
+    if (opcode == kOpText) {
+        messages_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool OKXWebSocket::SendAll(const char* data, size_t length) {
+    size_t offset = 0;
+    while (offset < length) {
+        size_t sent = 0;
+        CURLcode result = curl_easy_send(curl_, data + offset, length - offset, &sent);
+        offset += sent;
+        if (result == CURLE_AGAIN) {
+            // Socket buffer full: wait until writable
+            WaitForEvents(config_.connect_timeout_ms, true);
+        } else if (result != CURLE_OK) {
+            ReportError(std::string("WebSocket send failed: ") + curl_easy_strerror(result));
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OKXWebSocket::AttemptReconnect() {
+    while (running_) {
+        if (config_.max_reconnect_attempts > 0 &&
+            reconnect_attempts_ >= config_.max_reconnect_attempts) {
+            ReportError("WebSocket reconnect attempts exhausted");
+            return false;
+        }
+
+        // Exponential backoff; the first retry after a drop is immediate
+        if (reconnect_attempts_ > 0) {
+            int shift = std::min(reconnect_attempts_ - 1, 6);
+            int delay_s = std::min(config_.reconnect_delay_seconds << shift, kMaxReconnectDelaySeconds);
+            auto until = std::chrono::steady_clock::now() + std::chrono::seconds(delay_s);
+            while (running_ && std::chrono::steady_clock::now() < until) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    until - std::chrono::steady_clock::now()).count();
+                WaitForEvents(static_cast<int>(std::clamp<int64_t>(left, 0, kMaxPollMs)));
+            }
+            if (!running_) {
+                return false;
+            }
+        }
+
+        reconnect_attempts_++;
+        if (Open()) {
+            reconnections_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OKXWebSocket::CheckHeartbeat(std::chrono::steady_clock::time_point now) {
+    auto interval = std::chrono::seconds(config_.ping_interval_seconds);
+
+    if (ping_outstanding_) {
+        if (now - ping_sent_time_ >= interval) {
+            ReportError("WebSocket heartbeat timed out");
+            return false;
+        }
+        return true;
+    }
+
+    if (now - last_receive_time_ >= interval) {
+        if (!SendFrame("ping", kOpText)) {
+            return false;
+        }
+        ping_outstanding_ = true;
+        ping_sent_time_ = now;
+    }
+    return true;
+}
+
+void OKXWebSocket::Publish() {
+    // Overruns are counted by the ring itself
+    if (spsc_ring_) {
+        spsc_ring_->TryPush(event_);
+    }
+    if (mpsc_ring_) {
+        mpsc_ring_->TryPush(event_);
+    }
+}
+
+void OKXWebSocket::ReportError(const std::string& error) {
+    if (error_callback_) {
+        error_callback_(error);
+    } else {
+        std::cerr << "OKXWebSocket: " << error << std::endl;
+    }
+}
+
+// ==================== Message Processing ====================
+
+void OKXWebSocket::ProcessMessage(std::string_view message) {
+    if (message_callback_) {
+        message_callback_(message);
+    }
+
+    if (message == "pong") {
+        return;
+    }
+
+    // {"arg":{"channel":..,"instId":..},"action":..,"data":[..]}
+    // {"event":"subscribe"|"error"|"login",..,"code":..,"msg":..}
+    std::string_view arg, data, event, code, msg;
+    OKXFastParser::ObjectReader reader(message);
+    std::string_view key, value;
+    while (reader.Next(key, value)) {
+        if (key == "arg") {
+            arg = value;
+        } else if (key == "data") {
+            data = value;
+        } else if (key == "event") {
+            event = value;
+        } else if (key == "code") {
+            code = value;
+        } else if (key == "msg") {
+            msg = value;
+        }
+    }
+    if (!reader.Ok()) {
+        return;
+    }
+
+    if (!event.empty()) {
+        ProcessEvent(event, code, msg);
+        return;
+    }
+    if (arg.empty() || data.empty()) {
+        return;
+    }
+
+    std::string_view channel, inst_id;
+    OKXFastParser::ObjectReader arg_reader(arg);
+    while (arg_reader.Next(key, value)) {
+        if (key == "channel") {
+            channel = value;
+        } else if (key == "instId") {
+            inst_id = value;
+        }
+    }
+
+    Subscription* subscription = FindSubscription(channel, inst_id);
+    if (!subscription) {
+        return;
+    }
+    dispatch_subscription_ = subscription;
+
+    switch (subscription->type) {
+    case ChannelType::kTicker:
+        ProcessTickerMessage(*subscription, data);
+        break;
+    case ChannelType::kDepth:
+        ProcessDepthMessage(*subscription, data);
+        break;
+    case ChannelType::kBook:
+        ProcessBookMessage(*subscription, message);
+        break;
+    case ChannelType::kOrders:
+        ProcessOrderMessage(*subscription, data);
+        break;
+    case ChannelType::kPositions:
+        ProcessPositionMessage(*subscription, data);
+        break;
+    case ChannelType::kAccount:
+        ProcessAccountMessage(*subscription, data);
+        break;
+    }
+}
+
+void OKXWebSocket::ProcessEvent(std::string_view event, std::string_view code,
+                                std::string_view msg) {
+    if (event == "login") {
+        if (code == "0") {
+            logged_in_ = true;
+            SubscribeAll(true);
+        } else {
+            ReportError("WebSocket login failed: " + std::string(code) + " " + std::string(msg));
+        }
+    } else if (event == "error") {
+        ReportError("WebSocket error " + std::string(code) + ": " + std::string(msg));
+    }
+}
+
+OKXWebSocket::Subscription* OKXWebSocket::FindSubscription(std::string_view channel,
+                                                           std::string_view inst_id) {
+    // A handful of subscriptions per connection: a linear scan beats hashing
+    for (auto& subscription : subscriptions_) {
+        if (subscription->channel == channel &&
+            (subscription->inst_id.empty() || subscription->inst_id == inst_id)) {
+            return subscription.get();
+        }
+    }
+    return nullptr;
+}
+
+void OKXWebSocket::ProcessTickerMessage(Subscription& subscription, std::string_view data) {
+    OKXFastParser::ArrayReader elements(data);
+    std::string_view element;
+    while (elements.Next(element)) {
+        if (OKXFastParser::ParseTicker(element, tick_)) {
+            tick_.platform = "okx";
+            tick_.bid = tick_.bid_price;
+            tick_.ask = tick_.ask_price;
+            tick_.last = tick_.last_price;
+            tick_.latency_us = RecordLatency(subscription, tick_.timestamp);
+            ScopedDuration dispatch(dispatch_ns_);
+            if (spsc_ring_ || mpsc_ring_) {
+                MarketEvent::FromTick(tick_, SteadyNanos(last_receive_time_), event_);
+                Publish();
+            }
+            if (bridge_) {
+                bridge_->PublishTick(tick_);
+            }
+            if (subscription.on_tick) {
+                subscription.on_tick(tick_);
+            }
+        }
+    }
+}
+
+void OKXWebSocket::ProcessDepthMessage(Subscription& subscription, std::string_view data) {
+    OKXFastParser::ArrayReader elements(data);
+    std::string_view element;
+    while (elements.Next(element)) {
+        if (OKXFastParser::ParseOrderBook(element, depth_)) {
+            depth_.inst_id = subscription.inst_id;
+            depth_.symbol = subscription.inst_id;
+            depth_.platform = "okx";
+            depth_.latency_us = RecordLatency(subscription, depth_.timestamp);
+            ScopedDuration dispatch(dispatch_ns_);
+            if (spsc_ring_ || mpsc_ring_) {
+                MarketEvent::FromDepth(depth_, SteadyNanos(last_receive_time_), event_);
+                Publish();
+            }
+            if (bridge_) {
+                bridge_->PublishDepth(depth_);
+            }
+            if (subscription.on_depth) {
+                subscription.on_depth(depth_);
+            }
+        }
+    }
+}
+
+void OKXWebSocket::ProcessBookMessage(Subscription& subscription, std::string_view message) {
+    OrderBook::Result result = subscription.book->ApplyMessage(message);
+    if (result == OrderBook::Result::kOk) {
+        // Without a callback only the levels a MarketEvent / bridge slot carries
+        size_t levels = subscription.on_depth ? config_.book_depth
+                        : bridge_          ? OKX_BRIDGE_BOOK_LEVELS
+                                           : MarketEvent::kDepthLevels;
+        subscription.book->ToDepth(depth_, levels);
+        depth_.symbol = subscription.inst_id;
+        depth_.platform = "okx";
+        depth_.latency_us = RecordLatency(subscription, depth_.timestamp);
+        ScopedDuration dispatch(dispatch_ns_);
+        if (spsc_ring_ || mpsc_ring_) {
+            MarketEvent::FromDepth(depth_, SteadyNanos(last_receive_time_), event_);
+            Publish();
+        }
+        if (bridge_) {
+            bridge_->PublishDepth(depth_);
+        }
+        if (subscription.on_depth) {
+            subscription.on_depth(depth_);
+        }
+        return;
+    }
+
+    // Pushes between the error and the new snapshot are rejected as
+    // kNotInitialized; only the first error triggers a resubscribe
+    if (result == OrderBook::Result::kNotInitialized) {
+        return;
+    }
+    ReportError("Order book " + subscription.inst_id + " out of sync (" +
+                (result == OrderBook::Result::kChecksumMismatch ? "checksum" :
+                 result == OrderBook::Result::kSequenceGap ? "sequence gap" : "parse error") +
+                "), resubscribing");
+    subscription.book->Clear();
+    SendUnsubscription(subscription);
+    SendSubscription(subscription);
+}
+
+void OKXWebSocket::ProcessOrderMessage(Subscription& subscription, std::string_view data) {
+    OKXFastParser::ArrayReader elements(data);
+    std::string_view element;
+    while (elements.Next(element)) {
+        order_ = Order();
+        if (!OKXFastParser::ParseOrder(element, order_)) {
+            continue;
+        }
+        ScopedDuration dispatch(dispatch_ns_);
+        if (spsc_ring_ || mpsc_ring_) {
+            MarketEvent::FromOrder(order_, SteadyNanos(last_receive_time_), event_);
+            Publish();
+        }
+        if (subscription.on_order) {
+            subscription.on_order(order_);
+        }
+    }
+}
+
+void OKXWebSocket::ProcessPositionMessage(Subscription& subscription, std::string_view data) {
+    OKXFastParser::ArrayReader elements(data);
+    std::string_view element;
+    while (elements.Next(element)) {
+        position_ = Position();
+        if (OKXFastParser::ParsePosition(element, position_) && subscription.on_position) {
+            ScopedDuration dispatch(dispatch_ns_);
+            subscription.on_position(position_);
+        }
+    }
+}
+
+void OKXWebSocket::ProcessAccountMessage(Subscription& subscription, std::string_view data) {
+    OKXFastParser::ArrayReader elements(data);
+    std::string_view element;
+    while (elements.Next(element)) {
+        if (ParseAccount(element, account_) && subscription.on_account) {
+            ScopedDuration dispatch(dispatch_ns_);
+            subscription.on_account(account_);
+        }
+    }
+}
+
+// ==================== Subscription Messages ====================
+
+std::string OKXWebSocket::SubscriptionArg(const Subscription& subscription) {
+    std::string arg = "{\"channel\":\"" + subscription.channel + "\"";
+    if (subscription.type == ChannelType::kOrders || subscription.type == ChannelType::kPositions) {
+        arg += ",\"instType\":\"ANY\"";
+    }
+    if (!subscription.inst_id.empty()) {
+        arg += ",\"instId\":\"" + subscription.inst_id + "\"";
+    }
+    arg += "}";
+    return arg;
+}
+
+bool OKXWebSocket::SendSubscription(const Subscription& subscription) {
+    return SendFrame("{\"op\":\"subscribe\",\"args\":[" + SubscriptionArg(subscription) + "]}",
+                     kOpText);
+}
+
+bool OKXWebSocket::SendUnsubscription(const Subscription& subscription) {
+    return SendFrame("{\"op\":\"unsubscribe\",\"args\":[" + SubscriptionArg(subscription) + "]}",
+                     kOpText);
+}
+
+void OKXWebSocket::SubscribeAll(bool private_channels) {
+    // One op with all args instead of a frame per channel
+    std::string message = "{\"op\":\"subscribe\",\"args\":[";
+    bool any = false;
+    for (const auto& subscription : subscriptions_) {
+        if (subscription->IsPrivate() == private_channels) {
+            if (any) {
+                message += ",";
+            }
+            message += SubscriptionArg(*subscription);
+            any = true;
+        }
+    }
+    message += "]}";
+
+    if (any) {
+        SendFrame(message, kOpText);
+    }
+}
+
+// ==================== Authentication ====================
+
+bool OKXWebSocket::Authenticate() {
+    // WebSocket login uses a Unix timestamp in seconds (server clock)
+    std::string timestamp = std::to_string(OKXSigner::NowMs() / 1000);
+
+    std::string message = "{\"op\":\"login\",\"args\":[{\"apiKey\":\"" + signer_->GetAPIKey() +
+                          "\",\"passphrase\":\"" + signer_->GetPassphrase() +
+                          "\",\"timestamp\":\"" + timestamp +
+                          "\",\"sign\":\"" + GenerateAuthSignature(timestamp) + "\"}]}";
+    return SendFrame(message, kOpText);
+}
+
+std::string OKXWebSocket::GenerateAuthSignature(const std::string& timestamp) {
+    return signer_->Sign(timestamp, "GET", "/users/self/verify", "");
+}
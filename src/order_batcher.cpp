@@ -0,0 +1,269 @@
+#include "order_batcher.h"
+#include "okx_rest_api.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    struct Endpoints {
+        const char* single;
+        const char* batch;
+    };
+
+    const Endpoints kEndpoints[] = {
+        {"/api/v5/trade/order", "/api/v5/trade/batch-orders"},
+        {"/api/v5/trade/cancel-order", "/api/v5/trade/cancel-batch-orders"},
+        {"/api/v5/trade/amend-order", "/api/v5/trade/amend-batch-orders"},
+    };
+
+    // data[index] normally answers the index-th item; fall back to the
+    // clOrdId when the counts or ids don't line up
+    const OrderBatcher::json* FindResult(const OrderBatcher::json& data, size_t index,
+                                         const std::string& client_order_id) {
+        if (index < data.size()) {
+            const auto& item = data[index];
+            if (client_order_id.empty() || item.value("clOrdId", "") == client_order_id) {
+                return &item;
+            }
+        }
+        if (client_order_id.empty()) {
+            return nullptr;
+        }
+        for (const auto& item : data) {
+            if (item.value("clOrdId", "") == client_order_id) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+}
+
+OrderBatcher::OrderBatcher(OKXRestAPI& api)
+    : OrderBatcher(api, Options()) {
+}
+
+OrderBatcher::OrderBatcher(OKXRestAPI& api, const Options& options)
+    : api_(api)
+    , options_(options)
+    , running_(true)
+    , flush_(false)
+    , in_flight_(0)
+    , submitted_(0)
+    , requests_(0)
+    , batched_(0)
+    , failed_(0)
+    , largest_batch_(0) {
+    options_.max_batch = std::min(std::max<size_t>(options_.max_batch, 1), kMaxBatch);
+    thread_ = std::thread([this] { Run(); });
+}
+
+OrderBatcher::~OrderBatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    std::unique_lock<std::mutex> lock(in_flight_mutex_);
+    in_flight_done_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+// ==================== Submission ====================
+
+std::future<OrderBatcher::Result> OrderBatcher::PlaceOrder(const Order& order) {
+    return Enqueue(Kind::kPlace, api_.BuildOrderBody(order));
+}
+
+std::future<OrderBatcher::Result> OrderBatcher::CancelOrder(const std::string& inst_id,
+                                                            const std::string& order_id,
+                                                            const std::string& client_order_id) {
+    return Enqueue(Kind::kCancel, api_.BuildCancelBody(inst_id, order_id, client_order_id));
+}
+
+std::future<OrderBatcher::Result> OrderBatcher::AmendOrder(const std::string& inst_id,
+                                                           const std::string& order_id,
+                                                           const std::string& new_size,
+                                                           const std::string& new_price) {
+    json item = {
+        {"instId", inst_id},
+        {"ordId", order_id}
+    };
+    if (!new_size.empty()) {
+        item["newSz"] = new_size;
+    }
+    if (!new_price.empty()) {
+        item["newPx"] = new_price;
+    }
+    return Enqueue(Kind::kAmend, std::move(item));
+}
+
+std::future<OrderBatcher::Result> OrderBatcher::Enqueue(Kind kind, json item) {
+    Pending pending;
+    pending.item = std::move(item);
+    std::future<Result> future = pending.promise.get_future();
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            Result result;
+            result.message = "Order batcher stopped";
+            pending.promise.set_value(std::move(result));
+            failed_++;
+            return future;
+        }
+
+        Queue& queue = queues_[static_cast<size_t>(kind)];
+        if (queue.items.empty()) {
+            queue.deadline = Clock::now() + options_.window;
+        }
+        queue.items.push_back(std::move(pending));
+        // A new window to wait for, or a full batch to send
+        wake = queue.items.size() == 1 || queue.items.size() >= options_.max_batch;
+    }
+    submitted_++;
+
+    if (wake) {
+        wake_.notify_one();
+    }
+    return future;
+}
+
+void OrderBatcher::Flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_ = true;
+    }
+    wake_.notify_one();
+}
+
+// ==================== Flushing ====================
+
+void OrderBatcher::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        Clock::time_point now = Clock::now();
+        Clock::time_point next_deadline = Clock::time_point::max();
+        bool sent = false;
+
+        for (size_t k = 0; k < kKindCount; k++) {
+            Queue& queue = queues_[k];
+            if (queue.items.empty()) {
+                continue;
+            }
+            bool due = !running_ || flush_ || queue.deadline <= now ||
+                       queue.items.size() >= options_.max_batch;
+            if (!due) {
+                next_deadline = std::min(next_deadline, queue.deadline);
+                continue;
+            }
+
+            size_t take = std::min(queue.items.size(), options_.max_batch);
+            auto batch = std::make_shared<Batch>(std::make_move_iterator(queue.items.begin()),
+                                                 std::make_move_iterator(queue.items.begin() + take));
+            queue.items.erase(queue.items.begin(), queue.items.begin() + take);
+            // Anything left over has already waited its window
+
+            lock.unlock();
+            Send(static_cast<Kind>(k), std::move(batch));
+            lock.lock();
+            sent = true;
+        }
+        if (sent) {
+            continue;
+        }
+
+        // Nothing due: every queue is empty or inside its window
+        flush_ = false;
+        if (!running_) {
+            break;
+        }
+        if (next_deadline == Clock::time_point::max()) {
+            wake_.wait(lock);
+        } else {
+            wake_.wait_until(lock, next_deadline);
+        }
+    }
+}
+
+void OrderBatcher::Send(Kind kind, std::shared_ptr<Batch> batch) {
+    const Endpoints& endpoints = kEndpoints[static_cast<size_t>(kind)];
+
+    json params;
+    const char* path = endpoints.single;
+    if (batch->size() == 1) {
+        params = (*batch)[0].item;
+    } else {
+        path = endpoints.batch;
+        params = json::array();
+        for (const Pending& pending : *batch) {
+            params.push_back(pending.item);
+        }
+        batched_ += batch->size();
+    }
+
+    requests_++;
+    size_t largest = largest_batch_.load(std::memory_order_relaxed);
+    while (batch->size() > largest && !largest_batch_.compare_exchange_weak(largest, batch->size())) {
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mutex_);
+        in_flight_++;
+    }
+    api_.MakeRequestAsync("POST", path, params, true,
+        [this, batch](const json& response) {
+            Complete(*batch, response);
+
+            std::lock_guard<std::mutex> lock(in_flight_mutex_);
+            if (--in_flight_ == 0) {
+                in_flight_done_.notify_all();
+            }
+        });
+}
+
+void OrderBatcher::Complete(Batch& batch, const json& response) {
+    // A request that failed as a whole (HTTP error, rate limit, code 50xxx
+    // without data) fails every item with the response's code and msg
+    std::string code = response.is_object() ? response.value("code", "") : "";
+    std::string message = response.is_object() ? response.value("msg", "") : "";
+    const json* data = nullptr;
+    if (response.is_object() && response.contains("data") && response["data"].is_array()) {
+        data = &response["data"];
+    }
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        Pending& pending = batch[i];
+        Result result;
+        result.client_order_id = pending.item.value("clOrdId", "");
+
+        const json* item = data ? FindResult(*data, i, result.client_order_id) : nullptr;
+        if (item) {
+            result.order_id = item->value("ordId", "");
+            result.client_order_id = item->value("clOrdId", result.client_order_id);
+            result.code = item->value("sCode", code);
+            result.message = item->value("sMsg", message);
+            result.success = result.code == "0";
+        } else {
+            result.code = code;
+            result.message = message.empty() ? "No result for this request" : message;
+        }
+
+        if (!result.success) {
+            failed_++;
+        }
+        pending.promise.set_value(std::move(result));
+    }
+}
+
+OrderBatcher::Statistics OrderBatcher::GetStatistics() const {
+    Statistics stats;
+    stats.submitted = submitted_.load();
+    stats.requests = requests_.load();
+    stats.batched = batched_.load();
+    stats.failed = failed_.load();
+    stats.largest_batch = largest_batch_.load();
+    return stats;
+}
@@ -0,0 +1,425 @@
+#include "order_book.h"
+#include "okx_fast_parser.h"
+#include "okx_numeric.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace {
+    // Slicing-by-8 tables for the reflected 0xEDB88320 polynomial
+    struct Crc32Tables {
+        uint32_t table[8][256];
+
+        Crc32Tables() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+                }
+                table[0][i] = crc;
+            }
+            for (uint32_t i = 0; i < 256; i++) {
+                for (int slice = 1; slice < 8; slice++) {
+                    uint32_t prev = table[slice - 1][i];
+                    table[slice][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+                }
+            }
+        }
+    };
+
+    const Crc32Tables& Tables() {
+        static const Crc32Tables tables;
+        return tables;
+    }
+
+    inline uint32_t Load32(const unsigned char* p) {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    bool SetText(char* data, uint8_t& length, std::string_view text, size_t capacity) {
+        if (text.size() > capacity) {
+            return false;
+        }
+        std::memcpy(data, text.data(), text.size());
+        length = static_cast<uint8_t>(text.size());
+        return true;
+    }
+}
+
+uint32_t OrderBook::Crc32(const char* data, size_t length) {
+    return Crc32Update(0xFFFFFFFFu, data, length) ^ 0xFFFFFFFFu;
+}
+
+uint32_t OrderBook::Crc32Update(uint32_t crc, const char* data, size_t length) {
+    const auto& t = Tables().table;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+
+    while (length >= 8) {
+        uint32_t lo = Load32(p) ^ crc;
+        uint32_t hi = Load32(p + 4);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+              t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        length -= 8;
+    }
+    while (length--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+
+    return crc;
+}
+
+// ==================== BookSide ====================
+
+void OrderBook::BookSide::Reserve(size_t levels) {
+    capacity = levels;
+    price.resize(levels);
+    size.resize(levels);
+    price_text.resize(levels);
+    size_text.resize(levels);
+}
+
+DepthLevel OrderBook::BookSide::Level(size_t depth) const {
+    if (depth >= count) {
+        return DepthLevel();
+    }
+    size_t index = count - 1 - depth;
+    return DepthLevel(price[index], size[index]);
+}
+
+size_t OrderBook::BookSide::Find(double px) const {
+    const double* begin = price.data();
+    const double* end = begin + count;
+    // Bids ascend (lowest first), asks descend (highest first)
+    const double* it = is_bid ? std::lower_bound(begin, end, px)
+                              : std::lower_bound(begin, end, px, std::greater<double>());
+    return static_cast<size_t>(it - begin);
+}
+
+bool OrderBook::BookSide::Apply(double px, double sz,
+                            std::string_view px_text, std::string_view sz_text) {
+    size_t pos = Find(px);
+    bool exists = pos < count && price[pos] == px;
+
+    if (sz == 0) {
+        if (exists) {
+            changed_depth = std::min(changed_depth, count - 1 - pos);
+            size_t tail = count - pos - 1;
+            std::memmove(price.data() + pos, price.data() + pos + 1, tail * sizeof(double));
+            std::memmove(size.data() + pos, size.data() + pos + 1, tail * sizeof(double));
+            std::memmove(price_text.data() + pos, price_text.data() + pos + 1, tail * sizeof(LevelText));
+            std::memmove(size_text.data() + pos, size_text.data() + pos + 1, tail * sizeof(LevelText));
+            count--;
+        }
+        return true;
+    }
+
+    if (!exists) {
+        if (count == capacity) {
+            if (pos == 0) {
+                return true;  // Deeper than every level we keep
+            }
+            // Drop the worst level to make room
+            pos--;
+            std::memmove(price.data(), price.data() + 1, pos * sizeof(double));
+            std::memmove(size.data(), size.data() + 1, pos * sizeof(double));
+            std::memmove(price_text.data(), price_text.data() + 1, pos * sizeof(LevelText));
+            std::memmove(size_text.data(), size_text.data() + 1, pos * sizeof(LevelText));
+        } else {
+            size_t tail = count - pos;
+            std::memmove(price.data() + pos + 1, price.data() + pos, tail * sizeof(double));
+            std::memmove(size.data() + pos + 1, size.data() + pos, tail * sizeof(double));
+            std::memmove(price_text.data() + pos + 1, price_text.data() + pos, tail * sizeof(LevelText));
+            std::memmove(size_text.data() + pos + 1, size_text.data() + pos, tail * sizeof(LevelText));
+            count++;
+        }
+        price[pos] = px;
+    }
+
+    changed_depth = std::min(changed_depth, count - 1 - pos);
+
+    size[pos] = sz;
+    return SetText(price_text[pos].data, price_text[pos].length, px_text, kTextCapacity) &&
+           SetText(size_text[pos].data, size_text[pos].length, sz_text, kTextCapacity);
+}
+
+// ==================== OrderBook ====================
+
+OrderBook::OrderBook(const std::string& inst_id, size_t max_depth)
+    : inst_id_(inst_id)
+    , timestamp_(0)
+    , seq_id_(-1)
+    , initialized_(false)
+    , verify_checksum_(true)
+    , checksum_(0) {
+    checksum_state_[0] = 0xFFFFFFFFu;
+    bids_.is_bid = true;
+    asks_.is_bid = false;
+    bids_.Reserve(max_depth);
+    asks_.Reserve(max_depth);
+}
+
+void OrderBook::Clear() {
+    bids_.count = 0;
+    asks_.count = 0;
+    timestamp_ = 0;
+    seq_id_ = -1;
+    initialized_ = false;
+}
+
+OrderBook::Result OrderBook::ApplyMessage(std::string_view message) {
+    OKXFastParser::ObjectReader reader(message);
+    std::string_view key, value, action, data;
+
+    while (reader.Next(key, value)) {
+        if (key == "action") {
+            action = value;
+        } else if (key == "data") {
+            data = value;
+        }
+    }
+    if (!reader.Ok() || data.empty()) {
+        stats_.parse_errors++;
+        return Result::kParseError;
+    }
+
+    bool snapshot = action == "snapshot";
+    OKXFastParser::ArrayReader elements(data);
+    std::string_view element;
+    Result result = Result::kOk;
+
+    while (result == Result::kOk && elements.Next(element)) {
+        result = Apply(element, snapshot);
+    }
+    if (result == Result::kOk && !elements.Ok()) {
+        stats_.parse_errors++;
+        initialized_ = false;
+        result = Result::kParseError;
+    }
+    return result;
+}
+
+OrderBook::Result OrderBook::ApplySnapshot(std::string_view data) {
+    return Apply(data, true);
+}
+
+OrderBook::Result OrderBook::ApplyUpdate(std::string_view data) {
+    return Apply(data, false);
+}
+
+bool OrderBook::ParseSide(std::string_view levels, BookSide& side, bool snapshot) {
+    if (levels.empty()) {
+        // Side not present in this message
+        if (snapshot) {
+            side.count = 0;
+            side.changed_depth = 0;
+        }
+        return true;
+    }
+
+    OKXFastParser::ArrayReader rows(levels);
+    std::string_view row, px_text, sz_text;
+
+    if (!snapshot) {
+        while (rows.Next(row)) {
+            // ["price", "size", "liquidated orders", "order count"]
+            OKXFastParser::ArrayReader fields(row);
+            double px, sz;
+            if (!fields.Next(px_text) || !fields.Next(sz_text) ||
+                !OKXNumeric::TryParse(px_text, px) || !OKXNumeric::TryParse(sz_text, sz) ||
+                !side.Apply(px, sz, px_text, sz_text)) {
+                return false;
+            }
+            stats_.levels_changed++;
+        }
+        return rows.Ok();
+    }
+
+    // Snapshots arrive best-first: fill from the top of the arrays down,
+    // then slide the block to index 0
+    size_t filled = 0;
+    while (rows.Next(row)) {
+        if (filled == side.capacity) {
+            continue;
+        }
+        OKXFastParser::ArrayReader fields(row);
+        size_t index = side.capacity - 1 - filled;
+        if (!fields.Next(px_text) || !fields.Next(sz_text) ||
+            !OKXNumeric::TryParse(px_text, side.price[index]) ||
+            !OKXNumeric::TryParse(sz_text, side.size[index]) ||
+            !SetText(side.price_text[index].data, side.price_text[index].length,
+                     px_text, kTextCapacity) ||
+            !SetText(side.size_text[index].data, side.size_text[index].length,
+                     sz_text, kTextCapacity)) {
+            return false;
+        }
+        filled++;
+    }
+
+    size_t first = side.capacity - filled;
+    if (first != 0) {
+        std::memmove(side.price.data(), side.price.data() + first, filled * sizeof(double));
+        std::memmove(side.size.data(), side.size.data() + first, filled * sizeof(double));
+        std::memmove(side.price_text.data(), side.price_text.data() + first, filled * sizeof(LevelText));
+        std::memmove(side.size_text.data(), side.size_text.data() + first, filled * sizeof(LevelText));
+    }
+    side.count = filled;
+    side.changed_depth = 0;
+    return rows.Ok();
+}
+
+OrderBook::Result OrderBook::Apply(std::string_view data, bool snapshot) {
+    OKXFastParser::ObjectReader reader(data);
+    std::string_view key, value, asks, bids, checksum, seq_id, prev_seq_id, ts;
+
+    while (reader.Next(key, value)) {
+        if (key == "asks") {
+            asks = value;
+        } else if (key == "bids") {
+            bids = value;
+        } else if (key == "ts") {
+            ts = value;
+        } else if (key == "checksum") {
+            checksum = value;
+        } else if (key == "seqId") {
+            seq_id = value;
+        } else if (key == "prevSeqId") {
+            prev_seq_id = value;
+        }
+    }
+    if (!reader.Ok()) {
+        stats_.parse_errors++;
+        return Result::kParseError;
+    }
+
+    if (!snapshot) {
+        if (!initialized_) {
+            return Result::kNotInitialized;
+        }
+        int64_t prev = 0;
+        if (seq_id_ >= 0 && OKXNumeric::TryParse(prev_seq_id, prev) && prev != seq_id_) {
+            stats_.sequence_gaps++;
+            initialized_ = false;
+            return Result::kSequenceGap;
+        }
+    }
+
+    if (!ParseSide(bids, bids_, snapshot) || !ParseSide(asks, asks_, snapshot)) {
+        stats_.parse_errors++;
+        initialized_ = false;
+        return Result::kParseError;
+    }
+
+    timestamp_ = OKXNumeric::ToUint64(ts, timestamp_);
+    seq_id_ = OKXNumeric::ToInt64(seq_id, -1);
+    if (snapshot) {
+        stats_.snapshots++;
+    } else {
+        stats_.updates++;
+    }
+
+    int64_t expected = 0;
+    if (verify_checksum_ && OKXNumeric::TryParse(checksum, expected) &&
+        static_cast<int32_t>(expected) !=
+            UpdateChecksum(std::min(bids_.changed_depth, asks_.changed_depth))) {
+        stats_.checksum_failures++;
+        initialized_ = false;
+        return Result::kChecksumMismatch;
+    }
+
+    initialized_ = true;
+    return Result::kOk;
+}
+
+int32_t OrderBook::UpdateChecksum(size_t from_depth) {
+    bids_.changed_depth = kChecksumLevels;
+    asks_.changed_depth = kChecksumLevels;
+    if (from_depth >= kChecksumLevels) {
+        return checksum_;
+    }
+
+    // Same layout as ComputeChecksum, hashed one depth at a time with a
+    // ':' in front of every field except the very first
+    char chunk[4 * (kTextCapacity + 1)];
+    uint32_t state = checksum_state_[from_depth];
+    bool separator = from_depth > 0;
+
+    for (size_t depth = from_depth; depth < kChecksumLevels; depth++) {
+        size_t length = 0;
+        auto append = [&](const LevelText& text) {
+            if (separator) {
+                chunk[length++] = ':';
+            }
+            separator = true;
+            std::memcpy(chunk + length, text.data, text.length);
+            length += text.length;
+        };
+
+        if (depth < bids_.count) {
+            size_t index = bids_.count - 1 - depth;
+            append(bids_.price_text[index]);
+            append(bids_.size_text[index]);
+        }
+        if (depth < asks_.count) {
+            size_t index = asks_.count - 1 - depth;
+            append(asks_.price_text[index]);
+            append(asks_.size_text[index]);
+        }
+
+        state = Crc32Update(state, chunk, length);
+        checksum_state_[depth + 1] = state;
+    }
+
+    checksum_ = static_cast<int32_t>(state ^ 0xFFFFFFFFu);
+    return checksum_;
+}
+
+int32_t OrderBook::ComputeChecksum() const {
+    // "bid1Px:bid1Sz:ask1Px:ask1Sz:bid2Px:..." over the top 25 levels;
+    // a side that runs out is simply skipped
+    char buffer[kChecksumLevels * 4 * (kTextCapacity + 1)];
+    size_t length = 0;
+
+    auto append = [&](const LevelText& text) {
+        std::memcpy(buffer + length, text.data, text.length);
+        length += text.length;
+        buffer[length++] = ':';
+    };
+
+    for (size_t depth = 0; depth < kChecksumLevels; depth++) {
+        if (depth < bids_.count) {
+            size_t index = bids_.count - 1 - depth;
+            append(bids_.price_text[index]);
+            append(bids_.size_text[index]);
+        }
+        if (depth < asks_.count) {
+            size_t index = asks_.count - 1 - depth;
+            append(asks_.price_text[index]);
+            append(asks_.size_text[index]);
+        }
+    }
+    if (length > 0) {
+        length--;  // Trailing ':'
+    }
+
+    return static_cast<int32_t>(Crc32(buffer, length));
+}
+
+void OrderBook::ToDepth(Depth& depth, size_t levels) const {
+    depth.inst_id = inst_id_;
+    depth.timestamp = timestamp_;
+    depth.fixed_point = false;
+
+    depth.bids.clear();
+    for (size_t i = 0; i < levels && i < bids_.count; i++) {
+        depth.bids.push_back(bids_.Level(i));
+    }
+
+    depth.asks.clear();
+    for (size_t i = 0; i < levels && i < asks_.count; i++) {
+        depth.asks.push_back(asks_.Level(i));
+    }
+}
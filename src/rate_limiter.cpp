@@ -0,0 +1,147 @@
+#include "rate_limiter.h"
+#include <algorithm>
+
+void RateLimiter::Bucket::Refill(Clock::time_point now) {
+    if (now <= last_refill) {
+        return;
+    }
+
+    double elapsed = std::chrono::duration<double>(now - last_refill).count();
+    tokens = std::min(limit.burst, tokens + elapsed * limit.requests_per_second);
+    last_refill = now;
+}
+
+void RateLimiter::SetLimit(const std::string& key, const Limit& limit) {
+    std::unique_lock<std::shared_mutex> lock(map_mutex_);
+
+    auto& bucket = buckets_[key];
+    if (!bucket) {
+        bucket = std::make_unique<Bucket>(limit);
+        return;
+    }
+
+    // Update in place so pointers from GetBucket() stay valid
+    std::lock_guard<std::mutex> bucket_lock(bucket->mutex);
+    bucket->limit = limit;
+    bucket->tokens = limit.burst;
+    bucket->last_refill = Clock::now();
+}
+
+void RateLimiter::SetDefaultLimit(const Limit& limit) {
+    std::unique_lock<std::shared_mutex> lock(map_mutex_);
+    default_limit_ = limit;
+}
+
+RateLimiter::Bucket* RateLimiter::FindOrCreate(const std::string& key) {
+    {
+        std::shared_lock<std::shared_mutex> lock(map_mutex_);
+        auto it = buckets_.find(key);
+        if (it != buckets_.end()) {
+            return it->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(map_mutex_);
+    auto& bucket = buckets_[key];
+    if (!bucket) {
+        bucket = std::make_unique<Bucket>(default_limit_);
+    }
+    return bucket.get();
+}
+
+RateLimiter::Decision RateLimiter::Acquire(const std::string& key,
+                                           std::chrono::milliseconds max_wait,
+                                           double cost) {
+    return Acquire(FindOrCreate(key), max_wait, cost);
+}
+
+RateLimiter::Decision RateLimiter::Acquire(Bucket* bucket,
+                                           std::chrono::milliseconds max_wait,
+                                           double cost) {
+    auto now = Clock::now();
+    Decision decision;
+    decision.not_before = now;
+
+    std::lock_guard<std::mutex> lock(bucket->mutex);
+    bucket->Refill(now);
+
+    if (bucket->tokens >= cost) {
+        bucket->tokens -= cost;
+        bucket->stats.granted++;
+        decision.granted = true;
+        return decision;
+    }
+
+    if (bucket->limit.requests_per_second <= 0) {
+        bucket->stats.rejected++;
+        return decision;
+    }
+
+    // Time until the bucket (including earlier reservations) covers `cost`
+    double wait_seconds = (cost - bucket->tokens) / bucket->limit.requests_per_second;
+    auto wait = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(wait_seconds));
+
+    if (wait > max_wait) {
+        bucket->stats.rejected++;
+        return decision;
+    }
+
+    // Reserve: tokens go negative and later callers queue behind this one
+    bucket->tokens -= cost;
+    bucket->stats.queued++;
+    bucket->stats.total_queue_ms += wait_seconds * 1000.0;
+
+    decision.granted = true;
+    decision.not_before = now + wait;
+    return decision;
+}
+
+RateLimiter::BucketStatistics RateLimiter::GetStatistics(const std::string& key) const {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+
+    auto it = buckets_.find(key);
+    if (it == buckets_.end()) {
+        BucketStatistics stats;
+        stats.limit = default_limit_;
+        stats.tokens = default_limit_.burst;
+        return stats;
+    }
+
+    Bucket& bucket = *it->second;
+    std::lock_guard<std::mutex> bucket_lock(bucket.mutex);
+    bucket.Refill(Clock::now());
+
+    BucketStatistics stats = bucket.stats;
+    stats.tokens = bucket.tokens;
+    stats.limit = bucket.limit;
+    return stats;
+}
+
+std::map<std::string, RateLimiter::BucketStatistics> RateLimiter::GetAllStatistics() const {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+
+    std::map<std::string, BucketStatistics> result;
+    auto now = Clock::now();
+
+    for (const auto& [key, bucket] : buckets_) {
+        std::lock_guard<std::mutex> bucket_lock(bucket->mutex);
+        bucket->Refill(now);
+
+        BucketStatistics stats = bucket->stats;
+        stats.tokens = bucket->tokens;
+        stats.limit = bucket->limit;
+        result[key] = stats;
+    }
+
+    return result;
+}
+
+void RateLimiter::ResetStatistics() {
+    std::shared_lock<std::shared_mutex> lock(map_mutex_);
+
+    for (auto& [key, bucket] : buckets_) {
+        std::lock_guard<std::mutex> bucket_lock(bucket->mutex);
+        bucket->stats = BucketStatistics();
+    }
+}
@@ -0,0 +1,277 @@
+#include "spread_engine.h"
+#include <algorithm>
+#include <iostream>
+
+SpreadEngine::SpreadEngine(const StrategyParams& params, SymbolTable::Id okx_symbol, SymbolTable::Id mt5_symbol)
+    : max_levels_(0)
+    , okx_symbol_(okx_symbol)
+    , mt5_symbol_(mt5_symbol)
+    , okx_{}
+    , mt5_{}
+    , ladders_{}
+    , next_group_id_(1)
+    , stats_{} {
+    SetParams(params);
+}
+
+void SpreadEngine::SetParams(const StrategyParams& params) {
+    params_ = params;
+    if (params.max_orders > static_cast<int>(kMaxLevels)) {
+        std::cerr << "SpreadEngine: max_orders " << params.max_orders << " clamped to " << kMaxLevels << std::endl;
+    }
+    max_levels_ = static_cast<size_t>(std::min<int>(std::max(params.max_orders, 0),
+                                                     static_cast<int>(kMaxLevels)));
+}
+
+// ==================== Quote events ====================
+
+size_t SpreadEngine::OnQuote(const TickPOD& tick, Decision* out, size_t capacity) {
+    if (tick.platform == TickPOD::Platform::kOKX && tick.symbol_id == okx_symbol_) {
+        return OnOkxQuote(tick.bid, tick.ask, tick.timestamp, out, capacity);
+    }
+    if (tick.platform == TickPOD::Platform::kMT5 && tick.symbol_id == mt5_symbol_) {
+        return OnMt5Quote(tick.bid, tick.ask, tick.timestamp, out, capacity);
+    }
+    return 0;
+}
+
+size_t SpreadEngine::OnOkxQuote(Price bid, Price ask, Timestamp timestamp, Decision* out, size_t capacity) {
+    // A one-sided or empty book stops trading on the pair until it recovers
+    okx_.valid = bid > 0 && ask > 0;
+    if (!okx_.valid) {
+        return 0;
+    }
+    okx_.bid = bid;
+    okx_.ask = ask;
+    okx_.timestamp = timestamp;
+    stats_.quotes++;
+    return Evaluate(out, capacity);
+}
+
+size_t SpreadEngine::OnMt5Quote(Price bid, Price ask, Timestamp timestamp, Decision* out, size_t capacity) {
+    mt5_.valid = bid > 0 && ask > 0;
+    if (!mt5_.valid) {
+        return 0;
+    }
+    mt5_.bid = bid;
+    mt5_.ask = ask;
+    mt5_.timestamp = timestamp;
+    stats_.quotes++;
+    return Evaluate(out, capacity);
+}
+
+SpreadEngine::Legs SpreadEngine::LegsFor(Direction direction) const {
+    Legs legs;
+    legs.okx_is_short = direction == Direction::kShortOkx;
+    if (legs.okx_is_short) {
+        legs.short_quote = &okx_;
+        legs.long_quote = &mt5_;
+        legs.short_size = params_.okx_order_size;
+        legs.long_size = params_.mt5_order_size;
+        legs.short_fee_rate = params_.okx_fee_rate;
+        legs.long_fee_rate = params_.mt5_fee_rate;
+    } else {
+        legs.short_quote = &mt5_;
+        legs.long_quote = &okx_;
+        legs.short_size = params_.mt5_order_size;
+        legs.long_size = params_.okx_order_size;
+        legs.short_fee_rate = params_.mt5_fee_rate;
+        legs.long_fee_rate = params_.okx_fee_rate;
+    }
+    return legs;
+}
+
+double SpreadEngine::NetSpread(const Legs& legs) {
+    Price short_bid = legs.short_quote->bid;
+    Price long_ask = legs.long_quote->ask;
+    // Opening and closing fee of one unit on each leg
+    double fees = 2 * (short_bid * legs.short_fee_rate + long_ask * legs.long_fee_rate);
+    return short_bid - long_ask - fees;
+}
+
+size_t SpreadEngine::Evaluate(Decision* out, size_t capacity) {
+    if (!okx_.valid || !mt5_.valid) {
+        return 0;
+    }
+    stats_.evaluations++;
+
+    Timestamp now = std::max(okx_.timestamp, mt5_.timestamp);
+    size_t written = EvaluateDirection(Direction::kShortOkx, now, out, capacity);
+    written += EvaluateDirection(Direction::kShortMt5, now, out + written, capacity - written);
+    return written;
+}
+
+size_t SpreadEngine::EvaluateDirection(Direction direction, Timestamp now, Decision* out, size_t capacity) {
+    Ladder& ladder = LadderFor(direction);
+    Legs legs = LegsFor(direction);
+    double net_spread = NetSpread(legs);
+    size_t written = 0;
+
+    // Short leg bought back at the ask, long leg sold at the bid
+    Price short_exit = legs.short_quote->ask;
+    Price long_exit = legs.long_quote->bid;
+    double close_fee = short_exit * legs.short_size * legs.short_fee_rate +
+                       long_exit * legs.long_size * legs.long_fee_rate;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < ladder.count; i++) {
+        const Group& group = ladder.groups[i];
+        Price short_entry = legs.okx_is_short ? group.okx_entry : group.mt5_entry;
+        Price long_entry = legs.okx_is_short ? group.mt5_entry : group.okx_entry;
+        double pnl = (short_entry - short_exit) * legs.short_size +
+                     (long_exit - long_entry) * legs.long_size - group.open_fee - close_fee;
+
+        // Groups that don't fit in out stay open and are reported next quote
+        if (pnl > params_.take_profit && written < capacity) {
+            Decision& decision = out[written++];
+            decision.action = Action::kClose;
+            decision.direction = direction;
+            decision.level = group.level;
+            decision.group_id = group.group_id;
+            decision.okx_price = legs.okx_is_short ? short_exit : long_exit;
+            decision.mt5_price = legs.okx_is_short ? long_exit : short_exit;
+            decision.net_spread = net_spread;
+            decision.pnl = pnl;
+            decision.timestamp = now;
+            stats_.closes++;
+            stats_.realized_pnl += pnl;
+            ladder.levels &= ~(1u << group.level);
+            continue;
+        }
+        ladder.groups[kept++] = group;
+    }
+    ladder.count = kept;
+
+    if (written >= capacity || ladder.count >= max_levels_) {
+        return written;
+    }
+    size_t level = FreeLevel(ladder);
+    double threshold = params_.first_order + static_cast<double>(level) * params_.next_order;
+    if (net_spread <= threshold) {
+        return written;
+    }
+
+    // Short leg sold at the bid, long leg bought at the ask
+    Price short_entry = legs.short_quote->bid;
+    Price long_entry = legs.long_quote->ask;
+
+    Group& group = ladder.groups[ladder.count];
+    group.group_id = next_group_id_++;
+    group.level = static_cast<uint8_t>(level);
+    group.okx_entry = legs.okx_is_short ? short_entry : long_entry;
+    group.mt5_entry = legs.okx_is_short ? long_entry : short_entry;
+    group.open_fee = short_entry * legs.short_size * legs.short_fee_rate +
+                     long_entry * legs.long_size * legs.long_fee_rate;
+    group.open_time = now;
+    ladder.count++;
+    ladder.levels |= 1u << level;
+
+    Decision& decision = out[written++];
+    decision.action = Action::kOpen;
+    decision.direction = direction;
+    decision.level = group.level;
+    decision.group_id = group.group_id;
+    decision.okx_price = group.okx_entry;
+    decision.mt5_price = group.mt5_entry;
+    decision.net_spread = net_spread;
+    decision.pnl = 0;
+    decision.timestamp = now;
+    stats_.opens++;
+    return written;
+}
+
+size_t SpreadEngine::FreeLevel(const Ladder& ladder) {
+    size_t level = 0;
+    while (ladder.levels & (1u << level)) {
+        level++;
+    }
+    return level;
+}
+
+// ==================== State ====================
+
+double SpreadEngine::NetSpread(Direction direction) const {
+    if (!okx_.valid || !mt5_.valid) {
+        return 0;
+    }
+    return NetSpread(LegsFor(direction));
+}
+
+double SpreadEngine::NextThreshold(Direction direction) const {
+    const Ladder& ladder = LadderFor(direction);
+    if (ladder.count >= max_levels_) {
+        return 0;
+    }
+    return params_.first_order + static_cast<double>(FreeLevel(ladder)) * params_.next_order;
+}
+
+bool SpreadEngine::UpdateEntry(int group_id, Price okx_fill, Price mt5_fill) {
+    for (Direction direction : {Direction::kShortOkx, Direction::kShortMt5}) {
+        Ladder& ladder = LadderFor(direction);
+        for (size_t i = 0; i < ladder.count; i++) {
+            Group& group = ladder.groups[i];
+            if (group.group_id != group_id) {
+                continue;
+            }
+            group.okx_entry = okx_fill;
+            group.mt5_entry = mt5_fill;
+            group.open_fee = okx_fill * params_.okx_order_size * params_.okx_fee_rate +
+                             mt5_fill * params_.mt5_order_size * params_.mt5_fee_rate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void SpreadEngine::ToOrderGroup(Direction direction, const Group& group, OrderGroup& out) const {
+    bool okx_short = direction == Direction::kShortOkx;
+
+    auto fill_leg = [&](Order& order, SymbolTable::Id symbol, const char* platform, bool is_short,
+                        Price entry, double size, double fee_rate) {
+        order = Order();
+        order.symbol = SymbolTable::Global().Name(symbol);
+        order.inst_id = order.symbol;
+        order.platform = platform;
+        order.side = is_short ? "sell" : "buy";
+        order.position_side = is_short ? "short" : "long";
+        order.order_type = "market";
+        order.state = "filled";
+        order.price = order.avg_price = order.avg_fill_price = entry;
+        order.size = order.filled_size = size;
+        order.fee = entry * size * fee_rate;
+        order.create_time = order.update_time = group.open_time;
+        order.group_id = group.group_id;
+    };
+    fill_leg(out.okx_order, okx_symbol_, "okx", okx_short, group.okx_entry,
+             params_.okx_order_size, params_.okx_fee_rate);
+    fill_leg(out.mt5_order, mt5_symbol_, "mt5", !okx_short, group.mt5_entry,
+             params_.mt5_order_size, params_.mt5_fee_rate);
+
+    out.group_id = group.group_id;
+    out.total_fee = group.open_fee;
+    out.total_pnl = 0;
+    if (okx_.valid && mt5_.valid) {
+        // Marked like EvaluateDirection, closing fees included
+        Price okx_exit = okx_short ? okx_.ask : okx_.bid;
+        Price mt5_exit = okx_short ? mt5_.bid : mt5_.ask;
+        double okx_pnl = (okx_exit - group.okx_entry) * params_.okx_order_size;
+        double mt5_pnl = (mt5_exit - group.mt5_entry) * params_.mt5_order_size;
+        double close_fee = okx_exit * params_.okx_order_size * params_.okx_fee_rate +
+                           mt5_exit * params_.mt5_order_size * params_.mt5_fee_rate;
+        out.total_pnl = (okx_short ? -okx_pnl : okx_pnl) + (okx_short ? mt5_pnl : -mt5_pnl) -
+                        group.open_fee - close_fee;
+    }
+    out.status = "open";
+    out.create_time = group.open_time;
+    out.close_time = 0;
+}
+
+void SpreadEngine::Reset() {
+    okx_ = Quote{};
+    mt5_ = Quote{};
+    for (Ladder& ladder : ladders_) {
+        ladder.count = 0;
+        ladder.levels = 0;
+    }
+    stats_ = Statistics{};
+}
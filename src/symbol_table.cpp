@@ -0,0 +1,75 @@
+#include "symbol_table.h"
+#include <functional>
+
+SymbolTable::SymbolTable()
+    : size_(0)
+    , index_(new std::atomic<uint32_t>[kIndexSize]()) {
+}
+
+SymbolTable::~SymbolTable() = default;
+
+SymbolTable& SymbolTable::Global() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolTable::Id SymbolTable::Intern(std::string_view name) {
+    if (name.empty()) {
+        return kInvalidId;
+    }
+
+    Id id = Find(name);
+    if (id != kInvalidId) {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = Find(name);
+    if (id != kInvalidId) {
+        return id;
+    }
+
+    uint32_t index = size_.load(std::memory_order_relaxed);
+    size_t chunk = index / kChunkSize;
+    if (chunk >= kMaxChunks) {
+        return kInvalidId;
+    }
+    if (!chunks_[chunk]) {
+        chunks_[chunk].reset(new std::string[kChunkSize]);
+    }
+
+    // Name first, then publish the new size and index entry for lock-free readers
+    std::string& stored = chunks_[chunk][index % kChunkSize];
+    stored.assign(name.data(), name.size());
+    size_.store(index + 1, std::memory_order_release);
+
+    size_t slot = std::hash<std::string_view>()(name) & (kIndexSize - 1);
+    while (index_[slot].load(std::memory_order_relaxed) != 0) {
+        slot = (slot + 1) & (kIndexSize - 1);
+    }
+    index_[slot].store(index + 1, std::memory_order_release);
+    return index;
+}
+
+SymbolTable::Id SymbolTable::Find(std::string_view name) const {
+    // Never full (kIndexSize is twice the name limit), so an empty entry ends the probe
+    size_t slot = std::hash<std::string_view>()(name) & (kIndexSize - 1);
+    for (;;) {
+        uint32_t entry = index_[slot].load(std::memory_order_acquire);
+        if (entry == 0) {
+            return kInvalidId;
+        }
+        if (chunks_[(entry - 1) / kChunkSize][(entry - 1) % kChunkSize] == name) {
+            return entry - 1;
+        }
+        slot = (slot + 1) & (kIndexSize - 1);
+    }
+}
+
+const std::string& SymbolTable::Name(Id id) const {
+    static const std::string empty;
+    if (id >= size_.load(std::memory_order_acquire)) {
+        return empty;
+    }
+    return chunks_[id / kChunkSize][id % kChunkSize];
+}
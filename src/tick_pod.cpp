@@ -0,0 +1,49 @@
+#include "tick_pod.h"
+#include <cstring>
+
+void TickPOD::FromTick(const Tick& tick, TickPOD& pod) {
+    pod.symbol_id = SymbolTable::Global().Intern(tick.inst_id.empty() ? tick.symbol : tick.inst_id);
+    pod.platform = PlatformFromString(tick.platform);
+    std::memset(pod.reserved, 0, sizeof(pod.reserved));
+
+    // Parsers fill either the OKX fields or the compatibility ones
+    pod.bid = tick.bid_price != 0 ? tick.bid_price : tick.bid;
+    pod.ask = tick.ask_price != 0 ? tick.ask_price : tick.ask;
+    pod.last = tick.last_price != 0 ? tick.last_price : tick.last;
+    pod.bid_size = tick.bid_size;
+    pod.ask_size = tick.ask_size;
+    pod.mark_price = tick.mark_price;
+    pod.timestamp = tick.timestamp;
+}
+
+void TickPOD::ToTick(Tick& tick) const {
+    const std::string& name = Symbol();
+    tick.symbol = name;
+    tick.inst_id = name;
+    tick.platform = platform == Platform::kUnknown ? std::string() : PlatformName(platform);
+    tick.bid = tick.bid_price = bid;
+    tick.ask = tick.ask_price = ask;
+    tick.last = tick.last_price = last;
+    tick.bid_size = bid_size;
+    tick.ask_size = ask_size;
+    tick.mark_price = mark_price;
+    tick.timestamp = timestamp;
+}
+
+TickPOD::Platform TickPOD::PlatformFromString(std::string_view platform) {
+    if (platform == "okx") {
+        return Platform::kOKX;
+    }
+    if (platform == "mt5") {
+        return Platform::kMT5;
+    }
+    return Platform::kUnknown;
+}
+
+const char* TickPOD::PlatformName(Platform platform) {
+    switch (platform) {
+        case Platform::kOKX: return "okx";
+        case Platform::kMT5: return "mt5";
+        default: return "";
+    }
+}
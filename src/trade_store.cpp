@@ -0,0 +1,1145 @@
+#include "trade_store.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    struct ColumnSpec {
+        const char* name;
+        uint32_t width;
+    };
+
+    struct TableSpec {
+        const char* name;
+        const ColumnSpec* columns;
+        size_t column_count;
+    };
+
+    enum FillColumn : size_t {
+        kFillBillId, kFillTradeId, kFillOrderId, kFillTime,
+        kFillInstId, kFillFeeCcy, kFillSide, kFillExecType,
+        kFillPrice, kFillSize, kFillFee
+    };
+
+    const ColumnSpec kFillColumns[] = {
+        {"bill_id", 8}, {"trade_id", 8}, {"order_id", 8}, {"fill_time", 8},
+        {"inst_id", 4}, {"fee_ccy", 4}, {"side", 4}, {"exec_type", 4},
+        {"fill_px", 8}, {"fill_sz", 8}, {"fee", 8},
+    };
+
+    enum OrderColumn : size_t {
+        kOrderId, kOrderCreateTime, kOrderUpdateTime,
+        kOrderInstId, kOrderSide, kOrderType, kOrderState, kOrderPositionSide,
+        kOrderPrice, kOrderSize, kOrderFilledSize, kOrderAvgPrice, kOrderFee, kOrderPnl
+    };
+
+    const ColumnSpec kOrderColumns[] = {
+        {"ord_id", 8}, {"c_time", 8}, {"u_time", 8},
+        {"inst_id", 4}, {"side", 4}, {"ord_type", 4}, {"state", 4}, {"pos_side", 4},
+        {"px", 8}, {"sz", 8}, {"acc_fill_sz", 8}, {"avg_px", 8}, {"fee", 8}, {"pnl", 8},
+    };
+
+    enum BillColumn : size_t {
+        kBillId, kBillTime, kBillInstId, kBillCcy, kBillType, kBillSubType,
+        kBillBalanceChange, kBillBalance, kBillFee
+    };
+
+    const ColumnSpec kBillColumns[] = {
+        {"bill_id", 8}, {"ts", 8}, {"inst_id", 4}, {"ccy", 4}, {"type", 4}, {"sub_type", 4},
+        {"bal_chg", 8}, {"bal", 8}, {"fee", 8},
+    };
+
+    const TableSpec kTables[] = {
+        {"fills", kFillColumns, sizeof(kFillColumns) / sizeof(kFillColumns[0])},
+        {"orders", kOrderColumns, sizeof(kOrderColumns) / sizeof(kOrderColumns[0])},
+        {"bills", kBillColumns, sizeof(kBillColumns) / sizeof(kBillColumns[0])},
+    };
+
+    const char* kDictionaryFile = "strings.dict";
+    const char* kMarksFile = "sync.marks";
+
+    // OKX ids are decimal strings; 0 for anything else
+    uint64_t ParseId(const std::string& id) {
+        if (id.empty() || id.size() > 20) {
+            return 0;
+        }
+        char* end = nullptr;
+        unsigned long long value = std::strtoull(id.c_str(), &end, 10);
+        return end && *end == '\0' ? static_cast<uint64_t>(value) : 0;
+    }
+
+    std::string IdString(uint64_t id) {
+        return id == 0 ? std::string() : std::to_string(id);
+    }
+
+    bool MakeDirectory(const std::string& path) {
+#if defined(_WIN32)
+        return CreateDirectoryA(path.c_str(), nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+#else
+        return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+    }
+
+    // Records whose id is not stored yet, by ascending id, one per id
+    template <typename T>
+    std::vector<std::pair<uint64_t, const T*>> NewRecords(const std::vector<T>& records,
+                                                          const std::unordered_set<uint64_t>& stored,
+                                                          uint64_t (*id_of)(const T&)) {
+        std::vector<std::pair<uint64_t, const T*>> fresh;
+        fresh.reserve(records.size());
+        for (const T& record : records) {
+            uint64_t id = id_of(record);
+            if (id != 0 && stored.count(id) == 0) {
+                fresh.emplace_back(id, &record);
+            }
+        }
+        std::sort(fresh.begin(), fresh.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        fresh.erase(std::unique(fresh.begin(), fresh.end(),
+                                [](const auto& a, const auto& b) { return a.first == b.first; }),
+                    fresh.end());
+        return fresh;
+    }
+
+    uint64_t FillId(const OKXRestAPI::Fill& fill) { return ParseId(fill.bill_id); }
+    uint64_t OrderId(const Order& order) { return ParseId(order.order_id); }
+    uint64_t BillId(const OKXRestAPI::Bill& bill) { return ParseId(bill.bill_id); }
+
+    // Walk a pager newest to oldest until done(record)
+    template <typename T, typename Done>
+    bool Collect(HistoryPager<T> pager, Done done, const char* what, std::vector<T>& fresh) {
+        T record;
+        while (pager.Next(record)) {
+            if (done(record)) {
+                break;
+            }
+            fresh.push_back(std::move(record));
+        }
+        if (pager.Failed()) {
+            std::cerr << "TradeStore: " << what << " sync failed after " << fresh.size()
+                      << " records; nothing stored" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+static_assert(sizeof(uint64_t) == sizeof(double), "Columns store doubles as 8 bytes");
+
+// ==================== MappedFile ====================
+
+TradeStore::MappedFile::MappedFile()
+    : data_(nullptr)
+    , size_(0)
+#if defined(_WIN32)
+    , file_(INVALID_HANDLE_VALUE)
+    , mapping_(nullptr)
+#else
+    , fd_(-1)
+#endif
+{
+}
+
+TradeStore::MappedFile::MappedFile(MappedFile&& other) noexcept
+    : path_(std::move(other.path_))
+    , data_(other.data_)
+    , size_(other.size_)
+#if defined(_WIN32)
+    , file_(other.file_)
+    , mapping_(other.mapping_)
+#else
+    , fd_(other.fd_)
+#endif
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+#if defined(_WIN32)
+    other.file_ = INVALID_HANDLE_VALUE;
+    other.mapping_ = nullptr;
+#else
+    other.fd_ = -1;
+#endif
+}
+
+TradeStore::MappedFile& TradeStore::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        path_ = std::move(other.path_);
+        data_ = other.data_;
+        size_ = other.size_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+#if defined(_WIN32)
+        file_ = other.file_;
+        mapping_ = other.mapping_;
+        other.file_ = INVALID_HANDLE_VALUE;
+        other.mapping_ = nullptr;
+#else
+        fd_ = other.fd_;
+        other.fd_ = -1;
+#endif
+    }
+    return *this;
+}
+
+TradeStore::MappedFile::~MappedFile() {
+    Close();
+}
+
+bool TradeStore::MappedFile::Open(const std::string& path, size_t min_size) {
+    Close();
+    path_ = path;
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "TradeStore: cannot open " << path << std::endl;
+        return false;
+    }
+    file_ = file;
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(file, &current)) {
+        Close();
+        return false;
+    }
+    size_t size = static_cast<size_t>(current.QuadPart);
+#else
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        std::cerr << "TradeStore: cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd_, &info) != 0) {
+        Close();
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+#endif
+
+    return Map(std::max<size_t>(size, min_size));
+}
+
+bool TradeStore::MappedFile::Grow(size_t size) {
+    if (size <= size_) {
+        return true;
+    }
+    Unmap();
+    return Map(size);
+}
+
+bool TradeStore::MappedFile::Map(size_t size) {
+#if defined(_WIN32)
+    // Mapping a file beyond its end extends it
+    HANDLE mapping = CreateFileMappingA(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                       static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+    if (!mapping) {
+        std::cerr << "TradeStore: cannot map " << path_ << std::endl;
+        return false;
+    }
+    void* memory = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!memory) {
+        CloseHandle(mapping);
+        std::cerr << "TradeStore: cannot map " << path_ << std::endl;
+        return false;
+    }
+    mapping_ = mapping;
+#else
+    struct stat info;
+    if (fstat(fd_, &info) != 0 ||
+        (static_cast<size_t>(info.st_size) < size && ftruncate(fd_, static_cast<off_t>(size)) != 0)) {
+        std::cerr << "TradeStore: cannot size " << path_ << std::endl;
+        return false;
+    }
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (memory == MAP_FAILED) {
+        std::cerr << "TradeStore: cannot map " << path_ << std::endl;
+        return false;
+    }
+#endif
+
+    data_ = static_cast<char*>(memory);
+    size_ = size;
+    return true;
+}
+
+void TradeStore::MappedFile::Unmap() {
+    if (!data_) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    munmap(data_, size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool TradeStore::MappedFile::Sync() {
+    if (!data_) {
+        return false;
+    }
+#if defined(_WIN32)
+    return FlushViewOfFile(data_, size_) && FlushFileBuffers(static_cast<HANDLE>(file_));
+#else
+    return msync(data_, size_, MS_SYNC) == 0;
+#endif
+}
+
+void TradeStore::MappedFile::Close() {
+    Unmap();
+#if defined(_WIN32)
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+// ==================== Store ====================
+
+TradeStore::TradeStore()
+    : open_(false)
+    , order_lookback_ms_(kOrderLookbackMs) {
+}
+
+TradeStore::~TradeStore() {
+    Close();
+}
+
+bool TradeStore::Open(const std::string& directory) {
+    Close();
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (directory.empty() || !MakeDirectory(directory)) {
+        std::cerr << "TradeStore: cannot create " << directory << std::endl;
+        return false;
+    }
+    directory_ = directory;
+
+    // Dictionary: id 0 is the empty string, line n of strings.dict is id n.
+    // A line cut short by a crash was never referenced by a committed row
+    strings_.assign(1, std::string());
+    string_ids_.clear();
+    string_ids_.emplace(std::string(), 0);
+    pending_strings_.clear();
+
+    std::string path = directory_ + "/" + kDictionaryFile;
+    std::ifstream in(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    size_t valid = contents.rfind('\n');
+    valid = valid == std::string::npos ? 0 : valid + 1;
+    std::istringstream lines(contents.substr(0, valid));
+    std::string line;
+    while (std::getline(lines, line)) {
+        string_ids_.emplace(line, static_cast<uint32_t>(strings_.size()));
+        strings_.push_back(line);
+    }
+    if (valid != contents.size()) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(valid));
+        if (!out) {
+            std::cerr << "TradeStore: cannot repair " << path << std::endl;
+            return false;
+        }
+    }
+
+    for (size_t t = 0; t < kTableCount; t++) {
+        if (!OpenTable(static_cast<Table>(t))) {
+            for (TableState& state : tables_) {
+                state = TableState();
+            }
+            return false;
+        }
+    }
+    if (!LoadMarks()) {
+        for (TableState& state : tables_) {
+            state = TableState();
+        }
+        return false;
+    }
+
+    open_ = true;
+    return true;
+}
+
+bool TradeStore::OpenTable(Table table) {
+    const TableSpec& spec = kTables[static_cast<size_t>(table)];
+    TableState& state = tables_[static_cast<size_t>(table)];
+    std::string prefix = directory_ + "/" + spec.name;
+
+    if (!state.meta.Open(prefix + ".meta", sizeof(Header))) {
+        return false;
+    }
+    state.header = reinterpret_cast<Header*>(state.meta.Data());
+    Header& header = *state.header;
+    if (header.magic == 0) {
+        header.version = kVersion;
+        header.table = static_cast<uint32_t>(table);
+        header.column_count = static_cast<uint32_t>(spec.column_count);
+        header.rows = 0;
+        header.last_id = 0;
+        header.magic = kMagic;
+    } else if (header.magic != kMagic || header.version != kVersion ||
+               header.table != static_cast<uint32_t>(table) || header.column_count != spec.column_count) {
+        std::cerr << "TradeStore: " << prefix << ".meta does not match this store" << std::endl;
+        return false;
+    }
+
+    state.capacity = SIZE_MAX;
+    for (size_t c = 0; c < spec.column_count; c++) {
+        const ColumnSpec& column = spec.columns[c];
+        MappedFile file;
+        if (!file.Open(prefix + "." + column.name + ".col", kGrowRows * column.width)) {
+            return false;
+        }
+        state.capacity = std::min<size_t>(state.capacity, file.Size() / column.width);
+        state.columns.push_back(std::move(file));
+        state.widths.push_back(column.width);
+    }
+
+    if (header.rows > state.capacity) {
+        std::cerr << "TradeStore: " << spec.name << " columns are shorter than "
+                  << header.rows << " rows" << std::endl;
+        return false;
+    }
+
+    // Every table's id (billId, ordId) is column 0
+    const uint64_t* ids = reinterpret_cast<const uint64_t*>(state.columns[0].Data());
+    state.ids.reserve(header.rows);
+    state.ids.insert(ids, ids + header.rows);
+    return true;
+}
+
+bool TradeStore::LoadMarks() {
+    // One "<key> <mark>" per line; rewritten whole, so never partial
+    marks_.clear();
+    std::ifstream in(directory_ + "/" + kMarksFile);
+    if (!in.is_open()) {
+        return true;                // No sync yet
+    }
+    std::string key;
+    uint64_t mark = 0;
+    while (in >> key >> mark) {
+        marks_[key] = mark;
+    }
+    if (!in.eof()) {
+        std::cerr << "TradeStore: cannot read " << kMarksFile << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TradeStore::SaveMarks() {
+    std::string path = directory_ + "/" + kMarksFile;
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        for (const auto& entry : marks_) {
+            out << entry.first << ' ' << entry.second << '\n';
+        }
+        out.flush();
+        if (!out) {
+            std::cerr << "TradeStore: cannot write " << temp << std::endl;
+            return false;
+        }
+    }
+#if defined(_WIN32)
+    bool moved = MoveFileExA(temp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool moved = std::rename(temp.c_str(), path.c_str()) == 0;
+#endif
+    if (!moved) {
+        std::cerr << "TradeStore: cannot replace " << path << std::endl;
+    }
+    return moved;
+}
+
+void TradeStore::Close() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (TableState& state : tables_) {
+        state = TableState();
+    }
+    strings_.clear();
+    string_ids_.clear();
+    pending_strings_.clear();
+    marks_.clear();
+    directory_.clear();
+    open_ = false;
+}
+
+bool TradeStore::Flush() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!open_ || !FlushDictionary()) {
+        return false;
+    }
+    bool ok = true;
+    for (TableState& state : tables_) {
+        for (MappedFile& column : state.columns) {
+            ok = column.Sync() && ok;
+        }
+        ok = state.meta.Sync() && ok;
+    }
+    return ok;
+}
+
+bool TradeStore::Reserve(TableState& state, size_t rows) {
+    if (rows <= state.capacity) {
+        return true;
+    }
+    size_t capacity = (rows + kGrowRows - 1) / kGrowRows * kGrowRows;
+    for (size_t c = 0; c < state.columns.size(); c++) {
+        if (!state.columns[c].Grow(capacity * state.widths[c])) {
+            return false;
+        }
+    }
+    state.capacity = capacity;
+    return true;
+}
+
+void TradeStore::Commit(TableState& state, size_t rows, uint64_t last_id) {
+    // Values first, then the count that makes them part of the table
+    std::atomic_thread_fence(std::memory_order_release);
+    state.header->last_id = std::max<uint64_t>(state.header->last_id, last_id);
+    state.header->rows = rows;
+}
+
+// ==================== Dictionary ====================
+
+uint32_t TradeStore::Intern(const std::string& value) {
+    auto it = string_ids_.find(value);
+    if (it != string_ids_.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    strings_.push_back(value);
+    string_ids_.emplace(value, id);
+    pending_strings_ += value;
+    pending_strings_ += '\n';
+    return id;
+}
+
+const std::string& TradeStore::Lookup(uint32_t id) const {
+    return id < strings_.size() ? strings_[id] : strings_[0];
+}
+
+bool TradeStore::FlushDictionary() {
+    if (pending_strings_.empty()) {
+        return true;
+    }
+    std::ofstream out(directory_ + "/" + kDictionaryFile, std::ios::binary | std::ios::app);
+    out.write(pending_strings_.data(), static_cast<std::streamsize>(pending_strings_.size()));
+    out.flush();
+    if (!out) {
+        std::cerr << "TradeStore: cannot write " << kDictionaryFile << std::endl;
+        return false;
+    }
+    pending_strings_.clear();
+    return true;
+}
+
+TradeStore::CompiledFilter TradeStore::Compile(const Filter& filter) const {
+    CompiledFilter compiled;
+    compiled.begin_time = filter.begin_time;
+    compiled.end_time = filter.end_time;
+    if (!filter.inst_id.empty()) {
+        auto it = string_ids_.find(filter.inst_id);
+        compiled.empty = it == string_ids_.end();
+        compiled.inst_id = compiled.empty ? 0 : it->second;
+        compiled.by_inst = true;
+    }
+    if (!filter.currency.empty()) {
+        auto it = string_ids_.find(filter.currency);
+        compiled.empty = compiled.empty || it == string_ids_.end();
+        compiled.currency = it == string_ids_.end() ? 0 : it->second;
+        compiled.by_currency = true;
+    }
+    return compiled;
+}
+
+bool TradeStore::Matches(const CompiledFilter& filter, uint32_t inst_id, uint32_t currency, uint64_t time) {
+    return (!filter.by_inst || inst_id == filter.inst_id) &&
+           (!filter.by_currency || currency == filter.currency) &&
+           time >= filter.begin_time &&
+           (filter.end_time == 0 || time < filter.end_time);
+}
+
+// ==================== Writing ====================
+
+size_t TradeStore::AppendFills(const std::vector<OKXRestAPI::Fill>& fills) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return 0;
+    }
+    TableState& state = tables_[static_cast<size_t>(Table::kFills)];
+    auto fresh = NewRecords(fills, state.ids, &FillId);
+    size_t rows = state.header->rows;
+    if (fresh.empty() || !Reserve(state, rows + fresh.size())) {
+        return 0;
+    }
+
+    uint64_t* bill_ids = Column<uint64_t>(Table::kFills, kFillBillId);
+    uint64_t* trade_ids = Column<uint64_t>(Table::kFills, kFillTradeId);
+    uint64_t* order_ids = Column<uint64_t>(Table::kFills, kFillOrderId);
+    uint64_t* times = Column<uint64_t>(Table::kFills, kFillTime);
+    uint32_t* inst_ids = Column<uint32_t>(Table::kFills, kFillInstId);
+    uint32_t* fee_ccys = Column<uint32_t>(Table::kFills, kFillFeeCcy);
+    uint32_t* sides = Column<uint32_t>(Table::kFills, kFillSide);
+    uint32_t* exec_types = Column<uint32_t>(Table::kFills, kFillExecType);
+    double* prices = Column<double>(Table::kFills, kFillPrice);
+    double* sizes = Column<double>(Table::kFills, kFillSize);
+    double* fees = Column<double>(Table::kFills, kFillFee);
+
+    for (size_t i = 0; i < fresh.size(); i++) {
+        const OKXRestAPI::Fill& fill = *fresh[i].second;
+        size_t row = rows + i;
+        bill_ids[row] = fresh[i].first;
+        trade_ids[row] = ParseId(fill.trade_id);
+        order_ids[row] = ParseId(fill.order_id);
+        times[row] = fill.fill_time;
+        inst_ids[row] = Intern(fill.inst_id);
+        fee_ccys[row] = Intern(fill.fee_currency);
+        sides[row] = Intern(fill.side);
+        exec_types[row] = Intern(fill.exec_type);
+        prices[row] = fill.fill_price;
+        sizes[row] = fill.fill_size;
+        fees[row] = fill.fee;
+    }
+
+    if (!FlushDictionary()) {
+        return 0;
+    }
+    Commit(state, rows + fresh.size(), fresh.back().first);
+    for (const auto& record : fresh) {
+        state.ids.insert(record.first);
+    }
+    return fresh.size();
+}
+
+size_t TradeStore::AppendOrders(const std::vector<Order>& orders) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return 0;
+    }
+    TableState& state = tables_[static_cast<size_t>(Table::kOrders)];
+    auto fresh = NewRecords(orders, state.ids, &OrderId);
+    size_t rows = state.header->rows;
+    if (fresh.empty() || !Reserve(state, rows + fresh.size())) {
+        return 0;
+    }
+
+    uint64_t* order_ids = Column<uint64_t>(Table::kOrders, kOrderId);
+    uint64_t* create_times = Column<uint64_t>(Table::kOrders, kOrderCreateTime);
+    uint64_t* update_times = Column<uint64_t>(Table::kOrders, kOrderUpdateTime);
+    uint32_t* inst_ids = Column<uint32_t>(Table::kOrders, kOrderInstId);
+    uint32_t* sides = Column<uint32_t>(Table::kOrders, kOrderSide);
+    uint32_t* types = Column<uint32_t>(Table::kOrders, kOrderType);
+    uint32_t* states = Column<uint32_t>(Table::kOrders, kOrderState);
+    uint32_t* position_sides = Column<uint32_t>(Table::kOrders, kOrderPositionSide);
+    double* prices = Column<double>(Table::kOrders, kOrderPrice);
+    double* sizes = Column<double>(Table::kOrders, kOrderSize);
+    double* filled_sizes = Column<double>(Table::kOrders, kOrderFilledSize);
+    double* avg_prices = Column<double>(Table::kOrders, kOrderAvgPrice);
+    double* fees = Column<double>(Table::kOrders, kOrderFee);
+    double* pnls = Column<double>(Table::kOrders, kOrderPnl);
+
+    for (size_t i = 0; i < fresh.size(); i++) {
+        const Order& order = *fresh[i].second;
+        size_t row = rows + i;
+        order_ids[row] = fresh[i].first;
+        create_times[row] = order.create_time;
+        update_times[row] = order.update_time;
+        inst_ids[row] = Intern(order.inst_id);
+        sides[row] = Intern(order.side);
+        types[row] = Intern(order.order_type);
+        states[row] = Intern(order.state);
+        position_sides[row] = Intern(order.position_side);
+        prices[row] = order.price;
+        sizes[row] = order.size;
+        filled_sizes[row] = order.filled_size;
+        avg_prices[row] = order.avg_fill_price;
+        fees[row] = order.fee;
+        pnls[row] = order.pnl;
+    }
+
+    if (!FlushDictionary()) {
+        return 0;
+    }
+    Commit(state, rows + fresh.size(), fresh.back().first);
+    for (const auto& record : fresh) {
+        state.ids.insert(record.first);
+    }
+    return fresh.size();
+}
+
+size_t TradeStore::AppendBills(const std::vector<OKXRestAPI::Bill>& bills) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return 0;
+    }
+    TableState& state = tables_[static_cast<size_t>(Table::kBills)];
+    auto fresh = NewRecords(bills, state.ids, &BillId);
+    size_t rows = state.header->rows;
+    if (fresh.empty() || !Reserve(state, rows + fresh.size())) {
+        return 0;
+    }
+
+    uint64_t* bill_ids = Column<uint64_t>(Table::kBills, kBillId);
+    uint64_t* times = Column<uint64_t>(Table::kBills, kBillTime);
+    uint32_t* inst_ids = Column<uint32_t>(Table::kBills, kBillInstId);
+    uint32_t* currencies = Column<uint32_t>(Table::kBills, kBillCcy);
+    int32_t* types = Column<int32_t>(Table::kBills, kBillType);
+    uint32_t* sub_types = Column<uint32_t>(Table::kBills, kBillSubType);
+    double* changes = Column<double>(Table::kBills, kBillBalanceChange);
+    double* balances = Column<double>(Table::kBills, kBillBalance);
+    double* fees = Column<double>(Table::kBills, kBillFee);
+
+    for (size_t i = 0; i < fresh.size(); i++) {
+        const OKXRestAPI::Bill& bill = *fresh[i].second;
+        size_t row = rows + i;
+        bill_ids[row] = fresh[i].first;
+        times[row] = bill.timestamp;
+        inst_ids[row] = Intern(bill.inst_id);
+        currencies[row] = Intern(bill.currency);
+        types[row] = bill.bill_type;
+        sub_types[row] = Intern(bill.bill_sub_type);
+        changes[row] = bill.balance_change;
+        balances[row] = bill.balance;
+        fees[row] = bill.fee;
+    }
+
+    if (!FlushDictionary()) {
+        return 0;
+    }
+    Commit(state, rows + fresh.size(), fresh.back().first);
+    for (const auto& record : fresh) {
+        state.ids.insert(record.first);
+    }
+    return fresh.size();
+}
+
+// ==================== Sync ====================
+
+std::string TradeStore::SyncKey(Table table, const OKXRestAPI::HistoryQuery& query) {
+    // No spaces in any field, so the key is one token of sync.marks
+    return std::string(kTables[static_cast<size_t>(table)].name) +
+           ":instType=" + query.inst_type + "&instId=" + query.inst_id + "&state=" + query.state +
+           "&type=" + std::to_string(query.bill_type) + "&begin=" + std::to_string(query.begin_time) +
+           "&end=" + std::to_string(query.end_time);
+}
+
+uint64_t TradeStore::GetMark(const std::string& key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = marks_.find(key);
+    return it != marks_.end() ? it->second : 0;
+}
+
+bool TradeStore::CommitMark(Table table, const std::string& key, uint64_t mark,
+                            const std::vector<uint64_t>& ids) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return false;
+    }
+    const std::unordered_set<uint64_t>& stored = tables_[static_cast<size_t>(table)].ids;
+    for (uint64_t id : ids) {
+        if (id != 0 && stored.count(id) == 0) {
+            std::cerr << "TradeStore: " << kTables[static_cast<size_t>(table)].name
+                      << " append failed; sync mark kept" << std::endl;
+            return false;
+        }
+    }
+    uint64_t& current = marks_[key];
+    if (mark <= current) {
+        return true;
+    }
+    current = mark;
+    return SaveMarks();
+}
+
+bool TradeStore::SyncFills(OKXRestAPI& api, const OKXRestAPI::HistoryQuery& query, size_t* added) {
+    if (added) {
+        *added = 0;
+    }
+    if (!open_) {
+        return false;
+    }
+    std::string key = SyncKey(Table::kFills, query);
+    uint64_t mark = GetMark(key);
+    OKXRestAPI::HistoryQuery walk = query;
+    walk.after.clear();
+    walk.prefetch = false;          // The walk usually stops in the first page
+    std::vector<OKXRestAPI::Fill> fresh;
+    if (!Collect(api.IterateFills(walk), [mark](const OKXRestAPI::Fill& fill) { return FillId(fill) <= mark; },
+                 "fills", fresh)) {
+        return false;
+    }
+
+    size_t count = AppendFills(fresh);
+    if (added) {
+        *added = count;
+    }
+    std::vector<uint64_t> ids;
+    ids.reserve(fresh.size());
+    for (const OKXRestAPI::Fill& fill : fresh) {
+        ids.push_back(FillId(fill));
+    }
+    return CommitMark(Table::kFills, key, ids.empty() ? 0 : *std::max_element(ids.begin(), ids.end()), ids);
+}
+
+bool TradeStore::SyncOrders(OKXRestAPI& api, const OKXRestAPI::HistoryQuery& query, size_t* added) {
+    if (added) {
+        *added = 0;
+    }
+    if (!open_) {
+        return false;
+    }
+    std::string key = SyncKey(Table::kOrders, query);
+    uint64_t newest = GetMark(key);
+    uint64_t lookback = order_lookback_ms_;
+    uint64_t oldest = newest > lookback ? newest - lookback : 0;
+    OKXRestAPI::HistoryQuery walk = query;
+    walk.after.clear();
+    walk.prefetch = false;          // The walk usually stops in the first page
+    std::vector<Order> fresh;
+    if (!Collect(api.IterateOrderHistory(walk), [oldest](const Order& order) { return order.create_time < oldest; },
+                 "orders", fresh)) {
+        return false;
+    }
+
+    size_t count = AppendOrders(fresh);
+    if (added) {
+        *added = count;
+    }
+    std::vector<uint64_t> ids;
+    ids.reserve(fresh.size());
+    for (const Order& order : fresh) {
+        ids.push_back(OrderId(order));
+        newest = std::max<uint64_t>(newest, order.create_time);
+    }
+    return CommitMark(Table::kOrders, key, newest, ids);
+}
+
+bool TradeStore::SyncBills(OKXRestAPI& api, const OKXRestAPI::HistoryQuery& query, size_t* added) {
+    if (added) {
+        *added = 0;
+    }
+    if (!open_) {
+        return false;
+    }
+    std::string key = SyncKey(Table::kBills, query);
+    uint64_t mark = GetMark(key);
+    OKXRestAPI::HistoryQuery walk = query;
+    walk.after.clear();
+    walk.prefetch = false;          // The walk usually stops in the first page
+    std::vector<OKXRestAPI::Bill> fresh;
+    if (!Collect(api.IterateBills(walk), [mark](const OKXRestAPI::Bill& bill) { return BillId(bill) <= mark; },
+                 "bills", fresh)) {
+        return false;
+    }
+
+    size_t count = AppendBills(fresh);
+    if (added) {
+        *added = count;
+    }
+    std::vector<uint64_t> ids;
+    ids.reserve(fresh.size());
+    for (const OKXRestAPI::Bill& bill : fresh) {
+        ids.push_back(BillId(bill));
+    }
+    return CommitMark(Table::kBills, key, ids.empty() ? 0 : *std::max_element(ids.begin(), ids.end()), ids);
+}
+
+// ==================== Reading ====================
+
+size_t TradeStore::Rows(Table table) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return open_ ? static_cast<size_t>(tables_[static_cast<size_t>(table)].header->rows) : 0;
+}
+
+uint64_t TradeStore::LastId(Table table) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return open_ ? tables_[static_cast<size_t>(table)].header->last_id : 0;
+}
+
+void TradeStore::ReadFill(size_t row, OKXRestAPI::Fill& fill) const {
+    fill.bill_id = IdString(Column<uint64_t>(Table::kFills, kFillBillId)[row]);
+    fill.trade_id = IdString(Column<uint64_t>(Table::kFills, kFillTradeId)[row]);
+    fill.order_id = IdString(Column<uint64_t>(Table::kFills, kFillOrderId)[row]);
+    fill.fill_time = Column<uint64_t>(Table::kFills, kFillTime)[row];
+    fill.inst_id = Lookup(Column<uint32_t>(Table::kFills, kFillInstId)[row]);
+    fill.fee_currency = Lookup(Column<uint32_t>(Table::kFills, kFillFeeCcy)[row]);
+    fill.side = Lookup(Column<uint32_t>(Table::kFills, kFillSide)[row]);
+    fill.exec_type = Lookup(Column<uint32_t>(Table::kFills, kFillExecType)[row]);
+    fill.fill_price = Column<double>(Table::kFills, kFillPrice)[row];
+    fill.fill_size = Column<double>(Table::kFills, kFillSize)[row];
+    fill.fee = Column<double>(Table::kFills, kFillFee)[row];
+    fill.fill_id.clear();
+}
+
+void TradeStore::ReadOrder(size_t row, Order& order) const {
+    order.order_id = IdString(Column<uint64_t>(Table::kOrders, kOrderId)[row]);
+    order.create_time = Column<uint64_t>(Table::kOrders, kOrderCreateTime)[row];
+    order.update_time = Column<uint64_t>(Table::kOrders, kOrderUpdateTime)[row];
+    order.inst_id = Lookup(Column<uint32_t>(Table::kOrders, kOrderInstId)[row]);
+    order.symbol = order.inst_id;
+    order.platform = "OKX";
+    order.side = Lookup(Column<uint32_t>(Table::kOrders, kOrderSide)[row]);
+    order.order_type = Lookup(Column<uint32_t>(Table::kOrders, kOrderType)[row]);
+    order.state = Lookup(Column<uint32_t>(Table::kOrders, kOrderState)[row]);
+    order.position_side = Lookup(Column<uint32_t>(Table::kOrders, kOrderPositionSide)[row]);
+    order.price = Column<double>(Table::kOrders, kOrderPrice)[row];
+    order.size = Column<double>(Table::kOrders, kOrderSize)[row];
+    order.filled_size = Column<double>(Table::kOrders, kOrderFilledSize)[row];
+    order.avg_fill_price = Column<double>(Table::kOrders, kOrderAvgPrice)[row];
+    order.avg_price = order.avg_fill_price;
+    order.fee = Column<double>(Table::kOrders, kOrderFee)[row];
+    order.pnl = Column<double>(Table::kOrders, kOrderPnl)[row];
+}
+
+void TradeStore::ReadBill(size_t row, OKXRestAPI::Bill& bill) const {
+    bill.bill_id = IdString(Column<uint64_t>(Table::kBills, kBillId)[row]);
+    bill.timestamp = Column<uint64_t>(Table::kBills, kBillTime)[row];
+    bill.inst_id = Lookup(Column<uint32_t>(Table::kBills, kBillInstId)[row]);
+    bill.currency = Lookup(Column<uint32_t>(Table::kBills, kBillCcy)[row]);
+    bill.bill_type = Column<int32_t>(Table::kBills, kBillType)[row];
+    bill.bill_sub_type = Lookup(Column<uint32_t>(Table::kBills, kBillSubType)[row]);
+    bill.balance_change = Column<double>(Table::kBills, kBillBalanceChange)[row];
+    bill.balance = Column<double>(Table::kBills, kBillBalance)[row];
+    bill.fee = Column<double>(Table::kBills, kBillFee)[row];
+    bill.notes.clear();
+}
+
+bool TradeStore::GetFill(size_t row, OKXRestAPI::Fill& fill) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_ || row >= tables_[static_cast<size_t>(Table::kFills)].header->rows) {
+        return false;
+    }
+    ReadFill(row, fill);
+    return true;
+}
+
+bool TradeStore::GetOrder(size_t row, Order& order) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_ || row >= tables_[static_cast<size_t>(Table::kOrders)].header->rows) {
+        return false;
+    }
+    ReadOrder(row, order);
+    return true;
+}
+
+bool TradeStore::GetBill(size_t row, OKXRestAPI::Bill& bill) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_ || row >= tables_[static_cast<size_t>(Table::kBills)].header->rows) {
+        return false;
+    }
+    ReadBill(row, bill);
+    return true;
+}
+
+size_t TradeStore::ScanFills(const Filter& filter,
+                             const std::function<void(const OKXRestAPI::Fill&)>& visit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return 0;
+    }
+    CompiledFilter compiled = Compile(filter);
+    if (compiled.empty) {
+        return 0;
+    }
+
+    size_t rows = tables_[static_cast<size_t>(Table::kFills)].header->rows;
+    const uint64_t* times = Column<uint64_t>(Table::kFills, kFillTime);
+    const uint32_t* inst_ids = Column<uint32_t>(Table::kFills, kFillInstId);
+    const uint32_t* fee_ccys = Column<uint32_t>(Table::kFills, kFillFeeCcy);
+
+    size_t count = 0;
+    OKXRestAPI::Fill fill;
+    for (size_t row = 0; row < rows; row++) {
+        if (Matches(compiled, inst_ids[row], fee_ccys[row], times[row])) {
+            ReadFill(row, fill);
+            visit(fill);
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t TradeStore::ScanOrders(const Filter& filter, const std::function<void(const Order&)>& visit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return 0;
+    }
+    CompiledFilter compiled = Compile(filter);
+    compiled.by_currency = false;       // Orders carry no currency column
+    compiled.empty = compiled.by_inst && string_ids_.find(filter.inst_id) == string_ids_.end();
+    if (compiled.empty) {
+        return 0;
+    }
+
+    size_t rows = tables_[static_cast<size_t>(Table::kOrders)].header->rows;
+    const uint64_t* times = Column<uint64_t>(Table::kOrders, kOrderCreateTime);
+    const uint32_t* inst_ids = Column<uint32_t>(Table::kOrders, kOrderInstId);
+
+    size_t count = 0;
+    Order order;
+    for (size_t row = 0; row < rows; row++) {
+        if (Matches(compiled, inst_ids[row], 0, times[row])) {
+            ReadOrder(row, order);
+            visit(order);
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t TradeStore::ScanBills(const Filter& filter,
+                             const std::function<void(const OKXRestAPI::Bill&)>& visit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return 0;
+    }
+    CompiledFilter compiled = Compile(filter);
+    if (compiled.empty) {
+        return 0;
+    }
+
+    size_t rows = tables_[static_cast<size_t>(Table::kBills)].header->rows;
+    const uint64_t* times = Column<uint64_t>(Table::kBills, kBillTime);
+    const uint32_t* inst_ids = Column<uint32_t>(Table::kBills, kBillInstId);
+    const uint32_t* currencies = Column<uint32_t>(Table::kBills, kBillCcy);
+
+    size_t count = 0;
+    OKXRestAPI::Bill bill;
+    for (size_t row = 0; row < rows; row++) {
+        if (Matches(compiled, inst_ids[row], currencies[row], times[row])) {
+            ReadBill(row, bill);
+            visit(bill);
+            count++;
+        }
+    }
+    return count;
+}
+
+// ==================== Aggregates ====================
+
+std::vector<TradeStore::DailyFees> TradeStore::FeesByDay(const Filter& filter) const {
+    std::vector<DailyFees> result;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return result;
+    }
+    CompiledFilter compiled = Compile(filter);
+    if (compiled.empty) {
+        return result;
+    }
+
+    // Reads five columns; strings stay dictionary ids until the end
+    size_t rows = tables_[static_cast<size_t>(Table::kFills)].header->rows;
+    const uint64_t* times = Column<uint64_t>(Table::kFills, kFillTime);
+    const uint32_t* inst_ids = Column<uint32_t>(Table::kFills, kFillInstId);
+    const uint32_t* fee_ccys = Column<uint32_t>(Table::kFills, kFillFeeCcy);
+    const double* prices = Column<double>(Table::kFills, kFillPrice);
+    const double* sizes = Column<double>(Table::kFills, kFillSize);
+    const double* fees = Column<double>(Table::kFills, kFillFee);
+
+    std::map<std::tuple<uint64_t, uint32_t, uint32_t>, DailyFees> groups;
+    for (size_t row = 0; row < rows; row++) {
+        if (!Matches(compiled, inst_ids[row], fee_ccys[row], times[row])) {
+            continue;
+        }
+        uint64_t day = times[row] / kDayMs * kDayMs;
+        DailyFees& group = groups[std::make_tuple(day, inst_ids[row], fee_ccys[row])];
+        group.fills++;
+        group.volume += sizes[row];
+        group.notional += prices[row] * sizes[row];
+        group.fee += fees[row];
+    }
+
+    result.reserve(groups.size());
+    for (auto& entry : groups) {
+        DailyFees group = entry.second;
+        group.day = std::get<0>(entry.first);
+        group.inst_id = Lookup(std::get<1>(entry.first));
+        group.currency = Lookup(std::get<2>(entry.first));
+        result.push_back(std::move(group));
+    }
+    std::sort(result.begin(), result.end(), [](const DailyFees& a, const DailyFees& b) {
+        return std::tie(a.day, a.inst_id, a.currency) < std::tie(b.day, b.inst_id, b.currency);
+    });
+    return result;
+}
+
+std::vector<TradeStore::DailyBills> TradeStore::BillsByDay(const Filter& filter) const {
+    std::vector<DailyBills> result;
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!open_) {
+        return result;
+    }
+    CompiledFilter compiled = Compile(filter);
+    if (compiled.empty) {
+        return result;
+    }
+
+    size_t rows = tables_[static_cast<size_t>(Table::kBills)].header->rows;
+    const uint64_t* times = Column<uint64_t>(Table::kBills, kBillTime);
+    const uint32_t* inst_ids = Column<uint32_t>(Table::kBills, kBillInstId);
+    const uint32_t* currencies = Column<uint32_t>(Table::kBills, kBillCcy);
+    const int32_t* types = Column<int32_t>(Table::kBills, kBillType);
+    const double* changes = Column<double>(Table::kBills, kBillBalanceChange);
+    const double* fees = Column<double>(Table::kBills, kBillFee);
+
+    std::map<std::tuple<uint64_t, uint32_t, int32_t>, DailyBills> groups;
+    for (size_t row = 0; row < rows; row++) {
+        if (!Matches(compiled, inst_ids[row], currencies[row], times[row])) {
+            continue;
+        }
+        uint64_t day = times[row] / kDayMs * kDayMs;
+        DailyBills& group = groups[std::make_tuple(day, currencies[row], types[row])];
+        group.bills++;
+        group.balance_change += changes[row];
+        group.fee += fees[row];
+    }
+
+    result.reserve(groups.size());
+    for (auto& entry : groups) {
+        DailyBills group = entry.second;
+        group.day = std::get<0>(entry.first);
+        group.currency = Lookup(std::get<1>(entry.first));
+        group.bill_type = std::get<2>(entry.first);
+        result.push_back(std::move(group));
+    }
+    std::sort(result.begin(), result.end(), [](const DailyBills& a, const DailyBills& b) {
+        return std::tie(a.day, a.currency, a.bill_type) < std::tie(b.day, b.currency, b.bill_type);
+    });
+    return result;
+}
@@ -0,0 +1,275 @@
+// Microbenchmark: json/map based order request building vs the
+// allocation-free OKXRequestBuffer path, plus a full PlaceOrder round
+// trip against a local server. Heap allocations are counted per thread
+// by replacing the global operator new.
+
+#include "okx_rest_api.h"
+#include "okx_request_builder.h"
+#include "okx_signer.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+namespace {
+    thread_local uint64_t g_allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    g_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace std;
+
+void PrintResult(const string& name, double ns_per_op, double allocs_per_op) {
+    cout << "  " << setw(28) << left << name
+         << fixed << setprecision(0) << setw(10) << right << ns_per_op << " ns/op   "
+         << setprecision(2) << allocs_per_op << " allocs/op\n";
+}
+
+// What OKXRestAPI did for every order before the hot path: json body,
+// dump, std::string timestamp/signature, header map, curl_slist per header
+size_t LegacyBuild(const Order& order, const OKXSigner& signer) {
+    json body = {
+        {"instId", order.inst_id},
+        {"tdMode", order.trade_mode},
+        {"side", order.side},
+        {"ordType", order.order_type},
+        {"sz", std::to_string(order.size)}
+    };
+    if (order.price > 0) body["px"] = std::to_string(order.price);
+    if (!order.client_order_id.empty()) body["clOrdId"] = order.client_order_id;
+    std::string body_str = body.dump();
+
+    std::string timestamp = OKXSigner::GetTimestamp();
+    std::string signature = signer.Sign(timestamp, "POST", "/api/v5/trade/order", body_str);
+
+    std::map<std::string, std::string> headers = {
+        {"OK-ACCESS-KEY", signer.GetAPIKey()},
+        {"OK-ACCESS-SIGN", signature},
+        {"OK-ACCESS-TIMESTAMP", timestamp},
+        {"OK-ACCESS-PASSPHRASE", signer.GetPassphrase()},
+        {"Content-Type", "application/json"},
+        {"Accept", "application/json"}
+    };
+
+    struct curl_slist* chunk = nullptr;
+    for (const auto& [key, value] : headers) {
+        std::string header = key + ": " + value;
+        chunk = curl_slist_append(chunk, header.c_str());
+    }
+    size_t n = body_str.size();
+    curl_slist_free_all(chunk);
+    return n;
+}
+
+size_t HotBuild(const Order& order, const OKXSigner& signer, OKXRequestBuffer& buffer) {
+    OKXRequestBuilder::BuildPlaceOrder(order, buffer);
+
+    size_t ts_len = OKXSigner::FormatTimestamp(buffer.timestamp);
+    FixedWriter ts(buffer.timestamp_header, sizeof(buffer.timestamp_header));
+    ts.Append("OK-ACCESS-TIMESTAMP: ");
+    ts.Append(std::string_view(buffer.timestamp, ts_len));
+    ts.Terminate();
+
+    char signature[OKXSigner::kSignatureLength + 1];
+    size_t sig_len = signer.SignTo(std::string_view(buffer.timestamp, ts_len), "POST",
+                                   "/api/v5/trade/order",
+                                   std::string_view(buffer.body, buffer.body_length),
+                                   signature);
+    FixedWriter sign(buffer.sign_header, sizeof(buffer.sign_header));
+    sign.Append("OK-ACCESS-SIGN: ");
+    sign.Append(std::string_view(signature, sig_len));
+    sign.Terminate();
+    return buffer.body_length;
+}
+
+size_t TemplateBuild(const OKXOrderTemplate& order_template, Price price, std::string_view client_order_id,
+                     const OKXSigner& signer, OKXRequestBuffer& buffer) {
+    order_template.Render(price, client_order_id, buffer);
+
+    size_t ts_len = OKXSigner::FormatTimestamp(buffer.timestamp);
+    FixedWriter ts(buffer.timestamp_header, sizeof(buffer.timestamp_header));
+    ts.Append("OK-ACCESS-TIMESTAMP: ");
+    ts.Append(std::string_view(buffer.timestamp, ts_len));
+    ts.Terminate();
+
+    char signature[OKXSigner::kSignatureLength + 1];
+    size_t sig_len = signer.SignTo(std::string_view(buffer.timestamp, ts_len), "POST",
+                                   "/api/v5/trade/order",
+                                   std::string_view(buffer.body, buffer.body_length),
+                                   signature);
+    FixedWriter sign(buffer.sign_header, sizeof(buffer.sign_header));
+    sign.Append("OK-ACCESS-SIGN: ");
+    sign.Append(std::string_view(signature, sig_len));
+    sign.Terminate();
+    return buffer.body_length;
+}
+
+string Body(const OKXRequestBuffer& buffer) {
+    return string(buffer.body, buffer.body_length);
+}
+
+template <typename Fn>
+void Measure(const string& name, int iterations, Fn&& fn, double& ns_per_op, double& allocs_per_op) {
+    for (int i = 0; i < iterations / 10; i++) fn();  // Warm-up
+
+    uint64_t allocs_before = g_allocations;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+    ns_per_op = static_cast<double>(ns) / iterations;
+    allocs_per_op = static_cast<double>(g_allocations - allocs_before) / iterations;
+    PrintResult(name, ns_per_op, allocs_per_op);
+}
+
+int main() {
+    OKXSigner signer("cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8",
+                     "4DD3E6E14B69380235D2D585DDE5B5B5", "Abc@123456");
+
+    Order order;
+    order.inst_id = "XAUT-USDT-SWAP";
+    order.trade_mode = "cross";
+    order.side = "buy";
+    order.order_type = "limit";
+    order.size = 1;
+    order.price = 2350.5;
+    order.client_order_id = "hedge000123";
+
+    PrintHeader("Body equivalence");
+
+    OKXRequestBuffer buffer;
+    OKXRequestBuilder::BuildPlaceOrder(order, buffer);
+    json expected = {
+        {"instId", order.inst_id}, {"tdMode", order.trade_mode}, {"side", order.side},
+        {"ordType", order.order_type}, {"sz", std::to_string(order.size)},
+        {"px", std::to_string(order.price)}, {"clOrdId", order.client_order_id}
+    };
+    cout << "  " << string(buffer.body, buffer.body_length) << "\n";
+    Check(string(buffer.body, buffer.body_length) == expected.dump(),
+          "Builder output is byte-identical to json::dump()");
+
+    PrintHeader("Request build + sign (no network)");
+
+    const int iterations = 100000;
+    double legacy_ns, legacy_allocs, hot_ns, hot_allocs;
+    Measure("json + map + slist", iterations, [&] { LegacyBuild(order, signer); },
+            legacy_ns, legacy_allocs);
+    Measure("OKXRequestBuffer", iterations, [&] { HotBuild(order, signer, buffer); },
+            hot_ns, hot_allocs);
+    cout << "  speedup: " << setprecision(1) << legacy_ns / hot_ns << "x\n";
+    Check(hot_allocs == 0, "Hot path build+sign does no heap allocation");
+
+    PrintHeader("Order templates");
+
+    OKXOrderTemplate order_template;
+    OKXRequestBuffer expected_buffer;
+    Check(order_template.Arm(order) && order_template.HasPrice() &&
+          order_template.Render(order.price, order.client_order_id, buffer) &&
+          OKXRequestBuilder::BuildPlaceOrder(order, expected_buffer) && Body(buffer) == Body(expected_buffer),
+          "Rendered body identical to BuildPlaceOrder");
+
+    InstrumentScale scale;
+    FixedScale::FromStep("0.1", scale.price);
+    FixedScale::FromStep("1", scale.size);
+    Order scaled = order;
+    scaled.position_side = "long";
+    scaled.tp_trigger_price = 2400;
+    scaled.tp_order_price = -1;
+    scaled.price = 2351.3;
+    scaled.client_order_id = "hedge42";
+    OKXOrderTemplate scaled_template;
+    Check(scaled_template.Arm(scaled, &scale) &&
+          scaled_template.Render(2351.3, "hedge42", buffer) &&
+          OKXRequestBuilder::BuildPlaceOrder(scaled, expected_buffer, &scale) &&
+          Body(buffer) == Body(expected_buffer) && Body(buffer).find("\"px\":\"2351.3\"") != string::npos,
+          "With a scale: exact px, posSide and attached TP kept");
+    Check(scaled_template.RenderTicks(23514, "", buffer) &&
+          Body(buffer).find("\"px\":\"2351.4\"") != string::npos &&
+          Body(buffer).find("clOrdId") == string::npos, "Price in ticks, clOrdId left out when empty");
+
+    Order market = order;
+    market.order_type = "market";
+    market.price = 0;
+    market.client_order_id = "m1";
+    OKXOrderTemplate market_template;
+    Check(market_template.Arm(market) && !market_template.HasPrice() &&
+          market_template.Render(0, "m1", buffer) && OKXRequestBuilder::BuildPlaceOrder(market, expected_buffer) &&
+          Body(buffer) == Body(expected_buffer), "Market template has no px");
+
+    Order bad = order;
+    bad.side = "long";
+    OKXOrderTemplate unarmed;
+    Check(!unarmed.Arm(bad) && !unarmed.Render(2350, "", buffer), "Bad side rejected when arming");
+    bad = order;
+    bad.size = 0.2;
+    Check(!unarmed.Arm(bad, &scale), "Size below one lot rejected when arming");
+    Check(!order_template.Render(0, "x", buffer) && !order_template.Render(2350, "has-dash", buffer) &&
+          !order_template.Render(2350, string(33, 'a'), buffer) && !order_template.RenderTicks(1, "", buffer),
+          "Bad price / clOrdId rejected at fire time");
+
+    PrintHeader("Signal to signed body");
+
+    double build_ns, build_allocs, render_ns, render_allocs, armed_ns, armed_allocs;
+    Measure("BuildPlaceOrder", iterations, [&] { OKXRequestBuilder::BuildPlaceOrder(order, buffer); },
+            build_ns, build_allocs);
+    Measure("OKXOrderTemplate::Render", iterations,
+            [&] { order_template.Render(2350.5, "hedge000123", buffer); }, render_ns, render_allocs);
+    Measure("template + sign", iterations,
+            [&] { TemplateBuild(order_template, 2350.5, "hedge000123", signer, buffer); }, armed_ns, armed_allocs);
+    cout << "  body: " << setprecision(1) << build_ns / render_ns << "x faster; signal to signed body "
+         << setprecision(2) << armed_ns / 1000 << " us\n";
+    Check(render_ns < build_ns && render_allocs == 0 && armed_allocs == 0,
+          "Template render beats building from Order, no allocation");
+    Check(armed_ns < 10000, "Signal to signed body in single-digit microseconds");
+
+    PrintHeader("PlaceOrder round trip (local server)");
+
+    string last_body;
+    LocalHttpServer server([&last_body](const LocalHttpServer::Request& request) {
+        last_body = request.body;
+        LocalHttpServer::Reply reply;
+        reply.body = "{\"code\":\"0\",\"msg\":\"\",\"data\":[{\"clOrdId\":\"hedge000123\","
+                     "\"ordId\":\"312269865356374016\",\"sCode\":\"0\",\"sMsg\":\"\"}]}";
+        return reply;
+    });
+    server.Start();
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig config;
+    config.base_url = server.BaseUrl();
+    config.api_key = "cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8";
+    config.secret_key = "4DD3E6E14B69380235D2D585DDE5B5B5";
+    config.passphrase = "Abc@123456";
+    config.rate_limit_max_wait_ms = 0;
+    api.Initialize(config);
+
+    string order_id;
+    double rt_ns, rt_allocs;
+    Measure("PlaceOrder", 20, [&] { order_id = api.PlaceOrder(order); }, rt_ns, rt_allocs);
+    Check(order_id == "312269865356374016", "Order ID parsed from response");
+    // The only allocation left is the returned std::string (ordId > SSO size)
+    Check(rt_allocs <= 1.0, "Steady-state PlaceOrder allocates only the returned order ID");
+
+    OKXOrderTemplate api_template;
+    Check(api.ArmOrderTemplate(order, api_template), "Template armed through OKXRestAPI");
+    Measure("PlaceOrder(template)", 20, [&] { order_id = api.PlaceOrder(api_template, 2350.5, "hedge000123"); },
+            rt_ns, rt_allocs);
+    OKXRequestBuilder::BuildPlaceOrder(order, expected_buffer);
+    Check(order_id == "312269865356374016" && last_body == Body(expected_buffer) && rt_allocs <= 1.0,
+          "Template order sent with the same body");
+    Check(api.PlaceOrder(api_template, -1, "hedge000123").empty(), "Invalid fire-time price not sent");
+
+    server.Stop();
+
+    return TestSummary();
+}
@@ -0,0 +1,180 @@
+// Microbenchmark and known-answer checks for OKXSigner: the old signing
+// path (concatenate, one-shot HMAC(), BIO base64 chain) against the
+// cached key schedule with incremental feed and table base64. OpenSSL's
+// own allocations are counted through CRYPTO_set_mem_functions.
+
+#include "okx_signer.h"
+#include "test_util.h"
+#include <openssl/bio.h>
+#include <openssl/buffer.h>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace {
+    uint64_t g_allocations = 0;
+
+    void* CountingMalloc(size_t size, const char*, int) {
+        g_allocations++;
+        return std::malloc(size);
+    }
+
+    void* CountingRealloc(void* p, size_t size, const char*, int) {
+        g_allocations++;
+        return std::realloc(p, size);
+    }
+
+    void CountingFree(void* p, const char*, int) {
+        std::free(p);
+    }
+}
+
+using namespace std;
+
+// What OKXSigner::Sign did before the key schedule was cached
+string LegacySign(const string& secret, const string& timestamp, const string& method,
+                  const string& path, const string& body) {
+    string prehash = timestamp + method + path + body;
+    unsigned char* digest = HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()),
+                                 reinterpret_cast<const unsigned char*>(prehash.data()), prehash.size(),
+                                 nullptr, nullptr);
+
+    BIO* b64 = BIO_new(BIO_f_base64());
+    BIO* bio = BIO_push(b64, BIO_new(BIO_s_mem()));
+    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
+    BIO_write(bio, digest, 32);
+    BIO_flush(bio);
+    BUF_MEM* buffer;
+    BIO_get_mem_ptr(bio, &buffer);
+    string result(buffer->data, buffer->length);
+    BIO_free_all(bio);
+    return result;
+}
+
+// What OKXSigner::GetTimestamp did before: gmtime + put_time per call
+string LegacyTimestamp(int64_t epoch_ms) {
+    time_t timer = static_cast<time_t>(epoch_ms / 1000);
+    tm tm;
+    gmtime_r(&timer, &tm);
+    ostringstream oss;
+    oss << put_time(&tm, "%Y-%m-%dT%H:%M:%S");
+    oss << '.' << setfill('0') << setw(3) << epoch_ms % 1000 << 'Z';
+    return oss.str();
+}
+
+template <typename Fn>
+void Measure(const string& name, int iterations, Fn&& fn, double& ns_per_op, double& allocs_per_op) {
+    fn();   // Warm up
+    uint64_t allocs_before = g_allocations;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) fn();
+    ns_per_op = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+    allocs_per_op = static_cast<double>(g_allocations - allocs_before) / iterations;
+    cout << "  " << setw(28) << left << name << fixed << setprecision(0) << setw(8) << right
+         << ns_per_op << " ns/op   " << setprecision(2) << allocs_per_op << " allocs\n";
+}
+
+int main() {
+    // Must precede any OpenSSL allocation
+    bool counting = CRYPTO_set_mem_functions(CountingMalloc, CountingRealloc, CountingFree) == 1;
+
+    PrintHeader("Known answers");
+
+    // RFC 4231 test case 2 ("Jefe") and 6 (131-byte key, hashed first)
+    char out[OKXSigner::kSignatureLength + 1];
+    OKXSigner jefe("", "Jefe", "");
+    jefe.SignTo("what do ya want ", "for nothing?", "", "", out);
+    Check(string(out) == "W9zBRr9gdU5qBCQmCJV1x1oAPwidJzmDnexYuWTsOEM=", "RFC 4231 case 2");
+
+    OKXSigner long_key("", string(131, '\xaa'), "");
+    long_key.SignTo("Test Using Larger Than Block-Size Key - Hash Key First", "", "", "", out);
+    Check(string(out) == "YOQxWR7gtn8Niiaqy/W3f44LxiE3KMUUBUYEDw7jf1Q=", "RFC 4231 case 6 (long key)");
+
+    const string secret = "4DD3E6E14B69380235D2D585DDE5B5B5";
+    OKXSigner signer("cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8", secret, "Abc@123456");
+
+    mt19937 random(7);
+    bool all_match = true;
+    for (int i = 0; i < 200; i++) {
+        string body(random() % 300, 'x');
+        for (auto& c : body) c = static_cast<char>('a' + random() % 26);
+        string path = "/api/v5/trade/order?n=" + to_string(i);
+        all_match = all_match && signer.Sign("2024-01-01T00:00:00.000Z", "POST", path, body) ==
+                                     LegacySign(secret, "2024-01-01T00:00:00.000Z", "POST", path, body);
+    }
+    Check(all_match, "Matches one-shot HMAC + BIO base64 for 200 random requests");
+
+    for (size_t n = 0; n <= 6; n++) {
+        unsigned char data[6] = {0xfb, 0xff, 0x00, 0x10, 0x83, 0x7e};
+        char mine[16], reference[16];
+        OKXSigner::Base64Encode(data, n, mine);
+        EVP_EncodeBlock(reinterpret_cast<unsigned char*>(reference), data, static_cast<int>(n));
+        if (strcmp(mine, reference) != 0) all_match = false;
+    }
+    Check(all_match, "Base64 padding for 0..6 byte inputs");
+
+    PrintHeader("Benchmark: order signature");
+
+    const string timestamp = "2024-01-01T00:00:00.000Z";
+    const string path = "/api/v5/trade/order";
+    const string body = R"({"instId":"XAUT-USDT-SWAP","tdMode":"cross","side":"buy","ordType":"limit",)"
+                        R"("sz":"1","px":"2350.4","clOrdId":"hedge000123"})";
+    const int iterations = 100000;
+    double legacy_ns, legacy_allocs, cached_ns, cached_allocs;
+    size_t sink = 0;
+
+    Measure("concat + HMAC() + BIO", iterations / 10,
+            [&] { sink += LegacySign(secret, timestamp, "POST", path, body).size(); }, legacy_ns, legacy_allocs);
+    Measure("cached key + table base64", iterations,
+            [&] { sink += signer.SignTo(timestamp, "POST", path, body, out); }, cached_ns, cached_allocs);
+    cout << "  speedup: " << setprecision(1) << legacy_ns / cached_ns << "x\n";
+
+    Check(sink > 0 && cached_ns < legacy_ns, "Cached key schedule is faster");
+    if (counting) {
+        Check(cached_allocs == 0, "SignTo does no OpenSSL heap allocation");
+    }
+
+    PrintHeader("Timestamps");
+
+    char stamp[OKXSigner::kTimestampLength + 1];
+    OKXSigner::FormatTimestamp(1700000000123LL, stamp);
+    Check(string(stamp) == "2023-11-14T22:13:20.123Z", "Known epoch formatted");
+    OKXSigner::FormatTimestamp(1700000000999LL, stamp);
+    bool same_second = string(stamp) == "2023-11-14T22:13:20.999Z";
+    OKXSigner::FormatTimestamp(1700000001000LL, stamp);
+    Check(same_second && string(stamp) == "2023-11-14T22:13:21.000Z", "Cached prefix rolls over with the second");
+
+    bool stamps_match = true;
+    int64_t t = 1577836799000LL;   // 2019-12-31T23:59:59 (year rollover)
+    for (int i = 0; i < 5000; i++, t += static_cast<int64_t>(random() % 2000)) {
+        OKXSigner::FormatTimestamp(t, stamp);
+        stamps_match = stamps_match && string(stamp) == LegacyTimestamp(t);
+    }
+    Check(stamps_match, "Matches gmtime + put_time over 5000 increasing times");
+
+    int64_t local = OKXSigner::NowMs();
+    OKXSigner::SetClockOffsetMs(-1500);
+    int64_t shifted = OKXSigner::NowMs();
+    OKXSigner::SetClockOffsetMs(0);
+    Check(shifted - local <= -1400 && shifted - local >= -1600, "Server clock offset applied");
+
+    double old_ns, old_allocs, new_ns, new_allocs;
+    int64_t now_ms = OKXSigner::NowMs();
+    Measure("gmtime + ostringstream", iterations / 10,
+            [&] { sink += LegacyTimestamp(now_ms++ / 4).size(); }, old_ns, old_allocs);
+    Measure("FormatTimestamp (cached)", iterations,
+            [&] { sink += OKXSigner::FormatTimestamp(now_ms++ / 4, stamp); }, new_ns, new_allocs);
+    Measure("FormatTimestamp (clock)", iterations,
+            [&] { sink += OKXSigner::FormatTimestamp(stamp); }, new_ns, new_allocs);
+    Check(new_ns < old_ns, "Cached formatter is faster than gmtime + put_time");
+
+    return TestSummary();
+}
@@ -0,0 +1,251 @@
+// SpreadEngine: ladder / take-profit decisions on hand-picked quotes, then
+// a synthetic OKX + MT5 quote session (seeded, so every run sees the same
+// ticks) timed per tick. Heap
+// allocations are counted per thread by replacing the global operator new.
+
+#include "spread_engine.h"
+#include "latency_histogram.h"
+#include "test_util.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+namespace {
+    thread_local uint64_t g_allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+    g_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace std;
+
+using Direction = SpreadEngine::Direction;
+using Action = SpreadEngine::Action;
+
+bool Near(double a, double b) {
+    return fabs(a - b) < 1e-9;
+}
+
+StrategyParams MakeParams() {
+    StrategyParams params;
+    params.first_order = 10.0;
+    params.next_order = 5.0;
+    params.max_orders = 3;
+    params.take_profit = 5.0;
+    params.okx_fee_rate = 0.0005;
+    params.mt5_fee_rate = 0.0002;
+    params.okx_order_size = 1.0;
+    params.mt5_order_size = 1.0;
+    return params;
+}
+
+// A synthetic quote session shaped like what the bridge captures:
+// XAUT-USDT-SWAP and XAUUSD interleaved, a random-walk mid and a
+// mean-reverting basis that now and then stretches far enough to walk
+// the ladder
+vector<TickPOD> SyntheticSession(size_t count, SymbolTable::Id okx_symbol, SymbolTable::Id mt5_symbol) {
+    mt19937_64 random(2024);
+    normal_distribution<double> mid_step(0.0, 0.05);
+    normal_distribution<double> basis_step(0.0, 0.3);
+    bernoulli_distribution okx_next(0.55);
+
+    vector<TickPOD> ticks(count);
+    double mid = 2350.0;
+    double basis = 0.0;
+    Timestamp timestamp = 1700000000000ULL;
+    for (size_t i = 0; i < count; i++) {
+        mid += mid_step(random);
+        basis += -0.001 * basis + basis_step(random);
+        timestamp += 1 + random() % 100;
+
+        TickPOD& tick = ticks[i];
+        tick = TickPOD{};
+        tick.timestamp = timestamp;
+        if (okx_next(random)) {
+            tick.symbol_id = okx_symbol;
+            tick.platform = TickPOD::Platform::kOKX;
+            tick.bid = mid + basis / 2 - 0.1;
+            tick.ask = mid + basis / 2 + 0.1;
+        } else {
+            tick.symbol_id = mt5_symbol;
+            tick.platform = TickPOD::Platform::kMT5;
+            tick.bid = mid - basis / 2 - 0.15;
+            tick.ask = mid - basis / 2 + 0.15;
+        }
+        tick.last = (tick.bid + tick.ask) / 2;
+    }
+    return ticks;
+}
+
+int main() {
+    SymbolTable::Id okx_symbol = SymbolTable::Global().Intern("XAUT-USDT-SWAP");
+    SymbolTable::Id mt5_symbol = SymbolTable::Global().Intern("XAUUSD");
+    SpreadEngine::Decision decisions[SpreadEngine::kMaxDecisions];
+
+    PrintHeader("Ladder: OKX short / MT5 long");
+
+    SpreadEngine engine(MakeParams(), okx_symbol, mt5_symbol);
+    Check(engine.OnOkxQuote(2013.0, 2013.2, 1000, decisions, 8) == 0 && engine.NetSpread(Direction::kShortOkx) == 0,
+          "Nothing until both legs are quoted");
+
+    size_t n = engine.OnMt5Quote(1999.9, 2000.1, 1001, decisions, 8);
+    double expected_net = 2013.0 - 2000.1 - 2 * (2013.0 * 0.0005 + 2000.1 * 0.0002);
+    Check(Near(engine.NetSpread(Direction::kShortOkx), expected_net), "Net spread: okx.bid - mt5.ask less round-trip fees");
+    Check(n == 1 && decisions[0].action == Action::kOpen && decisions[0].direction == Direction::kShortOkx &&
+          decisions[0].level == 0 && decisions[0].okx_price == 2013.0 && decisions[0].mt5_price == 2000.1 &&
+          decisions[0].timestamp == 1001, "First level opens above first_order: sell OKX bid, buy MT5 ask");
+    Check(engine.OnMt5Quote(1999.9, 2000.1, 1002, decisions, 8) == 0 &&
+          engine.NextThreshold(Direction::kShortOkx) == 15.0, "Same spread does not add");
+
+    n = engine.OnOkxQuote(2018.5, 2018.7, 1003, decisions, 8);
+    Check(n == 1 && decisions[0].level == 1, "Second level above first_order + next_order");
+    n = engine.OnOkxQuote(2040.0, 2040.2, 1004, decisions, 8);
+    Check(n == 1 && decisions[0].level == 2, "A jump past several levels opens one per quote");
+    Check(engine.OnOkxQuote(2040.0, 2040.2, 1005, decisions, 8) == 0 && engine.OpenCount(Direction::kShortOkx) == 3 &&
+          engine.NextThreshold(Direction::kShortOkx) == 0, "max_orders caps the ladder");
+    Check(engine.OpenCount(Direction::kShortMt5) == 0, "Other direction untouched");
+
+    PrintHeader("Take profit");
+
+    // Only the deepest group is in profit: 2040 - 2020.2 - 0.2 - fees
+    n = engine.OnOkxQuote(2020.0, 2020.2, 1006, decisions, 8);
+    double expected_pnl = (2040.0 - 2020.2) + (1999.9 - 2000.1) - (2040.0 * 0.0005 + 2000.1 * 0.0002) -
+                          (2020.2 * 0.0005 + 1999.9 * 0.0002);
+    Check(n == 1 && decisions[0].action == Action::kClose && decisions[0].level == 2 &&
+          decisions[0].okx_price == 2020.2 && decisions[0].mt5_price == 1999.9 && Near(decisions[0].pnl, expected_pnl),
+          "Group closed on PnL after fees: buy OKX ask, sell MT5 bid");
+    Check(engine.OpenCount(Direction::kShortOkx) == 2 && engine.NextThreshold(Direction::kShortOkx) == 20.0,
+          "Closing frees the level");
+
+    n = engine.OnOkxQuote(2000.0, 2000.2, 1007, decisions, 8);
+    Check(n == 2 && decisions[0].action == Action::kClose && decisions[1].action == Action::kClose &&
+          engine.OpenCount(Direction::kShortOkx) == 0, "Converged spread closes the rest");
+    SpreadEngine::Statistics stats = engine.GetStatistics();
+    Check(stats.opens == 3 && stats.closes == 3 && stats.quotes == 8 && stats.realized_pnl > 40,
+          "Statistics");
+
+    // Level 0 filled far better than quoted, so it reaches take profit before level 1
+    engine.Reset();
+    engine.OnMt5Quote(1999.9, 2000.1, 1010, decisions, 8);
+    engine.OnOkxQuote(2013.0, 2013.2, 1011, decisions, 8);
+    int shallow = decisions[0].group_id;
+    engine.OnOkxQuote(2018.5, 2018.7, 1012, decisions, 8);
+    Check(engine.UpdateEntry(shallow, 2100.0, 2000.1) && engine.OpenCount(Direction::kShortOkx) == 2,
+          "Levels 0 and 1 open");
+    n = engine.OnOkxQuote(2018.5, 2018.7, 1013, decisions, 8);
+    Check(n == 2 && decisions[0].action == Action::kClose && decisions[0].level == 0 &&
+          decisions[1].action == Action::kOpen && decisions[1].level == 0,
+          "Freed lower level reopened, not a second level 1");
+    Check(engine.OpenGroup(Direction::kShortOkx, 0).level == 1 && engine.OpenGroup(Direction::kShortOkx, 1).level == 0 &&
+          engine.NextThreshold(Direction::kShortOkx) == 20.0, "Next open takes level 2");
+
+    PrintHeader("Ladder: MT5 short / OKX long");
+
+    SpreadEngine reverse(MakeParams(), okx_symbol, mt5_symbol);
+    TickPOD okx_tick{};
+    okx_tick.symbol_id = okx_symbol;
+    okx_tick.platform = TickPOD::Platform::kOKX;
+    okx_tick.bid = 2000.0;
+    okx_tick.ask = 2000.2;
+    TickPOD mt5_tick{};
+    mt5_tick.symbol_id = mt5_symbol;
+    mt5_tick.platform = TickPOD::Platform::kMT5;
+    mt5_tick.bid = 2015.0;
+    mt5_tick.ask = 2015.2;
+    TickPOD other = okx_tick;
+    other.symbol_id = SymbolTable::Global().Intern("BTC-USDT-SWAP");
+
+    reverse.OnQuote(okx_tick, decisions, 8);
+    Check(reverse.OnQuote(other, decisions, 8) == 0 && reverse.GetStatistics().quotes == 1,
+          "Ticks of other instruments ignored");
+    n = reverse.OnQuote(mt5_tick, decisions, 8);
+    Check(n == 1 && decisions[0].direction == Direction::kShortMt5 && decisions[0].okx_price == 2000.2 &&
+          decisions[0].mt5_price == 2015.0, "mt5.bid - okx.ask opens: sell MT5 bid, buy OKX ask");
+    int group_id = decisions[0].group_id;
+
+    mt5_tick.bid = 0;
+    Check(reverse.OnQuote(mt5_tick, decisions, 8) == 0 && reverse.NetSpread(Direction::kShortMt5) == 0,
+          "Empty side suspends the pair");
+    mt5_tick.bid = 2015.0;
+
+    Check(reverse.UpdateEntry(group_id, 2000.4, 2014.8) && !reverse.UpdateEntry(9999, 0, 0) &&
+          reverse.OpenGroup(Direction::kShortMt5, 0).okx_entry == 2000.4, "Fills replace the assumed entry");
+
+    // Marked, not yet at take profit
+    StrategyParams params = MakeParams();
+    params.take_profit = 1000;
+    reverse.SetParams(params);
+    mt5_tick.bid = 2005.0;
+    mt5_tick.ask = 2005.2;
+    reverse.OnQuote(mt5_tick, decisions, 8);
+    OrderGroup group;
+    reverse.ToOrderGroup(Direction::kShortMt5, reverse.OpenGroup(Direction::kShortMt5, 0), group);
+    double marked = (2014.8 - 2005.2) + (2000.0 - 2000.4) - (2014.8 * 0.0002 + 2000.4 * 0.0005) -
+                    (2005.2 * 0.0002 + 2000.0 * 0.0005);
+    Check(group.group_id == group_id && group.okx_order.side == "buy" && group.mt5_order.side == "sell" &&
+          group.okx_order.inst_id == "XAUT-USDT-SWAP" && group.mt5_order.symbol == "XAUUSD" &&
+          group.status == "open" && Near(group.total_pnl, marked), "Legacy OrderGroup with marked PnL");
+
+    Check(reverse.OnQuote(mt5_tick, decisions, 0) == 0 && reverse.OpenCount(Direction::kShortMt5) == 1,
+          "No room for decisions: state unchanged");
+    params.take_profit = 5;
+    reverse.SetParams(params);
+    n = reverse.OnQuote(mt5_tick, decisions, 8);
+    Check(n == 1 && decisions[0].action == Action::kClose && Near(decisions[0].pnl, marked),
+          "Lowered take_profit closes at the same PnL");
+
+    PrintHeader("Benchmark: synthetic session");
+
+    const size_t session_ticks = 200000;
+    vector<TickPOD> session = SyntheticSession(session_ticks, okx_symbol, mt5_symbol);
+
+    SpreadEngine bench(MakeParams(), okx_symbol, mt5_symbol);
+    const int passes = 10;
+    size_t produced = 0;
+    uint64_t allocations_before = g_allocations;
+    auto start = chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (const TickPOD& tick : session) {
+            produced += bench.OnQuote(tick, decisions, SpreadEngine::kMaxDecisions);
+        }
+    }
+    double tick_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() /
+                     (static_cast<double>(passes) * session_ticks);
+    uint64_t allocations = g_allocations - allocations_before;
+
+    stats = bench.GetStatistics();
+    cout << fixed << setprecision(1);
+    cout << "  " << session_ticks << " ticks x " << passes << ": " << tick_ns << " ns/tick, "
+         << allocations << " allocations\n";
+    cout << "  " << stats.opens << " opens, " << stats.closes << " closes, realized "
+         << setprecision(2) << stats.realized_pnl << "\n";
+    Check(stats.opens > 0 && stats.closes > 0 && produced == stats.opens + stats.closes,
+          "Session walks the ladder both ways");
+    Check(allocations == 0, "No heap allocation per tick");
+    Check(tick_ns < 1000, "Well under 1 us per tick");
+
+    // Per-tick distribution (includes two clock reads)
+    LatencyHistogram histogram;
+    for (const TickPOD& tick : session) {
+        int64_t begin = LatencyRegistry::NowNs();
+        bench.OnQuote(tick, decisions, SpreadEngine::kMaxDecisions);
+        histogram.Record(LatencyRegistry::NowNs() - begin);
+    }
+    LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+    cout << "  per tick: p50 " << snapshot.ValueAtPercentile(50) << " ns, p99 "
+         << snapshot.ValueAtPercentile(99) << " ns, p99.9 " << snapshot.ValueAtPercentile(99.9) << " ns\n";
+    Check(snapshot.ValueAtPercentile(99) < 1000, "p99 under 1 us");
+
+    return TestSummary();
+}
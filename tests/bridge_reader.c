@@ -0,0 +1,85 @@
+/*
+ * Plain C consumer of the market data bridge, built as C so the test
+ * proves okx_bridge_c.h is usable from a non-C++ reader (as MT5 would be).
+ *
+ * The writer in test_market_data_bridge publishes quotes with
+ * ask = bid + 0.5 and last = bid + 0.25, and books whose level i is
+ * bid - i / ask + i. Any copy that mixes two updates breaks one of these.
+ */
+
+#include "okx_bridge_c.h"
+#include <sched.h>
+
+typedef struct BridgeReaderResult {
+    long reads;
+    long torn;
+    long out_of_order;
+} BridgeReaderResult;
+
+static int QuoteTorn(const OKXBridgeQuote* q) {
+    return q->ask != q->bid + 0.5 || q->last != q->bid + 0.25;
+}
+
+static int BookTorn(const OKXBridgeBook* b) {
+    uint32_t i;
+    if (b->bid_count != OKX_BRIDGE_BOOK_LEVELS || b->ask_count != OKX_BRIDGE_BOOK_LEVELS) {
+        return 1;
+    }
+    for (i = 0; i < OKX_BRIDGE_BOOK_LEVELS; i++) {
+        if (b->bid_price[i] != b->bid_price[0] - i || b->ask_price[i] != b->bid_price[0] + 0.5 + i) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Read until both the quote and the book reach final_count or the deadline passes */
+int RunBridgeReader(const char* name, const char* symbol, uint64_t final_count,
+                    int64_t timeout_ns, BridgeReaderResult* result) {
+    OKXBridgeQuote quote;
+    OKXBridgeBook book;
+    uint64_t last_quote = 0;
+    uint64_t last_book = 0;
+    int64_t deadline = OKX_BridgeNowNs() + timeout_ns;
+    int handle = -1;
+    int slot = -1;
+
+    result->reads = 0;
+    result->torn = 0;
+    result->out_of_order = 0;
+
+    while (handle < 0 || slot < 0) {
+        if (OKX_BridgeNowNs() > deadline) {
+            OKX_BridgeClose(handle);
+            return -1;
+        }
+        if (handle < 0) {
+            handle = OKX_BridgeOpen(name);
+        }
+        if (handle >= 0) {
+            slot = OKX_BridgeFindSymbol(handle, symbol);
+        }
+        sched_yield();
+    }
+
+    while (last_quote < final_count || last_book < final_count) {
+        if (OKX_BridgeNowNs() > deadline) {
+            break;
+        }
+        if (OKX_BridgeReadQuote(handle, slot, &quote) == 1) {
+            result->reads++;
+            result->torn += QuoteTorn(&quote);
+            result->out_of_order += quote.update_count < last_quote;
+            last_quote = quote.update_count;
+        }
+        if (OKX_BridgeReadBook(handle, slot, &book) == 1) {
+            result->reads++;
+            result->torn += BookTorn(&book);
+            result->out_of_order += book.update_count < last_book;
+            last_book = book.update_count;
+        }
+    }
+
+    OKX_BridgeClose(handle);
+    return last_quote == final_count && last_book == final_count ? 0 : -1;
+}
@@ -0,0 +1,182 @@
+#ifndef LOCAL_HTTP_SERVER_H
+#define LOCAL_HTTP_SERVER_H
+
+// Minimal HTTP/1.1 server on 127.0.0.1 for tests that must not touch the
+// network. Each accepted connection gets its own thread and keep-alive is
+// honoured, so connection reuse on the client side can be observed.
+// POSIX only.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LocalHttpServer {
+public:
+    struct Request {
+        std::string method;
+        std::string path;       // Includes query string
+        std::string body;
+        std::vector<std::pair<std::string, std::string>> headers;
+
+        std::string Header(const std::string& name) const {
+            for (const auto& [key, value] : headers) {
+                if (key == name) return value;
+            }
+            return "";
+        }
+    };
+
+    struct Reply {
+        int status = 200;
+        std::string body;
+        int delay_ms = 0;       // Sleep before answering
+    };
+
+    using Handler = std::function<Reply(const Request&)>;
+
+    explicit LocalHttpServer(Handler handler) : handler_(std::move(handler)) {}
+
+    ~LocalHttpServer() { Stop(); }
+
+    bool Start() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) return false;
+
+        int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listen_fd_, 64) != 0) {
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        accept_thread_ = std::thread([this] { AcceptLoop(); });
+        return true;
+    }
+
+    void Stop() {
+        if (!running_.exchange(false)) return;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        if (accept_thread_.joinable()) accept_thread_.join();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : client_fds_) ::shutdown(fd, SHUT_RDWR);
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    std::string BaseUrl() const {
+        return "http://127.0.0.1:" + std::to_string(port_);
+    }
+
+    int ConnectionCount() const { return connections_.load(); }
+
+private:
+    void AcceptLoop() {
+        while (running_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) break;
+            connections_++;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            client_fds_.push_back(fd);
+            workers_.emplace_back([this, fd] { Serve(fd); });
+        }
+    }
+
+    void Serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+
+        while (running_) {
+            // Read until the header block is complete
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) { ::close(fd); return; }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+
+            Request request;
+            std::string head = buffer.substr(0, header_end);
+            size_t line_end = head.find("\r\n");
+            std::string request_line = head.substr(0, line_end);
+            size_t sp1 = request_line.find(' ');
+            size_t sp2 = request_line.find(' ', sp1 + 1);
+            request.method = request_line.substr(0, sp1);
+            request.path = request_line.substr(sp1 + 1, sp2 - sp1 - 1);
+
+            size_t content_length = 0;
+            size_t pos = line_end + 2;
+            while (pos < head.size()) {
+                size_t eol = head.find("\r\n", pos);
+                if (eol == std::string::npos) eol = head.size();
+                std::string line = head.substr(pos, eol - pos);
+                size_t colon = line.find(':');
+                if (colon != std::string::npos) {
+                    std::string key = line.substr(0, colon);
+                    std::string value = line.substr(colon + 1);
+                    value.erase(0, value.find_first_not_of(' '));
+                    if (key == "Content-Length" || key == "content-length") {
+                        content_length = std::stoul(value);
+                    }
+                    request.headers.emplace_back(key, value);
+                }
+                pos = eol + 2;
+            }
+
+            buffer.erase(0, header_end + 4);
+            while (buffer.size() < content_length) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) { ::close(fd); return; }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+            request.body = buffer.substr(0, content_length);
+            buffer.erase(0, content_length);
+
+            Reply reply = handler_(request);
+            if (reply.delay_ms > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(reply.delay_ms));
+            }
+
+            std::string out = "HTTP/1.1 " + std::to_string(reply.status) + " OK\r\n"
+                              "Content-Type: application/json\r\n"
+                              "Content-Length: " + std::to_string(reply.body.size()) + "\r\n"
+                              "Connection: keep-alive\r\n\r\n" + reply.body;
+            if (::send(fd, out.data(), out.size(), MSG_NOSIGNAL) < 0) break;
+        }
+        ::close(fd);
+    }
+
+    Handler handler_;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<int> connections_{0};
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<int> client_fds_;
+    std::vector<std::thread> workers_;
+};
+
+#endif // LOCAL_HTTP_SERVER_H
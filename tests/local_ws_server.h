@@ -0,0 +1,284 @@
+#ifndef LOCAL_WS_SERVER_H
+#define LOCAL_WS_SERVER_H
+
+// Minimal TLS WebSocket server on 127.0.0.1 for tests that must not touch
+// the network. A self-signed certificate is generated at start-up, every
+// connection gets its own thread, and each received text frame is handed
+// to a handler whose replies are sent back (echo by default). The number
+// of TLS handshakes and of resumed sessions is counted so session reuse
+// on the client side can be observed. POSIX + OpenSSL only.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <csignal>
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class LocalWsServer {
+public:
+    struct Reply {
+        std::vector<std::string> messages;
+        bool close_connection = false;   // Drop the TCP connection after sending
+    };
+
+    using Handler = std::function<Reply(const std::string&)>;
+
+    explicit LocalWsServer(Handler handler = nullptr) : handler_(std::move(handler)) {}
+
+    ~LocalWsServer() { Stop(); }
+
+    bool Start() {
+        if (!CreateContext()) return false;
+
+        // SSL_write to a client that already hung up must fail, not kill the test
+        ::signal(SIGPIPE, SIG_IGN);
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) return false;
+
+        int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            ::listen(listen_fd_, 16) != 0) {
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        accept_thread_ = std::thread([this] { AcceptLoop(); });
+        return true;
+    }
+
+    void Stop() {
+        if (!running_.exchange(false)) return;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        if (accept_thread_.joinable()) accept_thread_.join();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int fd : client_fds_) ::shutdown(fd, SHUT_RDWR);
+        }
+        for (auto& t : workers_) {
+            if (t.joinable()) t.join();
+        }
+        SSL_CTX_free(ctx_);
+        ctx_ = nullptr;
+    }
+
+    std::string Url() const {
+        return "wss://127.0.0.1:" + std::to_string(port_) + "/ws/v5/public";
+    }
+
+    int Handshakes() const { return handshakes_.load(); }
+    int ResumedSessions() const { return resumed_.load(); }
+    int CloseFrames() const { return close_frames_.load(); }
+
+private:
+    bool CreateContext() {
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        X509* cert = X509_new();
+        if (!key || !cert) return false;
+
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_sign(cert, key, EVP_sha256());
+
+        ctx_ = SSL_CTX_new(TLS_server_method());
+        bool ok = ctx_ && SSL_CTX_use_certificate(ctx_, cert) == 1 &&
+                  SSL_CTX_use_PrivateKey(ctx_, key) == 1;
+        if (ok) {
+            const unsigned char id[] = "okx-ws-test";
+            SSL_CTX_set_session_id_context(ctx_, id, sizeof(id) - 1);
+        }
+
+        X509_free(cert);
+        EVP_PKEY_free(key);
+        return ok;
+    }
+
+    void AcceptLoop() {
+        while (running_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) break;
+
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            client_fds_.push_back(fd);
+            workers_.emplace_back([this, fd] { Serve(fd); });
+        }
+    }
+
+    void Serve(int fd) {
+        SSL* ssl = SSL_new(ctx_);
+        SSL_set_fd(ssl, fd);
+        if (SSL_accept(ssl) == 1) {
+            handshakes_++;
+            if (SSL_session_reused(ssl)) resumed_++;
+            if (Upgrade(ssl)) {
+                FrameLoop(ssl);
+            }
+            SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+        ::close(fd);
+    }
+
+    bool Upgrade(SSL* ssl) {
+        std::string request;
+        char chunk[2048];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            int n = SSL_read(ssl, chunk, sizeof(chunk));
+            if (n <= 0) return false;
+            request.append(chunk, static_cast<size_t>(n));
+        }
+
+        const char* header = "Sec-WebSocket-Key:";
+        size_t pos = request.find(header);
+        if (pos == std::string::npos) return false;
+        pos += std::strlen(header);
+        while (request[pos] == ' ') pos++;
+        std::string key = request.substr(pos, request.find("\r\n", pos) - pos);
+
+        std::string accept_src = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+        unsigned char digest[SHA_DIGEST_LENGTH];
+        SHA1(reinterpret_cast<const unsigned char*>(accept_src.data()), accept_src.size(), digest);
+        unsigned char accept[64];
+        EVP_EncodeBlock(accept, digest, SHA_DIGEST_LENGTH);
+
+        std::string response = "HTTP/1.1 101 Switching Protocols\r\n"
+                               "Upgrade: websocket\r\n"
+                               "Connection: Upgrade\r\n"
+                               "Sec-WebSocket-Accept: " +
+                               std::string(reinterpret_cast<char*>(accept)) + "\r\n\r\n";
+        return SSL_write(ssl, response.data(), static_cast<int>(response.size())) > 0;
+    }
+
+    static bool ReadExact(SSL* ssl, unsigned char* out, size_t length) {
+        while (length > 0) {
+            int n = SSL_read(ssl, out, static_cast<int>(length));
+            if (n <= 0) return false;
+            out += n;
+            length -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static bool WriteFrame(SSL* ssl, int opcode, const std::string& payload) {
+        std::string frame;
+        frame.push_back(static_cast<char>(0x80 | opcode));
+        if (payload.size() < 126) {
+            frame.push_back(static_cast<char>(payload.size()));
+        } else if (payload.size() <= 0xFFFF) {
+            frame.push_back(126);
+            frame.push_back(static_cast<char>(payload.size() >> 8));
+            frame.push_back(static_cast<char>(payload.size() & 0xFF));
+        } else {
+            frame.push_back(127);
+            for (int i = 7; i >= 0; i--) frame.push_back(static_cast<char>(payload.size() >> (i * 8)));
+        }
+        frame += payload;
+        return SSL_write(ssl, frame.data(), static_cast<int>(frame.size())) > 0;
+    }
+
+    void FrameLoop(SSL* ssl) {
+        std::string message;
+        while (running_) {
+            unsigned char head[2];
+            if (!ReadExact(ssl, head, 2)) return;
+
+            bool fin = head[0] & 0x80;
+            int opcode = head[0] & 0x0F;
+            uint64_t length = head[1] & 0x7F;
+            if (length == 126) {
+                unsigned char ext[2];
+                if (!ReadExact(ssl, ext, 2)) return;
+                length = (ext[0] << 8) | ext[1];
+            } else if (length == 127) {
+                unsigned char ext[8];
+                if (!ReadExact(ssl, ext, 8)) return;
+                length = 0;
+                for (int i = 0; i < 8; i++) length = (length << 8) | ext[i];
+            }
+
+            unsigned char mask[4] = {0, 0, 0, 0};
+            if ((head[1] & 0x80) && !ReadExact(ssl, mask, 4)) return;
+
+            std::string payload(length, '\0');
+            if (length && !ReadExact(ssl, reinterpret_cast<unsigned char*>(&payload[0]), length)) return;
+            for (size_t i = 0; i < payload.size(); i++) payload[i] ^= mask[i % 4];
+
+            if (opcode == 0x8) {
+                close_frames_++;
+                WriteFrame(ssl, 0x8, "");
+                return;
+            }
+            if (opcode == 0x9) {
+                WriteFrame(ssl, 0xA, payload);
+                continue;
+            }
+
+            message += payload;
+            if (!fin) continue;
+
+            Reply reply;
+            if (handler_) {
+                reply = handler_(message);
+            } else {
+                reply.messages.push_back(message);
+            }
+            message.clear();
+
+            for (const auto& out : reply.messages) {
+                if (!WriteFrame(ssl, 0x1, out)) return;
+            }
+            if (reply.close_connection) return;
+        }
+    }
+
+    Handler handler_;
+    SSL_CTX* ctx_ = nullptr;
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<int> handshakes_{0};
+    std::atomic<int> resumed_{0};
+    std::atomic<int> close_frames_{0};
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<int> client_fds_;
+    std::vector<std::thread> workers_;
+};
+
+#endif // LOCAL_WS_SERVER_H
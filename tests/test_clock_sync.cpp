@@ -0,0 +1,128 @@
+#include "clock_sync.h"
+#include "okx_rest_api.h"
+#include "okx_signer.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+// Server clock 250 ms ahead; the server reads it `server_after_us` into the round trip
+int64_t ServerMs(int64_t send_us, int64_t server_after_us) {
+    return (send_us + server_after_us + 250000) / 1000;
+}
+
+int main() {
+    PrintHeader("Min-RTT filter on synthetic round trips");
+
+    ClockSync sync(ClockSync::ServerTimeSource(nullptr));
+    Check(!sync.GetEstimate().valid, "No estimate before the first sample");
+
+    int64_t t = 1700000000000000LL;
+    // Slow responses with the delay all on the way back: offset off by ~40 ms
+    Check(sync.AddSample(t, ServerMs(t, 5000), t + 90000), "Asymmetric sample accepted");
+    Check(llabs(sync.GetEstimate().offset_us - 250000) > 30000, "One slow sample gives a poor offset");
+
+    t += 1000000;
+    sync.AddSample(t, ServerMs(t, 1000), t + 2000);     // Fast and symmetric
+    t += 1000000;
+    sync.AddSample(t, ServerMs(t, 2000), t + 60000);
+    ClockSync::Estimate estimate = sync.GetEstimate();
+    Check(estimate.valid && estimate.samples == 3 && estimate.rtt_us == 2000,
+          "Fastest round trip selected");
+    Check(llabs(estimate.offset_us - 250000) <= 1000 + estimate.rtt_us / 2,
+          "Offset within the sample's error bound");
+    Check(estimate.jitter_us > 0, "Jitter reflects the slow samples");
+
+    Check(!sync.AddSample(t, ServerMs(t, 0), t - 1) && !sync.AddSample(t, ServerMs(t, 0), t + 5000000) &&
+          sync.GetEstimate().rejected == 2, "Negative and over-long round trips rejected");
+
+    // The fast sample ages out of the window
+    for (size_t i = 0; i < ClockSync::kWindow; i++) {
+        t += 1000000;
+        sync.AddSample(t, ServerMs(t, 5000), t + 10000);
+    }
+    Check(sync.GetEstimate().rtt_us == 10000, "Window keeps only the last kWindow samples");
+
+    PrintHeader("Applied to signing timestamps");
+
+    int64_t before = OKXSigner::NowMs();
+    sync.Apply();
+    Check(OKXSigner::GetClockOffsetUs() == sync.GetEstimate().offset_us, "Offset pushed to OKXSigner");
+    int64_t shifted = OKXSigner::NowMs() - before;
+    Check(shifted >= 240 && shifted <= 270, "NowMs() on the server clock");
+    OKXSigner::SetClockOffsetUs(0);
+
+    PrintHeader("Against a skewed /api/v5/public/time");
+
+    const int64_t skew_ms = 3500;
+    atomic<int> requests{0};
+    atomic<bool> failing{false};
+    LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        if (failing || request.path != "/api/v5/public/time") {
+            reply.status = 500;
+            return reply;
+        }
+        int64_t server_ms = ClockSync::LocalNowUs() / 1000 + skew_ms;
+        reply.body = R"({"code":"0","msg":"","data":[{"ts":")" + to_string(server_ms) + R"("}]})";
+        // Every other reply is held back after the timestamp is taken
+        reply.delay_ms = requests++ % 2 ? 20 : 0;
+        return reply;
+    });
+    server.Start();
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig api_config;
+    api_config.base_url = server.BaseUrl();
+    api_config.max_retries = 1;
+    api.Initialize(api_config);
+
+    int64_t server_ms = api.GetServerTime();
+    Check(llabs(server_ms - (ClockSync::LocalNowUs() / 1000 + skew_ms)) < 100, "GetServerTime parses ts");
+
+    ClockSync rest_sync(api);
+    Check(rest_sync.Sync(6) == 6, "Six samples accepted");
+    estimate = rest_sync.GetEstimate();
+    cout << "  offset " << estimate.offset_us << " us, rtt " << estimate.rtt_us
+         << " us, jitter " << estimate.jitter_us << " us\n";
+    Check(estimate.rtt_us < 20000, "Delayed replies never selected");
+    Check(llabs(estimate.offset_us - skew_ms * 1000) <= 1000 + estimate.rtt_us / 2, "Skew recovered");
+    Check(OKXSigner::GetClockOffsetUs() == estimate.offset_us, "Sync applies the offset");
+
+    Check(llabs(OKXSigner::NowMs() - (ClockSync::LocalNowUs() / 1000 + skew_ms)) < 10,
+          "Signed timestamps follow the server clock");
+
+    failing = true;
+    Check(!rest_sync.SyncOnce() && rest_sync.GetEstimate().rejected == 1 &&
+          rest_sync.GetEstimate().offset_us == estimate.offset_us, "Failed request keeps the estimate");
+    failing = false;
+
+    uint64_t samples = rest_sync.GetEstimate().samples;
+    Check(rest_sync.Start(chrono::milliseconds(10)) && !rest_sync.Start(), "Background sampling started");
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    while (rest_sync.GetEstimate().samples < samples + 6 && chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    rest_sync.Stop();
+    Check(!rest_sync.IsRunning() && rest_sync.GetEstimate().samples >= samples + 6,
+          "Burst then periodic samples");
+
+    // The limiter's 10 per 2 s is spent by now, so this request queues first
+    int64_t send_us = 0, receive_us = 0;
+    auto start = chrono::steady_clock::now();
+    server_ms = api.GetServerTime(send_us, receive_us);
+    int64_t waited_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    cout << "  queued call " << waited_us << " us, measured round trip " << receive_us - send_us << " us\n";
+    Check(server_ms > 0 && waited_us > 50000 && receive_us - send_us >= 0 && receive_us - send_us < waited_us / 2,
+          "Rate-limiter wait not counted in the round trip");
+
+    OKXSigner::SetClockOffsetUs(0);
+    server.Stop();
+
+    return TestSummary();
+}
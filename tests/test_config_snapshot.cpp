@@ -0,0 +1,136 @@
+#include "config.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+json MakeConfig(double first_order) {
+    return {
+        {"environment", "simulation"},
+        {"okx", {
+            {"simulation", {{"api_key", "sim-key"}, {"secret_key", "sim-secret"}, {"passphrase", "p"},
+                            {"rest_url", "https://www.okx.com"}, {"ws_public", "wss://wspap.okx.com:8443/ws/v5/public"},
+                            {"ws_private", "wss://wspap.okx.com:8443/ws/v5/private"}}},
+            {"production", {{"api_key", "live-key"}, {"secret_key", "live-secret"}, {"passphrase", "p"},
+                            {"rest_url", "https://www.okx.com"}, {"ws_public", "wss://ws.okx.com:8443/ws/v5/public"},
+                            {"ws_private", "wss://ws.okx.com:8443/ws/v5/private"}}},
+            {"symbols", {{"XAUT", "XAUT-USDT-SWAP"}}}}},
+        {"mt5", {
+            {"simulation", {{"server", "Demo-Server"}, {"login", 7}, {"password", ""}}},
+            {"symbols", {{"XAUT", "XAUUSD"}}}}},
+        {"strategy", {{"first_order", first_order}, {"next_order", 5.0}, {"max_orders", 5},
+                      {"take_profit", 50.0}, {"okx_fee_rate", 0.0005}, {"mt5_fee_rate", 0.0002},
+                      {"okx_order_size", 1.0}, {"mt5_order_size", 1.0}}}
+    };
+}
+
+void WriteFile(const string& path, const string& text) {
+    ofstream(path) << text;
+}
+
+int main() {
+    const string path = "test_config_snapshot_" + to_string(getpid()) + ".json";
+    Config& config = Config::Instance();
+
+    PrintHeader("Snapshot built at load");
+
+    WriteFile(path, MakeConfig(10.0).dump());
+    Check(config.Load(path), "Config loaded");
+    auto snapshot = config.GetSnapshot();
+    Check(snapshot->version == 1 && config.GetVersion() == 1, "Version 1");
+    Check(snapshot->IsSimulation() && snapshot->okx.api_key == "sim-key" && snapshot->mt5.login == 7 &&
+          snapshot->okx_symbols.at("XAUT") == "XAUT-USDT-SWAP", "Typed account and symbol fields");
+    Check(snapshot->strategy.first_order == 10.0 && snapshot->strategy.max_orders == 5 &&
+          config.GetTakeProfit() == 50.0, "StrategyParams parsed once");
+    Check(config.GetOKXSymbol("BTC").empty() && config.GetMT5Server() == "Demo-Server", "Legacy getters");
+
+    config.SetEnvironment("production");
+    Check(config.GetOKXAPIKey() == "live-key" && config.GetMT5Server().empty() && config.GetVersion() == 2,
+          "SetEnvironment publishes a new snapshot");
+    Check(snapshot->okx.api_key == "sim-key", "Held snapshot is unchanged");
+
+    PrintHeader("Reload");
+
+    Config::Reader reader;
+    Check(reader.Strategy().first_order == 10.0, "Reader sees the current parameters");
+
+    WriteFile(path, MakeConfig(12.5).dump());
+    Check(config.Load(path) && config.GetVersion() == 3, "Reload accepted");
+    Check(reader.Strategy().first_order == 12.5, "Reader picks up the new snapshot");
+
+    json bad = MakeConfig(-1.0);
+    WriteFile(path, bad.dump());
+    Check(!config.Load(path) && config.GetVersion() == 3 && config.GetFirstOrder() == 12.5,
+          "Negative spread rejected, previous snapshot kept");
+    bad = MakeConfig(1.0);
+    bad["strategy"]["max_orders"] = "five";
+    WriteFile(path, bad.dump());
+    Check(!config.Load(path) && config.GetVersion() == 3, "Wrong type rejected");
+    bad = MakeConfig(1.0);
+    bad["strategy"]["max_orders"] = 33;
+    WriteFile(path, bad.dump());
+    Check(!config.Load(path) && config.GetVersion() == 3, "max_orders above SpreadEngine::kMaxLevels rejected");
+    bad = MakeConfig(1.0);
+    bad["strategy"].erase("take_profit");
+    WriteFile(path, bad.dump());
+    Check(!config.Load(path), "Missing key rejected");
+    WriteFile(path, "{\"environment\": ");
+    Check(!config.Load(path) && config.GetVersion() == 3, "Truncated file rejected");
+
+    PrintHeader("Readers during reloads");
+
+    atomic<bool> running{true};
+    atomic<long> torn{0};
+    atomic<long> reads{0};
+    thread strategy([&] {
+        Config::Reader local;
+        while (running.load(memory_order_relaxed)) {
+            const StrategyParams& p = local.Strategy();
+            // Every published snapshot has next_order 5 and take_profit 50
+            if (p.next_order != 5.0 || p.take_profit != 50.0) torn++;
+            reads++;
+        }
+    });
+    for (int i = 0; i < 50; i++) {
+        WriteFile(path, MakeConfig(1.0 + i).dump());
+        config.Load(path);
+    }
+    running = false;
+    strategy.join();
+    Check(torn.load() == 0 && reads.load() > 0 && config.GetFirstOrder() == 50.0,
+          "50 reloads under a reading thread, no partial parameters seen");
+    remove(path.c_str());
+
+    PrintHeader("Benchmark: strategy parameter read");
+
+    const int iterations = 1000000;
+    double sink = 0;
+    json raw = MakeConfig(10.0);
+    const json& const_raw = raw;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations / 10; i++) {
+        sink += const_raw["strategy"]["first_order"].get<double>() + const_raw["strategy"]["take_profit"].get<double>();
+    }
+    double json_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (iterations / 10);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        const StrategyParams& p = reader.Strategy();
+        sink += p.first_order + p.take_profit;
+    }
+    double reader_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << fixed << setprecision(1);
+    cout << "  JSON lookup (2 fields)   : " << json_ns << " ns\n";
+    cout << "  Config::Reader (2 fields): " << reader_ns << " ns\n";
+    Check(sink > 0 && reader_ns < json_ns, "Snapshot read is cheaper than the JSON lookup");
+
+    return TestSummary();
+}
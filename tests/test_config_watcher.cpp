@@ -0,0 +1,132 @@
+#include "config_watcher.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate, int timeout_ms = 3000) {
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout_ms);
+    while (!predicate()) {
+        if (chrono::steady_clock::now() > deadline) return false;
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return true;
+}
+
+string MakeConfig(double first_order, const string& rest_url = "https://www.okx.com") {
+    json config = {
+        {"environment", "simulation"},
+        {"okx", {{"simulation", {{"api_key", "k"}, {"secret_key", "s"}, {"passphrase", "p"},
+                                 {"rest_url", rest_url}, {"ws_public", "wss://a"}, {"ws_private", "wss://b"}}},
+                 {"live", {{"api_key", "lk"}, {"secret_key", "ls"}, {"passphrase", "lp"},
+                           {"rest_url", "https://live.okx.com"}, {"ws_public", "wss://a"}, {"ws_private", "wss://b"}}}}},
+        {"strategy", {{"first_order", first_order}, {"next_order", 5.0}, {"max_orders", 5},
+                      {"take_profit", 50.0}, {"okx_fee_rate", 0.0005}, {"mt5_fee_rate", 0.0002},
+                      {"okx_order_size", 1.0}, {"mt5_order_size", 1.0}}}
+    };
+    return config.dump(2);
+}
+
+void WriteFile(const string& path, const string& text) {
+    ofstream(path) << text;
+}
+
+int main() {
+    const string path = "test_config_watcher_" + to_string(getpid()) + ".json";
+    WriteFile(path, MakeConfig(10.0));
+
+    Config& config = Config::Instance();
+    config.Load(path);
+    Config::Reader reader;
+
+    ConfigWatcher watcher;
+    atomic<int> callbacks{0};
+    string callback_url;
+    watcher.SetReloadCallback([&](const ConfigSnapshot& snapshot) {
+        callback_url = snapshot.okx.rest_url;
+        callbacks++;
+    });
+    Check(watcher.Start(path) && watcher.IsRunning(), "Watching the config file");
+
+    // A strategy thread keeps reading while the file changes underneath
+    atomic<bool> running{true};
+    atomic<long> torn{0};
+    thread strategy([&] {
+        Config::Reader local;
+        while (running.load(memory_order_relaxed)) {
+            const StrategyParams& p = local.Strategy();
+            if (p.next_order != 5.0 || p.take_profit != 50.0) torn++;
+        }
+    });
+
+    PrintHeader("In-place edit");
+
+    WriteFile(path, MakeConfig(12.5));
+    Check(WaitFor([&] { return watcher.GetStatistics().accepted == 1; }), "Write picked up and accepted");
+    Check(reader.Strategy().first_order == 12.5 && callbacks.load() == 1, "New parameters visible, callback run");
+
+    PrintHeader("Invalid edit");
+
+    WriteFile(path, MakeConfig(-3.0));
+    Check(WaitFor([&] { return watcher.GetStatistics().rejected == 1; }), "Negative spread rejected");
+    WriteFile(path, "{\"environment\": \"simulation\", ");
+    Check(WaitFor([&] { return watcher.GetStatistics().rejected == 2; }), "Truncated JSON rejected");
+    Check(reader.Strategy().first_order == 12.5 && watcher.GetStatistics().accepted == 1,
+          "Previous snapshot still in force");
+
+    PrintHeader("Replace by rename");
+
+    const string temp = path + ".tmp";
+    WriteFile(temp, MakeConfig(20.0, "https://aws.okx.com"));
+    rename(temp.c_str(), path.c_str());
+    Check(WaitFor([&] { return watcher.GetStatistics().accepted == 2; }), "Rename picked up");
+    Check(reader.Strategy().first_order == 20.0 && callback_url == "https://aws.okx.com" &&
+          config.GetOKXRESTURL() == "https://aws.okx.com", "Endpoints swapped with the parameters");
+
+    PrintHeader("Burst of writes");
+
+    uint64_t accepted_before = watcher.GetStatistics().accepted;
+    for (int i = 0; i < 5; i++) WriteFile(path, MakeConfig(30.0 + i));
+    Check(WaitFor([&] { return reader.Strategy().first_order == 34.0; }), "Last write wins");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    uint64_t burst_reloads = watcher.GetStatistics().accepted - accepted_before;
+    cout << "  5 writes -> " << burst_reloads << " reload(s)\n";
+    Check(burst_reloads >= 1 && burst_reloads <= 5, "Burst folded into at most one reload per write");
+
+    WriteFile(path + ".other", "not json");
+    this_thread::sleep_for(chrono::milliseconds(100));
+    Check(watcher.GetStatistics().rejected == 2, "Other files in the directory ignored");
+    remove((path + ".other").c_str());
+
+    PrintHeader("Environment override");
+
+    config.SetEnvironment("live");
+    Check(config.GetEnvironment() == "live" && config.GetOKXAPIKey() == "lk", "Switched to live");
+    WriteFile(path, MakeConfig(35.0));
+    Check(WaitFor([&] { return reader.Strategy().first_order == 35.0; }), "Edit reloaded");
+    Check(config.GetEnvironment() == "live" && config.GetOKXRESTURL() == "https://live.okx.com",
+          "Reload keeps the SetEnvironment() override");
+    config.SetEnvironment("");
+    Check(config.GetEnvironment() == "simulation" && config.GetOKXAPIKey() == "k",
+          "Empty override falls back to the file's environment");
+
+    running = false;
+    strategy.join();
+    Check(torn.load() == 0, "Reader thread never saw partial parameters");
+
+    watcher.Stop();
+    Check(!watcher.IsRunning(), "Stopped");
+    WriteFile(path, MakeConfig(40.0));
+    this_thread::sleep_for(chrono::milliseconds(100));
+    Check(reader.Strategy().first_order == 35.0, "No reloads after Stop()");
+    remove(path.c_str());
+
+    return TestSummary();
+}
@@ -0,0 +1,124 @@
+#include "depth_pricer.h"
+#include "order_book.h"
+#include "test_util.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+bool Close(double a, double b) {
+    return fabs(a - b) <= 1e-12 * max(fabs(a), fabs(b));
+}
+
+Depth MakeBook(int levels, mt19937& rng) {
+    Depth depth;
+    for (int i = 0; i < levels; i++) {
+        depth.bids.emplace_back(2350.0 - i * 0.1, 0.5 + rng() % 40 / 4.0);
+        depth.asks.emplace_back(2350.1 + i * 0.1, 0.5 + rng() % 40 / 4.0);
+    }
+    return depth;
+}
+
+int main() {
+    PrintHeader("Matches Depth::CalculateAvgPrice");
+
+    mt19937 rng(7);
+    Depth depth = MakeBook(400, rng);
+    DepthPricer pricer;
+    pricer.Build(depth);
+
+    bool same = true;
+    for (int i = 0; i < 2000 && same; i++) {
+        double target = (rng() % 100000) / 10.0;
+        same = Close(pricer.AvgPrice(Side::kBuy, target), depth.CalculateAvgPrice("buy", target)) &&
+               Close(pricer.AvgPrice(Side::kSell, target), depth.CalculateAvgPrice("sell", target));
+    }
+    Check(same, "2000 random sizes, both sides");
+
+    Check(pricer.AvgPrice(Side::kBuy, depth.asks[0].size) == depth.asks[0].price,
+          "Size within the best level prices at the best level");
+    Check(pricer.AvgPrice(Side::kBuy, pricer.AvailableSize(Side::kBuy) + 1) == 0,
+          "Book too thin gives 0");
+    Check(pricer.AvgPrice(Side::kSell, 0) == 0 && depth.CalculateAvgPrice(Side::kSell, 0) == 0,
+          "Size 0 gives 0");
+
+    Depth empty;
+    DepthPricer empty_pricer;
+    empty_pricer.Build(empty);
+    Check(empty_pricer.AvgPrice(Side::kBuy, 1) == 0, "Empty book gives 0");
+
+    OrderBook book("XAUT-USDT-SWAP");
+    book.SetVerifyChecksum(false);
+    book.ApplyMessage(R"({"action":"snapshot","data":[{"asks":[["2350.6","2","0","1"],["2350.8","3","0","1"]],)"
+                      R"("bids":[["2350.4","1","0","1"]],"ts":"1"}]})");
+    DepthPricer from_book;
+    from_book.Build(book);
+    Check(Close(from_book.AvgPrice(Side::kBuy, 4), (2350.6 * 2 + 2350.8 * 2) / 4) &&
+          from_book.AvgPrice(Side::kSell, 1) == 2350.4, "Build from OrderBook");
+
+    PrintHeader("Batch");
+
+    vector<Volume> ladder;
+    for (int i = 1; i <= 20; i++) ladder.push_back(i * 5.0);
+    vector<Price> prices;
+    pricer.AvgPrices(Side::kBuy, ladder, prices);
+    bool ladder_ok = prices.size() == ladder.size();
+    for (size_t i = 0; ladder_ok && i < ladder.size(); i++) {
+        ladder_ok = Close(prices[i], depth.CalculateAvgPrice(Side::kBuy, ladder[i]));
+    }
+    Check(ladder_ok, "Sorted ladder in one pass");
+
+    Price by_step[20];
+    pricer.AvgPricesForLadder(Side::kBuy, 5.0, 20, by_step);
+    bool step_ok = true;
+    for (int i = 0; i < 20; i++) step_ok = step_ok && by_step[i] == prices[i];
+    Check(step_ok, "AvgPricesForLadder matches explicit targets");
+
+    vector<Volume> unsorted = {40, 3, 0, 900, 12.5, 1};
+    pricer.AvgPrices(Side::kSell, unsorted, prices);
+    bool unsorted_ok = true;
+    for (size_t i = 0; i < unsorted.size(); i++) {
+        unsorted_ok = unsorted_ok && Close(prices[i], depth.CalculateAvgPrice(Side::kSell, unsorted[i]));
+    }
+    Check(unsorted_ok, "Unsorted targets");
+
+    PrintHeader("Benchmark: 20-step ladder on a 400-level book");
+
+    const int iterations = 20000;
+    double sink = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+        for (size_t i = 0; i < ladder.size(); i++) {
+            sink += depth.CalculateAvgPrice("buy", ladder[i] * 10);
+        }
+    }
+    double scalar_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    Price out[20];
+    start = chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+        pricer.Build(depth);
+        pricer.AvgPricesForLadder(Side::kBuy, 50.0, 20, out);
+        sink += out[19];
+    }
+    double batch_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    start = chrono::steady_clock::now();
+    for (int n = 0; n < iterations; n++) {
+        pricer.AvgPricesForLadder(Side::kBuy, 50.0, 20, out);
+        sink += out[19];
+    }
+    double query_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << fixed << setprecision(0);
+    cout << "  20 x CalculateAvgPrice(\"buy\")  : " << scalar_ns << " ns\n";
+    cout << "  Build + AvgPricesForLadder    : " << batch_ns << " ns\n";
+    cout << "  AvgPricesForLadder (built)    : " << query_ns << " ns\n";
+    Check(sink > 0 && query_ns < scalar_ns, "Batch ladder is faster than per-size walks");
+
+    return TestSummary();
+}
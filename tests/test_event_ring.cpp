@@ -0,0 +1,192 @@
+#include "event_ring.h"
+#include "market_event.h"
+#include "test_util.h"
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+struct Record {
+    uint32_t producer;
+    uint64_t value;
+};
+
+template <typename Ring>
+void PushRetry(Ring& ring, const Record& record) {
+    while (!ring.TryPush(record)) {
+        this_thread::yield();
+    }
+}
+
+int main() {
+    PrintHeader("SpscRing basics");
+
+    SpscRing<Record> ring(6);
+    Check(ring.Capacity() == 8, "Capacity rounded up to a power of two");
+
+    int pushed = 0;
+    while (ring.TryPush({0, static_cast<uint64_t>(pushed)})) pushed++;
+    Check(pushed == 8 && ring.Size() == 8, "Fills to capacity");
+    Check(!ring.TryPush({0, 99}) && ring.GetStatistics().overruns == 2,
+          "Full ring drops and counts overruns");
+
+    Record record{};
+    Check(ring.TryPop(record) && record.value == 0, "FIFO order");
+    uint64_t expected = 1;
+    bool in_order = true;
+    size_t drained = ring.Drain([&](const Record& r) { in_order = in_order && r.value == expected++; }, 4);
+    Check(drained == 4 && in_order && ring.Size() == 3, "Drain hands out a bounded batch in order");
+    ring.Drain([](const Record&) {});
+    Check(ring.Empty() && !ring.TryPop(record), "Empty after draining");
+
+    atomic<bool> stopped{false};
+    Check(!ring.Pop(record, stopped, EventRing::WaitMode::kYield), "Pop returns when stopped");
+
+    PrintHeader("SpscRing across threads");
+
+    const uint64_t count = 200000;
+    SpscRing<Record> spsc(1024);
+    atomic<bool> running{true};
+    thread producer([&] {
+        for (uint64_t i = 0; i < count; i++) PushRetry(spsc, {0, i});
+    });
+
+    uint64_t next = 0;
+    bool ordered = true;
+    while (next < count && spsc.Pop(record, running, EventRing::WaitMode::kYield)) {
+        ordered = ordered && record.value == next;
+        next++;
+    }
+    producer.join();
+    Check(next == count && ordered, "200000 records received in order");
+    Check(spsc.GetStatistics().pushed == count && spsc.GetStatistics().popped == count,
+          "pushed / popped counters");
+
+    PrintHeader("MpscRing across threads");
+
+    const int producers = 4;
+    const uint64_t per_producer = 50000;
+    MpscRing<Record> mpsc(1024);
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (uint64_t i = 0; i < per_producer; i++) PushRetry(mpsc, {static_cast<uint32_t>(p), i});
+        });
+    }
+
+    vector<uint64_t> next_value(producers, 0);
+    uint64_t received = 0;
+    bool per_producer_ordered = true;
+    while (received < producers * per_producer) {
+        received += mpsc.Drain([&](const Record& r) {
+            per_producer_ordered = per_producer_ordered && r.value == next_value[r.producer];
+            next_value[r.producer]++;
+        });
+        this_thread::yield();
+    }
+    for (auto& t : threads) t.join();
+    Check(received == producers * per_producer && per_producer_ordered,
+          "4 x 50000 records, each producer's records in order");
+
+    MpscRing<Record> small(2);
+    small.TryPush({0, 1});
+    small.TryPush({0, 2});
+    Check(!small.TryPush({0, 3}) && small.GetStatistics().overruns == 1, "MPSC overrun counted");
+    Check(small.TryPop(record) && record.value == 1 && small.TryPush({0, 3}), "Slot reused after pop");
+
+    PrintHeader("MarketEvent");
+
+    Tick tick;
+    tick.inst_id = "XAUT-USDT-SWAP";
+    tick.bid_price = 2350.4;
+    tick.ask_price = 2350.6;
+    tick.last_price = 2350.5;
+    tick.timestamp = 1700000000000ULL;
+    MarketEvent event;
+    MarketEvent::FromTick(tick, 42, event);
+    Tick back;
+    event.ToTick(back);
+    Check(event.type == MarketEvent::Type::kTick && event.InstId() == "XAUT-USDT-SWAP" &&
+          back.bid == 2350.4 && back.ask_price == 2350.6 && back.timestamp == tick.timestamp &&
+          event.receive_time_ns == 42, "Tick round trip");
+
+    Depth depth;
+    depth.inst_id = "XAUT-USDT-SWAP";
+    for (int i = 0; i < 8; i++) {
+        depth.bids.emplace_back(2350.0 - i, 1.0 + i);
+        depth.asks.emplace_back(2351.0 + i, 2.0 + i);
+    }
+    MarketEvent::FromDepth(depth, 0, event);
+    Depth top;
+    event.ToDepth(top);
+    Check(top.bids.size() == MarketEvent::kDepthLevels && top.asks[4].price == 2355.0 &&
+          top.bids[0].size == 1.0, "Depth cut to the top levels");
+
+    Order order;
+    order.inst_id = string(40, 'X');
+    order.order_id = "312269865356374016";
+    order.state = "partially_filled";
+    order.filled_size = 3;
+    MarketEvent::FromOrder(order, 0, event);
+    Order order_back;
+    event.ToOrder(order_back);
+    Check(event.InstId().size() == MarketEvent::kInstIdSize - 1 &&
+          order_back.order_id == order.order_id && order_back.state == "partially_filled" &&
+          order_back.filled_size == 3, "Order round trip, long text truncated");
+
+    cout << "  sizeof(MarketEvent) = " << sizeof(MarketEvent) << " bytes, sizeof(Tick) = "
+         << sizeof(Tick) << " bytes\n";
+
+#if defined(__linux__)
+    Check(EventRing::PinCurrentThread(0), "Pin thread to core 0");
+#endif
+
+    PrintHeader("Benchmark: hand-off cost per event");
+
+    const int iterations = 200000;
+    SpscRing<MarketEvent> event_ring(4096);
+    MarketEvent::FromTick(tick, 0, event);
+    MarketEvent out;
+    double sink = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        event.tick.bid = i;
+        event_ring.TryPush(event);
+        event_ring.TryPop(out);
+        sink += out.tick.bid;
+    }
+    double ring_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    // What a locked queue of legacy Ticks costs for the same hand-off
+    mutex queue_mutex;
+    deque<Tick> queue;
+    Tick popped;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        tick.bid_price = i;
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            queue.push_back(tick);
+        }
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            popped = queue.front();
+            queue.pop_front();
+        }
+        sink += popped.bid_price;
+    }
+    double queue_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << fixed << setprecision(1);
+    cout << "  SpscRing<MarketEvent> push+pop : " << ring_ns << " ns\n";
+    cout << "  mutex + deque<Tick> push+pop   : " << queue_ns << " ns\n";
+    Check(sink > 0 && ring_ns < queue_ns, "Ring hand-off is cheaper than a locked queue");
+
+    return TestSummary();
+}
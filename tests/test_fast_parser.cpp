@@ -0,0 +1,152 @@
+#include "okx_fast_parser.h"
+#include "nlohmann/json.hpp"
+#include "test_util.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using json = nlohmann::json;
+using namespace std;
+
+string MakeBook(int levels) {
+    ostringstream oss;
+    oss << "{\"code\":\"0\",\"msg\":\"\",\"data\":[{\"asks\":[";
+    for (int i = 0; i < levels; i++) {
+        if (i) oss << ",";
+        oss << "[\"" << fixed << setprecision(1) << 2350.5 + i * 0.1 << "\",\""
+            << setprecision(3) << 1.25 + i << "\",\"0\",\"" << (i % 7 + 1) << "\"]";
+    }
+    oss << "],\"bids\":[";
+    for (int i = 0; i < levels; i++) {
+        if (i) oss << ",";
+        oss << "[\"" << fixed << setprecision(1) << 2350.4 - i * 0.1 << "\",\""
+            << setprecision(3) << 2.5 + i << "\",\"0\",\"" << (i % 5 + 1) << "\"]";
+    }
+    oss << "],\"ts\":\"1700000000123\",\"checksum\":-855196043}]}";
+    return oss.str();
+}
+
+// The json DOM path OKXRestAPI used before (ParseOrderBook)
+Depth ParseBookWithDom(const string& body) {
+    json response = json::parse(body);
+    const json& data = response["data"][0];
+    Depth depth;
+    depth.timestamp = std::stoull(data.value("ts", "0"));
+    for (const auto& bid : data["bids"]) {
+        depth.bids.emplace_back(std::stod(bid[0].get<string>()), std::stod(bid[1].get<string>()));
+    }
+    for (const auto& ask : data["asks"]) {
+        depth.asks.emplace_back(std::stod(ask[0].get<string>()), std::stod(ask[1].get<string>()));
+    }
+    return depth;
+}
+
+int main() {
+    PrintHeader("Envelope");
+
+    OKXFastParser::Envelope env;
+    Check(OKXFastParser::ParseEnvelope(
+              " { \"code\" : \"51008\", \"msg\":\"Insufficient balance\", \"data\" : [ ] } ", env),
+          "Envelope with whitespace parsed");
+    Check(env.code == "51008" && env.msg == "Insufficient balance", "code/msg extracted");
+    string_view first;
+    Check(!OKXFastParser::FirstDataElement("{\"code\":\"0\",\"data\":[]}", first),
+          "Empty data has no first element");
+    Check(!OKXFastParser::ParseEnvelope("{\"code\":\"0\",\"data\":[{\"a\":\"1\"}", env),
+          "Truncated body rejected");
+    Check(!OKXFastParser::ParseEnvelope("<html>502 Bad Gateway</html>", env),
+          "Non-JSON body rejected");
+
+    PrintHeader("Ticker");
+
+    string ticker_body = R"({"code":"0","msg":"","data":[{"instType":"SWAP","instId":"XAUT-USDT-SWAP",
+        "last":"2351.2","lastSz":"0.5","askPx":"2351.3","askSz":"12","bidPx":"2351.1","bidSz":"7.5",
+        "open24h":"2300","high24h":"2360.8","low24h":"2298.1","volCcy24h":"1234.5","vol24h":"123450",
+        "ts":"1700000000456","sodUtc0":"2310","sodUtc8":"2320"}]})";
+    Tick tick;
+    Check(OKXFastParser::FirstDataElement(ticker_body, first) &&
+          OKXFastParser::ParseTicker(first, tick), "Ticker parsed");
+    Check(tick.inst_id == "XAUT-USDT-SWAP", "instId");
+    Check(tick.last_price == 2351.2 && tick.bid_price == 2351.1 && tick.ask_price == 2351.3,
+          "last/bid/ask prices");
+    Check(tick.bid_size == 7.5 && tick.ask_size == 12, "bid/ask sizes");
+    Check(tick.high_24h == 2360.8 && tick.low_24h == 2298.1, "24h high/low");
+    Check(tick.volume_24h == 123450 && tick.volume_currency_24h == 1234.5, "24h volumes");
+    Check(tick.timestamp == 1700000000456ULL, "ts");
+
+    PrintHeader("Order and position");
+
+    string order_body = R"({"code":"0","msg":"","data":[{"accFillSz":"0.5","avgPx":"2351.25",
+        "cTime":"1700000000001","clOrdId":"hedge\"01","fee":"-0.0123","instId":"XAUT-USDT-SWAP",
+        "lever":"20","ordId":"312269865356374016","ordType":"limit","pnl":"0","posSide":"long",
+        "px":"2350.5","side":"buy","slOrdPx":"","slTriggerPx":"","state":"partially_filled",
+        "sz":"1","tdMode":"cross","tpOrdPx":"-1","tpTriggerPx":"2400","uTime":"1700000000999",
+        "attachAlgoOrds":[{"attachAlgoId":"1","tpTriggerPx":"9"}]}]})";
+    Order order;
+    Check(OKXFastParser::FirstDataElement(order_body, first) &&
+          OKXFastParser::ParseOrder(first, order), "Order parsed");
+    Check(order.order_id == "312269865356374016" && order.inst_id == "XAUT-USDT-SWAP", "IDs");
+    Check(order.client_order_id == "hedge\"01", "Escaped string unescaped");
+    Check(order.side == "buy" && order.position_side == "long" && order.order_type == "limit" &&
+          order.trade_mode == "cross" && order.state == "partially_filled", "String fields");
+    Check(order.price == 2350.5 && order.size == 1 && order.filled_size == 0.5 &&
+          order.avg_fill_price == 2351.25 && order.fee == -0.0123, "Numeric fields");
+    Check(order.leverage == 20, "lever");
+    Check(order.tp_trigger_price == 2400 && order.tp_order_price == -1 &&
+          order.sl_trigger_price == 0, "TP/SL fields, nested objects skipped");
+    Check(order.create_time == 1700000000001ULL && order.update_time == 1700000000999ULL, "Times");
+
+    string position_body = R"({"code":"0","msg":"","data":[{"instId":"XAUT-USDT-SWAP","posSide":"net",
+        "pos":"-3","availPos":"3","avgPx":"2349.8","markPx":"2351","liqPx":"","upl":"-3.6",
+        "uplRatio":"-0.01","lever":"10","margin":"","mgnRatio":"12.5","imr":"705.3","mmr":"28.2",
+        "mgnMode":"cross","cTime":"1700000000000","uTime":"1700000000100"}]})";
+    Position pos;
+    Check(OKXFastParser::FirstDataElement(position_body, first) &&
+          OKXFastParser::ParsePosition(first, pos), "Position parsed");
+    Check(pos.position == -3 && pos.available_position == 3 && pos.avg_price == 2349.8 &&
+          pos.unrealized_pnl == -3.6 && pos.leverage == 10 && pos.liquidation_price == 0 &&
+          pos.trade_mode == "cross", "Position fields");
+
+    PrintHeader("400-level order book");
+
+    string book_body = MakeBook(400);
+    Depth fast_depth;
+    Check(OKXFastParser::FirstDataElement(book_body, first) &&
+          OKXFastParser::ParseOrderBook(first, fast_depth), "Book parsed");
+    Depth dom_depth = ParseBookWithDom(book_body);
+
+    bool same = fast_depth.bids.size() == 400 && fast_depth.asks.size() == 400 &&
+                fast_depth.timestamp == dom_depth.timestamp;
+    for (size_t i = 0; same && i < 400; i++) {
+        same = fast_depth.bids[i].price == dom_depth.bids[i].price &&
+               fast_depth.bids[i].size == dom_depth.bids[i].size &&
+               fast_depth.asks[i].price == dom_depth.asks[i].price &&
+               fast_depth.asks[i].size == dom_depth.asks[i].size;
+    }
+    Check(same, "Every level matches the json DOM + std::stod result");
+
+    const int iterations = 2000;
+    auto start = chrono::steady_clock::now();
+    size_t sink = 0;
+    for (int i = 0; i < iterations; i++) {
+        sink += ParseBookWithDom(book_body).bids.size();
+    }
+    double dom_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / iterations;
+
+    Depth reused;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        OKXFastParser::FirstDataElement(book_body, first);
+        OKXFastParser::ParseOrderBook(first, reused);
+        sink += reused.bids.size();
+    }
+    double fast_us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << fixed << setprecision(1);
+    cout << "  json DOM + stod : " << dom_us << " us/book\n";
+    cout << "  OKXFastParser   : " << fast_us << " us/book  (" << dom_us / fast_us << "x)\n";
+    Check(sink > 0 && fast_us < dom_us, "Fast parser is faster than the DOM path");
+
+    return TestSummary();
+}
@@ -0,0 +1,106 @@
+#include "fixed_point.h"
+#include "okx_fast_parser.h"
+#include "okx_request_builder.h"
+#include "test_util.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    PrintHeader("FixedScale");
+
+    FixedScale tick;
+    Check(FixedScale::FromStep("0.1", tick) && tick.Decimals() == 1 && tick.Step() == 1,
+          "tickSz 0.1");
+    FixedScale half;
+    Check(FixedScale::FromStep("0.5", half) && half.Decimals() == 1 && half.Step() == 5,
+          "tickSz 0.5 kept exact");
+    FixedScale lot;
+    Check(FixedScale::FromStep("1", lot) && lot.Decimals() == 0 && lot.Step() == 1, "lotSz 1");
+    FixedScale tiny;
+    Check(FixedScale::FromStep(0.00001, tiny) && tiny.Decimals() == 5, "Step from double 1e-5");
+    FixedScale trailing;
+    Check(FixedScale::FromStep("0.010", trailing) && trailing.Decimals() == 2 &&
+          trailing.Step() == 1, "Trailing zeros in step ignored");
+    FixedScale bad;
+    Check(!FixedScale::FromStep("0", bad) && !FixedScale::FromStep("-0.1", bad) &&
+          !FixedScale::FromStep("abc", bad), "Invalid steps rejected");
+
+    int64_t steps = 0;
+    Check(tick.Parse("2350.5", steps) && steps == 23505, "Parse 2350.5 -> 23505 ticks");
+    Check(tick.Parse("2350.50", steps) && steps == 23505, "Trailing zero accepted");
+    Check(!tick.Parse("2350.55", steps), "Off-grid price rejected");
+    Check(half.Parse("2350.5", steps) && steps == 4701, "0.5 grid");
+    Check(!half.Parse("2350.2", steps), "Off 0.5 grid rejected");
+    Check(tick.Parse("-1", steps) && steps == -10, "Negative (-1 = market TP/SL)");
+    Check(!tick.Parse("", steps) && !tick.Parse(".", steps) && !tick.Parse("1e3", steps),
+          "Malformed text rejected");
+
+    Check(tick.Round(2350.5) == 23505, "Round exact value");
+    Check(tick.Round(0.1 + 0.2) == 3, "Round 0.1+0.2 to 3 ticks");
+    Check(lot.Round(0.9999999) == 1, "Round size near 1");
+    Check(tick.ToDouble(23505) == 2350.5, "ToDouble");
+
+    Check(lot.ToString(1) == "1", "Size 1 formats as \"1\" (not 1.000000)");
+    Check(tick.ToString(23505) == "2350.5", "Price formats as \"2350.5\"");
+    Check(tick.ToString(23500) == "2350", "Whole price has no decimal point");
+    Check(tick.ToString(-10) == "-1", "Negative formats");
+    Check(tiny.ToString(1) == "0.00001", "Small step formats without exponent");
+    Check(half.ToString(3) == "1.5", "0.5 grid formats");
+
+    PrintHeader("Order body with scale");
+
+    InstrumentScale scale;
+    FixedScale::FromStep("0.1", scale.price);
+    FixedScale::FromStep("1", scale.size);
+
+    Order order;
+    order.inst_id = "XAUT-USDT-SWAP";
+    order.trade_mode = "cross";
+    order.side = "buy";
+    order.order_type = "limit";
+    order.size = 1;
+    order.price = 2350.5;
+
+    OKXRequestBuffer buffer;
+    OKXRequestBuilder::BuildPlaceOrder(order, buffer);
+    string legacy(buffer.body, buffer.body_length);
+    Check(legacy.find("\"sz\":\"1.000000\"") != string::npos, "Without scale: to_string format");
+
+    OKXRequestBuilder::BuildPlaceOrder(order, buffer, &scale);
+    string exact(buffer.body, buffer.body_length);
+    cout << "  " << exact << "\n";
+    Check(exact.find("\"sz\":\"1\"") != string::npos &&
+          exact.find("\"px\":\"2350.5\"") != string::npos, "With scale: exact px/sz");
+
+    order.price_ticks = 23506;
+    order.size_lots = 3;
+    OKXRequestBuilder::BuildPlaceOrder(order, buffer, &scale);
+    exact.assign(buffer.body, buffer.body_length);
+    Check(exact.find("\"sz\":\"3\"") != string::npos &&
+          exact.find("\"px\":\"2350.6\"") != string::npos, "price_ticks/size_lots take precedence");
+
+    PrintHeader("Parsing with scale");
+
+    string book = R"({"asks":[["2350.6","12","0","1"]],"bids":[["2350.5","3","0","2"]],"ts":"1"})";
+    Depth depth;
+    Check(OKXFastParser::ParseOrderBook(book, depth, &scale) && depth.fixed_point,
+          "Book parsed with scale");
+    Check(depth.asks.size() == 1 && depth.asks[0].price_ticks == 23506 &&
+          depth.asks[0].size_lots == 12, "Ask level ticks/lots");
+    Check(depth.bids.size() == 1 && depth.bids[0].price_ticks == 23505 &&
+          depth.bids[0].size_lots == 3 && depth.bids[0].price == 2350.5, "Bid level ticks/lots");
+    Check(OKXFastParser::ParseOrderBook(book, depth) && !depth.fixed_point &&
+          depth.bids[0].price_ticks == 0, "Without scale the fixed fields stay 0");
+
+    Tick tick_data;
+    Check(OKXFastParser::ParseTicker(R"({"bidPx":"2350.4","askPx":"2350.7"})", tick_data, &scale) &&
+          tick_data.bid_ticks == 23504 && tick_data.ask_ticks == 23507, "Ticker bid/ask ticks");
+
+    Order parsed;
+    Check(OKXFastParser::ParseOrder(R"({"px":"2350.5","sz":"2"})", parsed, &scale) &&
+          parsed.price_ticks == 23505 && parsed.size_lots == 2, "Order px/sz ticks/lots");
+
+    return TestSummary();
+}
@@ -0,0 +1,337 @@
+#include "okx_rest_api.h"
+#include "history_pager.h"
+#include "okx_signer.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// "/path?a=1&b=2" -> {a: 1, b: 2}
+map<string, string> QueryOf(const string& path) {
+    map<string, string> query;
+    size_t pos = path.find('?');
+    while (pos != string::npos) {
+        size_t next = path.find('&', pos + 1);
+        string pair = path.substr(pos + 1, next == string::npos ? string::npos : next - pos - 1);
+        size_t eq = pair.find('=');
+        if (eq != string::npos) {
+            query[pair.substr(0, eq)] = pair.substr(eq + 1);
+        }
+        pos = next;
+    }
+    return query;
+}
+
+double ElapsedMs(chrono::steady_clock::time_point start) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    mutex seen_mutex;
+    vector<string> seen;                // Paths, with query, in arrival order
+    atomic<int> total{1234};            // Records 1..total; id N is the Nth oldest
+    atomic<int> delay_ms{0};
+    atomic<int> signed_ok{0}, signed_bad{0};
+    OKXSigner signer("cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8", "4DD3E6E14B69380235D2D585DDE5B5B5", "Abc@123456");
+
+    // Serves ids newest first: after=X gives ids below X, before=X ids above it
+    LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        reply.delay_ms = delay_ms;
+        {
+            lock_guard<mutex> lock(seen_mutex);
+            seen.push_back(request.path);
+        }
+        // OKX signs timestamp + method + path with its query string + body
+        string expected = signer.Sign(request.Header("OK-ACCESS-TIMESTAMP"), request.method,
+                                      request.path, request.body);
+        (request.Header("OK-ACCESS-SIGN") == expected ? signed_ok : signed_bad)++;
+
+        map<string, string> query = QueryOf(request.path);
+        int limit = query.count("limit") ? stoi(query["limit"]) : 100;
+        int top = query.count("after") ? stoi(query["after"]) - 1 : total.load();
+        int bottom = query.count("before") ? stoi(query["before"]) + 1 : 1;
+        if (query.count("before") && !query.count("after")) {
+            top = min(total.load(), bottom + limit - 1);
+        }
+
+        string path = request.path.substr(0, request.path.find('?'));
+        json data = json::array();
+        for (int id = top; id >= bottom && static_cast<int>(data.size()) < limit; id--) {
+            string value = to_string(id);
+            if (path == "/api/v5/trade/fills") {
+                data.push_back({{"billId", value}, {"ordId", "ord" + value}, {"tradeId", "t" + value},
+                                {"instId", "XAUT-USDT-SWAP"}, {"side", "sell"}, {"fillPx", "2350.5"},
+                                {"fillSz", "1"}, {"fee", "-0.01"}, {"feeCcy", "USDT"},
+                                {"fillTime", to_string(1700000000000LL + id)}, {"execType", "T"}});
+            } else if (path == "/api/v5/account/bills") {
+                data.push_back({{"billId", value}, {"instId", "XAUT-USDT-SWAP"}, {"ccy", "USDT"},
+                                {"type", "2"}, {"balChg", "-0.01"}, {"bal", "1000"},
+                                {"ts", to_string(1700000000000LL + id)}});
+            } else {
+                data.push_back({{"ordId", value}, {"instId", "XAUT-USDT-SWAP"}, {"instType", "SWAP"},
+                                {"state", "filled"}, {"side", "sell"}, {"ordType", "limit"},
+                                {"px", "2350.5"}, {"sz", "1"}, {"cTime", to_string(1700000000000LL + id)}});
+            }
+        }
+        reply.body = json{{"code", "0"}, {"msg", ""}, {"data", data}}.dump();
+        return reply;
+    });
+    server.Start();
+
+    auto take_seen = [&] {
+        lock_guard<mutex> lock(seen_mutex);
+        vector<string> out;
+        out.swap(seen);
+        return out;
+    };
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig config;
+    config.base_url = server.BaseUrl();
+    config.api_key = "cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8";
+    config.secret_key = "4DD3E6E14B69380235D2D585DDE5B5B5";
+    config.passphrase = "Abc@123456";
+    config.max_retries = 1;
+    api.Initialize(config);
+
+    PrintHeader("Cursor parameters");
+
+    vector<Order> page = api.GetOrderHistory("", "", 0, 0, 10, "500");
+    Check(page.size() == 10 && page.front().order_id == "499" && page.back().order_id == "490",
+          "GetOrderHistory(after=500) returns the 10 older orders");
+    vector<OKXRestAPI::Fill> fills = api.GetFills("", 0, 0, 5, "", "1000");
+    Check(fills.size() == 5 && fills.front().bill_id == "1005" && fills.back().bill_id == "1001",
+          "GetFills(before=1000) returns newer fills with their billId");
+    vector<string> requests = take_seen();
+    Check(requests.size() == 2 && QueryOf(requests[0])["after"] == "500" && QueryOf(requests[1])["before"] == "1000",
+          "after / before sent as query parameters");
+    Check(signed_ok == 2 && signed_bad == 0, "Signature covers the path and its query string");
+
+    PrintHeader("Order history walk");
+
+    OKXRestAPI::HistoryQuery query;
+    query.inst_type = "SWAP";
+    query.state = "filled";
+    {
+        HistoryPager<Order> pager = api.IterateOrderHistory(query);
+        Check(take_seen().empty(), "Nothing requested before the first Next()");
+
+        Order order;
+        int expected = total;
+        bool ordered = true;
+        size_t max_buffered = 0;
+        while (pager.Next(order)) {
+            ordered = ordered && order.order_id == to_string(expected--);
+            max_buffered = max(max_buffered, pager.Buffered());
+        }
+        requests = take_seen();
+        cout << "  " << pager.Records() << " orders in " << pager.Pages() << " pages, at most "
+             << max_buffered << " buffered\n";
+        Check(pager.Records() == 1234 && ordered && expected == 0, "Every order once, newest first");
+        Check(pager.Pages() == 13 && requests.size() == 13, "13 requests; the short page ends the walk");
+        Check(max_buffered <= 200, "At most two pages held");
+        Check(!pager.Failed(), "Not failed");
+        Check(QueryOf(requests[0]).count("after") == 0 && QueryOf(requests[1])["after"] == "1135" &&
+              QueryOf(requests[12])["after"] == "35" && QueryOf(requests[12])["instType"] == "SWAP" &&
+              QueryOf(requests[12])["state"] == "filled", "Each request continues from the last ordId");
+    }
+
+    total = 300;
+    {
+        HistoryPager<Order> pager = api.IterateOrderHistory(query);
+        size_t count = 0;
+        for (const Order& order : pager) {
+            count += order.order_id.empty() ? 0 : 1;
+        }
+        requests = take_seen();
+        Check(count == 300 && requests.size() == 4 && !pager.Failed(),
+              "Exact multiple of the page size: ends on an empty page");
+    }
+
+    PrintHeader("Fills: range-for and resume");
+
+    total = 1234;
+    {
+        HistoryPager<OKXRestAPI::Fill> pager = api.IterateFills(query);
+        vector<string> ids;
+        for (const OKXRestAPI::Fill& fill : pager) {
+            ids.push_back(fill.bill_id);
+            if (ids.size() == 250) {
+                break;
+            }
+        }
+        string cursor = pager.Cursor();
+        Check(ids.size() == 250 && ids.back() == "985" && cursor == "985" && pager.Records() == 250,
+              "Stopped after 250 fills; cursor at the last one returned");
+        take_seen();
+
+        OKXRestAPI::HistoryQuery resume = query;
+        resume.after = cursor;
+        HistoryPager<OKXRestAPI::Fill> rest = api.IterateFills(resume);
+        OKXRestAPI::Fill fill;
+        size_t count = 0;
+        string first;
+        while (rest.Next(fill)) {
+            if (count++ == 0) {
+                first = fill.bill_id;
+            }
+        }
+        Check(first == "984" && count == 984 && fill.bill_id == "1" && fill.fill_price == 2350.5,
+              "A new walk resumes below the saved cursor");
+        take_seen();
+    }
+
+    PrintHeader("Prefetch");
+
+    total = 500;
+    delay_ms = 20;
+    auto consume = [&](bool prefetch) {
+        OKXRestAPI::HistoryQuery archive = query;
+        archive.prefetch = prefetch;
+        HistoryPager<Order> pager = api.IterateOrderArchive(archive);
+        auto start = chrono::steady_clock::now();
+        Order order;
+        size_t count = 0;
+        while (pager.Next(order)) {
+            if (count++ % 100 == 0) {
+                this_thread::sleep_for(chrono::milliseconds(20));     // Work on the page
+            }
+        }
+        double ms = ElapsedMs(start);
+        return count == 500 ? ms : -1.0;
+    };
+    double sequential_ms = consume(false);
+    double prefetch_ms = consume(true);
+    delay_ms = 0;
+    take_seen();
+    cout << fixed << setprecision(1) << "  20 ms server, 20 ms per page: sequential " << sequential_ms
+         << " ms, prefetch " << prefetch_ms << " ms\n";
+    Check(sequential_ms > 0 && prefetch_ms > 0 && prefetch_ms < sequential_ms * 0.85,
+          "Next page fetched while the current one is consumed");
+
+    PrintHeader("Bills: paced by the rate limiter");
+
+    total = 800;
+    {
+        OKXRestAPI::HistoryQuery bills = query;
+        bills.bill_type = 2;
+        HistoryPager<OKXRestAPI::Bill> pager = api.IterateBills(bills);
+        auto start = chrono::steady_clock::now();
+        OKXRestAPI::Bill bill;
+        size_t count = 0;
+        while (pager.Next(bill)) {
+            count++;
+        }
+        double ms = ElapsedMs(start);
+        requests = take_seen();
+        cout << "  " << requests.size() << " requests in " << ms << " ms\n";
+        Check(count == 800 && requests.size() == 9 && !pager.Failed(), "All 800 bills");
+        Check(ms >= 500, "9 requests at 5/s spread over more than a second's quota");
+        Check(QueryOf(requests[8])["type"] == "2" && QueryOf(requests[8])["after"] == "1",
+              "Bill walk continues from billId");
+
+        // The bucket is empty now: the prefetch queues behind the limiter
+        auto abandoned = make_unique<HistoryPager<OKXRestAPI::Bill>>(api.IterateBills(bills));
+        Check(abandoned->Next(bill) && bill.bill_id == "800", "First page of a walk left after one bill");
+        start = chrono::steady_clock::now();
+        abandoned.reset();
+        ms = ElapsedMs(start);
+        this_thread::sleep_for(chrono::milliseconds(400));
+        requests = take_seen();
+        Check(requests.size() == 1 && ms < 100, "Queued prefetch dropped unsent when the pager goes");
+    }
+
+    PrintHeader("Buffered");
+
+    total = 150;
+    {
+        HistoryPager<Order> pager = api.IterateOrderHistory(query);
+        Order order;
+        pager.Next(order);
+        auto start = chrono::steady_clock::now();
+        while (pager.Buffered() == 99 && ElapsedMs(start) < 2000) {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        Check(pager.Buffered() == 99 + 50, "A short prefetched page counts its real size");
+        take_seen();
+    }
+
+    server.Stop();
+    Check(signed_bad == 0, "Every page request signed over path and query");
+
+    PrintHeader("Retries and failure");
+
+    {
+        HistoryPager<int>::Options options;
+        options.page_size = 10;
+        options.retry_delay = chrono::milliseconds(1);
+
+        atomic<int> calls{0};
+        auto flaky = [&](const string& after, vector<int>& out, const atomic<bool>&) {
+            int call = ++calls;
+            if (call == 2 || call == 3) {
+                return false;       // Second page fails twice
+            }
+            int top = after.empty() ? 25 : stoi(after) - 1;
+            for (int id = top; id > 0 && out.size() < 10; id--) {
+                out.push_back(id);
+            }
+            return true;
+        };
+        HistoryPager<int> pager(flaky, [](const int& id) { return to_string(id); }, options);
+        int id = 0, count = 0;
+        while (pager.Next(id)) {
+            count++;
+        }
+        Check(count == 25 && id == 1 && !pager.Failed() && calls == 5, "Failed page retried, walk completed");
+
+        calls = 0;
+        auto broken = [&](const string& after, vector<int>& out, const atomic<bool>&) {
+            ++calls;
+            if (!after.empty()) {
+                return false;
+            }
+            for (int i = 100; i > 90; i--) {
+                out.push_back(i);
+            }
+            return true;
+        };
+        HistoryPager<int> failing(broken, [](const int& id) { return to_string(id); }, options);
+        count = 0;
+        while (failing.Next(id)) {
+            count++;
+        }
+        Check(count == 10 && failing.Failed() && calls == 1 + 1 + options.max_retries,
+              "Gives up after max_retries; Failed() set");
+
+        // Destroyed with a prefetch in flight
+        calls = 0;
+        auto slow = [&](const string&, vector<int>& out, const atomic<bool>&) {
+            ++calls;
+            this_thread::sleep_for(chrono::milliseconds(50));
+            out.assign(10, 7);
+            return true;
+        };
+        auto start = chrono::steady_clock::now();
+        {
+            HistoryPager<int> abandoned(slow, [](const int& id) { return to_string(id); }, options);
+            abandoned.Next(id);
+        }
+        double ms = ElapsedMs(start);
+        Check(calls <= 2 && ms < 150, "Abandoned walk stops its prefetch");
+    }
+
+    return TestSummary();
+}
@@ -0,0 +1,144 @@
+#include "http_client.h"
+#include "http_async_engine.h"
+#include "okx_rest_api.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <atomic>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+long ElapsedMs(chrono::steady_clock::time_point since) {
+    return static_cast<long>(chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - since).count());
+}
+
+int main() {
+    atomic<int> signed_requests{0};
+
+    LocalHttpServer server([&](const LocalHttpServer::Request& req) {
+        LocalHttpServer::Reply reply;
+        if (!req.Header("OK-ACCESS-SIGN").empty()) {
+            signed_requests++;
+        }
+        if (req.path == "/slow") {
+            reply.delay_ms = 300;
+            reply.body = "{\"code\":\"0\"}";
+        } else if (req.path == "/api/v5/trade/order") {
+            reply.delay_ms = 100;
+            reply.body = "{\"code\":\"0\",\"msg\":\"\",\"data\":[{\"ordId\":\"312269865356374016\","
+                         "\"clOrdId\":\"\",\"sCode\":\"0\",\"sMsg\":\"\"}]}";
+        } else if (req.path == "/api/v5/trade/cancel-order") {
+            reply.body = "{\"code\":\"0\",\"msg\":\"\",\"data\":[{\"ordId\":\"1\",\"sCode\":\"0\"}]}";
+        } else {
+            reply.status = 404;
+        }
+        return reply;
+    });
+    if (!server.Start()) {
+        cerr << "Failed to start local HTTP server\n";
+        return 1;
+    }
+
+    PrintHeader("SubmitAsync does not block the caller");
+
+    HttpClient client;
+    HttpClient::RequestOptions options;
+    options.max_requests_per_second = 0;
+    client.Initialize(options);
+
+    auto start = chrono::steady_clock::now();
+    atomic<int> callbacks{0};
+    vector<future<HttpClient::Response>> futures;
+    for (int i = 0; i < 8; i++) {
+        futures.push_back(client.SubmitAsync("GET", server.BaseUrl() + "/slow", "", {},
+            [&](const HttpClient::Response&) { callbacks++; }));
+    }
+    long submit_ms = ElapsedMs(start);
+
+    bool all_ok = true;
+    for (auto& f : futures) {
+        all_ok = all_ok && f.get().IsSuccess();
+    }
+    long total_ms = ElapsedMs(start);
+
+    cout << "  submit: " << submit_ms << " ms, all done: " << total_ms << " ms\n";
+    Check(submit_ms < 50, "Submitting 8 requests returned immediately");
+    Check(all_ok, "All async requests succeeded");
+    Check(callbacks == 8, "Completion callback ran for each request");
+    Check(total_ms < 8 * 300, "Requests ran concurrently on the I/O thread");
+    Check(client.GetStatistics().successful_requests == 8, "Statistics updated");
+
+    auto not_found = client.SubmitAsync("POST", server.BaseUrl() + "/missing", "{}").get();
+    Check(not_found.status_code == 404, "HTTP status propagated");
+
+    PrintHeader("OKXRestAPI PlaceOrderAsync / CancelOrderAsync");
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig config;
+    config.base_url = server.BaseUrl();
+    config.api_key = "key";
+    config.secret_key = "secret";
+    config.passphrase = "pass";
+    api.Initialize(config);
+
+    Order order;
+    order.inst_id = "XAUT-USDT-SWAP";
+    order.trade_mode = "cross";
+    order.side = "buy";
+    order.order_type = "market";
+    order.size = 1;
+
+    start = chrono::steady_clock::now();
+    future<string> order_id = api.PlaceOrderAsync(order);
+    future<bool> canceled = api.CancelOrderAsync("XAUT-USDT-SWAP", "1");
+    long fire_ms = ElapsedMs(start);
+
+    Check(fire_ms < 50, "Order and cancel fired without waiting for the round trip");
+    Check(order_id.get() == "312269865356374016", "Order ID delivered through future");
+    Check(canceled.get(), "Cancel result delivered through future");
+    Check(signed_requests == 2, "Async private requests were signed");
+
+    PrintHeader("Submit racing Stop");
+
+    // Every accepted request must complete, even if Stop() lands between
+    // Submit()'s running check and its queue push
+    bool every_completed = true;
+    bool drained = true;
+    for (int round = 0; round < 20; round++) {
+        HttpAsyncEngine engine(options, nullptr);
+        engine.Start();
+        atomic<int> accepted{0};
+        atomic<int> completed{0};
+        vector<thread> submitters;
+        for (int t = 0; t < 4; t++) {
+            submitters.emplace_back([&] {
+                for (int i = 0; i < 50; i++) {
+                    HttpAsyncEngine::Request request;
+                    request.method = "GET";
+                    request.url = server.BaseUrl() + "/missing";
+                    request.on_complete = [&](HttpClient::Response&) { completed++; };
+                    if (engine.Submit(std::move(request)) != 0) {
+                        accepted++;
+                    }
+                }
+            });
+        }
+        this_thread::sleep_for(chrono::microseconds(200 * (round % 5)));
+        engine.Stop();
+        for (auto& submitter : submitters) {
+            submitter.join();
+        }
+        every_completed = every_completed && completed == accepted;
+        drained = drained && engine.InFlight() == 0;
+    }
+    Check(every_completed, "Each accepted request completed across 20 stop races");
+    Check(drained, "Nothing left in flight after Stop()");
+
+    server.Stop();
+
+    return TestSummary();
+}
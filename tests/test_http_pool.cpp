@@ -0,0 +1,92 @@
+#include "http_client.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+int main() {
+    LocalHttpServer server([](const LocalHttpServer::Request& req) {
+        LocalHttpServer::Reply reply;
+        if (req.path == "/slow") {
+            reply.delay_ms = 600;
+        }
+        reply.body = "{\"code\":\"0\",\"path\":\"" + req.path + "\"}";
+        return reply;
+    });
+    if (!server.Start()) {
+        cerr << "Failed to start local HTTP server\n";
+        return 1;
+    }
+
+    HttpClient client;
+    HttpClient::RequestOptions options;
+    options.pool_size = 2;
+    options.max_requests_per_second = 0;
+    Check(client.Initialize(options), "Initialize pool of 2 handles");
+
+    PrintHeader("Slow request does not block a fast one");
+
+    auto slow_start = chrono::steady_clock::now();
+    thread slow([&] { client.Get(server.BaseUrl() + "/slow"); });
+
+    this_thread::sleep_for(chrono::milliseconds(50));
+    auto fast_start = chrono::steady_clock::now();
+    HttpClient::Response fast = client.Get(server.BaseUrl() + "/fast");
+    auto fast_ms = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - fast_start).count();
+    slow.join();
+    auto slow_ms = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now() - slow_start).count();
+
+    cout << "  fast: " << fast_ms << " ms, slow: " << slow_ms << " ms\n";
+    Check(fast.IsSuccess(), "Fast request succeeded");
+    Check(fast_ms < 300, "Fast request finished while slow one was in flight");
+
+    PrintHeader("Handles keep their connections");
+
+    for (int i = 0; i < 10; i++) {
+        client.Post(server.BaseUrl() + "/post", "{\"i\":1}");
+        client.Delete(server.BaseUrl() + "/delete");
+    }
+    cout << "  server connections: " << server.ConnectionCount() << "\n";
+    Check(server.ConnectionCount() <= 2, "At most one connection per pooled handle");
+
+    PrintHeader("Pool statistics");
+
+    auto pool = client.GetPoolStatistics();
+    cout << "  pool_size: " << pool.pool_size << "\n";
+    cout << "  checkouts: " << pool.checkouts << "\n";
+    cout << "  peak_in_use: " << pool.peak_in_use << "\n";
+    cout << "  checkout_waits: " << pool.checkout_waits << "\n";
+    Check(pool.pool_size == 2, "Pool size reported");
+    Check(pool.checkouts == 22, "Every request checked out a handle");
+    Check(pool.peak_in_use == 2, "Two handles were in use concurrently");
+    Check(pool.in_use == 0, "All handles returned");
+
+    auto stats = client.GetStatistics();
+    Check(stats.total_requests == 22 && stats.successful_requests == 22,
+          "Request statistics updated");
+
+    PrintHeader("Exhausted pool times out");
+
+    HttpClient tiny;
+    HttpClient::RequestOptions tiny_options;
+    tiny_options.pool_size = 1;
+    tiny_options.checkout_timeout_ms = 100;
+    tiny_options.max_requests_per_second = 0;
+    tiny.Initialize(tiny_options);
+
+    thread holder([&] { tiny.Get(server.BaseUrl() + "/slow"); });
+    this_thread::sleep_for(chrono::milliseconds(50));
+    HttpClient::Response rejected = tiny.Get(server.BaseUrl() + "/fast");
+    holder.join();
+    Check(!rejected.IsSuccess(), "Request failed when no handle became free");
+    Check(tiny.GetPoolStatistics().checkout_timeouts == 1, "Timeout counted");
+
+    server.Stop();
+
+    return TestSummary();
+}
@@ -0,0 +1,157 @@
+#include "instrument_registry.h"
+#include "config.h"
+#include "okx_rest_api.h"
+#include "tick_pod.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+
+const char* kConfig = R"({
+  "environment": "simulation",
+  "okx": {"symbols": {"XAUT": "XAUT-USDT-SWAP", "BTC": "BTC-USDT-SWAP", "ETH": "ETH-USDT"}},
+  "mt5": {"symbols": {"XAUT": "XAUUSD", "BTC": "BTCUSD"}}
+})";
+
+const char* kSwapInstruments =
+    R"({"code":"0","msg":"","data":[)"
+    R"({"instType":"SWAP","instId":"BTC-USDT-SWAP","ctVal":"0.01","tickSz":"0.1","lotSz":"0.01","minSz":"0.01","state":"live"},)"
+    R"({"instType":"SWAP","instId":"DOGE-USDT-SWAP","ctVal":"1000","tickSz":"0.00001","lotSz":"1","minSz":"1","state":"live"},)"
+    R"({"instType":"SWAP","instId":"XAUT-USDT-SWAP","ctVal":"0.001","tickSz":"0.1","lotSz":"1","minSz":"1","state":"live"}]})";
+
+const char* kFuturesInstruments =
+    R"({"code":"0","msg":"","data":[)"
+    R"({"instType":"FUTURES","instId":"BTC-USD-240628","ctVal":"100","tickSz":"0.1","lotSz":"1","minSz":"1","state":"live"}]})";
+
+const char* kSpotInstruments =
+    R"({"code":"0","msg":"","data":[)"
+    R"({"instType":"SPOT","instId":"ETH-USDT","tickSz":"0.01","lotSz":"0.000001","minSz":"0.0001","state":"live"}]})";
+
+int main() {
+    PrintHeader("Registry from Config");
+
+    const string path = "test_instrument_registry_" + to_string(getpid()) + ".json";
+    ofstream(path) << kConfig;
+    Config& config = Config::Instance();
+    bool config_loaded = config.Load(path);
+    remove(path.c_str());
+    Check(config_loaded, "Config loaded");
+
+    InstrumentRegistry registry;
+    Check(registry.LoadFromConfig(config) == 3 && registry.Size() == 3, "Three instruments registered");
+
+    InstrumentRegistry::Id xaut = registry.FindByBase("XAUT");
+    InstrumentRegistry::Id eth = registry.FindByInstId("ETH-USDT");
+    Check(xaut != InstrumentRegistry::kInvalidId && registry.FindByInstId("XAUT-USDT-SWAP") == xaut &&
+          registry.FindByMT5Symbol("XAUUSD") == xaut, "inst_id <-> MT5 symbol <-> id");
+    Check(registry.Get(xaut).inst_type == InstrumentRegistry::InstType::kSwap &&
+          registry.Get(eth).inst_type == InstrumentRegistry::InstType::kSpot &&
+          registry.Get(eth).mt5_symbol.empty(), "instType derived once; OKX-only instrument");
+    Check(registry.FindByInstId("SOL-USDT") == InstrumentRegistry::kInvalidId &&
+          registry.Add("XAUT", "XAUT-USDT-SWAP") == xaut, "Unknown lookup / duplicate add");
+    Check(registry.InstTypes().size() == 2, "Two instTypes to load");
+
+    using InstType = InstrumentRegistry::InstType;
+    Check(InstrumentRegistry::InstTypeFromInstId("BTC-USDT-SWAP") == InstType::kSwap &&
+          InstrumentRegistry::InstTypeFromInstId("BTC-USD-240628") == InstType::kFutures &&
+          InstrumentRegistry::InstTypeFromInstId("BTC-USD-240628-50000-C") == InstType::kOption &&
+          InstrumentRegistry::InstTypeFromInstId("ETH-USD-241227-3500-P") == InstType::kOption &&
+          InstrumentRegistry::InstTypeFromInstId("BTC-USDT") == InstType::kSpot &&
+          InstrumentRegistry::InstTypeFromInstId("BTC-USD-2406") == InstType::kSpot,
+          "instType from real OKX instIds");
+
+    Tick okx_tick, mt5_tick;
+    okx_tick.inst_id = "XAUT-USDT-SWAP";
+    mt5_tick.symbol = "XAUUSD";
+    TickPOD okx_pod, mt5_pod;
+    TickPOD::FromTick(okx_tick, okx_pod);
+    TickPOD::FromTick(mt5_tick, mt5_pod);
+    Check(registry.FindBySymbolId(okx_pod.symbol_id) == xaut && registry.FindBySymbolId(mt5_pod.symbol_id) == xaut,
+          "TickPOD from either platform maps to the same id");
+
+    PrintHeader("Batch preload from /public/instruments");
+
+    atomic<int> requests{0};
+    LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+        requests++;
+        LocalHttpServer::Reply reply;
+        if (request.path.find("/api/v5/public/instruments?instType=SWAP") == 0) {
+            reply.body = kSwapInstruments;
+        } else if (request.path.find("/api/v5/public/instruments?instType=SPOT") == 0) {
+            reply.body = kSpotInstruments;
+        } else if (request.path.find("/api/v5/public/instruments?instType=FUTURES") == 0) {
+            reply.body = kFuturesInstruments;
+        } else {
+            reply.status = 404;
+        }
+        return reply;
+    });
+    server.Start();
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig api_config;
+    api_config.base_url = server.BaseUrl();
+    api.Initialize(api_config);
+
+    Check(api.LoadInstruments(registry) == 3 && requests.load() == 2, "All specs loaded with one request per instType");
+    const InstrumentRegistry::Instrument& gold = registry.Get(xaut);
+    Check(gold.loaded && gold.contract_val == 0.001 && gold.tick_size == 0.1 && gold.min_size == 1 &&
+          gold.scale.price.Round(2350.44) == 23504, "Specs and fixed-point scale filled");
+    InstrumentScale scale;
+    Check(api.GetInstrumentScale("ETH-USDT", scale) && scale.size.Round(0.5) == 500000,
+          "Scales registered with the REST client");
+    Check(registry.FindByInstId("DOGE-USDT-SWAP") == InstrumentRegistry::kInvalidId,
+          "Unregistered instruments in the response are ignored");
+    Check(api.GetInstrumentScale(xaut, scale) && scale.price.Round(2350.44) == 23504 &&
+          !api.GetInstrumentScale(InstrumentRegistry::Id(99), scale), "Scale by registry id");
+
+    Order order;
+    order.inst_id = "XAUT-USDT-SWAP";
+    order.instrument_id = xaut;
+    order.trade_mode = "cross";
+    order.side = "buy";
+    order.order_type = "limit";
+    order.size = 1;
+    order.price = 2350.4;
+    OKXOrderTemplate order_template;
+    OKXRequestBuffer buffer;
+    Check(api.ArmOrderTemplate(order, order_template) && order_template.RenderTicks(23504, "", buffer),
+          "Template armed with the scale found by instrument_id");
+
+    InstrumentRegistry dated;
+    InstrumentRegistry::Id quarterly = dated.Add("BTC", "BTC-USD-240628");
+    requests = 0;
+    Check(api.LoadInstruments(dated) == 1 && requests.load() == 1 && dated.Get(quarterly).loaded &&
+          dated.Get(quarterly).contract_val == 100, "Dated futures loaded from the FUTURES list");
+
+    server.Stop();
+
+    PrintHeader("Benchmark: symbol lookup");
+
+    const int iterations = 200000;
+    size_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink += config.GetOKXSymbol("XAUT").size();
+    }
+    double config_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink += registry.Get(registry.FindBySymbolId(mt5_pod.symbol_id)).inst_id.size();
+    }
+    double registry_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << fixed << setprecision(1);
+    cout << "  Config::GetOKXSymbol  : " << config_ns << " ns\n";
+    cout << "  registry by id        : " << registry_ns << " ns\n";
+    Check(sink > 0 && registry_ns < config_ns, "Id lookup is cheaper than the JSON lookup");
+
+    return TestSummary();
+}
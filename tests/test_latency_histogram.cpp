@@ -0,0 +1,204 @@
+#include "latency_histogram.h"
+#include "okx_rest_api.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+bool Within(uint64_t value, uint64_t expected, double tolerance) {
+    double delta = static_cast<double>(value) - static_cast<double>(expected);
+    return delta <= expected * tolerance && -delta <= expected * tolerance;
+}
+
+const char* kTickerBody =
+    R"({"code":"0","msg":"","data":[{"instType":"SWAP","instId":"XAUT-USDT-SWAP","last":"2350.5",)"
+    R"("bidPx":"2350.4","bidSz":"3","askPx":"2350.6","askSz":"5","ts":"1700000000000"}]})";
+
+int main() {
+    PrintHeader("Bucket layout");
+
+    bool bounds_ok = true;
+    bool monotonic = true;
+    size_t previous = 0;
+    mt19937_64 random(7);
+    for (int i = 0; i < 200000; i++) {
+        uint64_t value = random() >> (random() % 64);
+        value %= uint64_t(1) << LatencyHistogram::kMaxBits;
+        size_t index = LatencyHistogram::BucketIndex(value);
+        uint64_t lower = LatencyHistogram::BucketLowerBound(index);
+        uint64_t upper = LatencyHistogram::BucketUpperBound(index);
+        bounds_ok = bounds_ok && index < LatencyHistogram::kBucketCount && lower <= value && value <= upper &&
+                    (upper - lower) * 64 <= lower;
+    }
+    for (uint64_t value = 0; value < (uint64_t(1) << 22); value++) {
+        size_t index = LatencyHistogram::BucketIndex(value);
+        monotonic = monotonic && index >= previous && index <= previous + 1;
+        previous = index;
+    }
+    Check(bounds_ok, "Every value inside its bucket, buckets at most 1/64 wide");
+    Check(monotonic, "Buckets contiguous and increasing");
+    Check(LatencyHistogram::BucketIndex(uint64_t(1) << 50) == LatencyHistogram::kBucketCount - 1 &&
+          LatencyHistogram::BucketIndex(~uint64_t(0)) == LatencyHistogram::kBucketCount - 1,
+          "Values past 2^kMaxBits ns clamp to the last bucket");
+
+    PrintHeader("Percentiles");
+
+    LatencyHistogram uniform;
+    for (int64_t ns = 1; ns <= 100000; ns++) {
+        uniform.Record(ns);
+    }
+    LatencyHistogram::Snapshot snapshot = uniform.GetSnapshot();
+    Check(snapshot.count == 100000 && snapshot.min_ns == 1 && snapshot.max_ns == 100000 &&
+          snapshot.Mean() == 50000.5, "Count, min, max and mean exact");
+    Check(Within(snapshot.ValueAtPercentile(50), 50000, 0.016) &&
+          Within(snapshot.ValueAtPercentile(99), 99000, 0.016) &&
+          Within(snapshot.ValueAtPercentile(99.9), 99900, 0.016) &&
+          snapshot.ValueAtPercentile(100) == 100000, "p50 / p99 / p99.9 within 1.6% on 1..100000 ns");
+
+    // What the old running average could not show
+    LatencyHistogram spiky;
+    for (int i = 0; i < 9990; i++) {
+        spiky.Record(800000);             // 0.8 ms
+    }
+    for (int i = 0; i < 10; i++) {
+        spiky.Record(250000000);          // 250 ms stall
+    }
+    snapshot = spiky.GetSnapshot();
+    cout << fixed << setprecision(3);
+    cout << "  mean " << snapshot.Mean() / 1e6 << " ms, p50 " << snapshot.ValueAtPercentile(50) / 1e6
+         << " ms, p99.9 " << snapshot.ValueAtPercentile(99.9) / 1e6 << " ms, p99.99 "
+         << snapshot.ValueAtPercentile(99.99) / 1e6 << " ms\n";
+    Check(Within(snapshot.ValueAtPercentile(50), 800000, 0.016) &&
+          Within(snapshot.ValueAtPercentile(99.9), 800000, 0.016) &&
+          Within(snapshot.ValueAtPercentile(99.99), 250000000, 0.016),
+          "Tail stalls visible at p99.99 while the mean looks harmless");
+
+    uniform.Reset();
+    uniform.Record(-5);
+    snapshot = uniform.GetSnapshot();
+    Check(snapshot.count == 1 && snapshot.max_ns == 0, "Reset, negative values count as 0");
+
+    LatencyHistogram::Snapshot merged = spiky.GetSnapshot();
+    merged.Merge(snapshot);
+    Check(merged.count == 10001 && merged.min_ns == 0, "Snapshots merge");
+
+    PrintHeader("Concurrent recording");
+
+    LatencyHistogram shared;
+    vector<thread> threads;
+    const int per_thread = 200000;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&shared, t] {
+            for (int i = 0; i < per_thread; i++) {
+                shared.Record(1000 * (t + 1) + i % 1000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    snapshot = shared.GetSnapshot();
+    Check(snapshot.count == 4u * per_thread && snapshot.min_ns == 1000 && snapshot.max_ns == 4999,
+          "No samples lost across 4 writer threads");
+
+    const int iterations = 2000000;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        shared.Record(i & 0xFFFFF);
+    }
+    double record_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+    cout << "  Record(): " << setprecision(1) << record_ns << " ns\n";
+
+    PrintHeader("Per-endpoint stages from OKXRestAPI");
+
+    LocalHttpServer server([](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        if (request.path.find("/api/v5/market/ticker") == 0) {
+            reply.body = kTickerBody;
+        } else if (request.path == "/api/v5/trade/order") {
+            reply.body = R"({"code":"0","msg":"","data":[{"ordId":"42","clOrdId":"","sCode":"0","sMsg":""}]})";
+        } else {
+            reply.status = 404;
+        }
+        return reply;
+    });
+    server.Start();
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig api_config;
+    api_config.base_url = server.BaseUrl();
+    api_config.http_pool_size = 1;
+    api.Initialize(api_config);
+
+    const int requests = 20;
+    bool tickers_ok = true;
+    for (int i = 0; i < requests; i++) {
+        tickers_ok = tickers_ok && api.GetTicker("XAUT-USDT-SWAP").bid_price == 2350.4;
+    }
+    Order order;
+    order.inst_id = "XAUT-USDT-SWAP";
+    order.side = "buy";
+    order.order_type = "limit";
+    order.price = 2350;
+    order.size = 1;
+    Check(tickers_ok && api.PlaceOrderAsync(order).get() == "42", "Requests served");
+
+    // kDispatch covers the completion callback, so it lands just after the future is ready
+    LatencyRegistry::Snapshot latency = api.GetLatencySnapshot();
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(2);
+    while (latency["POST /api/v5/trade/order"].Stage(LatencyStage::kDispatch).count == 0 &&
+           chrono::steady_clock::now() < deadline) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+        latency = api.GetLatencySnapshot();
+    }
+    const LatencyRegistry::EndpointSnapshot& ticker = latency["GET /api/v5/market/ticker"];
+    Check(ticker.Stage(LatencyStage::kTotal).count == requests &&
+          ticker.Stage(LatencyStage::kTtfb).count == requests &&
+          ticker.Stage(LatencyStage::kParse).count == requests, "ttfb / total / parse per request");
+    Check(ticker.Stage(LatencyStage::kConnect).count >= 1 &&
+          ticker.Stage(LatencyStage::kConnect).count < static_cast<uint64_t>(requests) &&
+          ticker.Stage(LatencyStage::kTls).count == 0, "connect only for new connections, no TLS on http");
+    Check(ticker.Stage(LatencyStage::kTtfb).ValueAtPercentile(50) <=
+          ticker.Stage(LatencyStage::kTotal).ValueAtPercentile(100) &&
+          ticker.Stage(LatencyStage::kTotal).min_ns > 0, "Timings in nanoseconds and ordered");
+    const LatencyRegistry::EndpointSnapshot& place = latency["POST /api/v5/trade/order"];
+    Check(place.Stage(LatencyStage::kTotal).count == 1 && place.Stage(LatencyStage::kDispatch).count == 1,
+          "Async completion dispatch timed");
+
+    nlohmann::json exported = LatencyRegistry::ToJson(latency);
+    Check(exported["GET /api/v5/market/ticker"]["total"]["count"] == requests &&
+          exported["GET /api/v5/market/ticker"]["total"].contains("p999_ns") &&
+          !exported["GET /api/v5/market/ticker"].contains("tls"), "Snapshot exported as JSON");
+    cout << "  ticker total: " << exported["GET /api/v5/market/ticker"]["total"]["p50_ns"] << " ns p50, "
+         << exported["GET /api/v5/market/ticker"]["total"]["p99_ns"] << " ns p99\n";
+
+    api.ResetLatency();
+    Check(api.GetLatencySnapshot()["GET /api/v5/market/ticker"].Stage(LatencyStage::kTotal).count == 0,
+          "ResetLatency clears the histograms");
+
+    PrintHeader("HttpClient response times");
+
+    HttpClient client;
+    HttpClient::RequestOptions options;
+    options.max_requests_per_second = 0;
+    client.Initialize(options);
+    for (int i = 0; i < 5; i++) {
+        client.Get(server.BaseUrl() + "/api/v5/market/ticker");
+    }
+    HttpClient::Response response = client.Get(server.BaseUrl() + "/api/v5/market/ticker");
+    Check(response.response_time_ns > 0 && response.timings.total_ns > 0 &&
+          !response.timings.new_connection, "Response carries ns timings, connection reused");
+    Check(client.GetResponseTimeHistogram().count == 6 && client.GetStatistics().avg_response_time_ms > 0,
+          "Response time histogram and fractional average");
+
+    server.Stop();
+
+    return TestSummary();
+}
@@ -0,0 +1,189 @@
+#include "market_data_bridge.h"
+#include "nlohmann/json.hpp"
+#include "test_util.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+extern "C" {
+struct BridgeReaderResult {
+    long reads;
+    long torn;
+    long out_of_order;
+};
+int RunBridgeReader(const char* name, const char* symbol, uint64_t final_count,
+                    int64_t timeout_ns, BridgeReaderResult* result);
+}
+
+// Same invariants bridge_reader.c checks for torn reads
+void MakeQuote(uint64_t n, OKXBridgeQuote& quote) {
+    quote.bid = 2000.0 + (n % 4096) * 0.25;
+    quote.ask = quote.bid + 0.5;
+    quote.last = quote.bid + 0.25;
+    quote.bid_size = static_cast<double>(n);
+    quote.ask_size = static_cast<double>(n);
+    quote.exchange_time = 1700000000000ULL + n;
+    quote.update_time_ns = MarketDataBridge::NowNs();
+    quote.update_count = n;
+}
+
+void MakeBook(uint64_t n, OKXBridgeBook& book) {
+    double bid = 2000.0 + (n % 4096) * 0.25;
+    book.bid_count = OKX_BRIDGE_BOOK_LEVELS;
+    book.ask_count = OKX_BRIDGE_BOOK_LEVELS;
+    for (int i = 0; i < OKX_BRIDGE_BOOK_LEVELS; i++) {
+        book.bid_price[i] = bid - i;
+        book.ask_price[i] = bid + 0.5 + i;
+        book.bid_size[i] = book.ask_size[i] = static_cast<double>(n);
+    }
+    book.exchange_time = 1700000000000ULL + n;
+    book.update_time_ns = MarketDataBridge::NowNs();
+    book.update_count = n;
+}
+
+int main() {
+    const string name = "okx_bridge_test_" + to_string(getpid());
+
+    PrintHeader("Writer and C reader API in one process");
+
+    Check(OKX_BridgeOpen(name.c_str()) == -1, "Open fails before the segment exists");
+
+    MarketDataBridge writer;
+    Check(writer.Create(name, 4), "Segment created");
+    int slot = writer.AddSymbol("XAUT-USDT-SWAP");
+    Check(slot == 0 && writer.AddSymbol("XAUT-USDT-SWAP") == 0, "Symbol added once");
+    Check(writer.AddSymbol(string(OKX_BRIDGE_SYMBOL_SIZE, 'X')) == -1, "Over-long symbol rejected");
+
+    int handle = OKX_BridgeOpen(name.c_str());
+    Check(handle >= 0 && OKX_BridgeSymbolCount(handle) == 1, "Reader maps the segment");
+    Check(OKX_BridgeFindSymbol(handle, "XAUT-USDT-SWAP") == 0 &&
+          OKX_BridgeFindSymbol(handle, "BTC-USDT") == -1, "Symbol lookup");
+
+    OKXBridgeQuote quote;
+    OKXBridgeBook book;
+    Check(OKX_BridgeReadQuote(handle, 0, &quote) == 0 && OKX_BridgeReadBook(handle, 0, &book) == 0,
+          "Nothing to read before the first publish");
+    Check(OKX_BridgeReadQuote(handle, 1, &quote) == -1 && OKX_BridgeReadQuote(99, 0, &quote) == -1,
+          "Unknown slot / handle rejected");
+
+    Tick tick;
+    tick.inst_id = "XAUT-USDT-SWAP";
+    tick.bid_price = 2350.4;
+    tick.ask_price = 2350.6;
+    tick.last_price = 2350.5;
+    tick.bid_size = 3;
+    tick.timestamp = 1700000000000ULL;
+    Check(writer.PublishTick(tick), "PublishTick");
+    Check(OKX_BridgeReadQuote(handle, 0, &quote) == 1 && quote.bid == 2350.4 && quote.ask == 2350.6 &&
+          quote.bid_size == 3 && quote.exchange_time == tick.timestamp && quote.update_count == 1,
+          "Quote read back");
+    Check(quote.update_time_ns <= OKX_BridgeNowNs(), "update_time_ns on the shared clock");
+
+    Depth depth;
+    depth.inst_id = "BTC-USDT";
+    for (int i = 0; i < 12; i++) {
+        depth.bids.emplace_back(60000.0 - i, 1.0 + i);
+        depth.asks.emplace_back(60001.0 + i, 2.0 + i);
+    }
+    Check(writer.PublishDepth(depth), "PublishDepth adds a new symbol");
+    int btc = OKX_BridgeFindSymbol(handle, "BTC-USDT");
+    Check(btc == 1 && OKX_BridgeReadBook(handle, btc, &book) == 1 &&
+          book.bid_count == OKX_BRIDGE_BOOK_LEVELS && book.ask_price[9] == 60010.0 &&
+          book.bid_size[0] == 1.0, "Book cut to the top levels");
+
+    // Two feeds publishing the same symbol: every update counted once
+    {
+        auto publish = [&] {
+            for (int i = 0; i < 20000; i++) {
+                writer.PublishTick(tick);
+            }
+        };
+        thread first(publish), second(publish);
+        first.join();
+        second.join();
+    }
+    Check(OKX_BridgeReadQuote(handle, 0, &quote) == 1 && quote.update_count == 40001,
+          "update_count taken under the seqlock");
+
+    writer.AddSymbol("ETH-USDT");
+    writer.AddSymbol("SOL-USDT");
+    Check(writer.AddSymbol("DOGE-USDT") == -1, "Full table rejects new symbols");
+
+    MarketDataBridge reader;
+    Check(reader.Open(name) && !reader.PublishTick(tick) && reader.AddSymbol("ETH-USDT") == -1,
+          "Read-only mapping cannot publish");
+    reader.Close();
+    OKX_BridgeClose(handle);
+
+    PrintHeader("Torn-read check against a separate reader process");
+
+    const uint64_t updates = 200000;
+    const string stress_name = name + "_stress";
+    MarketDataBridge stress;
+    Check(stress.Create(stress_name, 1) && stress.AddSymbol("XAUT-USDT-SWAP") == 0, "Stress segment");
+
+    cout << flush;   // Or the child repeats the buffered output
+    pid_t child = fork();
+    if (child == 0) {
+        BridgeReaderResult result;
+        int rc = RunBridgeReader(stress_name.c_str(), "XAUT-USDT-SWAP", updates, 60000000000LL, &result);
+        cout << "  reader: " << result.reads << " reads, " << result.torn << " torn, "
+             << result.out_of_order << " out of order\n" << flush;
+        _exit(rc == 0 && result.reads > 0 && result.torn == 0 && result.out_of_order == 0 ? 0 : 1);
+    }
+
+    for (uint64_t n = 1; n <= updates; n++) {
+        MakeQuote(n, quote);
+        stress.PublishQuote(0, quote);
+        MakeBook(n, book);
+        stress.PublishBook(0, book);
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    Check(child > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+          "Reader process saw every final update and no torn or reordered reads");
+    stress.Close();
+    MarketDataBridge::Unlink(stress_name);
+
+    PrintHeader("Benchmark: latest quote for MT5");
+
+    handle = OKX_BridgeOpen(name.c_str());
+    const int iterations = 200000;
+    double sink = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        OKX_BridgeReadQuote(handle, 0, &quote);
+        sink += quote.bid;
+    }
+    double bridge_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    // The JSON hand-off it replaces: serialize the tick, parse it back
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations / 10; i++) {
+        nlohmann::json out = {{"instId", tick.inst_id}, {"bid", tick.bid_price}, {"ask", tick.ask_price},
+                              {"last", tick.last_price}, {"ts", tick.timestamp}};
+        nlohmann::json in = nlohmann::json::parse(out.dump());
+        sink += in["bid"].get<double>();
+    }
+    double json_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (iterations / 10);
+    OKX_BridgeClose(handle);
+
+    cout << fixed << setprecision(1);
+    cout << "  OKX_BridgeReadQuote     : " << bridge_ns << " ns\n";
+    cout << "  JSON dump + parse       : " << json_ns << " ns\n";
+    Check(sink > 0 && bridge_ns < json_ns, "Shared-memory read is cheaper than the JSON hand-off");
+
+    writer.Close();
+    MarketDataBridge::Unlink(name);
+    Check(OKX_BridgeOpen(name.c_str()) == -1, "Segment removed");
+
+    return TestSummary();
+}
@@ -0,0 +1,101 @@
+#include "okx_numeric.h"
+#include "test_util.h"
+#include <chrono>
+#include <clocale>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// The conversion the REST parsers used before: std::string temporary,
+// locale-dependent strtod underneath, exceptions on bad input
+double LegacyStod(string_view text) {
+    string str(text);
+    if (str.empty()) {
+        return 0.0;
+    }
+    try {
+        return std::stod(str);
+    } catch (...) {
+        return 0.0;
+    }
+}
+
+int main() {
+    PrintHeader("Conversion");
+
+    double d = -1;
+    Check(OKXNumeric::TryParse("2350.5", d) && d == 2350.5, "Plain decimal");
+    Check(OKXNumeric::TryParse("-0.0123", d) && d == -0.0123, "Negative decimal");
+    Check(OKXNumeric::TryParse("+1.5", d) && d == 1.5, "Leading '+' accepted");
+    Check(OKXNumeric::TryParse("1e-8", d) && d == 1e-8, "Exponent");
+    Check(!OKXNumeric::TryParse("", d), "Empty string rejected");
+    Check(!OKXNumeric::TryParse("1.5x", d), "Trailing garbage rejected");
+    Check(!OKXNumeric::TryParse("abc", d), "Non-number rejected");
+    Check(OKXNumeric::ToDouble("", -1.0) == -1.0, "ToDouble default on empty");
+    Check(OKXNumeric::ToDouble("0.1") == 0.1, "ToDouble round-trips 0.1 exactly");
+
+    Check(OKXNumeric::ToUint64("1700000000123") == 1700000000123ULL, "Millisecond timestamp");
+    Check(OKXNumeric::ToUint64("18446744073709551615") == UINT64_MAX, "uint64 max");
+    Check(OKXNumeric::ToUint64("18446744073709551616", 7) == 7, "uint64 overflow gives default");
+    Check(OKXNumeric::ToUint64("-1", 7) == 7, "Negative uint64 gives default");
+    Check(OKXNumeric::ToInt64("-42") == -42, "int64");
+
+    Check(OKXNumeric::ToInt("20") == 20, "Integer leverage");
+    Check(OKXNumeric::ToInt("10.0") == 10, "Fractional leverage truncated");
+    Check(OKXNumeric::ToInt("long_short_mode", -1) == -1,
+          "Non-numeric string gives default (used to recurse forever in SafeStoi)");
+    Check(OKXNumeric::ToInt("1.2.3", -1) == -1, "Malformed fraction rejected");
+
+    PrintHeader("Locale independence");
+
+    // std::stod follows LC_NUMERIC; from_chars never does
+    if (setlocale(LC_NUMERIC, "de_DE.UTF-8") != nullptr) {
+        Check(OKXNumeric::ToDouble("2350.5") == 2350.5, "Decimal point parsed under de_DE");
+        cout << "  std::stod under de_DE gives " << LegacyStod("2350.5") << "\n";
+        setlocale(LC_NUMERIC, "C");
+    } else {
+        cout << "  de_DE locale not installed, skipped\n";
+    }
+
+    PrintHeader("Benchmark: 800 depth fields");
+
+    // Roughly what one 400-level books response carries
+    vector<string> fields;
+    for (int i = 0; i < 400; i++) {
+        fields.push_back(to_string(2350.5 + i * 0.1).substr(0, 7));
+        fields.push_back(to_string(1.25 + i).substr(0, 6));
+    }
+
+    const int iterations = 2000;
+    double sum_legacy = 0, sum_fast = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& field : fields) {
+            sum_legacy += LegacyStod(string_view(field));
+        }
+    }
+    double legacy_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()
+                       / (iterations * fields.size());
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        for (const auto& field : fields) {
+            sum_fast += OKXNumeric::ToDouble(string_view(field));
+        }
+    }
+    double fast_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()
+                     / (iterations * fields.size());
+
+    cout << fixed << setprecision(1);
+    cout << "  string + std::stod : " << legacy_ns << " ns/field\n";
+    cout << "  OKXNumeric         : " << fast_ns << " ns/field  ("
+         << legacy_ns / fast_ns << "x)\n";
+    Check(sum_legacy == sum_fast, "Both paths produce identical values");
+    Check(fast_ns < legacy_ns, "from_chars path is faster");
+
+    return TestSummary();
+}
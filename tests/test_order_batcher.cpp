@@ -0,0 +1,258 @@
+#include "order_batcher.h"
+#include "okx_rest_api.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+struct Seen {
+    string path;
+    size_t items;
+};
+
+Order MakeOrder(const string& client_order_id, double price) {
+    Order order;
+    order.inst_id = "XAUT-USDT-SWAP";
+    order.trade_mode = "cross";
+    order.side = "sell";
+    order.order_type = "limit";
+    order.size = 1;
+    order.price = price;
+    order.client_order_id = client_order_id;
+    return order;
+}
+
+int main() {
+    mutex seen_mutex;
+    vector<Seen> seen;
+    vector<json> bodies;
+    atomic<bool> fail_all{false};
+    atomic<bool> reverse_data{false};
+
+    // Answers every item like OKX: ordId, clOrdId, sCode/sMsg; clOrdIds
+    // starting with "bad" are rejected
+    LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        json body = json::parse(request.body, nullptr, false);
+        json items = body.is_array() ? body : json::array({body});
+        {
+            lock_guard<mutex> lock(seen_mutex);
+            seen.push_back({request.path, items.size()});
+            bodies.push_back(body);
+        }
+        if (fail_all) {
+            reply.status = 500;
+            return reply;
+        }
+
+        json data = json::array();
+        size_t rejected = 0;
+        for (const auto& item : items) {
+            string client_order_id = item.value("clOrdId", "");
+            bool bad = client_order_id.rfind("bad", 0) == 0;
+            rejected += bad ? 1 : 0;
+            data.push_back({
+                {"ordId", item.value("ordId", "ord-" + client_order_id)},
+                {"clOrdId", client_order_id},
+                {"sCode", bad ? "51008" : "0"},
+                {"sMsg", bad ? "Order failed. Insufficient USDT balance" : ""}
+            });
+        }
+        if (reverse_data) {
+            data = json(vector<json>(data.rbegin(), data.rend()));
+        }
+        string code = rejected == 0 ? "0" : rejected == items.size() ? "1" : "2";
+        reply.body = json{{"code", code}, {"msg", ""}, {"data", data}}.dump();
+        return reply;
+    });
+    server.Start();
+
+    auto take_seen = [&] {
+        lock_guard<mutex> lock(seen_mutex);
+        vector<Seen> out;
+        out.swap(seen);
+        return out;
+    };
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig config;
+    config.base_url = server.BaseUrl();
+    config.api_key = "cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8";
+    config.secret_key = "4DD3E6E14B69380235D2D585DDE5B5B5";
+    config.passphrase = "Abc@123456";
+    config.max_retries = 1;
+    api.Initialize(config);
+
+    OrderBatcher::Options options;
+    options.window = chrono::milliseconds(50);
+
+    {
+        OrderBatcher batcher(api, options);
+
+        PrintHeader("Ladder entries in one window");
+
+        vector<future<OrderBatcher::Result>> results;
+        for (int i = 0; i < 20; i++) {
+            results.push_back(batcher.PlaceOrder(MakeOrder("ladder" + to_string(i), 2350 + i)));
+        }
+        bool matched = true;
+        for (int i = 0; i < 20; i++) {
+            OrderBatcher::Result result = results[i].get();
+            matched = matched && result.success && result.code == "0" &&
+                      result.order_id == "ord-ladder" + to_string(i) &&
+                      result.client_order_id == "ladder" + to_string(i);
+        }
+        vector<Seen> requests = take_seen();
+        Check(requests.size() == 1 && requests[0].path == "/api/v5/trade/batch-orders" &&
+              requests[0].items == 20, "20 orders sent as one /trade/batch-orders request");
+        Check(matched, "Each future gets its own ordId");
+        {
+            lock_guard<mutex> lock(seen_mutex);
+            Check(bodies.back()[3]["px"] == "2353.000000" && bodies.back()[3]["clOrdId"] == "ladder3" &&
+                  bodies.back()[3]["side"] == "sell", "Items keep the single-order body");
+        }
+
+        results.clear();
+        for (int i = 0; i < 25; i++) {
+            results.push_back(batcher.PlaceOrder(MakeOrder("big" + to_string(i), 2350)));
+        }
+        matched = true;
+        for (int i = 0; i < 25; i++) {
+            matched = matched && results[i].get().order_id == "ord-big" + to_string(i);
+        }
+        requests = take_seen();
+        Check(requests.size() == 2 && requests[0].items == 20 && requests[1].items == 5 && matched,
+              "25 orders split into 20 + 5");
+
+        PrintHeader("Per-item sCode");
+
+        auto ok1 = batcher.PlaceOrder(MakeOrder("ok1", 2350));
+        auto bad2 = batcher.PlaceOrder(MakeOrder("bad2", 2351));
+        auto ok3 = batcher.PlaceOrder(MakeOrder("ok3", 2352));
+        OrderBatcher::Result r1 = ok1.get(), r2 = bad2.get(), r3 = ok3.get();
+        Check(r1.success && !r2.success && r3.success && r2.code == "51008" &&
+              r2.message.find("Insufficient") != string::npos && r3.order_id == "ord-ok3",
+              "Partial failure (code 2) resolved per item");
+
+        reverse_data = true;
+        auto first = batcher.PlaceOrder(MakeOrder("first", 2350));
+        auto second = batcher.PlaceOrder(MakeOrder("second", 2351));
+        Check(first.get().order_id == "ord-first" && second.get().order_id == "ord-second",
+              "Out-of-order data matched by clOrdId");
+        reverse_data = false;
+        take_seen();
+
+        PrintHeader("Cancels and amends");
+
+        vector<future<OrderBatcher::Result>> cancels;
+        for (int i = 0; i < 10; i++) {
+            cancels.push_back(batcher.CancelOrder("XAUT-USDT-SWAP", to_string(1000 + i)));
+        }
+        bool cancelled = true;
+        for (int i = 0; i < 10; i++) {
+            OrderBatcher::Result result = cancels[i].get();
+            cancelled = cancelled && result.success && result.order_id == to_string(1000 + i);
+        }
+        requests = take_seen();
+        Check(requests.size() == 1 && requests[0].path == "/api/v5/trade/cancel-batch-orders" &&
+              requests[0].items == 10 && cancelled, "Mass cancel in one /trade/cancel-batch-orders");
+
+        auto amend1 = batcher.AmendOrder("XAUT-USDT-SWAP", "1", "", "2360.5");
+        auto amend2 = batcher.AmendOrder("XAUT-USDT-SWAP", "2", "3");
+        Check(amend1.get().success && amend2.get().order_id == "2", "Amends resolved");
+        requests = take_seen();
+        {
+            lock_guard<mutex> lock(seen_mutex);
+            Check(requests.size() == 1 && requests[0].path == "/api/v5/trade/amend-batch-orders" &&
+                  bodies.back()[0]["newPx"] == "2360.5" && bodies.back()[1]["newSz"] == "3",
+                  "Amends in one /trade/amend-batch-orders");
+        }
+
+        auto lone = batcher.CancelOrder("XAUT-USDT-SWAP", "", "solo");
+        Check(lone.get().success, "Lone cancel resolved");
+        requests = take_seen();
+        Check(requests.size() == 1 && requests[0].path == "/api/v5/trade/cancel-order",
+              "A lone request uses the single-order endpoint");
+
+        PrintHeader("Window and Flush");
+
+        auto start = chrono::steady_clock::now();
+        batcher.PlaceOrder(MakeOrder("wait", 2350)).get();
+        double waited_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        auto flushed = batcher.PlaceOrder(MakeOrder("now", 2350));
+        batcher.Flush();
+        flushed.get();
+        double flushed_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << fixed << setprecision(1) << "  windowed " << waited_ms << " ms, flushed " << flushed_ms << " ms\n";
+        Check(waited_ms >= 49 && flushed_ms < waited_ms, "Sent at the end of the window, or on Flush()");
+
+        fail_all = true;
+        auto lost1 = batcher.PlaceOrder(MakeOrder("lost1", 2350));
+        auto lost2 = batcher.PlaceOrder(MakeOrder("lost2", 2350));
+        OrderBatcher::Result l1 = lost1.get(), l2 = lost2.get();
+        Check(!l1.success && !l2.success && l1.client_order_id == "lost1" && !l2.message.empty(),
+              "A failed request fails every item");
+        fail_all = false;
+
+        OrderBatcher::Statistics stats = batcher.GetStatistics();
+        Check(stats.submitted == 67 && stats.largest_batch == 20 && stats.failed == 3 &&
+              stats.batched == 64 && stats.requests == 11, "Statistics");
+    }
+    take_seen();
+
+    PrintHeader("Destruction sends what is queued");
+
+    vector<future<OrderBatcher::Result>> pending;
+    {
+        OrderBatcher::Options slow;
+        slow.window = chrono::seconds(30);
+        OrderBatcher batcher(api, slow);
+        for (int i = 0; i < 3; i++) {
+            pending.push_back(batcher.PlaceOrder(MakeOrder("late" + to_string(i), 2350)));
+        }
+    }
+    bool ready = true;
+    for (auto& result : pending) {
+        ready = ready && result.wait_for(chrono::seconds(0)) == future_status::ready && result.get().success;
+    }
+    vector<Seen> requests = take_seen();
+    Check(ready && requests.size() == 1 && requests[0].items == 3, "Queued orders sent and resolved");
+
+    PrintHeader("Round trips: 20 orders");
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < 20; i++) {
+        api.PlaceOrder(MakeOrder("seq" + to_string(i), 2350));
+    }
+    double sequential_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    size_t sequential_requests = take_seen().size();
+
+    OrderBatcher batcher(api);      // Default 200 us window
+    start = chrono::steady_clock::now();
+    vector<future<OrderBatcher::Result>> ladder;
+    for (int i = 0; i < 20; i++) {
+        ladder.push_back(batcher.PlaceOrder(MakeOrder("co" + to_string(i), 2350)));
+    }
+    bool all_ok = true;
+    for (auto& result : ladder) {
+        all_ok = result.get().success && all_ok;
+    }
+    double batched_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    size_t batched_requests = take_seen().size();
+    cout << "  PlaceOrder x20 : " << sequential_ms << " ms, " << sequential_requests << " requests\n";
+    cout << "  OrderBatcher   : " << batched_ms << " ms, " << batched_requests << " requests\n";
+    Check(all_ok && sequential_requests == 20 && batched_requests < sequential_requests,
+          "Coalesced into fewer round trips");
+
+    server.Stop();
+
+    return TestSummary();
+}
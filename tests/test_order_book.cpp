@@ -0,0 +1,197 @@
+#include "order_book.h"
+#include "okx_fast_parser.h"
+#include "test_util.h"
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+// Straightforward reference book: price text -> size text per side
+struct ReferenceBook {
+    map<double, pair<string, string>, greater<double>> bids;
+    map<double, pair<string, string>> asks;
+
+    int32_t Checksum() const {
+        string s;
+        auto bid = bids.begin();
+        auto ask = asks.begin();
+        for (int i = 0; i < 25; i++) {
+            if (bid != bids.end()) {
+                s += bid->second.first + ":" + bid->second.second + ":";
+                ++bid;
+            }
+            if (ask != asks.end()) {
+                s += ask->second.first + ":" + ask->second.second + ":";
+                ++ask;
+            }
+        }
+        if (!s.empty()) s.pop_back();
+        return static_cast<int32_t>(OrderBook::Crc32(s.data(), s.size()));
+    }
+};
+
+string PriceText(int ticks) {
+    ostringstream oss;
+    oss << ticks / 10;
+    if (ticks % 10) oss << "." << ticks % 10;
+    return oss.str();
+}
+
+string Level(const string& px, const string& sz) {
+    return "[\"" + px + "\",\"" + sz + "\",\"0\",\"1\"]";
+}
+
+string Message(const string& action, const string& bids, const string& asks,
+               int32_t checksum, int64_t seq, int64_t prev) {
+    return "{\"arg\":{\"channel\":\"books\",\"instId\":\"XAUT-USDT-SWAP\"},\"action\":\"" + action +
+           "\",\"data\":[{\"asks\":[" + asks + "],\"bids\":[" + bids +
+           "],\"ts\":\"1700000000000\",\"checksum\":" + to_string(checksum) +
+           ",\"prevSeqId\":" + to_string(prev) + ",\"seqId\":" + to_string(seq) + "}]}";
+}
+
+int main() {
+    PrintHeader("CRC32 and OKX checksum");
+
+    Check(OrderBook::Crc32("123456789", 9) == 0xCBF43926u, "CRC32 check value");
+
+    OrderBook book("XAUT-USDT-SWAP");
+    // Example from the OKX docs: "3366.1:7:3366.8:9:3366:6:3368:8"
+    string snapshot = Message("snapshot",
+                              Level("3366.1", "7") + "," + Level("3366", "6"),
+                              Level("3366.8", "9") + "," + Level("3368", "8"),
+                              -1881014294, 100, -1);
+    Check(book.ApplyMessage(snapshot) == OrderBook::Result::kOk, "Snapshot checksum verified");
+    Check(book.IsValid() && book.BidCount() == 2 && book.AskCount() == 2, "Level counts");
+    Check(book.BestBid() == 3366.1 && book.BestBidSize() == 7 &&
+          book.BestAsk() == 3366.8 && book.BestAskSize() == 9, "Best bid/ask");
+    Check(book.Bid(1).price == 3366 && book.Ask(1).price == 3368, "Second levels");
+
+    PrintHeader("Incremental updates");
+
+    string update = Message("update", Level("3366.1", "0"), Level("3366.5", "2"), 0, 101, 100);
+    book.SetVerifyChecksum(false);
+    Check(book.ApplyMessage(update) == OrderBook::Result::kOk, "Update applied");
+    Check(book.BestBid() == 3366 && book.BidCount() == 1, "Size 0 deletes the level");
+    Check(book.BestAsk() == 3366.5 && book.AskCount() == 3, "New best ask inserted");
+    book.SetVerifyChecksum(true);
+
+    string gap = Message("update", Level("3366", "1"), "", 0, 105, 103);
+    Check(book.ApplyMessage(gap) == OrderBook::Result::kSequenceGap && !book.IsValid(),
+          "prevSeqId gap detected, book invalidated");
+    Check(book.ApplyMessage(update) == OrderBook::Result::kNotInitialized,
+          "Updates rejected until next snapshot");
+
+    book.ApplyMessage(snapshot);
+    string bad = Message("update", Level("3366", "5"), "", 12345, 101, 100);
+    Check(book.ApplyMessage(bad) == OrderBook::Result::kChecksumMismatch && !book.IsValid(),
+          "Checksum mismatch detected");
+    Check(book.GetStatistics().checksum_failures == 1 && book.GetStatistics().sequence_gaps == 1,
+          "Statistics counted");
+
+    PrintHeader("Randomized against reference (400 levels)");
+
+    mt19937 rng(42);
+    ReferenceBook ref;
+    string bids, asks;
+    for (int i = 0; i < 400; i++) {
+        string bid_px = PriceText(23500 - i * 2), ask_px = PriceText(23502 + i * 2);
+        string sz = to_string(1 + rng() % 50);
+        ref.bids[stod(bid_px)] = {bid_px, sz};
+        ref.asks[stod(ask_px)] = {ask_px, sz};
+        bids += (i ? "," : "") + Level(bid_px, sz);
+        asks += (i ? "," : "") + Level(ask_px, sz);
+    }
+
+    // Room for levels inserted between ticks so nothing is trimmed
+    OrderBook deep("XAUT-USDT-SWAP", 1000);
+    Check(deep.ApplyMessage(Message("snapshot", bids, asks, ref.Checksum(), 1, -1)) ==
+          OrderBook::Result::kOk, "400-level snapshot");
+
+    vector<string> updates;
+    int64_t seq = 1;
+    for (int i = 0; i < 5000; i++) {
+        // Mostly near the top: modify, insert between ticks, or delete
+        string bid_px = PriceText(23500 - static_cast<int>(rng() % 40));
+        string ask_px = PriceText(23502 + static_cast<int>(rng() % 40));
+        string bid_sz = (rng() % 3 == 0) ? "0" : to_string(rng() % 100 + 1);
+        string ask_sz = (rng() % 3 == 0) ? "0" : to_string(rng() % 100 + 1);
+
+        if (bid_sz == "0") ref.bids.erase(stod(bid_px)); else ref.bids[stod(bid_px)] = {bid_px, bid_sz};
+        if (ask_sz == "0") ref.asks.erase(stod(ask_px)); else ref.asks[stod(ask_px)] = {ask_px, ask_sz};
+
+        updates.push_back(Message("update", Level(bid_px, bid_sz), Level(ask_px, ask_sz),
+                                  ref.Checksum(), seq + 1, seq));
+        seq++;
+    }
+
+    bool all_ok = true;
+    for (const auto& message : updates) {
+        all_ok = all_ok && deep.ApplyMessage(message) == OrderBook::Result::kOk;
+    }
+    Check(all_ok, "5000 updates, every checksum verified");
+
+    bool same = deep.BidCount() == ref.bids.size() && deep.AskCount() == ref.asks.size();
+    size_t depth = 0;
+    for (auto it = ref.bids.begin(); same && it != ref.bids.end(); ++it, ++depth) {
+        same = deep.Bid(depth).price == it->first && deep.Bid(depth).size == stod(it->second.second);
+    }
+    depth = 0;
+    for (auto it = ref.asks.begin(); same && it != ref.asks.end(); ++it, ++depth) {
+        same = deep.Ask(depth).price == it->first && deep.Ask(depth).size == stod(it->second.second);
+    }
+    Check(same, "Book matches the reference level for level");
+
+    OrderBook small("XAUT-USDT-SWAP", 2);
+    small.SetVerifyChecksum(false);
+    small.ApplyMessage(snapshot);
+    small.ApplyMessage(Message("update", Level("3366.05", "4") + "," + Level("3365", "1"), "", 0, 101, 100));
+    Check(small.BidCount() == 2 && small.Bid(0).price == 3366.1 && small.Bid(1).price == 3366.05,
+          "Depth cap keeps the best levels");
+
+    Depth legacy;
+    deep.ToDepth(legacy, 5);
+    Check(legacy.bids.size() == 5 && legacy.bids[0].price == deep.BestBid() &&
+          legacy.asks[0].price == deep.BestAsk(), "ToDepth copies the top levels");
+
+    PrintHeader("Benchmark");
+
+    // Replay the same update stream on a fresh book
+    auto run = [&](bool verify) {
+        OrderBook bench("XAUT-USDT-SWAP", 1000);
+        bench.ApplyMessage(Message("snapshot", bids, asks, 0, 1, -1));
+        bench.SetVerifyChecksum(verify);
+        auto start = chrono::steady_clock::now();
+        for (const auto& message : updates) {
+            bench.ApplyMessage(message);
+        }
+        return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() /
+               updates.size();
+    };
+    double with_checksum = run(true);
+    double without_checksum = run(false);
+
+    auto start = chrono::steady_clock::now();
+    Depth rebuilt;
+    const int rebuilds = 200;
+    string snapshot_400 = Message("snapshot", bids, asks, 0, 1, -1);
+    for (int i = 0; i < rebuilds; i++) {
+        string_view element;
+        OKXFastParser::FirstDataElement(snapshot_400, element);
+        OKXFastParser::ParseOrderBook(element, rebuilt);
+    }
+    double rebuild_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() /
+                        rebuilds;
+
+    cout << fixed << setprecision(0);
+    cout << "  parse + apply update (checksum on)  : " << with_checksum << " ns\n";
+    cout << "  parse + apply update (checksum off) : " << without_checksum << " ns\n";
+    cout << "  rebuild Depth from 400-level snapshot: " << rebuild_ns << " ns\n";
+    Check(with_checksum < rebuild_ns, "Incremental update is cheaper than a rebuild");
+
+    return TestSummary();
+}
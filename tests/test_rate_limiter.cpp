@@ -0,0 +1,78 @@
+#include "rate_limiter.h"
+#include "test_util.h"
+#include <iostream>
+#include <thread>
+
+using namespace std;
+using namespace std::chrono;
+
+int main() {
+    const string order_key = "POST /api/v5/trade/order";
+    const string books_key = "GET /api/v5/market/books";
+
+    RateLimiter limiter;
+    limiter.SetLimit(order_key, RateLimiter::Limit::PerWindow(4, seconds(2)));
+    limiter.SetLimit(books_key, RateLimiter::Limit::PerWindow(2, seconds(2)));
+    limiter.SetDefaultLimit(RateLimiter::Limit::PerWindow(1, seconds(1)));
+
+    PrintHeader("Burst allowance");
+
+    bool burst_ok = true;
+    for (int i = 0; i < 4; i++) {
+        auto d = limiter.Acquire(order_key, milliseconds(0));
+        burst_ok = burst_ok && d.granted && !d.IsQueued(RateLimiter::Clock::now());
+    }
+    Check(burst_ok, "Four requests granted immediately from a bucket of 4");
+
+    auto rejected = limiter.Acquire(order_key, milliseconds(0));
+    Check(!rejected.granted, "Fifth request rejected when max_wait is 0");
+
+    PrintHeader("Queueing never blocks the caller");
+
+    auto before = RateLimiter::Clock::now();
+    auto queued = limiter.Acquire(order_key, milliseconds(2000));
+    auto call_us = duration_cast<microseconds>(RateLimiter::Clock::now() - before).count();
+    auto wait_ms = duration_cast<milliseconds>(queued.not_before - before).count();
+    cout << "  Acquire took " << call_us << " us, reserved wait " << wait_ms << " ms\n";
+    Check(queued.granted && queued.IsQueued(before), "Request queued with a future send time");
+    Check(wait_ms >= 400 && wait_ms <= 600, "Wait matches refill rate (2 req/s)");
+    Check(call_us < 10000, "Acquire returned without sleeping");
+
+    auto queued2 = limiter.Acquire(order_key, milliseconds(2000));
+    Check(queued2.not_before > queued.not_before, "Later request queues behind earlier reservation");
+
+    PrintHeader("Endpoints have separate budgets");
+
+    auto books1 = limiter.Acquire(books_key, milliseconds(0));
+    auto books2 = limiter.Acquire(books_key, milliseconds(0));
+    auto books3 = limiter.Acquire(books_key, milliseconds(0));
+    Check(books1.granted && books2.granted, "Market data has its own bucket despite exhausted order bucket");
+    Check(!books3.granted, "Market data bucket exhausts independently");
+
+    auto other = limiter.Acquire("GET /api/v5/unknown", milliseconds(0));
+    Check(other.granted, "Unknown endpoint gets a bucket with the default limit");
+
+    PrintHeader("Cost and refill");
+
+    limiter.SetLimit("batch", RateLimiter::Limit::PerWindow(20, milliseconds(200)));
+    Check(limiter.Acquire("batch", milliseconds(0), 20).granted, "Batch of 20 consumes the whole bucket");
+    Check(!limiter.Acquire("batch", milliseconds(0), 1).granted, "Nothing left right after");
+    this_thread::sleep_for(milliseconds(120));
+    Check(limiter.Acquire("batch", milliseconds(0), 10).granted, "Bucket refilled over time");
+
+    PrintHeader("Counters");
+
+    auto stats = limiter.GetStatistics(order_key);
+    cout << "  granted: " << stats.granted << ", queued: " << stats.queued
+         << ", rejected: " << stats.rejected << ", tokens: " << stats.tokens << "\n";
+    Check(stats.granted == 4, "Granted counter");
+    Check(stats.queued == 2, "Queued counter");
+    Check(stats.rejected == 1, "Rejected counter");
+    Check(stats.tokens < 0, "Reserved tokens show as negative balance");
+    Check(limiter.GetAllStatistics().size() == 4, "All buckets listed");
+
+    limiter.ResetStatistics();
+    Check(limiter.GetStatistics(order_key).granted == 0, "Counters reset");
+
+    return TestSummary();
+}
@@ -0,0 +1,116 @@
+#include "tick_pod.h"
+#include "event_ring.h"
+#include "test_util.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+int main() {
+    PrintHeader("SymbolTable");
+
+    SymbolTable table;
+    SymbolTable::Id xaut = table.Intern("XAUT-USDT-SWAP");
+    SymbolTable::Id btc = table.Intern("BTC-USDT-SWAP");
+    Check(xaut == 0 && btc == 1 && table.Intern("XAUT-USDT-SWAP") == xaut, "Dense ids, interned once");
+    Check(table.Find("BTC-USDT-SWAP") == btc && table.Find("ETH-USDT") == SymbolTable::kInvalidId &&
+          table.Size() == 2, "Find never adds");
+    Check(table.Name(xaut) == "XAUT-USDT-SWAP" && table.Name(99).empty(), "Name by id");
+    Check(table.Intern("") == SymbolTable::kInvalidId, "Empty name rejected");
+
+    const string& stable = table.Name(xaut);
+    for (int i = 0; i < 1000; i++) table.Intern("SYM-" + to_string(i));
+    Check(&stable == &table.Name(xaut) && table.Name(SymbolTable::Id(1001)) == "SYM-999",
+          "Names stay in place while the table grows past one chunk");
+
+    // Concurrent interning of the same names agrees on the ids
+    SymbolTable shared;
+    vector<vector<SymbolTable::Id>> seen(4);
+    vector<thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 500; i++) seen[t].push_back(shared.Intern("INST-" + to_string(i)));
+        });
+    }
+    for (auto& th : threads) th.join();
+    bool agree = shared.Size() == 500;
+    for (int t = 1; t < 4; t++) agree = agree && seen[t] == seen[0];
+    Check(agree, "4 threads interning the same 500 names get the same ids");
+
+    PrintHeader("TickPOD");
+
+    cout << "  sizeof(TickPOD) = " << sizeof(TickPOD) << " bytes, sizeof(Tick) = "
+         << sizeof(Tick) << " bytes\n";
+    Check(sizeof(TickPOD) == 64 && alignof(TickPOD) == 64, "One cache line");
+
+    Tick tick;
+    tick.inst_id = "XAUT-USDT-SWAP";
+    tick.platform = "okx";
+    tick.bid_price = 2350.4;
+    tick.ask_price = 2350.6;
+    tick.last_price = 2350.5;
+    tick.bid_size = 3;
+    tick.ask_size = 5;
+    tick.mark_price = 2350.45;
+    tick.timestamp = 1700000000000ULL;
+
+    TickPOD pod;
+    TickPOD::FromTick(tick, pod);
+    Check(pod.Symbol() == "XAUT-USDT-SWAP" && pod.platform == TickPOD::Platform::kOKX &&
+          pod.bid == 2350.4 && pod.ask_size == 5 && pod.timestamp == tick.timestamp, "Packed from Tick");
+
+    TickPOD copy;
+    memcpy(&copy, &pod, sizeof(pod));
+    Tick back;
+    copy.ToTick(back);
+    Check(back.inst_id == "XAUT-USDT-SWAP" && back.symbol == back.inst_id && back.platform == "okx" &&
+          back.bid == 2350.4 && back.bid_price == 2350.4 && back.last == 2350.5 &&
+          back.mark_price == 2350.45 && back.timestamp == tick.timestamp, "memcpy'd copy converts back");
+
+    Tick mt5;
+    mt5.symbol = "XAUUSD";
+    mt5.platform = "mt5";
+    mt5.bid = 2349.9;
+    mt5.ask = 2350.1;
+    TickPOD::FromTick(mt5, pod);
+    Check(pod.Symbol() == "XAUUSD" && pod.platform == TickPOD::Platform::kMT5 && pod.bid == 2349.9,
+          "MT5 tick: symbol and compatibility prices");
+
+    SpscRing<TickPOD> ring(16);
+    TickPOD::FromTick(tick, pod);
+    Check(ring.TryPush(pod) && ring.TryPop(copy) && copy.symbol_id == pod.symbol_id, "Moves through SpscRing");
+
+    PrintHeader("Benchmark: copying a quote");
+
+    const int iterations = 1000000;
+    vector<Tick> ticks(64);
+    vector<TickPOD> pods(64);
+    double sink = 0;
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        tick.bid_price = i;
+        ticks[i & 63] = tick;
+        sink += ticks[(i + 1) & 63].bid_price;
+    }
+    double tick_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        pod.bid = i;
+        pods[i & 63] = pod;
+        sink += pods[(i + 1) & 63].bid;
+    }
+    double pod_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / iterations;
+
+    cout << fixed << setprecision(1);
+    cout << "  Tick copy    : " << tick_ns << " ns\n";
+    cout << "  TickPOD copy : " << pod_ns << " ns\n";
+    Check(sink > 0 && pod_ns < tick_ns, "TickPOD copies cheaper than Tick");
+
+    return TestSummary();
+}
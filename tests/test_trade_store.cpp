@@ -0,0 +1,474 @@
+#include "trade_store.h"
+#include "local_http_server.h"
+#include "test_util.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+const uint64_t kBaseTime = 1700000000000ULL;    // 2023-11-14 22:13:20 UTC
+
+string MakeTempDirectory() {
+    char path[] = "/tmp/trade_store_XXXXXX";
+    return mkdtemp(path) ? string(path) : string();
+}
+
+void RemoveDirectory(const string& path) {
+    if (DIR* dir = opendir(path.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            string name = entry->d_name;
+            if (name != "." && name != "..") {
+                remove((path + "/" + name).c_str());
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(path.c_str());
+}
+
+// Fill with billId id, one every 7 minutes
+OKXRestAPI::Fill MakeFill(uint64_t id) {
+    OKXRestAPI::Fill fill;
+    fill.bill_id = to_string(id);
+    fill.trade_id = to_string(500000 + id);
+    fill.order_id = to_string(900000 + id / 2);
+    fill.inst_id = id % 3 == 0 ? "BTC-USDT-SWAP" : "XAUT-USDT-SWAP";
+    fill.side = id % 2 ? "sell" : "buy";
+    fill.fill_price = 2000 + static_cast<double>(id % 50);
+    fill.fill_size = 1 + static_cast<double>(id % 3);
+    fill.fee = -0.0005 * fill.fill_price * fill.fill_size;
+    fill.fee_currency = id % 7 == 0 ? "XAUT" : "USDT";
+    fill.fill_time = kBaseTime + id * 7 * 60 * 1000;
+    fill.exec_type = id % 4 == 0 ? "M" : "T";
+    return fill;
+}
+
+OKXRestAPI::Bill MakeBill(uint64_t id) {
+    OKXRestAPI::Bill bill;
+    bill.bill_id = to_string(id);
+    bill.inst_id = "XAUT-USDT-SWAP";
+    bill.currency = id % 4 == 0 ? "XAUT" : "USDT";
+    bill.bill_type = id % 3 == 0 ? 8 : 2;          // Funding fee / trade
+    bill.bill_sub_type = id % 3 == 0 ? "173" : "1";
+    bill.balance_change = id % 3 == 0 ? 0.25 : -1.0;
+    bill.balance = 1000 + static_cast<double>(id);
+    bill.fee = id % 3 == 0 ? 0 : -0.5;
+    bill.timestamp = kBaseTime + id * 60 * 60 * 1000;
+    return bill;
+}
+
+Order MakeHistoryOrder(uint64_t id) {
+    Order order;
+    order.order_id = to_string(id);
+    order.inst_id = id % 2 ? "XAUT-USDT-SWAP" : "BTC-USDT-SWAP";
+    order.side = "sell";
+    order.order_type = "limit";
+    order.state = id % 5 == 0 ? "canceled" : "filled";
+    order.position_side = "net";
+    order.price = 2350.5;
+    order.size = 2;
+    order.filled_size = id % 5 == 0 ? 0 : 2;
+    order.avg_fill_price = id % 5 == 0 ? 0 : 2350.5;
+    order.fee = -0.1;
+    order.create_time = kBaseTime + id * 1000;
+    order.update_time = order.create_time + 500;
+    return order;
+}
+
+using FeeKey = tuple<uint64_t, string, string>;
+
+struct FeeTotals {
+    size_t fills = 0;
+    double volume = 0;
+    double fee = 0;
+};
+
+// Brute-force FeesByDay over the generated fills
+map<FeeKey, FeeTotals> ExpectedFees(uint64_t first, uint64_t last, const string& inst_id = "") {
+    map<FeeKey, FeeTotals> expected;
+    for (uint64_t id = first; id <= last; id++) {
+        OKXRestAPI::Fill fill = MakeFill(id);
+        if (!inst_id.empty() && fill.inst_id != inst_id) {
+            continue;
+        }
+        FeeTotals& totals = expected[FeeKey(fill.fill_time / TradeStore::kDayMs * TradeStore::kDayMs,
+                                            fill.inst_id, fill.fee_currency)];
+        totals.fills++;
+        totals.volume += fill.fill_size;
+        totals.fee += fill.fee;
+    }
+    return expected;
+}
+
+bool SameFees(const vector<TradeStore::DailyFees>& actual, const map<FeeKey, FeeTotals>& expected) {
+    if (actual.size() != expected.size()) {
+        return false;
+    }
+    auto it = expected.begin();
+    for (const auto& group : actual) {
+        if (FeeKey(group.day, group.inst_id, group.currency) != it->first ||
+            group.fills != it->second.fills || fabs(group.volume - it->second.volume) > 1e-9 ||
+            fabs(group.fee - it->second.fee) > 1e-6) {
+            return false;
+        }
+        ++it;
+    }
+    return true;
+}
+
+// "/path?a=1&b=2" -> {a: 1, b: 2}
+map<string, string> QueryOf(const string& path) {
+    map<string, string> query;
+    size_t pos = path.find('?');
+    while (pos != string::npos) {
+        size_t next = path.find('&', pos + 1);
+        string pair = path.substr(pos + 1, next == string::npos ? string::npos : next - pos - 1);
+        size_t eq = pair.find('=');
+        if (eq != string::npos) {
+            query[pair.substr(0, eq)] = pair.substr(eq + 1);
+        }
+        pos = next;
+    }
+    return query;
+}
+
+int main() {
+    string directory = MakeTempDirectory();
+    if (directory.empty()) {
+        cout << "Cannot create a temporary directory\n";
+        return 1;
+    }
+
+    PrintHeader("Append");
+
+    TradeStore store;
+    Check(store.Open(directory), "Open creates the store");
+    Check(store.Rows(TradeStore::Table::kFills) == 0 && store.LastId(TradeStore::Table::kFills) == 0,
+          "Empty tables");
+
+    // Newest first, as OKX pages come
+    vector<OKXRestAPI::Fill> fills;
+    for (uint64_t id = 1000; id >= 1; id--) {
+        fills.push_back(MakeFill(id));
+    }
+    Check(store.AppendFills(fills) == 1000 && store.LastId(TradeStore::Table::kFills) == 1000,
+          "1000 fills appended, last billId 1000");
+    Check(store.AppendFills(fills) == 0, "Appending them again adds nothing");
+
+    fills.clear();
+    for (uint64_t id = 990; id <= 1010; id++) {
+        fills.push_back(MakeFill(id));
+    }
+    fills.push_back(MakeFill(1005));
+    Check(store.AppendFills(fills) == 10 && store.Rows(TradeStore::Table::kFills) == 1010,
+          "Overlap and duplicates skipped");
+
+    OKXRestAPI::Fill fill;
+    OKXRestAPI::Fill expected = MakeFill(1);
+    Check(store.GetFill(0, fill) && fill.bill_id == "1" && fill.trade_id == expected.trade_id &&
+          fill.order_id == expected.order_id && fill.inst_id == expected.inst_id &&
+          fill.side == expected.side && fill.fill_price == expected.fill_price &&
+          fill.fill_size == expected.fill_size && fill.fee == expected.fee &&
+          fill.fee_currency == expected.fee_currency && fill.fill_time == expected.fill_time &&
+          fill.exec_type == expected.exec_type, "Row 0 is the oldest fill, every field intact");
+    Check(store.GetFill(1009, fill) && fill.bill_id == "1010" && !store.GetFill(1010, fill),
+          "Rows stored by ascending billId");
+
+    vector<Order> orders;
+    for (uint64_t id = 200; id >= 101; id--) {
+        orders.push_back(MakeHistoryOrder(id));
+    }
+    vector<OKXRestAPI::Bill> bills;
+    for (uint64_t id = 1; id <= 240; id++) {
+        bills.push_back(MakeBill(id));
+    }
+    Check(store.AppendOrders(orders) == 100 && store.AppendBills(bills) == 240, "Orders and bills appended");
+
+    PrintHeader("Queries");
+
+    TradeStore::Filter all;
+    Check(SameFees(store.FeesByDay(all), ExpectedFees(1, 1010)), "FeesByDay matches a brute-force sum");
+
+    TradeStore::Filter xaut;
+    xaut.inst_id = "XAUT-USDT-SWAP";
+    vector<TradeStore::DailyFees> xaut_fees = store.FeesByDay(xaut);
+    Check(SameFees(xaut_fees, ExpectedFees(1, 1010, "XAUT-USDT-SWAP")), "Filtered by instrument");
+    for (size_t i = 0; i < xaut_fees.size() && i < 4; i++) {
+        const auto& group = xaut_fees[i];
+        cout << "  " << group.day << " " << group.inst_id << " " << group.currency << " fills "
+             << group.fills << " fee " << fixed << setprecision(4) << group.fee << "\n";
+    }
+
+    TradeStore::Filter window;
+    window.begin_time = MakeFill(100).fill_time;
+    window.end_time = MakeFill(200).fill_time;
+    window.currency = "USDT";
+    size_t matched = 0;
+    bool in_window = true;
+    size_t scanned = store.ScanFills(window, [&](const OKXRestAPI::Fill& f) {
+        matched++;
+        in_window = in_window && f.fill_time >= window.begin_time && f.fill_time < window.end_time &&
+                    f.fee_currency == "USDT";
+    });
+    size_t expected_window = 0;
+    for (uint64_t id = 100; id < 200; id++) {
+        expected_window += MakeFill(id).fee_currency == "USDT" ? 1 : 0;
+    }
+    Check(scanned == matched && matched == expected_window && in_window, "Scan by time range and currency");
+
+    TradeStore::Filter unknown;
+    unknown.inst_id = "ETH-USDT-SWAP";
+    Check(store.FeesByDay(unknown).empty() && store.ScanFills(unknown, [](const OKXRestAPI::Fill&) {}) == 0,
+          "Unknown instrument matches nothing");
+
+    size_t canceled = 0;
+    TradeStore::Filter btc;
+    btc.inst_id = "BTC-USDT-SWAP";
+    size_t btc_orders = store.ScanOrders(btc, [&](const Order& order) {
+        canceled += order.state == "canceled" ? 1 : 0;
+    });
+    Order order;
+    Check(btc_orders == 50 && canceled == 10 && store.GetOrder(0, order) && order.order_id == "101" &&
+          order.avg_fill_price == 2350.5 && order.update_time == order.create_time + 500,
+          "Orders scanned by instrument");
+
+    vector<TradeStore::DailyBills> bill_days = store.BillsByDay(all);
+    size_t bill_count = 0;
+    double funding = 0;
+    for (const auto& group : bill_days) {
+        bill_count += group.bills;
+        funding += group.bill_type == 8 ? group.balance_change : 0;
+    }
+    map<tuple<uint64_t, string, int>, size_t> bill_groups;
+    for (uint64_t id = 1; id <= 240; id++) {
+        OKXRestAPI::Bill b = MakeBill(id);
+        bill_groups[make_tuple(b.timestamp / TradeStore::kDayMs * TradeStore::kDayMs, b.currency, b.bill_type)]++;
+    }
+    bool same_groups = bill_days.size() == bill_groups.size();
+    for (size_t i = 0; same_groups && i < bill_days.size(); i++) {
+        auto it = next(bill_groups.begin(), static_cast<long>(i));
+        same_groups = make_tuple(bill_days[i].day, bill_days[i].currency, bill_days[i].bill_type) == it->first &&
+                      bill_days[i].bills == it->second;
+    }
+    Check(same_groups && bill_count == 240 && fabs(funding - 80 * 0.25) < 1e-9,
+          "BillsByDay per day, currency and type");
+
+    PrintHeader("Reopen and grow");
+
+    store.Close();
+    Check(!store.IsOpen() && store.Rows(TradeStore::Table::kFills) == 0, "Closed");
+    Check(store.Open(directory) && store.Rows(TradeStore::Table::kFills) == 1010 &&
+          store.LastId(TradeStore::Table::kFills) == 1010 && store.Rows(TradeStore::Table::kOrders) == 100 &&
+          store.LastId(TradeStore::Table::kBills) == 240, "Row counts and last ids persisted");
+    Check(SameFees(store.FeesByDay(all), ExpectedFees(1, 1010)) && store.GetFill(5, fill) &&
+          fill.inst_id == MakeFill(6).inst_id, "Columns and dictionary persisted");
+
+    fills.clear();
+    for (uint64_t id = 1011; id <= 200000; id++) {
+        fills.push_back(MakeFill(id));
+    }
+    auto start = chrono::steady_clock::now();
+    size_t appended = store.AppendFills(fills);
+    double append_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    Check(appended == 198990 && store.GetFill(199999, fill) && fill.bill_id == "200000" &&
+          fill.fee == MakeFill(200000).fee, "Columns grown past " + to_string(TradeStore::kGrowRows) + " rows");
+
+    start = chrono::steady_clock::now();
+    vector<TradeStore::DailyFees> days = store.FeesByDay(xaut);
+    double aggregate_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cout << fixed << setprecision(1) << "  200000 fills: append " << append_ms << " ms, FeesByDay "
+         << aggregate_ms << " ms (" << days.size() << " groups)\n";
+    Check(SameFees(days, ExpectedFees(1, 200000, "XAUT-USDT-SWAP")), "FeesByDay over 200000 fills");
+    Check(store.Flush(), "Flush");
+
+    store.Close();
+    RemoveDirectory(directory);
+
+    PrintHeader("Incremental sync");
+
+    directory = MakeTempDirectory();
+    mutex seen_mutex;
+    vector<string> seen;
+    atomic<int> total{1234};
+    atomic<bool> fail_older{false};
+    set<int> live_orders;               // Not final yet: left out of orders-history
+
+    // Fills, orders and bills with ids 1..total, newest first, honouring after / limit / instId
+    LocalHttpServer server([&](const LocalHttpServer::Request& request) {
+        LocalHttpServer::Reply reply;
+        {
+            lock_guard<mutex> lock(seen_mutex);
+            seen.push_back(request.path);
+        }
+        map<string, string> query = QueryOf(request.path);
+        if (fail_older && query.count("after")) {
+            reply.status = 500;
+            return reply;
+        }
+        int limit = query.count("limit") ? stoi(query["limit"]) : 100;
+        int top = query.count("after") ? stoi(query["after"]) - 1 : total.load();
+        string inst_id = query.count("instId") ? query["instId"] : "";
+
+        string path = request.path.substr(0, request.path.find('?'));
+        json data = json::array();
+        for (int id = top; id >= 1 && static_cast<int>(data.size()) < limit; id--) {
+            if (path == "/api/v5/trade/fills") {
+                OKXRestAPI::Fill f = MakeFill(id);
+                if (!inst_id.empty() && f.inst_id != inst_id) {
+                    continue;
+                }
+                data.push_back({{"billId", f.bill_id}, {"tradeId", f.trade_id}, {"ordId", f.order_id},
+                                {"instId", f.inst_id}, {"side", f.side}, {"fillPx", to_string(f.fill_price)},
+                                {"fillSz", to_string(f.fill_size)}, {"fee", to_string(f.fee)},
+                                {"feeCcy", f.fee_currency}, {"fillTime", to_string(f.fill_time)},
+                                {"execType", f.exec_type}});
+            } else if (path == "/api/v5/account/bills") {
+                OKXRestAPI::Bill b = MakeBill(id);
+                data.push_back({{"billId", b.bill_id}, {"instId", b.inst_id}, {"ccy", b.currency},
+                                {"type", to_string(b.bill_type)}, {"subType", b.bill_sub_type},
+                                {"balChg", to_string(b.balance_change)}, {"bal", to_string(b.balance)},
+                                {"fee", to_string(b.fee)}, {"ts", to_string(b.timestamp)}});
+            } else {
+                Order o = MakeHistoryOrder(id);
+                if ((!inst_id.empty() && o.inst_id != inst_id) || live_orders.count(id)) {
+                    continue;
+                }
+                data.push_back({{"ordId", o.order_id}, {"instId", o.inst_id}, {"side", o.side},
+                                {"ordType", o.order_type}, {"state", o.state}, {"posSide", o.position_side},
+                                {"px", "2350.5"}, {"sz", "2"}, {"cTime", to_string(o.create_time)},
+                                {"uTime", to_string(o.update_time)}});
+            }
+        }
+        reply.body = json{{"code", "0"}, {"msg", ""}, {"data", data}}.dump();
+        return reply;
+    });
+    server.Start();
+
+    auto take_seen = [&] {
+        lock_guard<mutex> lock(seen_mutex);
+        vector<string> out;
+        out.swap(seen);
+        return out;
+    };
+
+    OKXRestAPI api;
+    OKXRestAPI::APIConfig config;
+    config.base_url = server.BaseUrl();
+    config.api_key = "cfd780d7-6dc6-4fee-bb27-d7a4608d2fa8";
+    config.secret_key = "4DD3E6E14B69380235D2D585DDE5B5B5";
+    config.passphrase = "Abc@123456";
+    config.max_retries = 1;
+    api.Initialize(config);
+
+    TradeStore synced;
+    synced.Open(directory);
+    OKXRestAPI::HistoryQuery query;
+    query.inst_type = "SWAP";
+
+    size_t added = 0;
+    Check(synced.SyncFills(api, query, &added) && added == 1234 &&
+          synced.LastId(TradeStore::Table::kFills) == 1234 && take_seen().size() == 13,
+          "First sync pulls the whole history (13 pages)");
+    Check(SameFees(synced.FeesByDay(all), ExpectedFees(1, 1234)), "Synced fills aggregate like the source");
+
+    total = 1264;
+    vector<string> requests;
+    Check(synced.SyncFills(api, query, &added) && added == 30 &&
+          synced.Rows(TradeStore::Table::kFills) == 1264, "Second sync appends only the 30 new fills");
+    requests = take_seen();
+    Check(requests.size() == 1 && QueryOf(requests[0]).count("after") == 0,
+          "Stops at the last stored billId");
+
+    Check(synced.SyncFills(api, query, &added) && added == 0, "Nothing new, nothing added");
+    take_seen();
+
+    total = 1500;
+    fail_older = true;
+    Check(!synced.SyncFills(api, query, &added) && added == 0 &&
+          synced.Rows(TradeStore::Table::kFills) == 1264, "A failed page stores nothing");
+    fail_older = false;
+    Check(synced.SyncFills(api, query, &added) && added == 236 &&
+          synced.LastId(TradeStore::Table::kFills) == 1500, "The next sync fills the gap");
+    take_seen();
+
+    total = 150;
+    live_orders = {140, 145};
+    Check(synced.SyncOrders(api, query, &added) && added == 148 && synced.GetOrder(147, order) &&
+          order.order_id == "150" && order.state == MakeHistoryOrder(150).state, "Orders synced");
+    Check(synced.SyncBills(api, query, &added) && added == 150 && synced.LastId(TradeStore::Table::kBills) == 150,
+          "Bills synced");
+    take_seen();
+
+    PrintHeader("Orders finalised after a sync");
+
+    // 140 and 145 finish after the first sync and appear below ordIds already stored
+    total = 160;
+    live_orders = {100};
+    Check(synced.SyncOrders(api, query, &added) && added == 12 &&
+          synced.Rows(TradeStore::Table::kOrders) == 160 && synced.LastId(TradeStore::Table::kOrders) == 160,
+          "New orders and the two late ones added, nothing twice");
+    set<string> order_ids;
+    synced.ScanOrders(all, [&](const Order& o) { order_ids.insert(o.order_id); });
+    Check(order_ids.size() == 160 && order_ids.count("140") && order_ids.count("145"), "Each ordId stored once");
+    take_seen();
+
+    // A 5 s lookback stops the walk at cTime(160) - 5 s: one page, and 100 stays missed
+    synced.SetOrderLookback(5000);
+    total = 170;
+    live_orders.clear();
+    Check(synced.SyncOrders(api, query, &added) && added == 10, "Lookback bounds the order walk");
+    requests = take_seen();
+    Check(requests.size() == 1, "One request with a short lookback");
+
+    synced.Close();
+    RemoveDirectory(directory);
+
+    PrintHeader("Sync marks per query");
+
+    directory = MakeTempDirectory();
+    total = 1500;
+    TradeStore split;
+    split.Open(directory);
+    OKXRestAPI::HistoryQuery btc_query = query, xaut_query = query;
+    btc_query.inst_id = "BTC-USDT-SWAP";
+    xaut_query.inst_id = "XAUT-USDT-SWAP";
+    Check(split.SyncFills(api, btc_query, &added) && added == 500, "BTC fills synced");
+    Check(split.SyncFills(api, xaut_query, &added) && added == 1000, "Older XAUT fills not hidden by the BTC sync");
+    Check(SameFees(split.FeesByDay(all), ExpectedFees(1, 1500)), "Both instruments aggregate like the source");
+    take_seen();
+
+    total = 1530;
+    size_t btc_added = 0, xaut_added = 0;
+    Check(split.SyncFills(api, btc_query, &btc_added) && split.SyncFills(api, xaut_query, &xaut_added) &&
+          btc_added == 10 && xaut_added == 20 && split.LastId(TradeStore::Table::kFills) == 1530,
+          "Each query adds only its new fills");
+    requests = take_seen();
+    Check(requests.size() == 2 && QueryOf(requests[0])["instId"] == "BTC-USDT-SWAP" &&
+          QueryOf(requests[1])["instId"] == "XAUT-USDT-SWAP", "One page per query");
+
+    split.Close();
+    Check(split.Open(directory) && split.SyncFills(api, btc_query, &btc_added) &&
+          split.SyncFills(api, xaut_query, &xaut_added) && btc_added == 0 && xaut_added == 0 &&
+          take_seen().size() == 2, "Marks survive a reopen");
+    Check(SameFees(split.FeesByDay(all), ExpectedFees(1, 1530)), "No fill lost or doubled");
+
+    server.Stop();
+    split.Close();
+    RemoveDirectory(directory);
+
+    return TestSummary();
+}
@@ -0,0 +1,30 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+// Scaffold shared by the standalone test and benchmark executables:
+// [PASS]/[FAIL] lines, section banners and the closing summary line.
+// Each executable is a single translation unit, so one counter suffices.
+
+#include <iostream>
+#include <string>
+
+inline int failures = 0;
+
+inline void Check(bool condition, const std::string& what) {
+    std::cout << "  " << (condition ? "[PASS] " : "[FAIL] ") << what << "\n";
+    if (!condition) failures++;
+}
+
+inline void PrintHeader(const std::string& title) {
+    std::cout << "\n================================================\n";
+    std::cout << "  " << title << "\n";
+    std::cout << "================================================\n\n";
+}
+
+// Print the summary line; the exit code of main()
+inline int TestSummary() {
+    std::cout << "\n" << (failures == 0 ? "All tests passed" : "Some tests FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
+#endif // TEST_UTIL_H
@@ -0,0 +1,234 @@
+#include "okx_websocket.h"
+#include "local_ws_server.h"
+#include "test_util.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate, int timeout_ms = 3000) {
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(timeout_ms);
+    while (!predicate()) {
+        if (chrono::steady_clock::now() > deadline) return false;
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return true;
+}
+
+const string kTickerPush =
+    R"({"arg":{"channel":"tickers","instId":"XAUT-USDT-SWAP"},"data":[{"instType":"SWAP",)"
+    R"("instId":"XAUT-USDT-SWAP","last":"2350.5","bidPx":"2350.4","bidSz":"3","askPx":"2350.6",)"
+    R"("askSz":"5","ts":"1700000000000"}]})";
+
+// Checksum example from the OKX docs (see test_order_book)
+const string kBookSnapshot =
+    R"({"arg":{"channel":"books","instId":"XAUT-USDT-SWAP"},"action":"snapshot","data":[{)"
+    R"("asks":[["3366.8","9","0","1"],["3368","8","0","1"]],)"
+    R"("bids":[["3366.1","7","0","1"],["3366","6","0","1"]],"ts":"1700000000000",)"
+    R"("checksum":-1881014294,"prevSeqId":-1,"seqId":100}]})";
+
+int main() {
+    atomic<int> pings{0};
+    atomic<int> ticker_subscribes{0};
+
+    LocalWsServer server([&](const string& message) {
+        LocalWsServer::Reply reply;
+        if (message == "ping") {
+            pings++;
+            reply.messages.push_back("pong");
+        } else if (message.find("\"op\":\"subscribe\"") != string::npos) {
+            if (message.find("tickers") != string::npos) {
+                ticker_subscribes++;
+                reply.messages.push_back(R"({"event":"subscribe","arg":{"channel":"tickers"}})");
+                reply.messages.push_back(kTickerPush);
+            }
+            if (message.find("books") != string::npos) {
+                reply.messages.push_back(kBookSnapshot);
+            }
+        } else if (message == "bad-op") {
+            reply.messages.push_back(R"({"event":"error","code":"60012","msg":"Invalid request"})");
+        } else if (message == "drop") {
+            reply.close_connection = true;
+        } else {
+            reply.messages.push_back(message);   // Echo
+        }
+        return reply;
+    });
+    if (!server.Start()) {
+        cerr << "Failed to start local TLS WebSocket server\n";
+        return 1;
+    }
+
+    PrintHeader("Connect and subscribe");
+
+    OKXWebSocket ws;
+    OKXWebSocket::WSConfig config;
+    config.url = server.Url();
+    config.verify_ssl = false;               // Self-signed test certificate
+    config.reconnect_delay_seconds = 1;
+    config.ping_interval_seconds = 1;
+    ws.Initialize(config);
+
+    mutex errors_mutex;
+    vector<string> errors;
+    ws.SetErrorCallback([&](const string& error) {
+        lock_guard<mutex> lock(errors_mutex);
+        errors.push_back(error);
+    });
+
+    // Round-trip probe: the I/O thread stamps the echo of the pending message
+    atomic<long> echo_expected{-1};
+    atomic<bool> echo_received{false};
+    ws.SetMessageCallback([&](string_view message) {
+        long expected = echo_expected.load(memory_order_acquire);
+        if (expected >= 0 && message == "echo " + to_string(expected)) {
+            echo_received.store(true, memory_order_release);
+        }
+    });
+
+    atomic<int> ticks{0};
+    atomic<double> last_bid{0};
+    atomic<int64_t> tick_latency_us{0};
+    ws.SubscribeTicker("XAUT-USDT-SWAP", [&](const Tick& tick) {
+        last_bid = tick.bid_price;
+        tick_latency_us = tick.latency_us;
+        ticks++;
+    });
+
+    Check(ws.Connect() && ws.IsConnected(), "Connected over TLS");
+    Check(WaitFor([&] { return ticks.load() == 1; }), "Subscription sent, ticker dispatched");
+    Check(last_bid.load() == 2350.4, "Ticker fields parsed");
+    // The canned push is stamped 1700000000000, so its "latency" is its age
+    int64_t age_us = OKXSigner::NowUs() - 1700000000000LL * 1000;
+    Check(tick_latency_us.load() > 0 && tick_latency_us.load() <= age_us &&
+          age_us - tick_latency_us.load() < 10000000, "One-way latency stamped on the tick");
+
+    atomic<int> depths{0};
+    atomic<double> best_bid{0};
+    ws.SubscribeDepth("XAUT-USDT-SWAP", [&](const Depth& depth) {
+        best_bid = depth.bids.empty() ? 0 : depth.bids[0].price;
+        depths++;
+    }, "books");
+    Check(WaitFor([&] { return depths.load() == 1; }) && best_bid.load() == 3366.1,
+          "books snapshot applied to the OrderBook (checksum verified)");
+
+    // Ring-only subscriber: decoded events, no callback on the I/O thread
+    OKXWebSocket ring_ws;
+    ring_ws.Initialize(config);
+    SpscRing<MarketEvent> ring(64);
+    ring_ws.SetEventRing(&ring);
+    MarketDataBridge bridge;
+    const string bridge_name = "okx_ws_test_" + to_string(getpid());
+    bridge.Create(bridge_name);
+    ring_ws.SetMarketDataBridge(&bridge);
+    ring_ws.SubscribeTicker("XAUT-USDT-SWAP", nullptr);
+    ring_ws.SubscribeDepth("XAUT-USDT-SWAP", nullptr, "books");
+    ring_ws.Connect();
+    Check(WaitFor([&] { return ring.Size() == 2; }), "Tick and depth published into the event ring");
+    MarketEvent event;
+    bool tick_ok = ring.TryPop(event) && event.type == MarketEvent::Type::kTick && event.tick.bid == 2350.4;
+    bool depth_ok = ring.TryPop(event) && event.type == MarketEvent::Type::kDepth &&
+                    event.depth.bid_count == 2 && event.depth.bid_price[0] == 3366.1;
+    Check(tick_ok && depth_ok && ring.GetStatistics().overruns == 0, "MarketEvent records decoded");
+    ring_ws.Disconnect();
+
+    OKXBridgeQuote quote;
+    OKXBridgeBook book;
+    int slot = bridge.FindSymbol("XAUT-USDT-SWAP");
+    Check(bridge.ReadQuote(slot, quote) && quote.bid == 2350.4 &&
+          bridge.ReadBook(slot, book) && book.ask_count == 2 && book.ask_price[0] == 3366.8,
+          "Tick and book stored in the shared-memory bridge");
+    bridge.Close();
+    MarketDataBridge::Unlink(bridge_name);
+
+    ws.SendText("bad-op");
+    Check(WaitFor([&] {
+        lock_guard<mutex> lock(errors_mutex);
+        return !errors.empty() && errors.back().find("60012") != string::npos;
+    }), "Error event reported");
+
+    PrintHeader("Round-trip latency against the local TLS echo server");
+
+    const int rounds = 2000;
+    vector<double> rtt_us;
+    rtt_us.reserve(rounds);
+    int lost = 0;
+    for (int i = 0; i < rounds; i++) {
+        string message = "echo " + to_string(i);
+        echo_received.store(false, memory_order_relaxed);
+        echo_expected.store(i, memory_order_release);
+        auto start = chrono::steady_clock::now();
+        ws.SendText(message);
+        while (!echo_received.load(memory_order_acquire)) {
+            if (chrono::steady_clock::now() - start > chrono::seconds(2)) break;
+        }
+        if (!echo_received.load()) {
+            lost++;
+            break;
+        }
+        rtt_us.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+    echo_expected = -1;
+
+    sort(rtt_us.begin(), rtt_us.end());
+    auto percentile = [&](double p) {
+        return rtt_us.empty() ? 0.0 : rtt_us[static_cast<size_t>(p * (rtt_us.size() - 1))];
+    };
+    cout << fixed << setprecision(1);
+    cout << "  round trips : " << rtt_us.size() << "\n";
+    cout << "  p50         : " << percentile(0.50) << " us\n";
+    cout << "  p99         : " << percentile(0.99) << " us\n";
+    cout << "  max         : " << percentile(1.0) << " us\n";
+    Check(lost == 0, "Every echo came back");
+    Check(percentile(0.50) < 10000, "Median round trip well under 10 ms");
+
+    PrintHeader("Heartbeat");
+
+    int pings_before = pings.load();
+    Check(WaitFor([&] { return pings.load() > pings_before; }, 3000),
+          "\"ping\" sent after the idle interval");
+    Check(ws.IsConnected(), "\"pong\" keeps the connection alive");
+
+    PrintHeader("Reconnect with TLS session reuse");
+
+    ws.SendText("drop");
+    Check(WaitFor([&] { return ws.GetStatistics().reconnection_count == 1 && ws.IsConnected(); }),
+          "Reconnected after the server dropped the connection");
+    Check(WaitFor([&] { return ticks.load() == 2 && depths.load() == 2; }),
+          "Subscriptions replayed after reconnect");
+    Check(ticker_subscribes.load() == 3, "Ticker subscribed once per connection");
+    cout << "  TLS handshakes: " << server.Handshakes()
+         << ", resumed: " << server.ResumedSessions() << "\n";
+    Check(server.Handshakes() == 3 && server.ResumedSessions() == 1,
+          "Reconnect resumed the previous TLS session");
+
+    PrintHeader("Disconnect");
+
+    OKXWebSocket::Statistics stats = ws.GetStatistics();
+    Check(stats.total_messages_received > static_cast<uint64_t>(rounds) &&
+          stats.total_messages_sent > static_cast<uint64_t>(rounds) &&
+          stats.subscription_count == 2, "Statistics counted");
+    Check(stats.latency_samples >= 2 && stats.max_latency_us >= stats.last_latency_us &&
+          stats.avg_latency_us > 0, "Market-data latency counted");
+    LatencyRegistry::Snapshot latency = ws.GetLatencySnapshot();
+    Check(latency["tickers"].Stage(LatencyStage::kParse).count >= 1 &&
+          latency["tickers"].Stage(LatencyStage::kDispatch).count >= 1 &&
+          latency["tickers"].Stage(LatencyStage::kNetwork).count >= 1 &&
+          latency["books"].Stage(LatencyStage::kParse).count >= 1, "Per-channel latency histograms");
+
+    ws.Disconnect();
+    Check(!ws.IsConnected(), "Disconnected");
+    Check(WaitFor([&] { return server.CloseFrames() == 2; }), "Close frame sent");
+
+    server.Stop();
+
+    return TestSummary();
+}